@@ -0,0 +1,156 @@
+/*
+  Benchmark driver for the checked-in scss corpus (make bench).
+
+  Each input is compiled repeatedly through sass_compile_file_context
+  with the profile option enabled; the per-phase timings the library
+  collects (parse/expand/cssize/render/...) are folded to their
+  minimum over all repetitions, which is the stablest estimator on a
+  noisy machine. The report is a single json document on stdout so
+  results can be archived and diffed for regression tracking; peak
+  RSS for the whole run is taken from getrusage at the end.
+
+  Repetitions default to 5 and can be overridden via BENCH_REPS.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <limits.h>
+#include <sys/resource.h>
+#include <sass/context.h>
+
+#define MAX_PHASES 16
+
+struct phase_stat {
+  char name[32];
+  double min_msec;
+};
+
+struct bench_result {
+  const char* file;
+  double total_msec;
+  size_t output_bytes;
+  struct phase_stat phases[MAX_PHASES];
+  int num_phases;
+};
+
+static double now_msec(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* pull "name": number pairs out of the flat "phases" object in the
+   profile json; the format is produced by our own serializer, so a
+   minimal scanner is all that is needed here */
+static void merge_phases(struct bench_result* res, const char* json)
+{
+  const char* p = strstr(json, "\"phases\"");
+  if (p == 0) return;
+  p = strchr(p, '{');
+  if (p == 0) return;
+  while (*p && *p != '}') {
+    const char* key = strchr(p, '"');
+    if (key == 0 || *key != '"') break;
+    const char* end = strchr(++key, '"');
+    if (end == 0) break;
+    size_t len = (size_t)(end - key);
+    if (len >= sizeof(((struct phase_stat*)0)->name))
+      len = sizeof(((struct phase_stat*)0)->name) - 1;
+    p = strchr(end, ':');
+    if (p == 0) break;
+    double val = strtod(p + 1, (char**)&p);
+    int i;
+    for (i = 0; i < res->num_phases; i++) {
+      if (strncmp(res->phases[i].name, key, len) == 0 &&
+          res->phases[i].name[len] == 0) break;
+    }
+    if (i == res->num_phases && i < MAX_PHASES) {
+      memcpy(res->phases[i].name, key, len);
+      res->phases[i].name[len] = 0;
+      res->phases[i].min_msec = val;
+      res->num_phases++;
+    }
+    else if (i < res->num_phases && val < res->phases[i].min_msec) {
+      res->phases[i].min_msec = val;
+    }
+    while (*p && *p != ',' && *p != '}') p++;
+    if (*p == ',') p++;
+  }
+}
+
+static int bench_file(const char* path, int reps, struct bench_result* res)
+{
+  int rep;
+  char abs[PATH_MAX];
+  /* the parse cache is keyed on resolved absolute paths */
+  const char* key = realpath(path, abs) ? abs : path;
+  memset(res, 0, sizeof(*res));
+  res->file = path;
+  res->total_msec = -1;
+  for (rep = 0; rep < reps; rep++) {
+    /* drop the cached parse tree so every repetition measures a
+       cold parse instead of a cache hit */
+    sass_invalidate_file(key);
+    struct Sass_File_Context* fctx = sass_make_file_context(path);
+    struct Sass_Context* ctx = sass_file_context_get_context(fctx);
+    struct Sass_Options* opts = sass_file_context_get_options(fctx);
+    sass_option_set_profile(opts, true);
+    double started = now_msec();
+    int status = sass_compile_file_context(fctx);
+    double elapsed = now_msec() - started;
+    if (status != 0) {
+      fprintf(stderr, "%s: %s", path, sass_context_get_error_message(ctx));
+      sass_delete_file_context(fctx);
+      return status;
+    }
+    if (res->total_msec < 0 || elapsed < res->total_msec)
+      res->total_msec = elapsed;
+    const char* output = sass_context_get_output_string(ctx);
+    res->output_bytes = output ? strlen(output) : 0;
+    const char* profile = sass_context_get_profile_json(ctx);
+    if (profile) merge_phases(res, profile);
+    sass_delete_file_context(fctx);
+  }
+  return 0;
+}
+
+static void emit_result(FILE* fp, const struct bench_result* res, int last)
+{
+  int i;
+  fprintf(fp, "    {\n");
+  fprintf(fp, "      \"file\": \"%s\",\n", res->file);
+  fprintf(fp, "      \"total_msec\": %.3f,\n", res->total_msec);
+  fprintf(fp, "      \"output_bytes\": %lu,\n", (unsigned long) res->output_bytes);
+  fprintf(fp, "      \"phases\": {");
+  for (i = 0; i < res->num_phases; i++) {
+    fprintf(fp, "%s\n        \"%s\": %.3f",
+      i ? "," : "", res->phases[i].name, res->phases[i].min_msec);
+  }
+  fprintf(fp, "\n      }\n");
+  fprintf(fp, "    }%s\n", last ? "" : ",");
+}
+
+int main(int argc, char** argv)
+{
+  int i, reps = 5;
+  const char* env_reps = getenv("BENCH_REPS");
+  if (env_reps && atoi(env_reps) > 0) reps = atoi(env_reps);
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <input.scss> [...]\n", argv[0]);
+    return 1;
+  }
+  printf("{\n  \"repetitions\": %d,\n  \"results\": [\n", reps);
+  for (i = 1; i < argc; i++) {
+    struct bench_result res;
+    if (bench_file(argv[i], reps, &res)) return 1;
+    emit_result(stdout, &res, i == argc - 1);
+  }
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  printf("  ],\n  \"peak_rss_kb\": %ld\n}\n", usage.ru_maxrss);
+  return 0;
+}
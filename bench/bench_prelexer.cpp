@@ -0,0 +1,121 @@
+/*
+  Microbenchmarks for the prelexer/lexer primitives (make bench).
+
+  The inputs are short token streams captured from real-world style
+  sheets so the matchers see the byte distribution they see in
+  production, not synthetic best cases. Each benchmark calls one
+  primitive over its whole input set and doubles the iteration count
+  until the sample runs long enough to be stable, then reports
+  nanoseconds per matcher call as json in the same shape as the
+  corpus driver so both land in the same regression report.
+
+  There is deliberately no external benchmark framework here; the
+  tree carries no third party dependencies and the adaptive timing
+  loop below is all these single-threaded matchers need.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+
+#include "../src/prelexer.hpp"
+#include "../src/parser.hpp"
+#include "../src/context.hpp"
+#include "../src/sass_context.hpp"
+
+namespace {
+
+  // keep results observable so the matcher calls cannot be elided
+  volatile const void* sink;
+
+  double now_msec()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>
+      (steady_clock::now().time_since_epoch()).count();
+  }
+
+  const char* identifiers[] = {
+    "background-image", "border-top-left-radius", "-webkit-transition",
+    "font-size", "a", "color", "justify-content", "-moz-user-select",
+    "grid-template-columns", "z-index",
+  };
+
+  const char* whitespace[] = {
+    " ", "\n  ", "  \t\n\t ", "/* inline comment */ ",
+    "\n/* multi\n * line\n * comment */\n  ", "// line comment\n  ",
+  };
+
+  const char* quoted_strings[] = {
+    "\"hello world\"", "'single quoted'", "\"escaped \\\" quote\"",
+    "\"Helvetica Neue\"", "'icons/sprite.svg#arrow'",
+    "\"data:image/png;base64,iVBORw0KGgoAAAANSUhEUgAAAAEAAAABCAYAAAA\"",
+  };
+
+  const char* interpolants[] = {
+    "#{$color}", "#{map-get($spec, size)}", "#{1 + 2}px",
+    "#{$prefix}-#{$name}", "#{nth($list, $i)}",
+  };
+
+  const char* selectors[] = {
+    ".a .b > .c", "ul li:hover", "#main .card-title",
+    "a[href^=\"http\"]", ".btn-primary:not(.disabled)::after",
+    "%base-1, .widget-2", "input[type=\"text\"]:focus",
+  };
+
+  // run one benchmark closure (returning the number of matcher
+  // calls it made) with an adaptively growing iteration count and
+  // emit one json entry; 100ms per sample drowns timer noise
+  template <typename F>
+  void run_bench(const char* name, F body, bool last)
+  {
+    size_t ops = body(); // warmup; also yields calls per pass
+    size_t iters = 1;
+    double elapsed = 0;
+    for (;;) {
+      double started = now_msec();
+      for (size_t i = 0; i < iters; i++) body();
+      elapsed = now_msec() - started;
+      if (elapsed > 100.0 || iters >= ((size_t)1 << 30)) break;
+      iters *= 2;
+    }
+    double ns_per_op = elapsed * 1e6 / ((double) iters * ops);
+    printf("    { \"name\": \"%s\", \"iterations\": %lu, \"ns_per_op\": %.2f }%s\n",
+      name, (unsigned long) (iters * ops), ns_per_op, last ? "" : ",");
+  }
+
+  // call one prelexer over every input once
+  #define SCAN_ALL(prelexer, inputs) [] {              \
+    size_t count = sizeof(inputs) / sizeof(*inputs);   \
+    for (size_t i = 0; i < count; i++) {               \
+      sink = Sass::Prelexer::prelexer(inputs[i]);      \
+    }                                                  \
+    return count;                                      \
+  }
+
+}
+
+int main()
+{
+  printf("{\n  \"benchmarks\": [\n");
+  run_bench("prelexer/identifier", SCAN_ALL(identifier, identifiers), false);
+  run_bench("prelexer/css_whitespace", SCAN_ALL(css_whitespace, whitespace), false);
+  run_bench("prelexer/quoted_string", SCAN_ALL(quoted_string, quoted_strings), false);
+  run_bench("prelexer/interpolant", SCAN_ALL(interpolant, interpolants), false);
+
+  // full selector parses need a live context for memory and traces
+  struct Sass_Data_Context* dctx =
+    sass_make_data_context(sass_copy_c_string("a { color: red; }"));
+  Sass::Data_Context ctx(*dctx);
+  Sass::Backtraces traces;
+  run_bench("parser/parse_selector", [&] {
+    size_t count = sizeof(selectors) / sizeof(*selectors);
+    for (size_t i = 0; i < count; i++) {
+      sink = Sass::Parser::parse_selector(selectors[i], ctx, traces).ptr();
+    }
+    return count;
+  }, true);
+  sass_delete_data_context(dctx);
+  printf("  ]\n}\n");
+  return 0;
+}
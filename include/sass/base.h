@@ -72,6 +72,14 @@ enum Sass_Output_Style {
   SASS_STYLE_TO_CSS
 };
 
+// granularity of generated source mappings; coarser
+// levels shrink the map and speed up serialization
+enum Sass_Srcmap_Granularity {
+  SASS_SRCMAP_TOKEN,
+  SASS_SRCMAP_DECLARATION,
+  SASS_SRCMAP_RULE
+};
+
 // to allocate buffer to be filled
 ADDAPI void* ADDCALL sass_alloc_memory(size_t size);
 // to allocate a buffer from existing string
@@ -83,6 +91,15 @@ ADDAPI void ADDCALL sass_free_memory(void* ptr);
 ADDAPI char* ADDCALL sass_string_quote (const char* str, const char quote_mark);
 ADDAPI char* ADDCALL sass_string_unquote (const char* str);
 
+// Process wide trace hook fired at phase boundaries
+// ("phase:begin"/"phase:end"), per import ("import"), per mixin
+// expansion ("mixin") and per extend registration ("extend").
+// Pass NULL to disable. The callback must be fast and thread
+// safe; it can be invoked from concurrent compilations. Register
+// before compilations start (the pointer is read unlocked).
+typedef void (*Sass_Trace_Callback) (const char* event, const char* detail, void* cookie);
+ADDAPI void ADDCALL sass_set_trace_callback (Sass_Trace_Callback cb, void* cookie);
+
 // Implemented sass language version
 // Hardcoded version 3.4 for time being
 ADDAPI const char* ADDCALL libsass_version(void);
@@ -21,6 +21,61 @@ struct Sass_Context; // : Sass_Options
 struct Sass_File_Context; // : Sass_Context
 struct Sass_Data_Context; // : Sass_Context
 
+// Typedef for the output writer callback; called repeatedly with
+// consecutive chunks of the rendered css (chunk is not terminated)
+typedef void (*Sass_Output_Writer_Fn) (const char* chunk, size_t len, void* cookie);
+
+// Callbacks for the compile avoidance cache. The key is a
+// fingerprint over the import closure of the previous compile
+// of the same entry file (content hashes of every source) plus
+// the output relevant options. On a hit the lookup fills css
+// (and optionally map) with buffers made via sass_copy_c_string
+// and returns true; the compile is skipped and those buffers
+// become the result. After a full compile the store callback
+// receives the fresh key together with the rendered output.
+typedef bool (*Sass_Cache_Lookup_Fn) (const char* key, char** out_css, char** out_map, void* cookie);
+typedef void (*Sass_Cache_Store_Fn) (const char* key, const char* css, const char* map, void* cookie);
+
+// Typedef for the message handler callback; receives the batched
+// @warn/@debug/deprecation output of one compilation phase in one
+// terminated buffer (instead of libsass writing it to stderr)
+typedef void (*Sass_Message_Fn) (const char* messages, void* cookie);
+
+// Per-compile measurements delivered to the metrics handler when a
+// compile finishes (successfully or not). Durations are wall clock
+// milliseconds; a phase that did not run reports zero. The counters
+// cover everything this compile did, imports included.
+struct Sass_Compile_Metrics {
+  double parse_msec;
+  double check_nesting_msec;
+  double expand_msec;
+  double cssize_msec;
+  double remove_placeholders_msec;
+  double render_msec;
+  // sum of all timed phases above
+  double total_msec;
+  // entry file plus every import that was loaded
+  size_t files_parsed;
+  // total source bytes handed to the parser
+  size_t bytes_in;
+  // rendered css bytes (zero when the compile failed)
+  size_t bytes_out;
+  // ast nodes allocated by this compile and their payload bytes
+  size_t node_allocations;
+  size_t node_bytes;
+  // high water mark of simultaneously live ast nodes
+  size_t peak_live_nodes;
+  // nonzero when the output came from the caller's cache and the
+  // whole pipeline (and therefore every timing above) was skipped
+  int cache_hit;
+  // same value the compile entry point returned
+  int error_status;
+};
+
+// Typedef for the metrics handler callback; the struct is borrowed
+// and only valid for the duration of the call
+typedef void (*Sass_Metrics_Fn) (const struct Sass_Compile_Metrics* metrics, void* cookie);
+
 // Compiler states
 enum Sass_Compiler_State {
   SASS_COMPILER_CREATED,
@@ -34,10 +89,28 @@ ADDAPI struct Sass_Options* ADDCALL sass_make_options (void);
 ADDAPI struct Sass_File_Context* ADDCALL sass_make_file_context (const char* input_path);
 ADDAPI struct Sass_Data_Context* ADDCALL sass_make_data_context (char* source_string);
 
+// Like sass_make_data_context, but the source buffer stays owned
+// by the caller: libsass never copies or frees it. The buffer must
+// be NUL terminated at source_len and must stay valid and unchanged
+// until the context (and any compiler using it) has been deleted.
+ADDAPI struct Sass_Data_Context* ADDCALL sass_make_data_context_view (char* source_string, size_t source_len);
+
 // Call the compilation step for the specific context
 ADDAPI int ADDCALL sass_compile_file_context (struct Sass_File_Context* ctx);
 ADDAPI int ADDCALL sass_compile_data_context (struct Sass_Data_Context* ctx);
 
+// Tell the compiler that a file changed on disk. Long-lived
+// processes keep parse results of unchanged imports between
+// compilations; call this with the resolved absolute path of
+// every changed file before recompiling (affects only the
+// calling thread, where the parse cache lives)
+ADDAPI void ADDCALL sass_invalidate_file (const char* abs_path);
+
+// Compile a batch of independent file contexts on a thread pool
+// Pass zero for nthreads to use the detected hardware concurrency
+// Returns the first non-zero error status (query contexts for details)
+ADDAPI int ADDCALL sass_compiler_pool_compile (struct Sass_File_Context** file_ctxs, size_t n, size_t nthreads);
+
 // Create a sass compiler instance for more control
 ADDAPI struct Sass_Compiler* ADDCALL sass_make_file_compiler (struct Sass_File_Context* file_ctx);
 ADDAPI struct Sass_Compiler* ADDCALL sass_make_data_compiler (struct Sass_Data_Context* data_ctx);
@@ -47,6 +120,21 @@ ADDAPI struct Sass_Compiler* ADDCALL sass_make_data_compiler (struct Sass_Data_C
 ADDAPI int ADDCALL sass_compiler_parse(struct Sass_Compiler* compiler);
 ADDAPI int ADDCALL sass_compiler_execute(struct Sass_Compiler* compiler);
 
+// Render the compiled tree once more in another output style, e.g.
+// a compressed artifact next to the expanded one, without parsing
+// and evaluating again. Valid after sass_compiler_parse succeeded.
+// Returns a string the caller must free, or NULL on error.
+ADDAPI char* ADDCALL sass_compiler_render_output(struct Sass_Compiler* compiler, enum Sass_Output_Style output_style);
+
+// Rewind a compiler so it can compile again on the same context.
+// Options, custom functions, headers and importers are retained;
+// outputs and errors from the previous run are released. Combine
+// with sass_data_context_set_source to feed in the next document.
+ADDAPI int ADDCALL sass_compiler_reset(struct Sass_Compiler* compiler);
+
+// Replace the input of a data context (takes ownership of the string)
+ADDAPI void ADDCALL sass_data_context_set_source (struct Sass_Data_Context* ctx, char* source_string);
+
 // Release all memory allocated with the compiler
 // This does _not_ include any contexts or options
 ADDAPI void ADDCALL sass_delete_compiler(struct Sass_Compiler* compiler);
@@ -77,12 +165,29 @@ ADDAPI bool ADDCALL sass_option_get_source_map_contents (struct Sass_Options* op
 ADDAPI bool ADDCALL sass_option_get_source_map_file_urls (struct Sass_Options* options);
 ADDAPI bool ADDCALL sass_option_get_omit_source_map_url (struct Sass_Options* options);
 ADDAPI bool ADDCALL sass_option_get_is_indented_syntax_src (struct Sass_Options* options);
+ADDAPI bool ADDCALL sass_option_get_mmap_sources (struct Sass_Options* options);
+ADDAPI bool ADDCALL sass_option_get_share_sources (struct Sass_Options* options);
+ADDAPI bool ADDCALL sass_option_get_import_once (struct Sass_Options* options);
+ADDAPI enum Sass_Srcmap_Granularity ADDCALL sass_option_get_source_map_granularity (struct Sass_Options* options);
+ADDAPI bool ADDCALL sass_option_get_profile (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_indent (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_linefeed (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_input_path (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_output_path (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_source_map_file (struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_source_map_root (struct Sass_Options* options);
+ADDAPI Sass_Output_Writer_Fn ADDCALL sass_option_get_output_writer (struct Sass_Options* options);
+ADDAPI size_t ADDCALL sass_option_get_render_threads (struct Sass_Options* options);
+ADDAPI size_t ADDCALL sass_option_get_parse_threads (struct Sass_Options* options);
+ADDAPI bool ADDCALL sass_option_get_speculative_imports (struct Sass_Options* options);
+ADDAPI bool ADDCALL sass_option_get_tree_shaking (struct Sass_Options* options);
+ADDAPI bool ADDCALL sass_option_get_dedup_declarations (struct Sass_Options* options);
+ADDAPI bool ADDCALL sass_option_get_merge_media_rules (struct Sass_Options* options);
+ADDAPI bool ADDCALL sass_option_get_trusted_input (struct Sass_Options* options);
+ADDAPI size_t ADDCALL sass_option_get_extend_budget (struct Sass_Options* options);
+ADDAPI size_t ADDCALL sass_option_get_compile_budget (struct Sass_Options* options);
+ADDAPI int* ADDCALL sass_option_get_cancel_flag (struct Sass_Options* options);
+ADDAPI const char* ADDCALL sass_option_get_ast_cache_dir (struct Sass_Options* options);
 ADDAPI Sass_Importer_List ADDCALL sass_option_get_c_headers (struct Sass_Options* options);
 ADDAPI Sass_Importer_List ADDCALL sass_option_get_c_importers (struct Sass_Options* options);
 ADDAPI Sass_Function_List ADDCALL sass_option_get_c_functions (struct Sass_Options* options);
@@ -96,6 +201,16 @@ ADDAPI void ADDCALL sass_option_set_source_map_contents (struct Sass_Options* op
 ADDAPI void ADDCALL sass_option_set_source_map_file_urls (struct Sass_Options* options, bool source_map_file_urls);
 ADDAPI void ADDCALL sass_option_set_omit_source_map_url (struct Sass_Options* options, bool omit_source_map_url);
 ADDAPI void ADDCALL sass_option_set_is_indented_syntax_src (struct Sass_Options* options, bool is_indented_syntax_src);
+ADDAPI void ADDCALL sass_option_set_mmap_sources (struct Sass_Options* options, bool mmap_sources);
+// Serve source files from a process wide refcounted registry, so
+// concurrent compiles that share an import closure read and keep one
+// copy of each file between them. Entries are validated against mtime
+// and size on every acquire and released with the last compile still
+// using them (posix only; shared reads copy, overriding mmap_sources)
+ADDAPI void ADDCALL sass_option_set_share_sources (struct Sass_Options* options, bool share_sources);
+ADDAPI void ADDCALL sass_option_set_import_once (struct Sass_Options* options, bool import_once);
+ADDAPI void ADDCALL sass_option_set_source_map_granularity (struct Sass_Options* options, enum Sass_Srcmap_Granularity source_map_granularity);
+ADDAPI void ADDCALL sass_option_set_profile (struct Sass_Options* options, bool profile);
 ADDAPI void ADDCALL sass_option_set_indent (struct Sass_Options* options, const char* indent);
 ADDAPI void ADDCALL sass_option_set_linefeed (struct Sass_Options* options, const char* linefeed);
 ADDAPI void ADDCALL sass_option_set_input_path (struct Sass_Options* options, const char* input_path);
@@ -104,6 +219,101 @@ ADDAPI void ADDCALL sass_option_set_plugin_path (struct Sass_Options* options, c
 ADDAPI void ADDCALL sass_option_set_include_path (struct Sass_Options* options, const char* include_path);
 ADDAPI void ADDCALL sass_option_set_source_map_file (struct Sass_Options* options, const char* source_map_file);
 ADDAPI void ADDCALL sass_option_set_source_map_root (struct Sass_Options* options, const char* source_map_root);
+// Stream the rendered css through the given callback instead of
+// materializing an output_string copy on the context; the callback
+// receives the output in chunks while the cookie is passed through
+ADDAPI void ADDCALL sass_option_set_output_writer (struct Sass_Options* options, Sass_Output_Writer_Fn fn, void* cookie);
+// Enable compile avoidance for file contexts: consult the
+// lookup before parsing and publish results via the store.
+// Never consulted when custom importers, headers or functions
+// are registered, since their results cannot be fingerprinted.
+ADDAPI void ADDCALL sass_option_set_cache_handler (struct Sass_Options* options, Sass_Cache_Lookup_Fn lookup, Sass_Cache_Store_Fn store, void* cookie);
+// Receive @warn/@debug/deprecation messages through the given
+// callback instead of stderr; messages are batched per phase
+ADDAPI void ADDCALL sass_option_set_message_handler (struct Sass_Options* options, Sass_Message_Fn handler, void* cookie);
+// Collapse identical messages into the first occurrence plus a
+// repeat count; off by default so every occurrence is reported
+ADDAPI void ADDCALL sass_option_set_message_dedup (struct Sass_Options* options, bool enable);
+// Receive a Sass_Compile_Metrics snapshot at the end of every
+// compile started through sass_compile_*_context. Registering a
+// handler enables phase timing even when the profile option is off
+ADDAPI void ADDCALL sass_option_set_metrics_handler (struct Sass_Options* options, Sass_Metrics_Fn handler, void* cookie);
+// Render independent top-level rules on this many threads (0 or 1
+// keeps the sequential renderer). Only honored when the library was
+// built with thread-safe reference counts; otherwise sharing AST
+// nodes across rendering threads would be undefined behavior
+ADDAPI void ADDCALL sass_option_set_render_threads (struct Sass_Options* options, size_t render_threads);
+// Re-parse the files loaded by the previous compile of the same entry
+// on this many worker threads before the compile proper starts, so
+// its sequential parse finds the parse cache already warm (0 or 1
+// keeps the purely sequential parser). Only honored when the library
+// was built with thread-safe reference counts
+ADDAPI void ADDCALL sass_option_set_parse_threads (struct Sass_Options* options, size_t parse_threads);
+
+// Speculatively walk the probable import closure on one helper thread
+// while the main thread parses: literal @import urls seen by the token
+// scan of each loaded source are resolved, read, scanned for their own
+// imports in turn and handed to the kernel's readahead, so deep import
+// chains stream in ahead of the parser instead of one level at a time.
+// The walker never touches the AST, so it works without thread-safe
+// reference counts; a mispredicted candidate (say an url inside a
+// comment) costs one bounded read. Off by default
+ADDAPI void ADDCALL sass_option_set_speculative_imports (struct Sass_Options* options, bool speculative_imports);
+// Skip registering and evaluating mixins, functions and variables no
+// emitted code can ever reach (useful for entries importing a large
+// library and using a fraction of it). Conservative: shakes nothing
+// when dynamic dispatch or existence introspection appears anywhere.
+// Off by default, since dead code stops being evaluated entirely and
+// its warnings, errors and other side effects disappear with it
+ADDAPI void ADDCALL sass_option_set_tree_shaking (struct Sass_Options* options, bool tree_shaking);
+// Drop declarations that a later declaration of the same property in
+// the same block overrides anyway, so only the winning layer of each
+// override chain is emitted. Declarations that may be fallbacks are
+// kept: custom properties are never touched, !important is never
+// dropped for a plain later declaration and vendor prefixed values
+// keep their whole chain. Off by default
+ADDAPI void ADDCALL sass_option_set_dedup_declarations (struct Sass_Options* options, bool dedup_declarations);
+
+// Coalesce adjacent @media rules whose query lists compare equal into
+// a single block. Bubbling duplicates the surrounding query for every
+// nested ruleset, so responsive bundles emit the same `@media` header
+// hundreds of times in a row; merged runs render it once. Rule order
+// inside the merged block is preserved. Off by default
+ADDAPI void ADDCALL sass_option_set_merge_media_rules (struct Sass_Options* options, bool merge_media_rules);
+
+// Treat the input as pre-validated: skip the whole-tree nesting checks
+// whose only purpose is clean author-error messages. Invalid input then
+// produces undefined output instead of an error, so enable this only
+// for machine-generated sources validated at the point they were
+// produced. Off by default
+ADDAPI void ADDCALL sass_option_set_trusted_input (struct Sass_Options* options, bool trusted_input);
+// Bound the selector combinations @extend weaving may produce per
+// compile. Pathological extend chains explode combinatorially; when the
+// budget is exceeded the output keeps the combinations woven so far and
+// a warning reports the truncation, keeping worst-case latency bounded.
+// Zero (the default) weaves exhaustively
+ADDAPI void ADDCALL sass_option_set_extend_budget (struct Sass_Options* options, size_t extend_budget);
+// Bound the wall-clock time of the whole compile in milliseconds. The
+// parser, expansion, extend weaving and the output emitter poll the
+// budget cooperatively and abort with error status 6 once it is spent,
+// so a latency-bounded service gets its thread back instead of killing
+// the process and losing its warm caches. Zero (the default) means no
+// budget
+ADDAPI void ADDCALL sass_option_set_compile_budget (struct Sass_Options* options, size_t compile_budget);
+// Install a caller-owned cancellation token checked at the same spots
+// as the compile budget: set the pointed-to int non-zero (from any
+// thread) and the running compile aborts with error status 6. The int
+// must stay valid for the duration of the compile. NULL by default
+ADDAPI void ADDCALL sass_option_set_cancel_flag (struct Sass_Options* options, int* cancel_flag);
+// Persist parsed trees in this directory as versioned binary artifacts
+// keyed by content hash, and load them back instead of parsing when the
+// source bytes match. Artifacts survive the process, so stable sources
+// (vendored libraries) parse once per content revision; they embed the
+// resolved import paths and are revalidated against the filesystem on
+// load. Files whose trees use constructs outside the serialized format
+// (@supports, @at-root) simply stay uncached, and source-mapped
+// compiles bypass the cache entirely. Unset by default
+ADDAPI void ADDCALL sass_option_set_ast_cache_dir (struct Sass_Options* options, const char* ast_cache_dir);
 ADDAPI void ADDCALL sass_option_set_c_headers (struct Sass_Options* options, Sass_Importer_List c_headers);
 ADDAPI void ADDCALL sass_option_set_c_importers (struct Sass_Options* options, Sass_Importer_List c_importers);
 ADDAPI void ADDCALL sass_option_set_c_functions (struct Sass_Options* options, Sass_Function_List c_functions);
@@ -120,13 +330,29 @@ ADDAPI const char* ADDCALL sass_context_get_error_src (struct Sass_Context* ctx)
 ADDAPI size_t ADDCALL sass_context_get_error_line (struct Sass_Context* ctx);
 ADDAPI size_t ADDCALL sass_context_get_error_column (struct Sass_Context* ctx);
 ADDAPI const char* ADDCALL sass_context_get_source_map_string (struct Sass_Context* ctx);
+// Timing report collected when the profile option was
+// enabled: per-phase and per-file milliseconds as json
+ADDAPI const char* ADDCALL sass_context_get_profile_json (struct Sass_Context* ctx);
+// Allocation statistics (nodes by count and bytes, string
+// bytes, env frames, peak live nodes) as json; always
+// collected since the counters are cheap enough to leave on
+ADDAPI const char* ADDCALL sass_context_get_stats_json (struct Sass_Context* ctx);
+// Import dependency graph as json: every loaded source with
+// its content hash plus importer/importee edges (resolved
+// absolute paths); available once parsing has finished
+ADDAPI const char* ADDCALL sass_context_get_import_graph_json (struct Sass_Context* ctx);
+// Null terminated path array, built once when the compile finishes
+// and borrowed from the context: repeated calls return the same
+// pointers without copying, valid until the context is deleted (or
+// the array is taken over with sass_context_take_included_files)
 ADDAPI char** ADDCALL sass_context_get_included_files (struct Sass_Context* ctx);
 
 // Getters for options include path array
 ADDAPI size_t ADDCALL sass_option_get_include_path_size(struct Sass_Options* options);
 ADDAPI const char* ADDCALL sass_option_get_include_path(struct Sass_Options* options, size_t i);
 
-// Calculate the size of the stored null terminated array
+// Size of the stored null terminated array (answered from a
+// cached count, not by walking the array)
 ADDAPI size_t ADDCALL sass_context_get_included_files_size (struct Sass_Context* ctx);
 
 // Take ownership of memory (value on context is set to 0)
@@ -32,6 +32,14 @@ typedef struct Sass_Importer* (*Sass_Importer_List);
 // Typedef defining importer signature and return type
 typedef Sass_Import_List (*Sass_Importer_Fn)
   (const char* url, Sass_Importer_Entry cb, struct Sass_Compiler* compiler);
+// Optional batch announcement: called once per @import statement with
+// every plain url in it, before the importer function is asked for
+// them one by one (in order). A remote-backed importer can kick off
+// all fetches concurrently here and let each later importer call
+// block only until its own url has arrived. Must not compile or
+// resolve anything itself; results are still returned per url
+typedef void (*Sass_Importer_Prefetch_Fn)
+  (const char* const* urls, size_t count, Sass_Importer_Entry cb, struct Sass_Compiler* compiler);
 
 // Typedef helpers for custom functions lists
 typedef struct Sass_Function (*Sass_Function_Entry);
@@ -62,6 +70,9 @@ ADDAPI Sass_Importer_Entry ADDCALL sass_make_importer (Sass_Importer_Fn importer
 ADDAPI Sass_Importer_Fn ADDCALL sass_importer_get_function (Sass_Importer_Entry cb);
 ADDAPI double ADDCALL sass_importer_get_priority (Sass_Importer_Entry cb);
 ADDAPI void* ADDCALL sass_importer_get_cookie (Sass_Importer_Entry cb);
+// Optional prefetch hook (see Sass_Importer_Prefetch_Fn); unset by default
+ADDAPI void ADDCALL sass_importer_set_prefetch_function (Sass_Importer_Entry cb, Sass_Importer_Prefetch_Fn fn);
+ADDAPI Sass_Importer_Prefetch_Fn ADDCALL sass_importer_get_prefetch_function (Sass_Importer_Entry cb);
 
 // Deallocator for associated memory
 ADDAPI void ADDCALL sass_delete_importer (Sass_Importer_Entry cb);
@@ -61,6 +61,10 @@ ADDAPI union Sass_Value* ADDCALL sass_make_warning (const char* msg);
 ADDAPI void ADDCALL sass_delete_value (union Sass_Value* val);
 
 // Make a deep cloned copy of the given sass value
+// List and map payloads are shared copy-on-write: the clone is
+// O(1) and the items are only copied once a clone is written to
+// through a setter. Treat items from getters as read-only while
+// more than one clone of the same list or map is alive.
 ADDAPI union Sass_Value* ADDCALL sass_clone_value (const union Sass_Value* val);
 
 // Execute an operation for two Sass_Values and return the result as a Sass_Value too
@@ -121,6 +125,12 @@ ADDAPI void ADDCALL sass_list_set_is_bracketed (union Sass_Value* v, bool value)
 // Getters and setters for Sass_List values
 ADDAPI union Sass_Value* ADDCALL sass_list_get_value (const union Sass_Value* v, size_t i);
 ADDAPI void ADDCALL sass_list_set_value (union Sass_Value* v, size_t i, union Sass_Value* value);
+// Batch getter: copies up to [count] element pointers starting at
+// [offset] into the caller's array and returns how many were written.
+// One exported call replaces one call per element for plugins that
+// walk large lists; the pointers borrow from the list exactly like
+// sass_list_get_value and stay valid until the list is modified
+ADDAPI size_t ADDCALL sass_list_get_values (const union Sass_Value* v, size_t offset, size_t count, union Sass_Value** dest);
 
 // Getter for the number of items in map
 ADDAPI size_t ADDCALL sass_map_get_length (const union Sass_Value* v);
@@ -129,6 +139,9 @@ ADDAPI union Sass_Value* ADDCALL sass_map_get_key (const union Sass_Value* v, si
 ADDAPI void ADDCALL sass_map_set_key (union Sass_Value* v, size_t i, union Sass_Value*);
 ADDAPI union Sass_Value* ADDCALL sass_map_get_value (const union Sass_Value* v, size_t i);
 ADDAPI void ADDCALL sass_map_set_value (union Sass_Value* v, size_t i, union Sass_Value*);
+// Batch getter over map entries; see sass_list_get_values. Either
+// destination may be null to fetch only keys or only values
+ADDAPI size_t ADDCALL sass_map_get_pairs (const union Sass_Value* v, size_t offset, size_t count, union Sass_Value** keys, union Sass_Value** values);
 
 // Getters and setters for Sass_Error
 ADDAPI char* ADDCALL sass_error_get_message (const union Sass_Value* v);
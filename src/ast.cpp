@@ -53,6 +53,57 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////
 
+  namespace {
+
+    // Scratch inspector reused across to_string round trips; Eval's
+    // interpolation and error formatting stringify values constantly,
+    // and a fresh Inspect (with its Emitter and OutputBuffer) per
+    // call was pure allocator churn. The emitter keeps a reference
+    // to its options, so the scratch owns a mutable options block
+    // that every call refreshes before rendering. A busy flag keeps
+    // reentrant stringification (a render that stringifies sub-nodes
+    // mid-flight) on the old one-shot path.
+    struct ScratchInspect {
+      Sass_Output_Options opt;
+      Inspect inspect;
+      bool busy;
+      ScratchInspect()
+      : opt(), inspect(Emitter(opt)), busy(false)
+      { }
+    };
+
+    thread_local ScratchInspect scratch_inspect;
+
+    std::string render_to_string(const AST_Node* node, Sass_Inspect_Options opt)
+    {
+      ScratchInspect& scratch = scratch_inspect;
+      if (scratch.busy) {
+        Sass_Output_Options out(opt);
+        Emitter emitter(out);
+        Inspect i(emitter);
+        i.in_declaration = true;
+        const_cast<AST_Node*>(node)->perform(&i);
+        return i.get_buffer();
+      }
+      scratch.busy = true;
+      scratch.opt.output_style = opt.output_style;
+      scratch.opt.precision = opt.precision;
+      scratch.inspect.reset();
+      scratch.inspect.in_declaration = true;
+      try {
+        // ToDo: inspect should be const
+        const_cast<AST_Node*>(node)->perform(&scratch.inspect);
+      }
+      catch (...) {
+        scratch.busy = false;
+        throw;
+      }
+      scratch.busy = false;
+      return scratch.inspect.get_buffer();
+    }
+
+  }
+
   void AST_Node::update_pstate(const ParserState& pstate)
   {
     pstate_.offset += pstate - pstate_ + pstate.offset;
@@ -60,25 +111,27 @@ namespace Sass {
 
   std::string AST_Node::to_string(Sass_Inspect_Options opt) const
   {
-    Sass_Output_Options out(opt);
-    Emitter emitter(out);
-    Inspect i(emitter);
-    i.in_declaration = true;
-    // ToDo: inspect should be const
-    const_cast<AST_Node*>(this)->perform(&i);
-    return i.get_buffer();
+    // selector lists get stringified over and over (error paths,
+    // selector functions, extend bookkeeping); memoize per node
+    size_t key = 0;
+    const SelectorList* sl = Cast<SelectorList>(this);
+    if (sl) {
+      key = sl->hash();
+      hash_combine(key, static_cast<size_t>(opt.output_style));
+      hash_combine(key, static_cast<size_t>(opt.precision));
+      if (const std::string* cached = sl->cached_to_string(key)) {
+        return *cached;
+      }
+    }
+    std::string res(render_to_string(this, opt));
+    if (sl) sl->cache_to_string(key, res);
+    return res;
   }
 
   std::string AST_Node::to_css(Sass_Inspect_Options opt) const
   {
     opt.output_style = TO_CSS;
-    Sass_Output_Options out(opt);
-    Emitter emitter(out);
-    Inspect i(emitter);
-    i.in_declaration = true;
-    // ToDo: inspect should be const
-    const_cast<AST_Node*>(this)->perform(&i);
-    return i.get_buffer();
+    return render_to_string(this, opt);
   }
 
   std::string AST_Node::to_string() const
@@ -120,12 +173,14 @@ namespace Sass {
   Block::Block(ParserState pstate, size_t s, bool r)
   : Statement(pstate),
     Vectorized<Statement_Obj>(s),
-    is_root_(r)
+    is_root_(r),
+    frame_scanned_(false), declares_variables_(false)
   { }
   Block::Block(const Block* ptr)
   : Statement(ptr),
     Vectorized<Statement_Obj>(*ptr),
-    is_root_(ptr->is_root_)
+    is_root_(ptr->is_root_),
+    frame_scanned_(false), declares_variables_(false)
   { }
 
   bool Block::isInvisible() const
@@ -163,13 +218,17 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////
 
   Ruleset::Ruleset(ParserState pstate, SelectorListObj s, Block_Obj b)
-  : Has_Block(pstate, b), selector_(s), schema_(), is_root_(false)
+  : Has_Block(pstate, b), selector_(s), schema_(), is_root_(false),
+    static_scanned_(false), is_static_(false)
   { statement_type(RULESET); }
   Ruleset::Ruleset(const Ruleset* ptr)
   : Has_Block(ptr),
     selector_(ptr->selector_),
     schema_(ptr->schema_),
-    is_root_(ptr->is_root_)
+    is_root_(ptr->is_root_),
+    // copies may get another selector or body, so they rescan
+    static_scanned_(false),
+    is_static_(false)
   { statement_type(RULESET); }
 
   bool Ruleset::is_invisible() const {
@@ -251,7 +310,8 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////
 
   Declaration::Declaration(ParserState pstate, String_Obj prop, Expression_Obj val, bool i, bool c, Block_Obj b)
-  : Has_Block(pstate, b), property_(prop), value_(val), is_important_(i), is_custom_property_(c), is_indented_(false)
+  : Has_Block(pstate, b), property_(prop), value_(val), is_important_(i), is_custom_property_(c), is_indented_(false),
+    static_scanned_(false), is_static_(false)
   { statement_type(DECLARATION); }
   Declaration::Declaration(const Declaration* ptr)
   : Has_Block(ptr),
@@ -259,7 +319,10 @@ namespace Sass {
     value_(ptr->value_),
     is_important_(ptr->is_important_),
     is_custom_property_(ptr->is_custom_property_),
-    is_indented_(ptr->is_indented_)
+    is_indented_(ptr->is_indented_),
+    // copies may get another property or value, so they rescan
+    static_scanned_(false),
+    is_static_(false)
   { statement_type(DECLARATION); }
 
   bool Declaration::is_invisible() const
@@ -455,7 +518,14 @@ namespace Sass {
     c_function_(ptr->c_function_),
     cookie_(ptr->cookie_),
     is_overload_stub_(ptr->is_overload_stub_),
-    signature_(ptr->signature_)
+    signature_(ptr->signature_),
+    frame_scanned_(ptr->frame_scanned_),
+    needs_frame_(ptr->needs_frame_),
+    // copies share the body, so the analysis carries over
+    purity_scanned_(ptr->purity_scanned_),
+    is_pure_(ptr->is_pure_),
+    free_variables_(ptr->free_variables_),
+    free_functions_(ptr->free_functions_)
   { }
 
   Definition::Definition(ParserState pstate,
@@ -472,7 +542,13 @@ namespace Sass {
     c_function_(0),
     cookie_(0),
     is_overload_stub_(false),
-    signature_(0)
+    signature_(0),
+    frame_scanned_(false),
+    needs_frame_(true),
+    purity_scanned_(false),
+    is_pure_(false),
+    free_variables_(),
+    free_functions_()
   { }
 
   Definition::Definition(ParserState pstate,
@@ -490,7 +566,13 @@ namespace Sass {
     c_function_(0),
     cookie_(0),
     is_overload_stub_(overload_stub),
-    signature_(sig)
+    signature_(sig),
+    frame_scanned_(false),
+    needs_frame_(true),
+    purity_scanned_(false),
+    is_pure_(false),
+    free_variables_(),
+    free_functions_()
   { }
 
   Definition::Definition(ParserState pstate,
@@ -507,20 +589,27 @@ namespace Sass {
     c_function_(c_func),
     cookie_(sass_function_get_cookie(c_func)),
     is_overload_stub_(false),
-    signature_(sig)
+    signature_(sig),
+    frame_scanned_(false),
+    needs_frame_(true),
+    purity_scanned_(false),
+    is_pure_(false),
+    free_variables_(),
+    free_functions_()
   { }
 
   /////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////
 
   Mixin_Call::Mixin_Call(ParserState pstate, std::string n, Arguments_Obj args, Parameters_Obj b_params, Block_Obj b)
-  : Has_Block(pstate, b), name_(n), arguments_(args), block_parameters_(b_params)
+  : Has_Block(pstate, b), name_(n), arguments_(args), block_parameters_(b_params), content_thunk_()
   { }
   Mixin_Call::Mixin_Call(const Mixin_Call* ptr)
   : Has_Block(ptr),
     name_(ptr->name_),
     arguments_(ptr->arguments_),
-    block_parameters_(ptr->block_parameters_)
+    block_parameters_(ptr->block_parameters_),
+    content_thunk_()
   { }
 
   /////////////////////////////////////////////////////////////////////////
@@ -672,7 +761,7 @@ namespace Sass {
 
   void Arguments::set_delayed(bool delayed)
   {
-    for (Argument_Obj arg : elements()) {
+    for (const Argument_Obj& arg : elements()) {
       if (arg) arg->set_delayed(delayed);
     }
     is_delayed(delayed);
@@ -681,7 +770,7 @@ namespace Sass {
   Argument_Obj Arguments::get_rest_argument()
   {
     if (this->has_rest_argument()) {
-      for (Argument_Obj arg : this->elements()) {
+      for (const Argument_Obj& arg : this->elements()) {
         if (arg->is_rest_argument()) {
           return arg;
         }
@@ -693,7 +782,7 @@ namespace Sass {
   Argument_Obj Arguments::get_keyword_argument()
   {
     if (this->has_keyword_argument()) {
-      for (Argument_Obj arg : this->elements()) {
+      for (const Argument_Obj& arg : this->elements()) {
         if (arg->is_keyword_argument()) {
           return arg;
         }
@@ -702,7 +791,7 @@ namespace Sass {
     return {};
   }
 
-  void Arguments::adjust_after_pushing(Argument_Obj a)
+  void Arguments::adjust_after_pushing(const Argument_Obj& a)
   {
     if (!a->name().empty()) {
       if (has_keyword_argument()) {
@@ -881,7 +970,7 @@ namespace Sass {
     has_rest_parameter_(ptr->has_rest_parameter_)
   { }
 
-  void Parameters::adjust_after_pushing(Parameter_Obj p)
+  void Parameters::adjust_after_pushing(const Parameter_Obj& p)
   {
     if (p->default_value()) {
       if (has_rest_parameter()) {
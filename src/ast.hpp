@@ -210,18 +210,24 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////////
   template <typename T>
   class Vectorized {
-    std::vector<T> elements_;
+    PoolVector<T> elements_;
   protected:
     mutable size_t hash_;
     void reset_hash() { hash_ = 0; }
-    virtual void adjust_after_pushing(T element) { }
+    virtual void adjust_after_pushing(const T& element) { }
   public:
     Vectorized(size_t s = 0) : hash_(0)
     { elements_.reserve(s); }
-    Vectorized(std::vector<T> vec) :
+    Vectorized(PoolVector<T> vec) :
       elements_(std::move(vec)),
       hash_(0)
     {}
+    #ifdef SASS_CUSTOM_ALLOCATOR
+    Vectorized(const std::vector<T>& vec) :
+      elements_(vec.begin(), vec.end()),
+      hash_(0)
+    {}
+    #endif
     virtual ~Vectorized() = 0;
     size_t length() const   { return elements_.size(); }
     bool empty() const      { return elements_.empty(); }
@@ -253,22 +259,31 @@ namespace Sass {
     // You are responsible to make a copy if needed
     // Note: since this returns the real object, we can't
     // Note: guarantee that the hash will not get out of sync
-    operator std::vector<T>&() { return elements_; }
-    operator const std::vector<T>&() const { return elements_; }
+    operator PoolVector<T>&() { return elements_; }
+    operator const PoolVector<T>&() const { return elements_; }
 
     // Explicitly request all elements as a real std::vector
     // You are responsible to make a copy if needed
     // Note: since this returns the real object, we can't
     // Note: guarantee that the hash will not get out of sync
-    std::vector<T>& elements() { return elements_; }
-    const std::vector<T>& elements() const { return elements_; }
+    PoolVector<T>& elements() { return elements_; }
+    const PoolVector<T>& elements() const { return elements_; }
 
     // Insert all items from compatible vector
+    void concat(const PoolVector<T>& v)
+    {
+      if (!v.empty()) reset_hash();
+      elements().insert(end(), v.begin(), v.end());
+    }
+
+    #ifdef SASS_CUSTOM_ALLOCATOR
+    // Interop with plain vectors built by callers
     void concat(const std::vector<T>& v)
     {
       if (!v.empty()) reset_hash();
       elements().insert(end(), v.begin(), v.end());
     }
+    #endif
 
     // Syntatic sugar for pointers
     void concat(const Vectorized<T>* v)
@@ -279,7 +294,7 @@ namespace Sass {
     }
 
     // Insert one item on the front
-    void unshift(T element)
+    void unshift(const T& element)
     {
       reset_hash();
       elements_.insert(begin(), element);
@@ -296,7 +311,7 @@ namespace Sass {
 
     // Insert one item on the back
     // ToDo: rename this to push
-    void append(T element)
+    void append(const T& element)
     {
       reset_hash();
       elements_.insert(end(), element);
@@ -305,6 +320,14 @@ namespace Sass {
       adjust_after_pushing(element);
     }
 
+    // Replace the item at the given position
+    // Unlike operator[] this keeps the hash in sync
+    void replace(size_t i, const T& element)
+    {
+      reset_hash();
+      elements_[i] = element;
+    }
+
     // Check if an item already exists
     // Uses underlying object `operator==`
     // E.g. compares the actual objects
@@ -320,10 +343,16 @@ namespace Sass {
     }
 
     // This might be better implemented as `operator=`?
-    void elements(std::vector<T> e) {
+    void elements(PoolVector<T> e) {
       reset_hash();
       elements_ = std::move(e);
     }
+    #ifdef SASS_CUSTOM_ALLOCATOR
+    void elements(const std::vector<T>& e) {
+      reset_hash();
+      elements_.assign(e.begin(), e.end());
+    }
+    #endif
 
     virtual size_t hash() const
     {
@@ -336,83 +365,121 @@ namespace Sass {
     }
 
     template <typename P, typename V>
-    typename std::vector<T>::iterator insert(P position, const V& val) {
+    typename PoolVector<T>::iterator insert(P position, const V& val) {
       reset_hash();
       return elements_.insert(position, val);
     }
 
-    typename std::vector<T>::iterator end() { return elements_.end(); }
-    typename std::vector<T>::iterator begin() { return elements_.begin(); }
-    typename std::vector<T>::const_iterator end() const { return elements_.end(); }
-    typename std::vector<T>::const_iterator begin() const { return elements_.begin(); }
-    typename std::vector<T>::iterator erase(typename std::vector<T>::iterator el) { reset_hash(); return elements_.erase(el); }
-    typename std::vector<T>::const_iterator erase(typename std::vector<T>::const_iterator el) { reset_hash(); return elements_.erase(el); }
+    typename PoolVector<T>::iterator end() { return elements_.end(); }
+    typename PoolVector<T>::iterator begin() { return elements_.begin(); }
+    typename PoolVector<T>::const_iterator end() const { return elements_.end(); }
+    typename PoolVector<T>::const_iterator begin() const { return elements_.begin(); }
+    typename PoolVector<T>::iterator erase(typename PoolVector<T>::iterator el) { reset_hash(); return elements_.erase(el); }
+    typename PoolVector<T>::const_iterator erase(typename PoolVector<T>::const_iterator el) { reset_hash(); return elements_.erase(el); }
 
   };
   template <typename T>
   inline Vectorized<T>::~Vectorized() { }
 
   /////////////////////////////////////////////////////////////////////////////
-  // Mixin class for AST nodes that should behave like a hash table. Uses an
-  // extra <std::vector> internally to maintain insertion order for interation.
+  // Mixin class for AST nodes that should behave like a hash table. Entries
+  // live in flat insertion-ordered vectors; lookups go through a small open
+  // addressing index of entry positions (linear probing, no tombstones since
+  // the container never erases) instead of a node-based unordered_map, so a
+  // map costs a few contiguous buffers instead of one allocation per entry.
   /////////////////////////////////////////////////////////////////////////////
   template <typename K, typename T, typename U>
   class Hashed {
   private:
-    std::unordered_map<
-      K, T, ObjHash, ObjEquality
-    > elements_;
-
     std::vector<K> _keys;
     std::vector<T> _values;
+    // hash of each key, parallel to _keys; lets the index grow
+    // without re-hashing (or even touching) any key object
+    std::vector<size_t> _hashes;
+    // probe table of entry index plus one (zero marks an empty
+    // slot); always a power of two, grown before 3/4 full
+    std::vector<uint32_t> _buckets;
+
+    // find the slot where key lives or would be inserted
+    size_t probe(size_t hash, const K& k) const
+    {
+      size_t mask = _buckets.size() - 1;
+      size_t i = hash & mask;
+      while (uint32_t b = _buckets[i]) {
+        size_t idx = b - 1;
+        if (_hashes[idx] == hash && ObjEqualityFn<K>(_keys[idx], k)) return i;
+        i = (i + 1) & mask;
+      }
+      return i;
+    }
+
+    void rehash(size_t entries)
+    {
+      size_t size = 8;
+      while (size * 3 < entries * 4) size *= 2;
+      if (size <= _buckets.size()) return;
+      _buckets.assign(size, 0);
+      size_t mask = size - 1;
+      for (size_t idx = 0; idx < _keys.size(); ++idx) {
+        size_t i = _hashes[idx] & mask;
+        while (_buckets[i]) i = (i + 1) & mask;
+        _buckets[i] = static_cast<uint32_t>(idx) + 1;
+      }
+    }
+
   protected:
     mutable size_t hash_;
     K duplicate_key_;
     void reset_hash() { hash_ = 0; }
     void reset_duplicate_key() { duplicate_key_ = {}; }
-    virtual void adjust_after_pushing(std::pair<K, T> p) { }
+    virtual void adjust_after_pushing(const std::pair<K, T>& p) { }
   public:
     Hashed(size_t s = 0)
-    : elements_(),
-      _keys(),
+    : _keys(),
       _values(),
+      _hashes(),
+      _buckets(),
       hash_(0), duplicate_key_({})
     {
       _keys.reserve(s);
       _values.reserve(s);
-      elements_.reserve(s);
+      _hashes.reserve(s);
+      rehash(s);
     }
     virtual ~Hashed();
     size_t length() const                  { return _keys.size(); }
     bool empty() const                     { return _keys.empty(); }
-    bool has(K k) const          {
-      return elements_.find(k) != elements_.end();
+    bool has(const K& k) const          {
+      return _buckets[probe(ObjHashFn(k), k)] != 0;
     }
-    T at(K k) const {
-      if (elements_.count(k))
-      {
-        return elements_.at(k);
-      }
+    T at(const K& k) const {
+      size_t i = probe(ObjHashFn(k), k);
+      if (uint32_t b = _buckets[i]) return _values[b - 1];
       else { return {}; }
     }
     bool has_duplicate_key() const         { return duplicate_key_ != nullptr; }
     K get_duplicate_key() const  { return duplicate_key_; }
-    const std::unordered_map<
-      K, T, ObjHash, ObjEquality
-    >& elements() { return elements_; }
-    Hashed& operator<<(std::pair<K, T> p)
+    Hashed& operator<<(const std::pair<K, T>& p)
     {
       reset_hash();
 
-      if (!has(p.first)) {
+      // single probe for both the duplicate
+      // check and the insertion slot
+      if ((_keys.size() + 1) * 4 > _buckets.size() * 3) rehash(_keys.size() + 1);
+      size_t hash = ObjHashFn(p.first);
+      size_t i = probe(hash, p.first);
+      if (uint32_t b = _buckets[i]) {
+        if (!duplicate_key_) {
+          duplicate_key_ = p.first;
+        }
+        _values[b - 1] = p.second;
+      }
+      else {
+        _buckets[i] = static_cast<uint32_t>(_keys.size()) + 1;
         _keys.push_back(p.first);
         _values.push_back(p.second);
+        _hashes.push_back(hash);
       }
-      else if (!duplicate_key_) {
-        duplicate_key_ = p.first;
-      }
-
-      elements_[p.first] = p.second;
 
       adjust_after_pushing(p);
       return *this;
@@ -420,31 +487,24 @@ namespace Sass {
     Hashed& operator+=(Hashed* h)
     {
       if (length() == 0) {
-        this->elements_ = h->elements_;
-        this->_values = h->_values;
         this->_keys = h->_keys;
+        this->_values = h->_values;
+        this->_hashes = h->_hashes;
+        this->_buckets = h->_buckets;
         return *this;
       }
 
-      for (auto key : h->keys()) {
-        *this << std::make_pair(key, h->at(key));
+      for (size_t i = 0, L = h->_keys.size(); i < L; ++i) {
+        *this << std::make_pair(h->_keys[i], h->_values[i]);
       }
 
       reset_duplicate_key();
       return *this;
     }
-    const std::unordered_map<
-      K, T, ObjHash, ObjEquality
-    >& pairs() const { return elements_; }
 
     const std::vector<K>& keys() const { return _keys; }
     const std::vector<T>& values() const { return _values; }
 
-//    std::unordered_map<Expression_Obj, Expression_Obj>::iterator end() { return elements_.end(); }
-//    std::unordered_map<Expression_Obj, Expression_Obj>::iterator begin() { return elements_.begin(); }
-//    std::unordered_map<Expression_Obj, Expression_Obj>::const_iterator end() const { return elements_.end(); }
-//    std::unordered_map<Expression_Obj, Expression_Obj>::const_iterator begin() const { return elements_.begin(); }
-
   };
   template <typename K, typename T, typename U>
   inline Hashed<K, T, U>::~Hashed() { }
@@ -501,9 +561,16 @@ namespace Sass {
   ////////////////////////
   class Block final : public Statement, public Vectorized<Statement_Obj> {
     ADD_PROPERTY(bool, is_root)
+    // frame analysis result, computed lazily on the first
+    // expansion: a block whose direct statements cannot create
+    // entries in a local frame borrows the enclosing scope
+    // instead of pushing an empty frame every variable lookup
+    // would have to probe (see block_declares_variables)
+    ADD_PROPERTY(bool, frame_scanned)
+    ADD_PROPERTY(bool, declares_variables)
     // needed for properly formatted CSS emission
   protected:
-    void adjust_after_pushing(Statement_Obj s) override {}
+    void adjust_after_pushing(const Statement_Obj& s) override {}
   public:
     Block(ParserState pstate, size_t s = 0, bool r = false);
     bool isInvisible() const;
@@ -533,6 +600,13 @@ namespace Sass {
     ADD_PROPERTY(SelectorListObj, selector)
     ADD_PROPERTY(Selector_Schema_Obj, schema)
     ADD_PROPERTY(bool, is_root);
+    // staticness analysis result, computed lazily on the first
+    // expansion: a rule without interpolation or parent refs whose
+    // body holds only static declarations (plain css, mostly from
+    // vendored imports) expands without an environment frame or
+    // selector stack bookkeeping
+    ADD_PROPERTY(bool, static_scanned)
+    ADD_PROPERTY(bool, is_static)
   public:
     Ruleset(ParserState pstate, SelectorListObj s = {}, Block_Obj b = {});
     bool is_invisible() const override;
@@ -604,6 +678,12 @@ namespace Sass {
     ADD_PROPERTY(bool, is_important)
     ADD_PROPERTY(bool, is_custom_property)
     ADD_PROPERTY(bool, is_indented)
+    // staticness analysis result, computed lazily on the first
+    // expansion: a declaration whose property and value are plain
+    // constants evaluates to itself, so hot mixin bodies made of
+    // such declarations skip the eval dispatch on every inclusion
+    ADD_PROPERTY(bool, static_scanned)
+    ADD_PROPERTY(bool, is_static)
   public:
     Declaration(ParserState pstate, String_Obj prop, Expression_Obj val, bool i = false, bool c = false, Block_Obj b = {});
     bool is_invisible() const override;
@@ -777,6 +857,24 @@ namespace Sass {
     ADD_PROPERTY(void*, cookie)
     ADD_PROPERTY(bool, is_overload_stub)
     ADD_PROPERTY(Signature, signature)
+    // closure analysis result, computed lazily on first inclusion:
+    // a mixin body that cannot create bindings in its local frame
+    // (no assignments, nested definitions or imports anywhere) can
+    // run directly against the definition environment, skipping
+    // the per-include frame entirely. defaults to needing a frame
+    ADD_PROPERTY(bool, frame_scanned)
+    ADD_PROPERTY(bool, needs_frame)
+    // purity analysis result, computed lazily on the first call:
+    // a function body that only reads its parameters and local
+    // bindings and only calls deterministic built-ins maps equal
+    // inputs to equal outputs, so repeat calls can be memoized.
+    // free_variables and free_functions list the names the body
+    // resolves through the closure; their current bindings join
+    // the memo key (see Eval::pure_call_key)
+    ADD_PROPERTY(bool, purity_scanned)
+    ADD_PROPERTY(bool, is_pure)
+    ADD_CONSTREF(std::vector<std::string>, free_variables)
+    ADD_CONSTREF(std::vector<std::string>, free_functions)
   public:
     Definition(ParserState pstate,
                std::string n,
@@ -805,6 +903,9 @@ namespace Sass {
     ADD_CONSTREF(std::string, name)
     ADD_PROPERTY(Arguments_Obj, arguments)
     ADD_PROPERTY(Parameters_Obj, block_parameters)
+    // cached @content thunk; the closure over the content block is
+    // reused across includes with only its environment rebound
+    ADD_PROPERTY(Definition_Obj, content_thunk)
   public:
     Mixin_Call(ParserState pstate, std::string n, Arguments_Obj args, Parameters_Obj b_params = {}, Block_Obj b = {});
     ATTACH_AST_OPERATIONS(Mixin_Call)
@@ -869,7 +970,7 @@ namespace Sass {
     ADD_PROPERTY(bool, has_rest_argument)
     ADD_PROPERTY(bool, has_keyword_argument)
   protected:
-    void adjust_after_pushing(Argument_Obj a) override;
+    void adjust_after_pushing(const Argument_Obj& a) override;
   public:
     Arguments(ParserState pstate);
     void set_delayed(bool delayed) override;
@@ -1043,7 +1144,7 @@ namespace Sass {
     ADD_PROPERTY(bool, has_optional_parameters)
     ADD_PROPERTY(bool, has_rest_parameter)
   protected:
-    void adjust_after_pushing(Parameter_Obj p) override;
+    void adjust_after_pushing(const Parameter_Obj& p) override;
   public:
     Parameters(ParserState pstate);
     ATTACH_AST_OPERATIONS(Parameters)
@@ -40,11 +40,32 @@ namespace Sass {
   union Sass_Value* AST2C::operator()(String_Quoted* s)
   { return sass_make_qstring(s->value().c_str()); }
 
+  union Sass_Value* AST2C::convert(Expression* e)
+  {
+    // typed fast paths for the value types that actually occur
+    // in big argument lists and maps; everything else falls back
+    // to the regular double virtual dispatch
+    if (Argument* arg = Cast<Argument>(e)) return convert(arg->value());
+    if (Number* n = Cast<Number>(e)) return operator()(n);
+    // quoted strings marshal as qstrings even when the quote mark
+    // was dropped, so they must not fall into the base-class cast
+    // below, which branches on the quote mark
+    if (String_Quoted* q = Cast<String_Quoted>(e)) return operator()(q);
+    if (String_Constant* s = Cast<String_Constant>(e)) return operator()(s);
+    if (Color_RGBA* c = Cast<Color_RGBA>(e)) return operator()(c);
+    if (Boolean* b = Cast<Boolean>(e)) return operator()(b);
+    // the list cast is not exact, so match arguments before
+    if (Arguments* a = Cast<Arguments>(e)) return operator()(a);
+    if (List* l = Cast<List>(e)) return operator()(l);
+    if (Map* m = Cast<Map>(e)) return operator()(m);
+    return e->perform(this);
+  }
+
   union Sass_Value* AST2C::operator()(List* l)
   {
     union Sass_Value* v = sass_make_list(l->length(), l->separator(), l->is_bracketed());
     for (size_t i = 0, L = l->length(); i < L; ++i) {
-      sass_list_set_value(v, i, (*l)[i]->perform(this));
+      sass_list_set_value(v, i, convert((*l)[i]));
     }
     return v;
   }
@@ -54,8 +75,8 @@ namespace Sass {
     union Sass_Value* v = sass_make_map(m->length());
     int i = 0;
     for (auto key : m->keys()) {
-      sass_map_set_key(v, i, key->perform(this));
-      sass_map_set_value(v, i, m->at(key)->perform(this));
+      sass_map_set_key(v, i, convert(key));
+      sass_map_set_value(v, i, convert(m->at(key)));
       i++;
     }
     return v;
@@ -65,7 +86,7 @@ namespace Sass {
   {
     union Sass_Value* v = sass_make_list(a->length(), SASS_COMMA, false);
     for (size_t i = 0, L = a->length(); i < L; ++i) {
-      sass_list_set_value(v, i, (*a)[i]->perform(this));
+      sass_list_set_value(v, i, convert((*a)[i]));
     }
     return v;
   }
@@ -32,6 +32,13 @@ namespace Sass {
     union Sass_Value* fallback(AST_Node* x)
     { return sass_make_error("unknown type for C-API"); }
 
+  private:
+
+    // one-pass conversion for container items; resolves the
+    // common value types directly instead of going through two
+    // virtual dispatches (perform plus visitor) per element
+    union Sass_Value* convert(Expression* e);
+
   };
 
 }
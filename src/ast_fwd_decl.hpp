@@ -222,7 +222,10 @@ namespace Sass {
   typedef std::vector<Sass_Import_Entry> ImporterStack;
 
   // only to switch implementations for testing
-  #define environment_map std::map
+  // hashed lookup beats ordered character-wise compares for the
+  // hot variable/function name accesses (nothing iterates frames
+  // outside of debug printing, so ordering is not relied upon)
+  #define environment_map std::unordered_map
 
   // ###########################################################################
   // explicit type conversion functions
@@ -124,6 +124,7 @@ namespace Sass {
   bool PtrObjEqualityFn(const T* lhs, const T* rhs) {
     if (lhs == nullptr) return rhs == nullptr;
     else if (rhs == nullptr) return false;
+    else if (lhs == rhs) return true;
     else return *lhs == *rhs;
   }
 
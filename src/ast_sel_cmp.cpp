@@ -71,6 +71,15 @@ namespace Sass {
   {
     if (&rhs == this) return true;
     if (rhs.length() != length()) return false;
+    // same identity shortcut as for compound selectors below
+    bool identical = true;
+    for (size_t i = 0, L = length(); i < L; i += 1) {
+      if (get(i).ptr() != rhs.get(i).ptr()) {
+        identical = false;
+        break;
+      }
+    }
+    if (identical) return true;
     std::unordered_set<const ComplexSelector*, PtrObjHash, PtrObjEquality> lhs_set;
     lhs_set.reserve(length());
     for (const ComplexSelectorObj& element : elements()) {
@@ -124,10 +133,14 @@ namespace Sass {
 
   bool ComplexSelector::operator== (const ComplexSelector& rhs) const
   {
+    if (&rhs == this) return true;
     size_t len = length();
     size_t rlen = rhs.length();
     if (len != rlen) return false;
     for (size_t i = 0; i < len; i += 1) {
+      // extend and parent resolution share component
+      // nodes, so identity settles most positions
+      if (get(i).ptr() == rhs.get(i).ptr()) continue;
       if (*get(i) != *rhs.get(i)) return false;
     }
     return true;
@@ -207,6 +220,17 @@ namespace Sass {
     // std::cerr << "comp vs comp\n";
     if (&rhs == this) return true;
     if (rhs.length() != length()) return false;
+    // parsed selectors share their simple selector nodes, so equal
+    // compounds are usually pairwise identical; check that before
+    // falling back to the order-insensitive set comparison
+    bool identical = true;
+    for (size_t i = 0, L = length(); i < L; i += 1) {
+      if (get(i).ptr() != rhs.get(i).ptr()) {
+        identical = false;
+        break;
+      }
+    }
+    if (identical) return true;
     std::unordered_set<const SimpleSelector*, PtrObjHash, PtrObjEquality> lhs_set;
     lhs_set.reserve(length());
     for (const SimpleSelectorObj& element : elements()) {
@@ -301,36 +325,42 @@ namespace Sass {
 
   bool Id_Selector::operator== (const SimpleSelector& rhs) const
   {
+    if (&rhs == this) return true;
     auto sel = Cast<Id_Selector>(&rhs);
     return sel ? *this == *sel : false;
   }
 
   bool Type_Selector::operator== (const SimpleSelector& rhs) const
   {
+    if (&rhs == this) return true;
     auto sel = Cast<Type_Selector>(&rhs);
     return sel ? *this == *sel : false;
   }
 
   bool Class_Selector::operator== (const SimpleSelector& rhs) const
   {
+    if (&rhs == this) return true;
     auto sel = Cast<Class_Selector>(&rhs);
     return sel ? *this == *sel : false;
   }
 
   bool Pseudo_Selector::operator== (const SimpleSelector& rhs) const
   {
+    if (&rhs == this) return true;
     auto sel = Cast<Pseudo_Selector>(&rhs);
     return sel ? *this == *sel : false;
   }
 
   bool Attribute_Selector::operator== (const SimpleSelector& rhs) const
   {
+    if (&rhs == this) return true;
     auto sel = Cast<Attribute_Selector>(&rhs);
     return sel ? *this == *sel : false;
   }
 
   bool Placeholder_Selector::operator== (const SimpleSelector& rhs) const
   {
+    if (&rhs == this) return true;
     auto sel = Cast<Placeholder_Selector>(&rhs);
     return sel ? *this == *sel : false;
   }
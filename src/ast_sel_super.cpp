@@ -19,8 +19,8 @@ namespace Sass {
   // [list2] matches, as well as possibly additional elements.
   // ##########################################################################
   bool listIsSuperslector(
-    const std::vector<ComplexSelectorObj>& list1,
-    const std::vector<ComplexSelectorObj>& list2);
+    const PoolVector<ComplexSelectorObj>& list1,
+    const PoolVector<ComplexSelectorObj>& list2);
 
   // ##########################################################################
   // Returns whether [complex1] is a superselector of [complex2].
@@ -28,8 +28,8 @@ namespace Sass {
   // [complex2] matches, as well as possibly additional elements.
   // ##########################################################################
   bool complexIsSuperselector(
-    const std::vector<SelectorComponentObj>& complex1,
-    const std::vector<SelectorComponentObj>& complex2);
+    const PoolVector<SelectorComponentObj>& complex1,
+    const PoolVector<SelectorComponentObj>& complex2);
 
   // ##########################################################################
   // Returns all pseudo selectors in [compound] that have
@@ -39,7 +39,7 @@ namespace Sass {
     CompoundSelectorObj compound, std::string name)
   {
     std::vector<Pseudo_Selector_Obj> rv;
-    for (SimpleSelectorObj sel : compound->elements()) {
+    for (const SimpleSelectorObj& sel : compound->elements()) {
       if (Pseudo_Selector_Obj pseudo = Cast<Pseudo_Selector>(sel)) {
         if (pseudo->isClass() && pseudo->selector()) {
           if (sel->name() == name) {
@@ -97,7 +97,7 @@ namespace Sass {
     const SimpleSelectorObj& simple,
     const CompoundSelectorObj& compound)
   {
-    for (SimpleSelectorObj simple2 : compound->elements()) {
+    for (const SimpleSelectorObj& simple2 : compound->elements()) {
       if (simpleIsSuperselector(simple, simple2)) {
         return true;
       }
@@ -192,8 +192,8 @@ namespace Sass {
     const Pseudo_Selector_Obj& pseudo1,
     const CompoundSelectorObj& compound2,
     // ToDo: is this really the most convenient way to do this?
-    std::vector<SelectorComponentObj>::const_iterator parents_from,
-    std::vector<SelectorComponentObj>::const_iterator parents_to)
+    PoolVector<SelectorComponentObj>::const_iterator parents_from,
+    PoolVector<SelectorComponentObj>::const_iterator parents_to)
   {
 
     // ToDo: move normalization function
@@ -203,15 +203,15 @@ namespace Sass {
       std::vector<Pseudo_Selector_Obj> pseudos =
         selectorPseudoNamed(compound2, pseudo1->name());
       SelectorListObj selector1 = pseudo1->selector();
-      for (Pseudo_Selector_Obj pseudo2 : pseudos) {
+      for (const Pseudo_Selector_Obj& pseudo2 : pseudos) {
         SelectorListObj selector = pseudo2->selector();
         if (selector1->isSuperselectorOf(selector)) {
           return true;
         }
       }
 
-      for (ComplexSelectorObj complex1 : selector1->elements()) {
-        std::vector<SelectorComponentObj> parents;
+      for (const ComplexSelectorObj& complex1 : selector1->elements()) {
+        PoolVector<SelectorComponentObj> parents;
         for (auto cur = parents_from; cur != parents_to; cur++) {
           parents.push_back(*cur);
         }
@@ -226,7 +226,7 @@ namespace Sass {
       std::vector<Pseudo_Selector_Obj> pseudos =
         selectorPseudoNamed(compound2, pseudo1->name());
       SelectorListObj selector1 = pseudo1->selector();
-      for (Pseudo_Selector_Obj pseudo2 : pseudos) {
+      for (const Pseudo_Selector_Obj& pseudo2 : pseudos) {
         SelectorListObj selector = pseudo2->selector();
         if (selector1->isSuperselectorOf(selector)) {
           return true;
@@ -235,7 +235,7 @@ namespace Sass {
 
     }
     else if (name == "not") {
-      for (ComplexSelectorObj complex : pseudo1->selector()->elements()) {
+      for (const ComplexSelectorObj& complex : pseudo1->selector()->elements()) {
         if (!pseudoNotIsSuperselectorOfCompound(pseudo1, compound2, complex)) return false;
       }
       return true;
@@ -243,7 +243,7 @@ namespace Sass {
     else if (name == "current") {
       std::vector<Pseudo_Selector_Obj> pseudos =
         selectorPseudoNamed(compound2, "current");
-      for (Pseudo_Selector_Obj pseudo2 : pseudos) {
+      for (const Pseudo_Selector_Obj& pseudo2 : pseudos) {
         if (ObjEqualityFn(pseudo1, pseudo2)) return true;
       }
 
@@ -276,12 +276,12 @@ namespace Sass {
     const CompoundSelectorObj& compound1,
     const CompoundSelectorObj& compound2,
     // ToDo: is this really the most convenient way to do this?
-    const std::vector<SelectorComponentObj>::const_iterator parents_from,
-    const std::vector<SelectorComponentObj>::const_iterator parents_to)
+    const PoolVector<SelectorComponentObj>::const_iterator parents_from,
+    const PoolVector<SelectorComponentObj>::const_iterator parents_to)
   {
     // Every selector in [compound1.components] must have
     // a matching selector in [compound2.components].
-    for (SimpleSelectorObj simple1 : compound1->elements()) {
+    for (const SimpleSelectorObj& simple1 : compound1->elements()) {
       Pseudo_Selector_Obj pseudo1 = Cast<Pseudo_Selector>(simple1);
       if (pseudo1 && pseudo1->selector()) {
         if (!selectorPseudoIsSuperselector(pseudo1, compound2, parents_from, parents_to)) {
@@ -294,7 +294,7 @@ namespace Sass {
     }
     // [compound1] can't be a superselector of a selector
     // with pseudo-elements that [compound2] doesn't share.
-    for (SimpleSelectorObj simple2 : compound2->elements()) {
+    for (const SimpleSelectorObj& simple2 : compound2->elements()) {
       Pseudo_Selector_Obj pseudo2 = Cast<Pseudo_Selector>(simple2);
       if (pseudo2 && pseudo2->isElement()) {
         if (!simpleIsSuperselectorOfCompound(pseudo2, compound1)) {
@@ -317,7 +317,7 @@ namespace Sass {
   bool compoundIsSuperselector(
     const CompoundSelectorObj& compound1,
     const CompoundSelectorObj& compound2,
-    const std::vector<SelectorComponentObj>& parents)
+    const PoolVector<SelectorComponentObj>& parents)
   {
     return compoundIsSuperselector(
       compound1, compound2,
@@ -332,8 +332,8 @@ namespace Sass {
   // [complex2] matches, as well as possibly additional elements.
   // ##########################################################################
   bool complexIsSuperselector(
-    const std::vector<SelectorComponentObj>& complex1,
-    const std::vector<SelectorComponentObj>& complex2)
+    const PoolVector<SelectorComponentObj>& complex1,
+    const PoolVector<SelectorComponentObj>& complex2)
   {
 
     // Selectors with trailing operators are neither superselectors nor subselectors.
@@ -368,14 +368,14 @@ namespace Sass {
       CompoundSelectorObj compound2 = Cast<CompoundSelector>(complex2.back());
 
       if (remaining1 == 1) {
-        std::vector<SelectorComponentObj>::const_iterator parents_to = complex2.end();
-        std::vector<SelectorComponentObj>::const_iterator parents_from = complex2.begin();
+        PoolVector<SelectorComponentObj>::const_iterator parents_to = complex2.end();
+        PoolVector<SelectorComponentObj>::const_iterator parents_from = complex2.begin();
         std::advance(parents_from, i2 + 1); // equivalent to dart `.skip(i2 + 1)`
         bool rv = compoundIsSuperselector(compound1, compound2, parents_from, parents_to);
-        std::vector<SelectorComponentObj> pp;
+        PoolVector<SelectorComponentObj> pp;
 
-        std::vector<SelectorComponentObj>::const_iterator end = parents_to;
-        std::vector<SelectorComponentObj>::const_iterator beg = parents_from;
+        PoolVector<SelectorComponentObj>::const_iterator end = parents_to;
+        PoolVector<SelectorComponentObj>::const_iterator beg = parents_from;
         while (beg != end) {
           pp.push_back(*beg);
           beg++;
@@ -393,8 +393,8 @@ namespace Sass {
       for (; afterSuperselector < complex2.size(); afterSuperselector++) {
         SelectorComponentObj component2 = complex2[afterSuperselector - 1];
         if (CompoundSelectorObj compound2 = Cast<CompoundSelector>(component2)) {
-          std::vector<SelectorComponentObj>::const_iterator parents_to = complex2.begin();
-          std::vector<SelectorComponentObj>::const_iterator parents_from = complex2.begin();
+          PoolVector<SelectorComponentObj>::const_iterator parents_to = complex2.begin();
+          PoolVector<SelectorComponentObj>::const_iterator parents_from = complex2.begin();
           // complex2.take(afterSuperselector - 1).skip(i2 + 1)
           std::advance(parents_from, i2 + 1); // equivalent to dart `.skip`
           std::advance(parents_to, afterSuperselector); // equivalent to dart `.take`
@@ -464,8 +464,8 @@ namespace Sass {
   // since `B X` is a superselector of `B A X`.
   // ##########################################################################
   bool complexIsParentSuperselector(
-    const std::vector<SelectorComponentObj>& complex1,
-    const std::vector<SelectorComponentObj>& complex2)
+    const PoolVector<SelectorComponentObj>& complex1,
+    const PoolVector<SelectorComponentObj>& complex2)
   {
     // Try some simple heuristics to see if we can avoid allocations.
     if (complex1.empty() && complex2.empty()) return false;
@@ -473,8 +473,8 @@ namespace Sass {
     if (Cast<SelectorCombinator>(complex2.front())) return false;
     if (complex1.size() > complex2.size()) return false;
     // TODO(nweiz): There's got to be a way to do this without a bunch of extra allocations...
-    std::vector<SelectorComponentObj> cplx1(complex1);
-    std::vector<SelectorComponentObj> cplx2(complex2);
+    PoolVector<SelectorComponentObj> cplx1(complex1);
+    PoolVector<SelectorComponentObj> cplx2(complex2);
     CompoundSelectorObj base = SASS_MEMORY_NEW(CompoundSelector, "[tmp]");
     cplx1.push_back(base); cplx2.push_back(base);
     return complexIsSuperselector(cplx1, cplx2);
@@ -487,12 +487,12 @@ namespace Sass {
   // [complex] matches, as well as possibly additional elements.
   // ##########################################################################
   bool listHasSuperslectorForComplex(
-    std::vector<ComplexSelectorObj> list,
+    PoolVector<ComplexSelectorObj> list,
     ComplexSelectorObj complex)
   {
     // Return true if every [complex] selector on [list2]
     // is a super selector of the full selector [list1].
-    for (ComplexSelectorObj lhs : list) {
+    for (const ComplexSelectorObj& lhs : list) {
       if (complexIsSuperselector(lhs->elements(), complex->elements())) {
         return true;
       }
@@ -507,12 +507,12 @@ namespace Sass {
   // [list2] matches, as well as possibly additional elements.
   // ##########################################################################
   bool listIsSuperslector(
-    const std::vector<ComplexSelectorObj>& list1,
-    const std::vector<ComplexSelectorObj>& list2)
+    const PoolVector<ComplexSelectorObj>& list1,
+    const PoolVector<ComplexSelectorObj>& list2)
   {
     // Return true if every [complex] selector on [list2]
     // is a super selector of the full selector [list1].
-    for (ComplexSelectorObj complex : list2) {
+    for (const ComplexSelectorObj& complex : list2) {
       if (!listHasSuperslectorForComplex(list1, complex)) {
         return false;
       }
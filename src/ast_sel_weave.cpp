@@ -8,6 +8,56 @@
 
 namespace Sass {
 
+  // ##########################################################################
+  // Complexity budget shared by the weave helpers below. The counters are
+  // thread local because the helpers are free functions reached from both
+  // the extender and selector unification; the extender arms the budget
+  // per compile (see the extend_budget option) and reads the truncated
+  // flag afterwards to report the degradation.
+  // ##########################################################################
+  static thread_local size_t weave_budget = 0;
+  static thread_local size_t weave_spent = 0;
+  static thread_local bool weave_truncated = false;
+  static thread_local void (*weave_poll)(void*) = 0;
+  static thread_local void* weave_poll_cookie = 0;
+
+  void setWeaveBudget(size_t budget)
+  {
+    weave_budget = budget;
+    weave_spent = 0;
+    weave_truncated = false;
+  }
+
+  void setWeavePoll(void (*poll)(void*), void* cookie)
+  {
+    weave_poll = poll;
+    weave_poll_cookie = cookie;
+  }
+
+  // account one woven combination; returns true (and latches the
+  // truncated flag) once the budget is used up. Also the spot the
+  // cancellation poll hangs off, so compiles without a weave
+  // budget stay cancellable inside pathological weaves
+  static bool spendWeaveBudget()
+  {
+    ++weave_spent;
+    if (weave_poll && !(weave_spent & 0xFF)) weave_poll(weave_poll_cookie);
+    if (weave_budget == 0) return false;
+    if (weave_spent <= weave_budget) return false;
+    weave_truncated = true;
+    return true;
+  }
+
+  bool weaveBudgetExhausted()
+  {
+    return weave_budget != 0 && weave_spent > weave_budget;
+  }
+
+  bool weaveTruncated()
+  {
+    return weave_truncated;
+  }
+
   // ##########################################################################
   // Returns whether or not [compound] contains a `::root` selector.
   // ##########################################################################
@@ -38,8 +88,8 @@ namespace Sass {
   // selectors contain the same unique simple selector, such as an ID.
   // ##########################################################################
   bool mustUnify(
-    const std::vector<SelectorComponentObj>& complex1,
-    const std::vector<SelectorComponentObj>& complex2)
+    const PoolVector<SelectorComponentObj>& complex1,
+    const PoolVector<SelectorComponentObj>& complex2)
   {
 
     std::vector<const SimpleSelector*> uniqueSelectors1;
@@ -76,9 +126,9 @@ namespace Sass {
   // Helper function used by `weaveParents`
   // ##########################################################################
   bool cmpGroups(
-    const std::vector<SelectorComponentObj>& group1,
-    const std::vector<SelectorComponentObj>& group2,
-    std::vector<SelectorComponentObj>& select)
+    const PoolVector<SelectorComponentObj>& group1,
+    const PoolVector<SelectorComponentObj>& group2,
+    PoolVector<SelectorComponentObj>& select)
   {
 
     if (group1.size() == group2.size() && std::equal(group1.begin(), group1.end(), group2.begin(), PtrObjEqualityFn<SelectorComponent>)) {
@@ -109,7 +159,7 @@ namespace Sass {
       return false;
     }
 
-    std::vector<std::vector<SelectorComponentObj>> unified
+    std::vector<PoolVector<SelectorComponentObj>> unified
       = unifyComplex({ group1, group2 });
     if (unified.empty()) return false;
     if (unified.size() > 1) return false;
@@ -131,8 +181,8 @@ namespace Sass {
   // Helper function used by `weaveParents`
   // ##########################################################################
   bool cmpChunkForEmptySequence(
-    const std::vector<std::vector<SelectorComponentObj>>& seq,
-    const std::vector<SelectorComponentObj>& group)
+    const std::vector<PoolVector<SelectorComponentObj>>& seq,
+    const PoolVector<SelectorComponentObj>& group)
   {
     return seq.empty();
   }
@@ -142,8 +192,8 @@ namespace Sass {
   // Helper function used by `weaveParents`
   // ##########################################################################
   bool cmpChunkForParentSuperselector(
-    const std::vector< std::vector<SelectorComponentObj>>& seq,
-    const std::vector<SelectorComponentObj>& group)
+    const std::vector< PoolVector<SelectorComponentObj>>& seq,
+    const PoolVector<SelectorComponentObj>& group)
   {
     return seq.empty() || complexIsParentSuperselector(seq.front(), group);
   }
@@ -193,7 +243,7 @@ namespace Sass {
   // If the first element of [queue] has a `::root` 
   // selector, removes and returns that element.
   // ##########################################################################
-  CompoundSelectorObj getFirstIfRoot(std::vector<SelectorComponentObj>& queue) {
+  CompoundSelectorObj getFirstIfRoot(PoolVector<SelectorComponentObj>& queue) {
     if (queue.empty()) return {};
     SelectorComponent* first = queue.front();
     if (CompoundSelector* sel = Cast<CompoundSelector>(first)) {
@@ -210,12 +260,12 @@ namespace Sass {
   // contains two adjacent [ComplexSelector]s. For example,
   // `(A B > C D + E ~ > G)` is grouped into `[(A) (B > C) (D + E ~ > G)]`.
   // ##########################################################################
-  std::vector<std::vector<SelectorComponentObj>> groupSelectors(
-    const std::vector<SelectorComponentObj>& components)
+  std::vector<PoolVector<SelectorComponentObj>> groupSelectors(
+    const PoolVector<SelectorComponentObj>& components)
   {
     bool lastWasCompound = false;
-    std::vector<SelectorComponentObj> group;
-    std::vector<std::vector<SelectorComponentObj>> groups;
+    PoolVector<SelectorComponentObj> group;
+    std::vector<PoolVector<SelectorComponentObj>> groups;
     for (size_t i = 0; i < components.size(); i += 1) {
       if (CompoundSelector* compound = components[i]->getCompound()) {
         if (lastWasCompound) {
@@ -244,19 +294,19 @@ namespace Sass {
   // If the combinators can't be merged, returns `null`.
   // ##########################################################################
   bool mergeInitialCombinators(
-    std::vector<SelectorComponentObj>& components1,
-    std::vector<SelectorComponentObj>& components2,
-    std::vector<SelectorComponentObj>& result)
+    PoolVector<SelectorComponentObj>& components1,
+    PoolVector<SelectorComponentObj>& components2,
+    PoolVector<SelectorComponentObj>& result)
   {
 
-    std::vector<SelectorComponentObj> combinators1;
+    PoolVector<SelectorComponentObj> combinators1;
     while (!components1.empty() && Cast<SelectorCombinator>(components1.front())) {
       SelectorCombinatorObj front = Cast<SelectorCombinator>(components1.front());
       components1.erase(components1.begin());
       combinators1.push_back(front);
     }
 
-    std::vector<SelectorComponentObj> combinators2;
+    PoolVector<SelectorComponentObj> combinators2;
     while (!components2.empty() && Cast<SelectorCombinator>(components2.front())) {
       SelectorCombinatorObj front = Cast<SelectorCombinator>(components2.front());
       components2.erase(components2.begin());
@@ -265,7 +315,7 @@ namespace Sass {
 
     // If neither sequence of combinators is a subsequence
     // of the other, they cannot be merged successfully.
-    std::vector<SelectorComponentObj> LCS = lcs<SelectorComponentObj>(combinators1, combinators2);
+    PoolVector<SelectorComponentObj> LCS = lcs<SelectorComponentObj>(combinators1, combinators2);
 
     if (ListEquality(LCS, combinators1, PtrObjEqualityFn<SelectorComponent>)) {
       result = combinators2;
@@ -288,9 +338,9 @@ namespace Sass {
   // empty list. If the sequences can't be merged, returns `null`.
   // ##########################################################################
   bool mergeFinalCombinators(
-    std::vector<SelectorComponentObj>& components1,
-    std::vector<SelectorComponentObj>& components2,
-    std::vector<std::vector<std::vector<SelectorComponentObj>>>& result)
+    PoolVector<SelectorComponentObj>& components1,
+    PoolVector<SelectorComponentObj>& components2,
+    std::vector<std::vector<PoolVector<SelectorComponentObj>>>& result)
   {
 
     if (components1.empty() || !Cast<SelectorCombinator>(components1.back())) {
@@ -299,14 +349,14 @@ namespace Sass {
       }
     }
     
-    std::vector<SelectorComponentObj> combinators1;
+    PoolVector<SelectorComponentObj> combinators1;
     while (!components1.empty() && Cast<SelectorCombinator>(components1.back())) {
       SelectorCombinatorObj back = Cast<SelectorCombinator>(components1.back());
       components1.erase(components1.end() - 1);
       combinators1.push_back(back);
     }
 
-    std::vector<SelectorComponentObj> combinators2;
+    PoolVector<SelectorComponentObj> combinators2;
     while (!components2.empty() && Cast<SelectorCombinator>(components2.back())) {
       SelectorCombinatorObj back = Cast<SelectorCombinator>(components2.back());
       components2.erase(components2.end() - 1);
@@ -356,7 +406,7 @@ namespace Sass {
           result.push_back({ { compound1, combinator1 } });
         }
         else {
-          std::vector<std::vector<SelectorComponentObj>> choices;
+          std::vector<PoolVector<SelectorComponentObj>> choices;
           choices.push_back({ compound1, combinator1, compound2, combinator2 });
           choices.push_back({ compound2, combinator2, compound1, combinator1 });
           if (CompoundSelector* unified = compound1->unifyWith(compound2)) {
@@ -378,7 +428,7 @@ namespace Sass {
         }
         else {
           CompoundSelectorObj unified = compound1->unifyWith(compound2);
-          std::vector<std::vector<SelectorComponentObj>> items;
+          std::vector<PoolVector<SelectorComponentObj>> items;
           
           if (!unified.isNull()) {
             items.push_back({
@@ -463,10 +513,10 @@ namespace Sass {
   // exponential output for very little gain. The selector `.D (.A .B)`
   // is represented as the list `[[.D], [.A, .B]]`.
   // ##########################################################################
-  std::vector<std::vector<SelectorComponentObj>> weave(
-    const std::vector<std::vector<SelectorComponentObj>>& complexes) {
+  std::vector<PoolVector<SelectorComponentObj>> weave(
+    const std::vector<PoolVector<SelectorComponentObj>>& complexes) {
 
-    std::vector<std::vector<SelectorComponentObj>> prefixes;
+    std::vector<PoolVector<SelectorComponentObj>> prefixes;
 
     prefixes.push_back(complexes.at(0));
 
@@ -475,7 +525,7 @@ namespace Sass {
       if (complexes[i].empty()) {
         continue;
       }
-      const std::vector<SelectorComponentObj>& complex = complexes[i];
+      const PoolVector<SelectorComponentObj>& complex = complexes[i];
       SelectorComponent* target = complex.back();
       if (complex.size() == 1) {
         for (auto& prefix : prefixes) {
@@ -484,13 +534,15 @@ namespace Sass {
         continue;
       }
 
-      std::vector<SelectorComponentObj> parents(complex);
+      PoolVector<SelectorComponentObj> parents(complex);
 
       parents.pop_back();
 
-      std::vector<std::vector<SelectorComponentObj>> newPrefixes;
-      for (std::vector<SelectorComponentObj> prefix : prefixes) {
-        std::vector<std::vector<SelectorComponentObj>>
+      std::vector<PoolVector<SelectorComponentObj>> newPrefixes;
+      for (PoolVector<SelectorComponentObj> prefix : prefixes) {
+        // keep the prefixes woven so far once the budget is spent
+        if (weaveBudgetExhausted() && !newPrefixes.empty()) break;
+        std::vector<PoolVector<SelectorComponentObj>>
           parentPrefixes = weaveParents(prefix, parents);
         if (parentPrefixes.empty()) continue;
         for (auto& parentPrefix : parentPrefixes) {
@@ -519,13 +571,13 @@ namespace Sass {
   // elements matched by `A X` and all elements matched by `B X`. Some `AB_i`
   // are elided to reduce the size of the output.
   // ##########################################################################
-  std::vector<std::vector<SelectorComponentObj>> weaveParents(
-    std::vector<SelectorComponentObj> queue1,
-    std::vector<SelectorComponentObj> queue2)
+  std::vector<PoolVector<SelectorComponentObj>> weaveParents(
+    PoolVector<SelectorComponentObj> queue1,
+    PoolVector<SelectorComponentObj> queue2)
   {
 
-    std::vector<SelectorComponentObj> leads;
-    std::vector<std::vector<std::vector<SelectorComponentObj>>> trails;
+    PoolVector<SelectorComponentObj> leads;
+    std::vector<std::vector<PoolVector<SelectorComponentObj>>> trails;
     if (!mergeInitialCombinators(queue1, queue2, leads)) return {};
     if (!mergeFinalCombinators(queue1, queue2, trails)) return {};
     // list comes out in reverse order for performance
@@ -550,27 +602,27 @@ namespace Sass {
     }
 
     // group into sub-lists so no sub-list contains two adjacent ComplexSelectors.
-    std::vector<std::vector<SelectorComponentObj>> groups1 = groupSelectors(queue1);
-    std::vector<std::vector<SelectorComponentObj>> groups2 = groupSelectors(queue2);
+    std::vector<PoolVector<SelectorComponentObj>> groups1 = groupSelectors(queue1);
+    std::vector<PoolVector<SelectorComponentObj>> groups2 = groupSelectors(queue2);
 
     // The main array to store our choices that will be permutated
-    std::vector<std::vector<std::vector<SelectorComponentObj>>> choices;
+    std::vector<std::vector<PoolVector<SelectorComponentObj>>> choices;
 
     // append initial combinators
     choices.push_back({ leads });
 
-    std::vector<std::vector<SelectorComponentObj>> LCS =
-      lcs<std::vector<SelectorComponentObj>>(groups1, groups2, cmpGroups);
+    std::vector<PoolVector<SelectorComponentObj>> LCS =
+      lcs<PoolVector<SelectorComponentObj>>(groups1, groups2, cmpGroups);
 
     for (auto group : LCS) {
 
       // Create junks from groups1 and groups2
-      std::vector<std::vector<std::vector<SelectorComponentObj>>>
-        chunks = getChunks<std::vector<SelectorComponentObj>>(
+      std::vector<std::vector<PoolVector<SelectorComponentObj>>>
+        chunks = getChunks<PoolVector<SelectorComponentObj>>(
           groups1, groups2, group, cmpChunkForParentSuperselector);
 
       // Create expanded array by flattening chunks2 inner
-      std::vector<std::vector<SelectorComponentObj>>
+      std::vector<PoolVector<SelectorComponentObj>>
         expanded = flattenInner(chunks);
 
       // Prepare data structures
@@ -586,8 +638,8 @@ namespace Sass {
     }
 
     // Create junks from groups1 and groups2
-    std::vector<std::vector<std::vector<SelectorComponentObj>>>
-      chunks = getChunks<std::vector<SelectorComponentObj>>(
+    std::vector<std::vector<PoolVector<SelectorComponentObj>>>
+      chunks = getChunks<PoolVector<SelectorComponentObj>>(
         groups1, groups2, {}, cmpChunkForEmptySequence);
 
     // Append chunks with inner arrays flattened
@@ -599,11 +651,18 @@ namespace Sass {
 
     // move all non empty items to the front, then erase the trailing ones
     choices.erase(std::remove_if(choices.begin(), choices.end(), checkForEmptyChild
-      <std::vector<std::vector<SelectorComponentObj>>>), choices.end());
-
-    // permutate all possible paths through selectors
-    std::vector<std::vector<SelectorComponentObj>>
-      results = flattenInner(permutate(choices));
+      <std::vector<PoolVector<SelectorComponentObj>>>), choices.end());
+
+    // permutate all possible paths through selectors; flatten each row
+    // as it is produced instead of materializing the raw cross-product.
+    // the first row is always produced so a budgeted run still returns
+    // one valid weave for every pair it visits
+    std::vector<PoolVector<SelectorComponentObj>> results;
+    permutateEach(choices,
+      [&results](const std::vector<PoolVector<SelectorComponentObj>>& path) {
+        results.emplace_back(flatten(path));
+        return !spendWeaveBudget();
+      });
 
     return results;
 
@@ -343,12 +343,17 @@ namespace Sass {
   SelectorList::SelectorList(ParserState pstate, size_t s)
   : Selector(pstate),
     Vectorized<ComplexSelectorObj>(s),
-    is_optional_(false)
+    is_optional_(false),
+    to_string_cache_(),
+    to_string_key_(0)
   { }
   SelectorList::SelectorList(const SelectorList* ptr)
     : Selector(ptr),
     Vectorized<ComplexSelectorObj>(*ptr),
-    is_optional_(ptr->is_optional_)
+    is_optional_(ptr->is_optional_),
+    // copies are cloned to be mutated, start fresh
+    to_string_cache_(),
+    to_string_key_(0)
   { }
 
   size_t SelectorList::hash() const
@@ -361,7 +366,7 @@ namespace Sass {
 
   bool SelectorList::has_real_parent_ref() const
   {
-    for (ComplexSelectorObj s : elements()) {
+    for (const ComplexSelectorObj& s : elements()) {
       if (s && s->has_real_parent_ref()) return true;
     }
     return false;
@@ -395,14 +400,19 @@ namespace Sass {
   : Selector(pstate),
     Vectorized<SelectorComponentObj>(),
     chroots_(false),
-    hasPreLineFeed_(false)
+    hasPreLineFeed_(false),
+    max_specificity_(std::string::npos),
+    min_specificity_(std::string::npos)
   {
   }
   ComplexSelector::ComplexSelector(const ComplexSelector* ptr)
   : Selector(ptr),
     Vectorized<SelectorComponentObj>(ptr->elements()),
     chroots_(ptr->chroots()),
-    hasPreLineFeed_(ptr->hasPreLineFeed())
+    hasPreLineFeed_(ptr->hasPreLineFeed()),
+    // copies may still be restructured, so they recompute
+    max_specificity_(std::string::npos),
+    min_specificity_(std::string::npos)
   {
   }
 
@@ -561,7 +571,7 @@ namespace Sass {
   bool CompoundSelector::has_placeholder() const
   {
     if (length() == 0) return false;
-    for (SimpleSelectorObj ss : elements()) {
+    for (const SimpleSelectorObj& ss : elements()) {
       if (ss->has_placeholder()) return true;
     }
     return false;
@@ -830,34 +840,40 @@ namespace Sass {
 
   size_t ComplexSelector::maxSpecificity() const
   {
-    size_t specificity = 0;
-    for (auto component : elements()) {
-      specificity += component->maxSpecificity();
+    if (max_specificity_ == std::string::npos) {
+      size_t specificity = 0;
+      for (auto component : elements()) {
+        specificity += component->maxSpecificity();
+      }
+      max_specificity_ = specificity;
     }
-    return specificity;
+    return max_specificity_;
   }
 
   size_t ComplexSelector::minSpecificity() const
   {
-    size_t specificity = 0;
-    for (auto component : elements()) {
-      specificity += component->minSpecificity();
+    if (min_specificity_ == std::string::npos) {
+      size_t specificity = 0;
+      for (auto component : elements()) {
+        specificity += component->minSpecificity();
+      }
+      min_specificity_ = specificity;
     }
-    return specificity;
+    return min_specificity_;
   }
 
   /////////////////////////////////////////////////////////////////////////
   // ToDo: this might be done easier with new selector format
   /////////////////////////////////////////////////////////////////////////
 
-  std::vector<ComplexSelectorObj>
+  PoolVector<ComplexSelectorObj>
     CompoundSelector::resolve_parent_refs(SelectorStack pstack, Backtraces& traces, bool implicit_parent)
   {
 
     auto parent = pstack.back();
-    std::vector<ComplexSelectorObj> rv;
+    PoolVector<ComplexSelectorObj> rv;
 
-    for (SimpleSelectorObj simple : elements()) {
+    for (const SimpleSelectorObj& simple : elements()) {
       if (Pseudo_Selector * pseudo = Cast<Pseudo_Selector>(simple)) {
         if (SelectorList* sel = Cast<SelectorList>(pseudo->selector())) {
           if (parent) {
@@ -944,7 +960,7 @@ namespace Sass {
   SelectorList* ComplexSelector::resolve_parent_refs(SelectorStack pstack, Backtraces& traces, bool implicit_parent)
   {
 
-    std::vector<std::vector<ComplexSelectorObj>> vars;
+    std::vector<PoolVector<ComplexSelectorObj>> vars;
 
     auto parent = pstack.back();
 
@@ -977,7 +993,7 @@ namespace Sass {
     }
 
     // Need complex selectors to preserve linefeeds
-    std::vector<std::vector<ComplexSelectorObj>> res = permutateAlt(vars);
+    std::vector<PoolVector<ComplexSelectorObj>> res = permutateAlt(vars);
 
     // std::reverse(std::begin(res), std::end(res));
 
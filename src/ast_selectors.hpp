@@ -15,25 +15,43 @@ namespace Sass {
   bool compoundIsSuperselector(
     const CompoundSelectorObj& compound1,
     const CompoundSelectorObj& compound2,
-    const std::vector<SelectorComponentObj>& parents);
+    const PoolVector<SelectorComponentObj>& parents);
 
   bool complexIsParentSuperselector(
-    const std::vector<SelectorComponentObj>& complex1,
-    const std::vector<SelectorComponentObj>& complex2);
-
-    std::vector<std::vector<SelectorComponentObj>> weave(
-    const std::vector<std::vector<SelectorComponentObj>>& complexes);
-
-  std::vector<std::vector<SelectorComponentObj>> weaveParents(
-    std::vector<SelectorComponentObj> parents1,
-    std::vector<SelectorComponentObj> parents2);
-
-  std::vector<SimpleSelectorObj> unifyCompound(
-    const std::vector<SimpleSelectorObj>& compound1,
-    const std::vector<SimpleSelectorObj>& compound2);
-
-  std::vector<std::vector<SelectorComponentObj>> unifyComplex(
-    const std::vector<std::vector<SelectorComponentObj>>& complexes);
+    const PoolVector<SelectorComponentObj>& complex1,
+    const PoolVector<SelectorComponentObj>& complex2);
+
+    std::vector<PoolVector<SelectorComponentObj>> weave(
+    const std::vector<PoolVector<SelectorComponentObj>>& complexes);
+
+  std::vector<PoolVector<SelectorComponentObj>> weaveParents(
+    PoolVector<SelectorComponentObj> parents1,
+    PoolVector<SelectorComponentObj> parents2);
+
+  // Complexity budget for the weave helpers above (thread local,
+  // see the extend_budget option): setting a budget also resets
+  // the spent and truncated state, zero disables the guard. When
+  // the helpers have produced budget many woven combinations they
+  // stop and keep whatever was generated so far, so pathological
+  // @extend inputs degrade to an approximate result instead of a
+  // combinatorial hang
+  void setWeaveBudget(size_t budget);
+  bool weaveBudgetExhausted();
+  bool weaveTruncated();
+
+  // Cooperative cancellation hook for the same helpers (thread
+  // local like the budget): the poll is invoked every few hundred
+  // woven combinations with the given cookie and may throw to
+  // abort the weave. Installed per compile next to the budget
+  // (see the compile_budget option), NULL disables it
+  void setWeavePoll(void (*poll)(void*), void* cookie);
+
+  PoolVector<SimpleSelectorObj> unifyCompound(
+    const PoolVector<SimpleSelectorObj>& compound1,
+    const PoolVector<SimpleSelectorObj>& compound2);
+
+  std::vector<PoolVector<SelectorComponentObj>> unifyComplex(
+    const std::vector<PoolVector<SelectorComponentObj>>& complexes);
 
   /////////////////////////////////////////
   // Abstract base class for CSS selectors.
@@ -268,6 +286,11 @@ namespace Sass {
     ADD_PROPERTY(bool, chroots)
     // line break before list separator
     ADD_PROPERTY(bool, hasPreLineFeed)
+    // memoized specificity bounds (npos = not yet computed);
+    // complex selectors are immutable by the time the extender's
+    // trim and source-specificity logic queries these repeatedly
+    mutable size_t max_specificity_;
+    mutable size_t min_specificity_;
   public:
     ComplexSelector(ParserState pstate);
 
@@ -429,7 +452,7 @@ namespace Sass {
     void cloneChildren() override;
     bool has_real_parent_ref() const override;
     bool has_placeholder() const override;
-    std::vector<ComplexSelectorObj> resolve_parent_refs(SelectorStack pstack, Backtraces& traces, bool implicit_parent = true);
+    PoolVector<ComplexSelectorObj> resolve_parent_refs(SelectorStack pstack, Backtraces& traces, bool implicit_parent = true);
 
     virtual bool isCompound() const override { return true; };
     virtual unsigned long specificity() const override;
@@ -458,8 +481,24 @@ namespace Sass {
     // maybe we have optional flag
     // ToDo: should be at ExtendRule?
     ADD_PROPERTY(bool, is_optional)
+    // memoized serialization; selector lists are stringified
+    // repeatedly outside the main emission (error messages,
+    // selector functions, extend bookkeeping), each time through
+    // a fresh Emitter/Inspect pair. Keyed by hash() plus the
+    // inspect options, mirroring the color render cache; filled
+    // and consulted by AST_Node::to_string.
+    mutable std::string to_string_cache_;
+    mutable size_t to_string_key_;
   public:
     SelectorList(ParserState pstate, size_t s = 0);
+
+    const std::string* cached_to_string(size_t key) const {
+      if (key && to_string_key_ == key) return &to_string_cache_;
+      return nullptr;
+    }
+    void cache_to_string(size_t key, const std::string& res) const {
+      to_string_cache_ = res; to_string_key_ = key;
+    }
     std::string type() const override { return "list"; }
     size_t hash() const override;
 
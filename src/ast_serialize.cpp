@@ -0,0 +1,1111 @@
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+#include "ast.hpp"
+
+#include <cstring>
+#include <unordered_map>
+
+#include "ast_serialize.hpp"
+#include "context.hpp"
+#include "parser.hpp"
+#include "file.hpp"
+
+namespace Sass {
+
+  namespace {
+
+    // artifact layout: magic, version, endianness probe, flag byte,
+    // content hash and source length, then one recursive node stream.
+    // bump the version whenever a node record changes shape; readers
+    // reject everything they were not built for
+    const char AST_MAGIC[4] = { 'L', 'S', 'A', 'C' };
+    const uint16_t AST_VERSION = 2;
+    const uint16_t AST_ENDIAN = 0xFEFF;
+    const size_t AST_MAX_DEPTH = 512;
+
+    enum AstTag : uint8_t {
+      TAG_NONE = 0,
+      // statements
+      TAG_BLOCK,
+      TAG_RULESET,
+      TAG_DECLARATION,
+      TAG_ASSIGNMENT,
+      TAG_COMMENT,
+      TAG_IMPORT,
+      TAG_IMPORT_STUB,
+      TAG_IF,
+      TAG_FOR,
+      TAG_EACH,
+      TAG_WHILE,
+      TAG_RETURN,
+      TAG_WARNING,
+      TAG_ERROR,
+      TAG_DEBUG,
+      TAG_DEFINITION,
+      TAG_MIXIN_CALL,
+      TAG_CONTENT,
+      TAG_MEDIA_RULE,
+      TAG_DIRECTIVE,
+      TAG_EXTEND_RULE,
+      // expressions
+      TAG_STRING_QUOTED,
+      TAG_STRING_CONSTANT,
+      TAG_STRING_SCHEMA,
+      TAG_NUMBER,
+      TAG_COLOR_RGBA,
+      TAG_BOOLEAN,
+      TAG_NULL,
+      TAG_LIST,
+      TAG_MAP,
+      TAG_VARIABLE,
+      TAG_BINARY,
+      TAG_UNARY,
+      TAG_FUNCTION_CALL,
+      TAG_MEDIA_QUERY,
+      TAG_MEDIA_QUERY_EXPR,
+      TAG_ARGUMENT,
+      TAG_ARGUMENTS
+    };
+
+    /////////////////////////////////////////////////////////////////////////
+    // writer: appends fixed-width little-endian scalars and interned
+    // strings to the output buffer; any unsupported node flips ok and
+    // the caller throws the whole buffer away
+    /////////////////////////////////////////////////////////////////////////
+
+    class AstWriter {
+    public:
+      std::vector<char>& buf;
+      const char* src;
+      size_t src_len;
+      bool ok;
+      std::unordered_map<std::string, uint32_t> interned;
+
+      AstWriter(std::vector<char>& buf, const char* src)
+      : buf(buf), src(src), src_len(src ? strlen(src) : 0), ok(true), interned()
+      { }
+
+      void put_raw(const void* p, size_t n)
+      {
+        const char* c = static_cast<const char*>(p);
+        buf.insert(buf.end(), c, c + n);
+      }
+      void put_u8(uint8_t v) { put_raw(&v, 1); }
+      void put_u16(uint16_t v) { put_raw(&v, 2); }
+      void put_u32(uint32_t v) { put_raw(&v, 4); }
+      void put_u64(uint64_t v) { put_raw(&v, 8); }
+      void put_double(double v) { put_raw(&v, 8); }
+
+      // strings are interned: the first occurrence carries the bytes,
+      // repeats carry the id (unit names, property names and the like
+      // repeat heavily in stylesheet code)
+      void put_str(const std::string& s)
+      {
+        auto it = interned.find(s);
+        if (it != interned.end()) {
+          put_u32(it->second * 2 + 1);
+          return;
+        }
+        interned.emplace(s, static_cast<uint32_t>(interned.size()));
+        put_u32(static_cast<uint32_t>(s.size()) * 2);
+        put_raw(s.data(), s.size());
+      }
+
+      void put_pstate(const ParserState& p)
+      {
+        put_u32(p.line);
+        put_u32(p.column);
+        put_u32(p.offset.line);
+        put_u32(p.offset.column);
+      }
+    };
+
+    /////////////////////////////////////////////////////////////////////////
+    // reader: every primitive bounds-checks and latches failure, so a
+    // truncated or corrupted artifact degrades to a null result (and a
+    // fresh parse) instead of undefined behavior
+    /////////////////////////////////////////////////////////////////////////
+
+    class AstReader {
+    public:
+      const char* buf;
+      size_t len;
+      size_t pos;
+      bool ok;
+      size_t depth;
+      std::vector<std::string> table;
+      Context& ctx;
+      const char* path;
+      const char* src;
+      size_t src_len;
+      size_t idx;
+
+      AstReader(const char* buf, size_t len, Context& ctx,
+                const char* path, const char* src, size_t idx)
+      : buf(buf), len(len), pos(0), ok(true), depth(0), table(),
+        ctx(ctx), path(path), src(src),
+        src_len(src ? strlen(src) : 0), idx(idx)
+      { }
+
+      bool need(size_t n)
+      {
+        if (!ok || n > len - pos) { ok = false; return false; }
+        return true;
+      }
+      uint8_t get_u8()
+      {
+        if (!need(1)) return 0;
+        return static_cast<uint8_t>(buf[pos++]);
+      }
+      uint16_t get_u16()
+      {
+        uint16_t v = 0;
+        if (!need(2)) return 0;
+        memcpy(&v, buf + pos, 2); pos += 2;
+        return v;
+      }
+      uint32_t get_u32()
+      {
+        uint32_t v = 0;
+        if (!need(4)) return 0;
+        memcpy(&v, buf + pos, 4); pos += 4;
+        return v;
+      }
+      uint64_t get_u64()
+      {
+        uint64_t v = 0;
+        if (!need(8)) return 0;
+        memcpy(&v, buf + pos, 8); pos += 8;
+        return v;
+      }
+      double get_double()
+      {
+        double v = 0;
+        if (!need(8)) return 0;
+        memcpy(&v, buf + pos, 8); pos += 8;
+        return v;
+      }
+
+      std::string get_str()
+      {
+        uint32_t head = get_u32();
+        if (!ok) return std::string();
+        if (head & 1) {
+          uint32_t id = head >> 1;
+          if (id >= table.size()) { ok = false; return std::string(); }
+          return table[id];
+        }
+        uint32_t n = head >> 1;
+        if (!need(n)) return std::string();
+        std::string s(buf + pos, n); pos += n;
+        table.push_back(s);
+        return s;
+      }
+
+      ParserState get_pstate()
+      {
+        uint32_t line = get_u32();
+        uint32_t column = get_u32();
+        uint32_t oline = get_u32();
+        uint32_t ocol = get_u32();
+        return ParserState(path, src, Position(idx, line, column),
+                           Offset(oline, ocol));
+      }
+
+      bool enter() { if (++depth > AST_MAX_DEPTH) ok = false; return ok; }
+      void leave() { --depth; }
+    };
+
+    /////////////////////////////////////////////////////////////////////////
+    // serialization
+    /////////////////////////////////////////////////////////////////////////
+
+    void write_stmt(AstWriter& w, Statement* s);
+    void write_expr(AstWriter& w, Expression* e);
+
+    // shared expression head: delayed/interpolant are the only base
+    // flags the parser sets; everything else is derived lazily
+    void put_expr_head(AstWriter& w, AstTag tag, Expression* e)
+    {
+      w.put_u8(tag);
+      w.put_pstate(e->pstate());
+      uint8_t flags = 0;
+      if (e->is_delayed()) flags |= 1;
+      if (e->is_interpolant()) flags |= 2;
+      w.put_u8(flags);
+    }
+
+    void write_parameters(AstWriter& w, Parameters* params)
+    {
+      if (params == 0) { w.put_u8(0); return; }
+      w.put_u8(1);
+      w.put_pstate(params->pstate());
+      w.put_u32(static_cast<uint32_t>(params->length()));
+      for (size_t i = 0, L = params->length(); i < L; ++i) {
+        Parameter* p = params->get(i);
+        w.put_pstate(p->pstate());
+        w.put_str(p->name());
+        write_expr(w, p->default_value());
+        w.put_u8(p->is_rest_parameter() ? 1 : 0);
+      }
+    }
+
+    void write_include(AstWriter& w, const Include& inc)
+    {
+      w.put_str(inc.imp_path);
+      w.put_str(inc.ctx_path);
+      w.put_str(inc.abs_path);
+    }
+
+    // selector lists are stored as canonical text and reparsed on
+    // load; schemas (interpolated selectors) keep their string
+    // schema, exactly as the parser left them
+    void write_selector(AstWriter& w, Selector_Schema* schema, SelectorList* list)
+    {
+      if (schema) {
+        w.put_u8(1);
+        w.put_pstate(schema->pstate());
+        write_expr(w, schema->contents());
+        w.put_u8(schema->connect_parent() ? 1 : 0);
+      }
+      else if (list) {
+        w.put_u8(2);
+        w.put_str(list->to_string());
+      }
+      else {
+        w.put_u8(0);
+      }
+    }
+
+    void write_expr(AstWriter& w, Expression* e)
+    {
+      if (!w.ok) return;
+      if (e == 0) { w.put_u8(TAG_NONE); return; }
+      if (String_Quoted* s = Cast<String_Quoted>(e)) {
+        put_expr_head(w, TAG_STRING_QUOTED, e);
+        w.put_str(s->value());
+        w.put_u8(static_cast<uint8_t>(s->quote_mark()));
+      }
+      else if (String_Constant* s = Cast<String_Constant>(e)) {
+        put_expr_head(w, TAG_STRING_CONSTANT, e);
+        w.put_str(s->value());
+        w.put_u8(static_cast<uint8_t>(s->quote_mark()));
+      }
+      else if (String_Schema* s = Cast<String_Schema>(e)) {
+        put_expr_head(w, TAG_STRING_SCHEMA, e);
+        w.put_u8(s->css() ? 1 : 0);
+        w.put_u32(static_cast<uint32_t>(s->length()));
+        for (size_t i = 0, L = s->length(); i < L; ++i) {
+          write_expr(w, s->get(i));
+        }
+      }
+      else if (Number* n = Cast<Number>(e)) {
+        put_expr_head(w, TAG_NUMBER, e);
+        w.put_double(n->value());
+        w.put_u8(n->zero() ? 1 : 0);
+        w.put_u32(static_cast<uint32_t>(n->numerators.size()));
+        for (const auto& u : n->numerators) w.put_str(u);
+        w.put_u32(static_cast<uint32_t>(n->denominators.size()));
+        for (const auto& u : n->denominators) w.put_str(u);
+      }
+      else if (Color_RGBA* c = Cast<Color_RGBA>(e)) {
+        put_expr_head(w, TAG_COLOR_RGBA, e);
+        w.put_double(c->r());
+        w.put_double(c->g());
+        w.put_double(c->b());
+        w.put_double(c->a());
+        w.put_str(c->disp());
+      }
+      else if (Boolean* b = Cast<Boolean>(e)) {
+        put_expr_head(w, TAG_BOOLEAN, e);
+        w.put_u8(b->value() ? 1 : 0);
+      }
+      else if (Cast<Null>(e)) {
+        put_expr_head(w, TAG_NULL, e);
+      }
+      else if (List* l = Cast<List>(e)) {
+        put_expr_head(w, TAG_LIST, e);
+        w.put_u8(static_cast<uint8_t>(l->separator()));
+        uint8_t flags = 0;
+        if (l->is_arglist()) flags |= 1;
+        if (l->is_bracketed()) flags |= 2;
+        w.put_u8(flags);
+        w.put_u32(static_cast<uint32_t>(l->length()));
+        for (size_t i = 0, L = l->length(); i < L; ++i) {
+          write_expr(w, l->get(i));
+        }
+      }
+      else if (Map* m = Cast<Map>(e)) {
+        put_expr_head(w, TAG_MAP, e);
+        w.put_u32(static_cast<uint32_t>(m->length()));
+        const auto& keys = m->keys();
+        const auto& vals = m->values();
+        for (size_t i = 0, L = keys.size(); i < L; ++i) {
+          write_expr(w, keys[i]);
+          write_expr(w, vals[i]);
+        }
+      }
+      else if (Variable* v = Cast<Variable>(e)) {
+        put_expr_head(w, TAG_VARIABLE, e);
+        w.put_str(v->name());
+      }
+      else if (Binary_Expression* b = Cast<Binary_Expression>(e)) {
+        put_expr_head(w, TAG_BINARY, e);
+        w.put_u8(static_cast<uint8_t>(b->op().operand));
+        w.put_u8(b->op().ws_before ? 1 : 0);
+        w.put_u8(b->op().ws_after ? 1 : 0);
+        write_expr(w, b->left());
+        write_expr(w, b->right());
+      }
+      else if (Unary_Expression* u = Cast<Unary_Expression>(e)) {
+        put_expr_head(w, TAG_UNARY, e);
+        w.put_u8(static_cast<uint8_t>(u->optype()));
+        write_expr(w, u->operand());
+      }
+      else if (Function_Call* c = Cast<Function_Call>(e)) {
+        // bound functions and call() markers only appear during
+        // evaluation; a fresh parse never carries them
+        if (!c->func().isNull() || c->cookie() || c->via_call()) {
+          w.ok = false;
+          return;
+        }
+        put_expr_head(w, TAG_FUNCTION_CALL, e);
+        write_expr(w, c->sname());
+        write_expr(w, c->arguments());
+      }
+      else if (Media_Query* q = Cast<Media_Query>(e)) {
+        put_expr_head(w, TAG_MEDIA_QUERY, e);
+        write_expr(w, q->media_type());
+        uint8_t flags = 0;
+        if (q->is_negated()) flags |= 1;
+        if (q->is_restricted()) flags |= 2;
+        w.put_u8(flags);
+        w.put_u32(static_cast<uint32_t>(q->length()));
+        for (size_t i = 0, L = q->length(); i < L; ++i) {
+          write_expr(w, q->get(i));
+        }
+      }
+      else if (Media_Query_Expression* x = Cast<Media_Query_Expression>(e)) {
+        put_expr_head(w, TAG_MEDIA_QUERY_EXPR, e);
+        write_expr(w, x->feature());
+        write_expr(w, x->value());
+        w.put_u8(x->is_interpolated() ? 1 : 0);
+      }
+      else if (Argument* a = Cast<Argument>(e)) {
+        put_expr_head(w, TAG_ARGUMENT, e);
+        write_expr(w, a->value());
+        w.put_str(a->name());
+        uint8_t flags = 0;
+        if (a->is_rest_argument()) flags |= 1;
+        if (a->is_keyword_argument()) flags |= 2;
+        w.put_u8(flags);
+      }
+      else if (Arguments* a = Cast<Arguments>(e)) {
+        put_expr_head(w, TAG_ARGUMENTS, e);
+        w.put_u32(static_cast<uint32_t>(a->length()));
+        for (size_t i = 0, L = a->length(); i < L; ++i) {
+          write_expr(w, a->get(i));
+        }
+      }
+      else {
+        w.ok = false;
+      }
+    }
+
+    void write_block(AstWriter& w, Block* b)
+    {
+      w.put_u8(TAG_BLOCK);
+      w.put_pstate(b->pstate());
+      w.put_u8(b->is_root() ? 1 : 0);
+      w.put_u32(static_cast<uint32_t>(b->length()));
+      for (size_t i = 0, L = b->length(); i < L; ++i) {
+        write_stmt(w, b->get(i));
+        if (!w.ok) return;
+      }
+    }
+
+    void write_stmt(AstWriter& w, Statement* s)
+    {
+      if (!w.ok) return;
+      if (s == 0) { w.put_u8(TAG_NONE); return; }
+      if (Block* b = Cast<Block>(s)) {
+        write_block(w, b);
+      }
+      else if (Ruleset* r = Cast<Ruleset>(s)) {
+        w.put_u8(TAG_RULESET);
+        w.put_pstate(r->pstate());
+        w.put_u8(r->is_root() ? 1 : 0);
+        write_selector(w, r->schema(), r->selector());
+        write_stmt(w, r->block());
+      }
+      else if (Declaration* d = Cast<Declaration>(s)) {
+        w.put_u8(TAG_DECLARATION);
+        w.put_pstate(d->pstate());
+        write_expr(w, d->property());
+        write_expr(w, d->value());
+        uint8_t flags = 0;
+        if (d->is_important()) flags |= 1;
+        if (d->is_custom_property()) flags |= 2;
+        if (d->is_indented()) flags |= 4;
+        w.put_u8(flags);
+        write_stmt(w, d->block());
+      }
+      else if (Assignment* a = Cast<Assignment>(s)) {
+        w.put_u8(TAG_ASSIGNMENT);
+        w.put_pstate(a->pstate());
+        w.put_str(a->variable());
+        write_expr(w, a->value());
+        uint8_t flags = 0;
+        if (a->is_default()) flags |= 1;
+        if (a->is_global()) flags |= 2;
+        w.put_u8(flags);
+      }
+      else if (Comment* c = Cast<Comment>(s)) {
+        w.put_u8(TAG_COMMENT);
+        w.put_pstate(c->pstate());
+        write_expr(w, c->text());
+        w.put_u8(c->is_important() ? 1 : 0);
+      }
+      else if (Import* i = Cast<Import>(s)) {
+        w.put_u8(TAG_IMPORT);
+        w.put_pstate(i->pstate());
+        w.put_u32(static_cast<uint32_t>(i->urls().size()));
+        for (const auto& url : i->urls()) write_expr(w, url);
+        w.put_u32(static_cast<uint32_t>(i->incs().size()));
+        for (const auto& inc : i->incs()) write_include(w, inc);
+        write_expr(w, i->import_queries());
+      }
+      else if (Import_Stub* i = Cast<Import_Stub>(s)) {
+        w.put_u8(TAG_IMPORT_STUB);
+        w.put_pstate(i->pstate());
+        write_include(w, i->resource());
+      }
+      else if (If* i = Cast<If>(s)) {
+        w.put_u8(TAG_IF);
+        w.put_pstate(i->pstate());
+        write_expr(w, i->predicate());
+        write_stmt(w, i->block());
+        write_stmt(w, i->alternative());
+      }
+      else if (For* f = Cast<For>(s)) {
+        w.put_u8(TAG_FOR);
+        w.put_pstate(f->pstate());
+        w.put_str(f->variable());
+        write_expr(w, f->lower_bound());
+        write_expr(w, f->upper_bound());
+        w.put_u8(f->is_inclusive() ? 1 : 0);
+        write_stmt(w, f->block());
+      }
+      else if (Each* e = Cast<Each>(s)) {
+        w.put_u8(TAG_EACH);
+        w.put_pstate(e->pstate());
+        w.put_u32(static_cast<uint32_t>(e->variables().size()));
+        for (const auto& var : e->variables()) w.put_str(var);
+        write_expr(w, e->list());
+        write_stmt(w, e->block());
+      }
+      else if (While* wh = Cast<While>(s)) {
+        w.put_u8(TAG_WHILE);
+        w.put_pstate(wh->pstate());
+        write_expr(w, wh->predicate());
+        write_stmt(w, wh->block());
+      }
+      else if (Return* r = Cast<Return>(s)) {
+        w.put_u8(TAG_RETURN);
+        w.put_pstate(r->pstate());
+        write_expr(w, r->value());
+      }
+      else if (Warning* x = Cast<Warning>(s)) {
+        w.put_u8(TAG_WARNING);
+        w.put_pstate(x->pstate());
+        write_expr(w, x->message());
+      }
+      else if (Error* x = Cast<Error>(s)) {
+        w.put_u8(TAG_ERROR);
+        w.put_pstate(x->pstate());
+        write_expr(w, x->message());
+      }
+      else if (Debug* x = Cast<Debug>(s)) {
+        w.put_u8(TAG_DEBUG);
+        w.put_pstate(x->pstate());
+        write_expr(w, x->value());
+      }
+      else if (Definition* d = Cast<Definition>(s)) {
+        // native and c bindings are injected at context setup, not
+        // parsed from source; refuse them to be safe
+        if (d->native_function() || d->c_function()) {
+          w.ok = false;
+          return;
+        }
+        w.put_u8(TAG_DEFINITION);
+        w.put_pstate(d->pstate());
+        w.put_str(d->name());
+        w.put_u8(d->type() == Definition::MIXIN ? 0 : 1);
+        write_parameters(w, d->parameters());
+        write_stmt(w, d->block());
+      }
+      else if (Mixin_Call* c = Cast<Mixin_Call>(s)) {
+        w.put_u8(TAG_MIXIN_CALL);
+        w.put_pstate(c->pstate());
+        w.put_str(c->name());
+        write_expr(w, c->arguments());
+        write_parameters(w, c->block_parameters());
+        write_stmt(w, c->block());
+      }
+      else if (Content* c = Cast<Content>(s)) {
+        w.put_u8(TAG_CONTENT);
+        w.put_pstate(c->pstate());
+        write_expr(w, c->arguments());
+      }
+      else if (MediaRule* m = Cast<MediaRule>(s)) {
+        w.put_u8(TAG_MEDIA_RULE);
+        w.put_pstate(m->pstate());
+        write_expr(w, m->schema());
+        write_stmt(w, m->block());
+      }
+      else if (Directive* d = Cast<Directive>(s)) {
+        // a selector on a directive only appears on rewritten nodes
+        if (!d->selector().isNull()) { w.ok = false; return; }
+        w.put_u8(TAG_DIRECTIVE);
+        w.put_pstate(d->pstate());
+        w.put_str(d->keyword());
+        write_expr(w, d->value());
+        write_stmt(w, d->block());
+      }
+      else if (ExtendRule* x = Cast<ExtendRule>(s)) {
+        w.put_u8(TAG_EXTEND_RULE);
+        w.put_pstate(x->pstate());
+        w.put_u8(x->isOptional() ? 1 : 0);
+        write_selector(w, x->schema(), x->selector());
+      }
+      else {
+        // @supports, @at-root and anything rewritten post-parse
+        // are not covered by this format version
+        w.ok = false;
+      }
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+    // deserialization
+    /////////////////////////////////////////////////////////////////////////
+
+    Statement_Obj read_stmt(AstReader& r);
+    Expression_Obj read_expr(AstReader& r);
+
+    Block_Obj read_block_obj(AstReader& r)
+    {
+      Statement_Obj s = read_stmt(r);
+      if (s.isNull()) return {};
+      Block_Obj b = Cast<Block>(s);
+      if (b.isNull()) r.ok = false;
+      return b;
+    }
+
+    Parameters_Obj read_parameters(AstReader& r)
+    {
+      if (r.get_u8() == 0) return {};
+      ParserState ps = r.get_pstate();
+      Parameters_Obj params = SASS_MEMORY_NEW(Parameters, ps);
+      uint32_t n = r.get_u32();
+      for (uint32_t i = 0; i < n && r.ok; ++i) {
+        ParserState pps = r.get_pstate();
+        std::string name(r.get_str());
+        Expression_Obj def = read_expr(r);
+        bool rest = r.get_u8() != 0;
+        if (!r.ok) break;
+        params->append(SASS_MEMORY_NEW(Parameter, pps, name, def, rest));
+      }
+      return params;
+    }
+
+    Include read_include(AstReader& r)
+    {
+      std::string imp(r.get_str());
+      std::string ctx_path(r.get_str());
+      std::string abs(r.get_str());
+      // the artifact embeds resolved paths; when a target moved or
+      // disappeared the cached tree is stale for this machine
+      if (r.ok && !File::file_exists(abs)) r.ok = false;
+      return Include(Importer(imp, ctx_path), abs);
+    }
+
+    // rebuild a selector as the parser would have left it: either
+    // the stored schema, or the canonical text reparsed into a list.
+    // chroot mirrors the parseSelectorList argument of the original
+    // parse site (@extend targets never take an implicit parent)
+    void read_selector(AstReader& r, Selector_Schema_Obj& schema,
+                       SelectorListObj& list, ParserState pstate,
+                       bool chroot)
+    {
+      uint8_t kind = r.get_u8();
+      if (kind == 1) {
+        ParserState sps = r.get_pstate();
+        Expression_Obj contents = read_expr(r);
+        bool connect = r.get_u8() != 0;
+        String_Obj str = Cast<String>(contents);
+        if (str.isNull()) { r.ok = false; return; }
+        schema = SASS_MEMORY_NEW(Selector_Schema, sps, str);
+        schema->connect_parent(connect);
+        list = SASS_MEMORY_NEW(SelectorList, pstate);
+      }
+      else if (kind == 2) {
+        std::string text(r.get_str());
+        if (!r.ok) return;
+        // the reparsed nodes keep pointing into this buffer, so it
+        // lives with the context like every parsed source
+        char* durable = sass_copy_c_string(text.c_str());
+        r.ctx.strings.push_back(durable);
+        list = Parser::parse_selector(durable, r.ctx, r.ctx.traces,
+                                      pstate, durable, true);
+        if (list.isNull()) { r.ok = false; return; }
+        // parse_selector parses without chroot; restore the flag
+        // the way parseSelectorList would have set it
+        for (size_t i = 0, L = list->length(); i < L; ++i) {
+          ComplexSelectorObj complex = list->get(i);
+          complex->chroots(complex->has_real_parent_ref() || chroot);
+        }
+      }
+      else if (kind != 0) {
+        r.ok = false;
+      }
+    }
+
+    Expression_Obj read_expr(AstReader& r)
+    {
+      if (!r.enter()) return {};
+      uint8_t tag = r.get_u8();
+      if (!r.ok || tag == TAG_NONE) { r.leave(); return {}; }
+      ParserState ps = r.get_pstate();
+      uint8_t flags = r.get_u8();
+      Expression_Obj e;
+      switch (tag) {
+        case TAG_STRING_QUOTED: {
+          std::string val(r.get_str());
+          char q = static_cast<char>(r.get_u8());
+          String_Quoted* s = SASS_MEMORY_NEW(String_Quoted, ps,
+            "", 0, false, true);
+          s->value(val);
+          s->quote_mark(q);
+          e = s;
+        } break;
+        case TAG_STRING_CONSTANT: {
+          std::string val(r.get_str());
+          char q = static_cast<char>(r.get_u8());
+          String_Constant* s = SASS_MEMORY_NEW(String_Constant, ps, "");
+          s->value(val);
+          s->quote_mark(q);
+          e = s;
+        } break;
+        case TAG_STRING_SCHEMA: {
+          bool css = r.get_u8() != 0;
+          uint32_t n = r.get_u32();
+          String_Schema* s = SASS_MEMORY_NEW(String_Schema, ps, 0, css);
+          for (uint32_t i = 0; i < n && r.ok; ++i) {
+            Expression_Obj el = read_expr(r);
+            PreValue_Obj pv = Cast<PreValue>(el);
+            if (pv.isNull()) { r.ok = false; break; }
+            s->append(pv);
+          }
+          e = s;
+        } break;
+        case TAG_NUMBER: {
+          double val = r.get_double();
+          bool zero = r.get_u8() != 0;
+          Number* n = SASS_MEMORY_NEW(Number, ps, val, "", zero);
+          uint32_t nn = r.get_u32();
+          for (uint32_t i = 0; i < nn && r.ok; ++i) {
+            n->numerators.push_back(r.get_str());
+          }
+          uint32_t nd = r.get_u32();
+          for (uint32_t i = 0; i < nd && r.ok; ++i) {
+            n->denominators.push_back(r.get_str());
+          }
+          e = n;
+        } break;
+        case TAG_COLOR_RGBA: {
+          double cr = r.get_double();
+          double cg = r.get_double();
+          double cb = r.get_double();
+          double ca = r.get_double();
+          std::string disp(r.get_str());
+          e = SASS_MEMORY_NEW(Color_RGBA, ps, cr, cg, cb, ca, disp);
+        } break;
+        case TAG_BOOLEAN: {
+          e = SASS_MEMORY_NEW(Boolean, ps, r.get_u8() != 0);
+        } break;
+        case TAG_NULL: {
+          e = SASS_MEMORY_NEW(Null, ps);
+        } break;
+        case TAG_LIST: {
+          uint8_t sep = r.get_u8();
+          uint8_t lflags = r.get_u8();
+          uint32_t n = r.get_u32();
+          if (sep > SASS_HASH) { r.ok = false; break; }
+          List* l = SASS_MEMORY_NEW(List, ps, n,
+            static_cast<enum Sass_Separator>(sep),
+            (lflags & 1) != 0, (lflags & 2) != 0);
+          for (uint32_t i = 0; i < n && r.ok; ++i) {
+            Expression_Obj el = read_expr(r);
+            if (!r.ok || el.isNull()) { r.ok = false; break; }
+            l->append(el);
+          }
+          e = l;
+        } break;
+        case TAG_MAP: {
+          uint32_t n = r.get_u32();
+          Map* m = SASS_MEMORY_NEW(Map, ps, n);
+          for (uint32_t i = 0; i < n && r.ok; ++i) {
+            Expression_Obj key = read_expr(r);
+            Expression_Obj val = read_expr(r);
+            if (key.isNull() || val.isNull()) { r.ok = false; break; }
+            *m << std::make_pair(key, val);
+          }
+          e = m;
+        } break;
+        case TAG_VARIABLE: {
+          e = SASS_MEMORY_NEW(Variable, ps, r.get_str());
+        } break;
+        case TAG_BINARY: {
+          uint8_t op = r.get_u8();
+          bool ws_before = r.get_u8() != 0;
+          bool ws_after = r.get_u8() != 0;
+          Expression_Obj lhs = read_expr(r);
+          Expression_Obj rhs = read_expr(r);
+          if (op >= NUM_OPS || lhs.isNull() || rhs.isNull()) {
+            r.ok = false; break;
+          }
+          e = SASS_MEMORY_NEW(Binary_Expression, ps,
+            Operand(static_cast<enum Sass_OP>(op), ws_before, ws_after),
+            lhs, rhs);
+        } break;
+        case TAG_UNARY: {
+          uint8_t op = r.get_u8();
+          Expression_Obj operand = read_expr(r);
+          if (op > Unary_Expression::SLASH || operand.isNull()) {
+            r.ok = false; break;
+          }
+          e = SASS_MEMORY_NEW(Unary_Expression, ps,
+            static_cast<Unary_Expression::Type>(op), operand);
+        } break;
+        case TAG_FUNCTION_CALL: {
+          Expression_Obj sname = read_expr(r);
+          Expression_Obj args = read_expr(r);
+          String_Obj name = Cast<String>(sname);
+          Arguments_Obj arguments = Cast<Arguments>(args);
+          if (name.isNull() || arguments.isNull()) { r.ok = false; break; }
+          e = SASS_MEMORY_NEW(Function_Call, ps, name, arguments);
+        } break;
+        case TAG_MEDIA_QUERY: {
+          Expression_Obj type = read_expr(r);
+          uint8_t qflags = r.get_u8();
+          uint32_t n = r.get_u32();
+          String_Obj t = Cast<String>(type);
+          if (!type.isNull() && t.isNull()) { r.ok = false; break; }
+          Media_Query* q = SASS_MEMORY_NEW(Media_Query, ps, t, n,
+            (qflags & 1) != 0, (qflags & 2) != 0);
+          for (uint32_t i = 0; i < n && r.ok; ++i) {
+            Expression_Obj el = read_expr(r);
+            Media_Query_Expression_Obj mqe = Cast<Media_Query_Expression>(el);
+            if (mqe.isNull()) { r.ok = false; break; }
+            q->append(mqe);
+          }
+          e = q;
+        } break;
+        case TAG_MEDIA_QUERY_EXPR: {
+          Expression_Obj feature = read_expr(r);
+          Expression_Obj value = read_expr(r);
+          bool interpolated = r.get_u8() != 0;
+          e = SASS_MEMORY_NEW(Media_Query_Expression, ps,
+            feature, value, interpolated);
+        } break;
+        case TAG_ARGUMENT: {
+          Expression_Obj val = read_expr(r);
+          std::string name(r.get_str());
+          uint8_t aflags = r.get_u8();
+          if (val.isNull()) { r.ok = false; break; }
+          e = SASS_MEMORY_NEW(Argument, ps, val, name,
+            (aflags & 1) != 0, (aflags & 2) != 0);
+        } break;
+        case TAG_ARGUMENTS: {
+          uint32_t n = r.get_u32();
+          Arguments* a = SASS_MEMORY_NEW(Arguments, ps);
+          for (uint32_t i = 0; i < n && r.ok; ++i) {
+            Expression_Obj el = read_expr(r);
+            Argument_Obj arg = Cast<Argument>(el);
+            if (arg.isNull()) { r.ok = false; break; }
+            a->append(arg);
+          }
+          e = a;
+        } break;
+        default:
+          r.ok = false;
+          break;
+      }
+      r.leave();
+      if (!r.ok || e.isNull()) { r.ok = false; return {}; }
+      e->is_delayed((flags & 1) != 0);
+      e->is_interpolant((flags & 2) != 0);
+      return e;
+    }
+
+    Statement_Obj read_stmt(AstReader& r)
+    {
+      if (!r.enter()) return {};
+      uint8_t tag = r.get_u8();
+      if (!r.ok || tag == TAG_NONE) { r.leave(); return {}; }
+      ParserState ps = r.get_pstate();
+      Statement_Obj result;
+      switch (tag) {
+        case TAG_BLOCK: {
+          bool is_root = r.get_u8() != 0;
+          uint32_t n = r.get_u32();
+          Block_Obj b = SASS_MEMORY_NEW(Block, ps, n, is_root);
+          for (uint32_t i = 0; i < n && r.ok; ++i) {
+            Statement_Obj child = read_stmt(r);
+            if (!r.ok || child.isNull()) { r.ok = false; break; }
+            b->append(child);
+          }
+          result = b;
+        } break;
+        case TAG_RULESET: {
+          bool is_root = r.get_u8() != 0;
+          Selector_Schema_Obj schema;
+          SelectorListObj list;
+          read_selector(r, schema, list, ps, false);
+          Block_Obj b = read_block_obj(r);
+          if (!r.ok || b.isNull()) { r.ok = false; break; }
+          Ruleset_Obj rs = SASS_MEMORY_NEW(Ruleset, ps, list, b);
+          if (schema) rs->schema(schema);
+          rs->is_root(is_root);
+          result = rs;
+        } break;
+        case TAG_DECLARATION: {
+          Expression_Obj prop = read_expr(r);
+          Expression_Obj val = read_expr(r);
+          uint8_t flags = r.get_u8();
+          Statement_Obj blk = read_stmt(r);
+          String_Obj property = Cast<String>(prop);
+          Block_Obj b = Cast<Block>(blk);
+          if (property.isNull() || (!blk.isNull() && b.isNull())) {
+            r.ok = false; break;
+          }
+          Declaration_Obj d = SASS_MEMORY_NEW(Declaration, ps,
+            property, val, (flags & 1) != 0, (flags & 2) != 0, b);
+          d->is_indented((flags & 4) != 0);
+          result = d;
+        } break;
+        case TAG_ASSIGNMENT: {
+          std::string var(r.get_str());
+          Expression_Obj val = read_expr(r);
+          uint8_t flags = r.get_u8();
+          if (val.isNull()) { r.ok = false; break; }
+          result = SASS_MEMORY_NEW(Assignment, ps, var, val,
+            (flags & 1) != 0, (flags & 2) != 0);
+        } break;
+        case TAG_COMMENT: {
+          Expression_Obj text = read_expr(r);
+          bool important = r.get_u8() != 0;
+          String_Obj str = Cast<String>(text);
+          if (str.isNull()) { r.ok = false; break; }
+          result = SASS_MEMORY_NEW(Comment, ps, str, important);
+        } break;
+        case TAG_IMPORT: {
+          Import_Obj imp = SASS_MEMORY_NEW(Import, ps);
+          uint32_t nurls = r.get_u32();
+          for (uint32_t i = 0; i < nurls && r.ok; ++i) {
+            Expression_Obj url = read_expr(r);
+            if (!r.ok || url.isNull()) { r.ok = false; break; }
+            imp->urls().push_back(url);
+          }
+          uint32_t nincs = r.get_u32();
+          for (uint32_t i = 0; i < nincs && r.ok; ++i) {
+            imp->incs().push_back(read_include(r));
+          }
+          Expression_Obj queries = read_expr(r);
+          List_Obj ql = Cast<List>(queries);
+          if (!queries.isNull() && ql.isNull()) { r.ok = false; break; }
+          imp->import_queries(ql);
+          result = imp;
+        } break;
+        case TAG_IMPORT_STUB: {
+          Include inc = read_include(r);
+          if (!r.ok) break;
+          result = SASS_MEMORY_NEW(Import_Stub, ps, inc);
+        } break;
+        case TAG_IF: {
+          Expression_Obj pred = read_expr(r);
+          Block_Obj con = read_block_obj(r);
+          Statement_Obj alt = read_stmt(r);
+          Block_Obj alt_b = Cast<Block>(alt);
+          if (pred.isNull() || con.isNull() ||
+              (!alt.isNull() && alt_b.isNull())) {
+            r.ok = false; break;
+          }
+          result = SASS_MEMORY_NEW(If, ps, pred, con, alt_b);
+        } break;
+        case TAG_FOR: {
+          std::string var(r.get_str());
+          Expression_Obj lo = read_expr(r);
+          Expression_Obj hi = read_expr(r);
+          bool inclusive = r.get_u8() != 0;
+          Block_Obj b = read_block_obj(r);
+          if (lo.isNull() || hi.isNull() || b.isNull()) {
+            r.ok = false; break;
+          }
+          result = SASS_MEMORY_NEW(For, ps, var, lo, hi, b, inclusive);
+        } break;
+        case TAG_EACH: {
+          uint32_t nvars = r.get_u32();
+          std::vector<std::string> vars;
+          for (uint32_t i = 0; i < nvars && r.ok; ++i) {
+            vars.push_back(r.get_str());
+          }
+          Expression_Obj list = read_expr(r);
+          Block_Obj b = read_block_obj(r);
+          if (list.isNull() || b.isNull()) { r.ok = false; break; }
+          result = SASS_MEMORY_NEW(Each, ps, vars, list, b);
+        } break;
+        case TAG_WHILE: {
+          Expression_Obj pred = read_expr(r);
+          Block_Obj b = read_block_obj(r);
+          if (pred.isNull() || b.isNull()) { r.ok = false; break; }
+          result = SASS_MEMORY_NEW(While, ps, pred, b);
+        } break;
+        case TAG_RETURN: {
+          Expression_Obj val = read_expr(r);
+          if (val.isNull()) { r.ok = false; break; }
+          result = SASS_MEMORY_NEW(Return, ps, val);
+        } break;
+        case TAG_WARNING: {
+          Expression_Obj msg = read_expr(r);
+          if (msg.isNull()) { r.ok = false; break; }
+          result = SASS_MEMORY_NEW(Warning, ps, msg);
+        } break;
+        case TAG_ERROR: {
+          Expression_Obj msg = read_expr(r);
+          if (msg.isNull()) { r.ok = false; break; }
+          result = SASS_MEMORY_NEW(Error, ps, msg);
+        } break;
+        case TAG_DEBUG: {
+          Expression_Obj val = read_expr(r);
+          if (val.isNull()) { r.ok = false; break; }
+          result = SASS_MEMORY_NEW(Debug, ps, val);
+        } break;
+        case TAG_DEFINITION: {
+          std::string name(r.get_str());
+          uint8_t type = r.get_u8();
+          Parameters_Obj params = read_parameters(r);
+          Block_Obj b = read_block_obj(r);
+          if (type > 1 || b.isNull()) { r.ok = false; break; }
+          result = SASS_MEMORY_NEW(Definition, ps, name, params, b,
+            type == 0 ? Definition::MIXIN : Definition::FUNCTION);
+        } break;
+        case TAG_MIXIN_CALL: {
+          std::string name(r.get_str());
+          Expression_Obj args = read_expr(r);
+          Parameters_Obj params = read_parameters(r);
+          Statement_Obj blk = read_stmt(r);
+          Arguments_Obj arguments = Cast<Arguments>(args);
+          Block_Obj b = Cast<Block>(blk);
+          if ((!args.isNull() && arguments.isNull()) ||
+              (!blk.isNull() && b.isNull())) {
+            r.ok = false; break;
+          }
+          result = SASS_MEMORY_NEW(Mixin_Call, ps, name,
+            arguments, params, b);
+        } break;
+        case TAG_CONTENT: {
+          Expression_Obj args = read_expr(r);
+          Arguments_Obj arguments = Cast<Arguments>(args);
+          if (!args.isNull() && arguments.isNull()) { r.ok = false; break; }
+          result = SASS_MEMORY_NEW(Content, ps, arguments);
+        } break;
+        case TAG_MEDIA_RULE: {
+          Expression_Obj schema = read_expr(r);
+          Block_Obj b = read_block_obj(r);
+          List_Obj sl = Cast<List>(schema);
+          if ((!schema.isNull() && sl.isNull()) || b.isNull()) {
+            r.ok = false; break;
+          }
+          MediaRule_Obj m = SASS_MEMORY_NEW(MediaRule, ps, b);
+          m->schema(sl);
+          result = m;
+        } break;
+        case TAG_DIRECTIVE: {
+          std::string keyword(r.get_str());
+          Expression_Obj val = read_expr(r);
+          Statement_Obj blk = read_stmt(r);
+          Block_Obj b = Cast<Block>(blk);
+          if (!blk.isNull() && b.isNull()) { r.ok = false; break; }
+          result = SASS_MEMORY_NEW(Directive, ps, keyword, {}, b, val);
+        } break;
+        case TAG_EXTEND_RULE: {
+          bool optional = r.get_u8() != 0;
+          Selector_Schema_Obj schema;
+          SelectorListObj list;
+          read_selector(r, schema, list, ps, true);
+          if (!r.ok) break;
+          ExtendRule_Obj x;
+          if (schema) x = SASS_MEMORY_NEW(ExtendRule, ps, schema);
+          else if (list) x = SASS_MEMORY_NEW(ExtendRule, ps, list);
+          else { r.ok = false; break; }
+          x->isOptional(optional);
+          result = x;
+        } break;
+        default:
+          r.ok = false;
+          break;
+      }
+      r.leave();
+      if (!r.ok) return {};
+      return result;
+    }
+
+  }
+  // EO anonymous namespace
+
+  bool serialize_ast(Block* root, const char* contents,
+                     size_t content_hash, bool has_placeholders,
+                     std::vector<char>& out)
+  {
+    if (root == 0) return false;
+    out.clear();
+    AstWriter w(out, contents);
+    w.put_raw(AST_MAGIC, 4);
+    w.put_u16(AST_VERSION);
+    w.put_u16(AST_ENDIAN);
+    w.put_u8(has_placeholders ? 1 : 0);
+    w.put_u64(static_cast<uint64_t>(content_hash));
+    w.put_u64(w.src_len);
+    write_block(w, root);
+    if (!w.ok) out.clear();
+    return w.ok;
+  }
+
+  Block_Obj deserialize_ast(const char* buf, size_t len,
+                            size_t content_hash, Context& ctx,
+                            const char* path, const char* contents,
+                            size_t idx, bool& has_placeholders)
+  {
+    if (buf == 0 || len < 25) return {};
+    AstReader r(buf, len, ctx, path, contents, idx);
+    char magic[4];
+    memcpy(magic, buf, 4); r.pos = 4;
+    if (memcmp(magic, AST_MAGIC, 4) != 0) return {};
+    if (r.get_u16() != AST_VERSION) return {};
+    if (r.get_u16() != AST_ENDIAN) return {};
+    bool placeholders = r.get_u8() != 0;
+    if (r.get_u64() != static_cast<uint64_t>(content_hash)) return {};
+    if (r.get_u64() != static_cast<uint64_t>(r.src_len)) return {};
+    Block_Obj root;
+    // selector reparsing may throw on a text the current parser no
+    // longer accepts; a stale artifact must never fail the compile
+    try { root = read_block_obj(r); }
+    catch (...) { return {}; }
+    if (!r.ok || r.pos != r.len || root.isNull()) return {};
+    has_placeholders = placeholders;
+    return root;
+  }
+
+}
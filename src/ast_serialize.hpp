@@ -0,0 +1,45 @@
+#ifndef SASS_AST_SERIALIZE_H
+#define SASS_AST_SERIALIZE_H
+
+#include <string>
+#include <vector>
+
+#include "ast_fwd_decl.hpp"
+
+namespace Sass {
+
+  class Context;
+
+  // Versioned binary codec for freshly parsed Block trees, backing
+  // the on-disk ast cache (see the ast_cache_dir option). The format
+  // is a flat tagged node stream with an interned string table;
+  // parser states are stored as offsets into the source buffer and
+  // rebuilt against the live path/contents of the loading compile,
+  // so errors and warnings keep their exact positions.
+  //
+  // The first format version covers the statement and expression
+  // kinds the parser emits for stylesheet code; selector lists are
+  // stored in canonical text form and reparsed on load (a small
+  // fraction of a file's parse cost). serialize_ast returns false
+  // when the tree contains anything the format does not cover
+  // (bound native functions, @supports, @at-root); callers then
+  // simply keep the parse result uncached.
+  bool serialize_ast(Block* root, const char* contents,
+                     size_t content_hash, bool has_placeholders,
+                     std::vector<char>& out);
+
+  // Rebuild a tree from a serialized buffer. path and contents
+  // describe the live source the rebuilt parser states point into
+  // and idx its resource index; has_placeholders replays the flag
+  // recorded at serialization time. Returns {} when the buffer is
+  // malformed, from a different format version, was written for
+  // different source contents, or references import targets that
+  // no longer exist on disk.
+  Block_Obj deserialize_ast(const char* buf, size_t len,
+                            size_t content_hash, Context& ctx,
+                            const char* path, const char* contents,
+                            size_t idx, bool& has_placeholders);
+
+}
+
+#endif
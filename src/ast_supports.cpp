@@ -32,15 +32,31 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////
 
   Supports_Operator::Supports_Operator(ParserState pstate, Supports_Condition_Obj l, Supports_Condition_Obj r, Operand o)
-  : Supports_Condition(pstate), left_(l), right_(r), operand_(o)
+  : Supports_Condition(pstate), left_(l), right_(r), operand_(o), hash_(0)
   { }
   Supports_Operator::Supports_Operator(const Supports_Operator* ptr)
   : Supports_Condition(ptr),
     left_(ptr->left_),
     right_(ptr->right_),
-    operand_(ptr->operand_)
+    operand_(ptr->operand_),
+    hash_(0)
   { }
 
+  size_t Supports_Operator::hash() const
+  {
+    if (hash_ == 0) {
+      size_t l = left_ ? left_->hash() : 0;
+      size_t r = right_ ? right_->hash() : 0;
+      // zero means a side cannot be told apart, so the
+      // whole condition stays unrecognizable as well
+      if (l == 0 || r == 0) return 0;
+      hash_ = std::hash<size_t>()(operand_ == AND ? 1 : 2);
+      hash_combine(hash_, l);
+      hash_combine(hash_, r);
+    }
+    return hash_;
+  }
+
   bool Supports_Operator::needs_parens(Supports_Condition_Obj cond) const
   {
     if (Supports_Operator_Obj op = Cast<Supports_Operator>(cond)) {
@@ -53,12 +69,23 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////
 
   Supports_Negation::Supports_Negation(ParserState pstate, Supports_Condition_Obj c)
-  : Supports_Condition(pstate), condition_(c)
+  : Supports_Condition(pstate), condition_(c), hash_(0)
   { }
   Supports_Negation::Supports_Negation(const Supports_Negation* ptr)
-  : Supports_Condition(ptr), condition_(ptr->condition_)
+  : Supports_Condition(ptr), condition_(ptr->condition_), hash_(0)
   { }
 
+  size_t Supports_Negation::hash() const
+  {
+    if (hash_ == 0) {
+      size_t c = condition_ ? condition_->hash() : 0;
+      if (c == 0) return 0;
+      hash_ = std::hash<size_t>()(3);
+      hash_combine(hash_, c);
+    }
+    return hash_;
+  }
+
   bool Supports_Negation::needs_parens(Supports_Condition_Obj cond) const
   {
     return Cast<Supports_Negation>(cond) ||
@@ -69,14 +96,28 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////
 
   Supports_Declaration::Supports_Declaration(ParserState pstate, Expression_Obj f, Expression_Obj v)
-  : Supports_Condition(pstate), feature_(f), value_(v)
+  : Supports_Condition(pstate), feature_(f), value_(v), hash_(0)
   { }
   Supports_Declaration::Supports_Declaration(const Supports_Declaration* ptr)
   : Supports_Condition(ptr),
     feature_(ptr->feature_),
-    value_(ptr->value_)
+    value_(ptr->value_),
+    hash_(0)
   { }
 
+  size_t Supports_Declaration::hash() const
+  {
+    if (hash_ == 0) {
+      size_t f = feature_ ? feature_->hash() : 0;
+      size_t v = value_ ? value_->hash() : 0;
+      if (f == 0 || v == 0) return 0;
+      hash_ = std::hash<size_t>()(4);
+      hash_combine(hash_, f);
+      hash_combine(hash_, v);
+    }
+    return hash_;
+  }
+
   bool Supports_Declaration::needs_parens(Supports_Condition_Obj cond) const
   {
     return false;
@@ -86,13 +127,25 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////
 
   Supports_Interpolation::Supports_Interpolation(ParserState pstate, Expression_Obj v)
-  : Supports_Condition(pstate), value_(v)
+  : Supports_Condition(pstate), value_(v), hash_(0)
   { }
   Supports_Interpolation::Supports_Interpolation(const Supports_Interpolation* ptr)
   : Supports_Condition(ptr),
-    value_(ptr->value_)
+    value_(ptr->value_),
+    hash_(0)
   { }
 
+  size_t Supports_Interpolation::hash() const
+  {
+    if (hash_ == 0) {
+      size_t v = value_ ? value_->hash() : 0;
+      if (v == 0) return 0;
+      hash_ = std::hash<size_t>()(5);
+      hash_combine(hash_, v);
+    }
+    return hash_;
+  }
+
   bool Supports_Interpolation::needs_parens(Supports_Condition_Obj cond) const
   {
     return false;
@@ -69,8 +69,10 @@ namespace Sass {
     ADD_PROPERTY(Supports_Condition_Obj, left);
     ADD_PROPERTY(Supports_Condition_Obj, right);
     ADD_PROPERTY(Operand, operand);
+    mutable size_t hash_;
   public:
     Supports_Operator(ParserState pstate, Supports_Condition_Obj l, Supports_Condition_Obj r, Operand o);
+    virtual size_t hash() const override;
     virtual bool needs_parens(Supports_Condition_Obj cond) const override;
     ATTACH_AST_OPERATIONS(Supports_Operator)
     ATTACH_CRTP_PERFORM_METHODS()
@@ -82,8 +84,10 @@ namespace Sass {
   class Supports_Negation : public Supports_Condition {
   private:
     ADD_PROPERTY(Supports_Condition_Obj, condition);
+    mutable size_t hash_;
   public:
     Supports_Negation(ParserState pstate, Supports_Condition_Obj c);
+    virtual size_t hash() const override;
     virtual bool needs_parens(Supports_Condition_Obj cond) const override;
     ATTACH_AST_OPERATIONS(Supports_Negation)
     ATTACH_CRTP_PERFORM_METHODS()
@@ -96,8 +100,10 @@ namespace Sass {
   private:
     ADD_PROPERTY(Expression_Obj, feature);
     ADD_PROPERTY(Expression_Obj, value);
+    mutable size_t hash_;
   public:
     Supports_Declaration(ParserState pstate, Expression_Obj f, Expression_Obj v);
+    virtual size_t hash() const override;
     virtual bool needs_parens(Supports_Condition_Obj cond) const override;
     ATTACH_AST_OPERATIONS(Supports_Declaration)
     ATTACH_CRTP_PERFORM_METHODS()
@@ -109,8 +115,10 @@ namespace Sass {
   class Supports_Interpolation : public Supports_Condition {
   private:
     ADD_PROPERTY(Expression_Obj, value);
+    mutable size_t hash_;
   public:
     Supports_Interpolation(ParserState pstate, Expression_Obj v);
+    virtual size_t hash() const override;
     virtual bool needs_parens(Supports_Condition_Obj cond) const override;
     ATTACH_AST_OPERATIONS(Supports_Interpolation)
     ATTACH_CRTP_PERFORM_METHODS()
@@ -2,6 +2,7 @@
 // __EXTENSIONS__ fix on Solaris.
 #include "sass.hpp"
 #include "ast.hpp"
+#include "utf8_string.hpp"
 
 namespace Sass {
 
@@ -89,14 +90,16 @@ namespace Sass {
   bool List::operator== (const Expression& rhs) const
   {
     if (auto r = Cast<List>(&rhs)) {
+      if (this == r) return true;
       if (length() != r->length()) return false;
       if (separator() != r->separator()) return false;
       if (is_bracketed() != r->is_bracketed()) return false;
       for (size_t i = 0, L = length(); i < L; ++i) {
-        auto rv = r->at(i);
-        auto lv = this->at(i);
+        const Expression_Obj& rv = r->at(i);
+        const Expression_Obj& lv = this->at(i);
         if (!lv && rv) return false;
         else if (!rv && lv) return false;
+        else if (lv.ptr() == rv.ptr()) continue;
         else if (*lv != *rv) return false;
       }
       return true;
@@ -172,12 +175,14 @@ namespace Sass {
   bool Map::operator== (const Expression& rhs) const
   {
     if (auto r = Cast<Map>(&rhs)) {
+      if (this == r) return true;
       if (length() != r->length()) return false;
-      for (auto key : keys()) {
-        auto rv = r->at(key);
-        auto lv = this->at(key);
+      for (const auto& key : keys()) {
+        Expression_Obj rv = r->at(key);
+        Expression_Obj lv = this->at(key);
         if (!lv && rv) return false;
         else if (!rv && lv) return false;
+        else if (lv.ptr() == rv.ptr()) continue;
         else if (*lv != *rv) return false;
       }
       return true;
@@ -188,7 +193,7 @@ namespace Sass {
   List_Obj Map::to_list(ParserState& pstate) {
     List_Obj ret = SASS_MEMORY_NEW(List, pstate, length(), SASS_COMMA);
 
-    for (auto key : keys()) {
+    for (const auto& key : keys()) {
       List_Obj l = SASS_MEMORY_NEW(List, pstate, 2);
       l->append(key);
       l->append(at(key));
@@ -201,7 +206,7 @@ namespace Sass {
   size_t Map::hash() const
   {
     if (hash_ == 0) {
-      for (auto key : keys()) {
+      for (const auto& key : keys()) {
         hash_combine(hash_, key->hash());
         hash_combine(hash_, at(key)->hash());
       }
@@ -382,7 +387,7 @@ namespace Sass {
   {
     if (hash_ == 0) {
       hash_ = std::hash<std::string>()(name());
-      for (auto argument : arguments()->elements())
+      for (const auto& argument : arguments()->elements())
         hash_combine(hash_, argument->hash());
     }
     return hash_;
@@ -430,7 +435,8 @@ namespace Sass {
     Units(),
     value_(val),
     zero_(zero),
-    hash_(0)
+    hash_(0),
+    render_cache_(), render_key_(0)
   {
     size_t l = 0;
     size_t r;
@@ -461,7 +467,11 @@ namespace Sass {
   : Value(ptr),
     Units(ptr),
     value_(ptr->value_), zero_(ptr->zero_),
-    hash_(ptr->hash_)
+    hash_(ptr->hash_),
+    canonical_(ptr->canonical_),
+    // copies usually feed an arithmetic mutation right away,
+    // so the memoized serialization does not carry over
+    render_cache_(), render_key_(0)
   { concrete_type(NUMBER); }
 
   // cancel out unnecessary units
@@ -477,6 +487,36 @@ namespace Sass {
     value_ *= this->Units::normalize();
   }
 
+  const CanonicalUnits& Number::canonical() const
+  {
+    // key the cache on the live unit vectors; the vectors are public
+    // and mutated in place by the operator implementations, so the
+    // key is what keeps a reused node from serving a stale form
+    size_t key = 0xc6a4a793UL;
+    for (const auto& numerator : numerators)
+      hash_combine(key, std::hash<std::string>()(numerator));
+    hash_combine(key, numerators.size());
+    for (const auto& denominator : denominators)
+      hash_combine(key, std::hash<std::string>()(denominator));
+    if (key == 0) key = 1; // zero marks "not computed"
+    if (canonical_.key == key) return canonical_;
+    // canonicalize a scratch copy in two stages: comparisons need
+    // the unit count after reduce() (unitless numbers compare by
+    // reduced value only) and the unit vectors after normalize()
+    Units scratch(*this);
+    double reduce_factor = scratch.reduce();
+    size_t reduced_count = scratch.numerators.size()
+                         + scratch.denominators.size();
+    double total_factor = reduce_factor * scratch.normalize();
+    canonical_.reduced_count = reduced_count;
+    canonical_.reduce_factor = reduce_factor;
+    canonical_.total_factor = total_factor;
+    canonical_.numerators = std::move(scratch.numerators);
+    canonical_.denominators = std::move(scratch.denominators);
+    canonical_.key = key;
+    return canonical_;
+  }
+
   size_t Number::hash() const
   {
     if (hash_ == 0) {
@@ -507,43 +547,50 @@ namespace Sass {
 
   bool Number::operator== (const Number& rhs) const
   {
+    // identical units need no reduction or normalization at all;
+    // the packed signature proves that with two integer compares
+    uint64_t sig = unit_signature();
+    if (sig && sig == rhs.unit_signature()) {
+      return NEAR_EQUAL(value(), rhs.value());
+    }
     // unitless or only having one unit are equivalent (3.4)
     // therefore we need to reduce the units beforehand
-    Number l(*this), r(rhs); l.reduce(); r.reduce();
-    size_t lhs_units = l.numerators.size() + l.denominators.size();
-    size_t rhs_units = r.numerators.size() + r.denominators.size();
-    if (!lhs_units || !rhs_units) {
-      return NEAR_EQUAL(l.value(), r.value());
+    const CanonicalUnits& l = canonical();
+    const CanonicalUnits& r = rhs.canonical();
+    if (!l.reduced_count || !r.reduced_count) {
+      return NEAR_EQUAL(value() * l.reduce_factor,
+                        rhs.value() * r.reduce_factor);
     }
     // ensure both have same units
-    l.normalize(); r.normalize();
-    Units &lhs_unit = l, &rhs_unit = r;
-    return lhs_unit == rhs_unit &&
-      NEAR_EQUAL(l.value(), r.value());
+    return l.numerators == r.numerators &&
+      l.denominators == r.denominators &&
+      NEAR_EQUAL(value() * l.total_factor,
+                 rhs.value() * r.total_factor);
   }
 
   bool Number::operator< (const Number& rhs) const
   {
+    // identical units need no reduction or normalization at all;
+    // the packed signature proves that with two integer compares
+    // (all conversion factors are positive, so order is invariant)
+    uint64_t sig = unit_signature();
+    if (sig && sig == rhs.unit_signature()) {
+      return value() < rhs.value();
+    }
     // unitless or only having one unit are equivalent (3.4)
     // therefore we need to reduce the units beforehand
-    Number l(*this), r(rhs); l.reduce(); r.reduce();
-    size_t lhs_units = l.numerators.size() + l.denominators.size();
-    size_t rhs_units = r.numerators.size() + r.denominators.size();
-    if (!lhs_units || !rhs_units) {
-      return l.value() < r.value();
+    const CanonicalUnits& l = canonical();
+    const CanonicalUnits& r = rhs.canonical();
+    if (!l.reduced_count || !r.reduced_count) {
+      return value() * l.reduce_factor < rhs.value() * r.reduce_factor;
     }
     // ensure both have same units
-    l.normalize(); r.normalize();
-    Units &lhs_unit = l, &rhs_unit = r;
-    if (!(lhs_unit == rhs_unit)) {
+    if (l.numerators != r.numerators ||
+        l.denominators != r.denominators) {
       /* ToDo: do we always get useful backtraces? */
       throw Exception::IncompatibleUnits(rhs, *this);
     }
-    if (lhs_unit == rhs_unit) {
-      return l.value() < r.value();
-    } else {
-      return lhs_unit < rhs_unit;
-    }
+    return value() * l.total_factor < rhs.value() * r.total_factor;
   }
 
   /////////////////////////////////////////////////////////////////////////
@@ -597,14 +644,18 @@ namespace Sass {
 
   Color_RGBA::Color_RGBA(ParserState pstate, double r, double g, double b, double a, const std::string disp)
   : Color(pstate, a, disp),
-    r_(r), g_(g), b_(b)
+    r_(r), g_(g), b_(b),
+    render_cache_(), render_key_(0)
   { concrete_type(COLOR); }
 
   Color_RGBA::Color_RGBA(const Color_RGBA* ptr)
   : Color(ptr),
     r_(ptr->r_),
     g_(ptr->g_),
-    b_(ptr->b_)
+    b_(ptr->b_),
+    // copies drop disp and are usually mutated right away,
+    // so the memoized serialization does not carry over
+    render_cache_(), render_key_(0)
   { concrete_type(COLOR); }
 
   bool Color_RGBA::operator< (const Expression& rhs) const
@@ -894,14 +945,15 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////
 
   String_Schema::String_Schema(ParserState pstate, size_t size, bool css)
-  : String(pstate), Vectorized<PreValue_Obj>(size), css_(css), hash_(0)
+  : String(pstate), Vectorized<PreValue_Obj>(size), css_(css), hash_(0), has_interpolants_(-1)
   { concrete_type(STRING); }
 
   String_Schema::String_Schema(const String_Schema* ptr)
   : String(ptr),
     Vectorized<PreValue_Obj>(*ptr),
     css_(ptr->css_),
-    hash_(ptr->hash_)
+    hash_(ptr->hash_),
+    has_interpolants_(ptr->has_interpolants_)
   { concrete_type(STRING); }
 
   void String_Schema::rtrim()
@@ -940,10 +992,12 @@ namespace Sass {
   bool String_Schema::operator== (const Expression& rhs) const
   {
     if (auto r = Cast<String_Schema>(&rhs)) {
+      if (this == r) return true;
       if (length() != r->length()) return false;
       for (size_t i = 0, L = length(); i < L; ++i) {
-        auto rv = (*r)[i];
-        auto lv = (*this)[i];
+        const PreValue_Obj& rv = (*r)[i];
+        const PreValue_Obj& lv = (*this)[i];
+        if (lv.ptr() == rv.ptr()) continue;
         if (*lv != *rv) return false;
       }
       return true;
@@ -951,18 +1005,66 @@ namespace Sass {
     return false;
   }
 
-  bool String_Schema::has_interpolants()
+  const String_Schema::EvalPlan& String_Schema::eval_plan() const
+  {
+    if (plan_.valid) return plan_;
+    size_t L = length();
+    plan_.into_quotes = false;
+    // first and last constant element carrying matching quote
+    // characters evaluate the whole schema into quoted context
+    if (L > 1) {
+      if (!Cast<String_Quoted>((*this)[0]) && !Cast<String_Quoted>((*this)[L - 1])) {
+        if (String_Constant* l = Cast<String_Constant>((*this)[0])) {
+          if (String_Constant* r = Cast<String_Constant>((*this)[L - 1])) {
+            if (r->value().size() > 0) {
+              if (l->value()[0] == '"' && r->value()[r->value().size() - 1] == '"') plan_.into_quotes = true;
+              if (l->value()[0] == '\'' && r->value()[r->value().size() - 1] == '\'') plan_.into_quotes = true;
+            }
+          }
+        }
+      }
+    }
+    plan_.flags.assign(L, 0);
+    plan_.estimate = 0;
+    for (size_t i = 0; i < L; ++i) {
+      const PreValue_Obj& element = (*this)[i];
+      unsigned char flags = 0;
+      if (element->is_interpolant()) flags |= PLAN_INTERPOLANT;
+      if (Cast<String_Quoted>(element)) {
+        flags |= PLAN_QUOTED;
+        plan_.estimate += Cast<String_Constant>(element)->value().size();
+      }
+      else if (String_Constant* sc = Cast<String_Constant>(element)) {
+        // evaluating a plain constant is the identity, so the
+        // eval loop skips the dispatch for these entirely
+        flags |= PLAN_LITERAL;
+        plan_.estimate += sc->value().size();
+      }
+      else {
+        // interpolants get a small ballpark figure
+        plan_.estimate += 16;
+      }
+      plan_.flags[i] = flags;
+    }
+    plan_.valid = true;
+    return plan_;
+  }
+
+  bool String_Schema::has_interpolants() const
   {
-    for (auto el : elements()) {
-      if (el->is_interpolant()) return true;
+    if (has_interpolants_ < 0) {
+      has_interpolants_ = 0;
+      for (const auto& el : elements()) {
+        if (el->is_interpolant()) { has_interpolants_ = 1; break; }
+      }
     }
-    return false;
+    return has_interpolants_ == 1;
   }
 
   size_t String_Schema::hash() const
   {
     if (hash_ == 0) {
-      for (auto string : elements())
+      for (const auto& string : elements())
         hash_combine(hash_, string->hash());
     }
     return hash_;
@@ -977,23 +1079,26 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////
 
   String_Constant::String_Constant(ParserState pstate, std::string val, bool css)
-  : String(pstate), quote_mark_(0), value_(read_css_string(val, css)), hash_(0)
+  : String(pstate), quote_mark_(0), value_(read_css_string(std::move(val), css)), hash_(0), cp_count_(std::string::npos), quoted_mark_(0)
   { }
   String_Constant::String_Constant(ParserState pstate, const char* beg, bool css)
-  : String(pstate), quote_mark_(0), value_(read_css_string(std::string(beg), css)), hash_(0)
+  : String(pstate), quote_mark_(0), value_(read_css_string(std::string(beg), css)), hash_(0), cp_count_(std::string::npos), quoted_mark_(0)
   { }
   String_Constant::String_Constant(ParserState pstate, const char* beg, const char* end, bool css)
-  : String(pstate), quote_mark_(0), value_(read_css_string(std::string(beg, end-beg), css)), hash_(0)
+  : String(pstate), quote_mark_(0), value_(read_css_string(std::string(beg, end-beg), css)), hash_(0), cp_count_(std::string::npos), quoted_mark_(0)
   { }
   String_Constant::String_Constant(ParserState pstate, const Token& tok, bool css)
-  : String(pstate), quote_mark_(0), value_(read_css_string(std::string(tok.begin, tok.end), css)), hash_(0)
+  : String(pstate), quote_mark_(0), value_(read_css_string(std::string(tok.begin, tok.end), css)), hash_(0), cp_count_(std::string::npos), quoted_mark_(0)
   { }
 
   String_Constant::String_Constant(const String_Constant* ptr)
   : String(ptr),
     quote_mark_(ptr->quote_mark_),
     value_(ptr->value_),
-    hash_(ptr->hash_)
+    hash_(ptr->hash_),
+    cp_count_(ptr->cp_count_),
+    quoted_(ptr->quoted_),
+    quoted_mark_(ptr->quoted_mark_)
   { }
 
   bool String_Constant::is_invisible() const {
@@ -1025,12 +1130,31 @@ namespace Sass {
 
   std::string String_Constant::inspect() const
   {
-    return quote(value_, '*');
+    return quoted('*');
+  }
+
+  const std::string& String_Constant::quoted(char q) const
+  {
+    #ifdef SASS_THREADSAFE_REFCOUNT
+    // node level memoization would race between render threads;
+    // quote into a per thread scratch buffer instead
+    static thread_local std::string scratch;
+    scratch = quote(value_, q);
+    return scratch;
+    #else
+    if (quoted_mark_ != q) {
+      quoted_ = quote(value_, q);
+      quoted_mark_ = q;
+    }
+    return quoted_;
+    #endif
   }
 
   void String_Constant::rtrim()
   {
     str_rtrim(value_);
+    hash_ = 0; cp_count_ = std::string::npos;
+    quoted_mark_ = 0;
   }
 
   size_t String_Constant::hash() const
@@ -1041,16 +1165,28 @@ namespace Sass {
     return hash_;
   }
 
+  size_t String_Constant::code_point_count() const
+  {
+    if (cp_count_ == std::string::npos) {
+      cp_count_ = UTF_8::code_point_count(value_, 0, value_.size());
+    }
+    return cp_count_;
+  }
+
   /////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////
 
   String_Quoted::String_Quoted(ParserState pstate, std::string val, char q,
     bool keep_utf8_escapes, bool skip_unquoting,
     bool strict_unquoting, bool css)
-  : String_Constant(pstate, val, css)
+  : String_Constant(pstate, std::move(val), css)
   {
     if (skip_unquoting == false) {
-      value_ = unquote(value_, &quote_mark_, keep_utf8_escapes, strict_unquoting);
+      hash_ = 0; cp_count_ = std::string::npos;
+      quoted_mark_ = 0;
+      // the decoding scan counts code points on the side, so the
+      // utf8 aware builtins need no second pass over the value
+      value_ = unquote(value_, &quote_mark_, keep_utf8_escapes, strict_unquoting, &cp_count_);
     }
     if (q && quote_mark_) quote_mark_ = q;
   }
@@ -1084,7 +1220,7 @@ namespace Sass {
 
   std::string String_Quoted::inspect() const
   {
-    return quote(value_, '*');
+    return quoted('*');
   }
 
   /////////////////////////////////////////////////////////////////////////
@@ -1119,6 +1255,55 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////
 
+  // compilations that collect a source map opt out of sharing:
+  // the emitted segments take positions from the value nodes, so
+  // each value must carry the pstate of the call producing it
+  // instead of the singletons' position-less "[NA]" state
+  thread_local bool value_sharing = true;
+
+  void enable_value_sharing(bool enabled)
+  {
+    value_sharing = enabled;
+  }
+
+  Boolean* shared_boolean(bool value, ParserState pstate)
+  {
+    if (!value_sharing) {
+      return SASS_MEMORY_NEW(Boolean, pstate, value);
+    }
+    // created on first use, so the thread local arena pool already
+    // exists and outlives them (destructors run in reverse order)
+    thread_local Boolean_Obj truthy = SASS_MEMORY_NEW(Boolean, "[NA]", true);
+    thread_local Boolean_Obj falsy = SASS_MEMORY_NEW(Boolean, "[NA]", false);
+    return value ? truthy.ptr() : falsy.ptr();
+  }
+
+  Null* shared_null(ParserState pstate)
+  {
+    if (!value_sharing) {
+      return SASS_MEMORY_NEW(Null, pstate);
+    }
+    thread_local Null_Obj null = SASS_MEMORY_NEW(Null, ParserState("[NA]"));
+    return null.ptr();
+  }
+
+  Number* shared_number(double value, ParserState pstate)
+  {
+    // list lengths and indexes cluster in the first few integers
+    size_t whole = static_cast<size_t>(value);
+    if (value_sharing && value >= 0 && whole < 64
+        && static_cast<double>(whole) == value) {
+      thread_local std::vector<Number_Obj> interned(64);
+      Number_Obj& slot = interned[whole];
+      if (slot.isNull()) slot = SASS_MEMORY_NEW(Number, "[NA]", value);
+      return slot.ptr();
+    }
+    return SASS_MEMORY_NEW(Number, pstate, value);
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////
+
   Parent_Reference::Parent_Reference(ParserState pstate)
   : Value(pstate)
   { concrete_type(PARENT); }
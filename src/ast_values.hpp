@@ -48,7 +48,7 @@ namespace Sass {
   // type-tag.) Also used to represent variable-length argument lists.
   ///////////////////////////////////////////////////////////////////////
   class List : public Value, public Vectorized<Expression_Obj> {
-    void adjust_after_pushing(Expression_Obj e) override { is_expanded(false); }
+    void adjust_after_pushing(const Expression_Obj& e) override { is_expanded(false); }
   private:
     ADD_PROPERTY(enum Sass_Separator, separator)
     ADD_PROPERTY(bool, is_arglist)
@@ -80,7 +80,7 @@ namespace Sass {
   // Key value paris.
   ///////////////////////////////////////////////////////////////////////
   class Map : public Value, public Hashed<Expression_Obj, Expression_Obj, Map_Obj> {
-    void adjust_after_pushing(std::pair<Expression_Obj, Expression_Obj> p) override { is_expanded(false); }
+    void adjust_after_pushing(const std::pair<Expression_Obj, Expression_Obj>& p) override { is_expanded(false); }
   public:
     Map(ParserState pstate, size_t size = 0);
     std::string type() const override { return "map"; }
@@ -203,9 +203,28 @@ namespace Sass {
     HASH_PROPERTY(double, value)
     ADD_PROPERTY(bool, zero)
     mutable size_t hash_;
+    // lazily computed canonical unit form; see canonical()
+    mutable CanonicalUnits canonical_;
+    // memoized css serialization, same scheme the colors use: an
+    // evaluated number commonly reaches many declarations through
+    // one variable, and each render pays unit reduction, rounding
+    // and trimming again. The key is computed fresh from value,
+    // units, style and precision (the public unit vectors bypass
+    // the lazy hash, so that one could go stale)
+    mutable std::string render_cache_;
+    mutable size_t render_key_;
   public:
     Number(ParserState pstate, double val, std::string u = "", bool zero = true);
 
+    const std::string* cached_render(size_t key) const {
+      if (key && render_key_ == key) return &render_cache_;
+      return nullptr;
+    }
+    void cache_render(size_t key, const std::string& res) const {
+      if (!key) return; // caching disabled for this render
+      render_cache_ = res; render_key_ = key;
+    }
+
     bool zero() { return zero_; }
 
     std::string type() const override { return "number"; }
@@ -219,6 +238,12 @@ namespace Sass {
     // needed to compare two numbers
     void normalize();
 
+    // canonical unit form for comparisons; computed on first use
+    // and reused while the unit vectors stay unchanged (the cache
+    // revalidates against a hash of the vectors, so the public
+    // mutable unit members can never leave it stale)
+    const CanonicalUnits& canonical() const;
+
     size_t hash() const override;
 
     bool operator< (const Number& rhs) const;
@@ -264,9 +289,26 @@ namespace Sass {
     HASH_PROPERTY(double, r)
     HASH_PROPERTY(double, g)
     HASH_PROPERTY(double, b)
+    // memoized css serialization; the same color node is often
+    // emitted many times, and rendering involves rounding, color
+    // name lookups and hex formatting. The key mixes hash() with
+    // the output style and precision, so the channel setters
+    // (which reset hash_) invalidate it; disp and is_delayed are
+    // only ever set right after construction, before any render.
+    mutable std::string render_cache_;
+    mutable size_t render_key_;
   public:
     Color_RGBA(ParserState pstate, double r, double g, double b, double a = 1, const std::string disp = "");
 
+    const std::string* cached_render(size_t key) const {
+      if (key && render_key_ == key) return &render_cache_;
+      return nullptr;
+    }
+    void cache_render(size_t key, const std::string& res) const {
+      if (!key) return; // caching disabled for this render
+      render_cache_ = res; render_key_ = key;
+    }
+
     std::string type() const override { return "color"; }
     static std::string type_name() { return "color"; }
 
@@ -392,6 +434,38 @@ namespace Sass {
   class String_Schema final : public String, public Vectorized<PreValue_Obj> {
     ADD_PROPERTY(bool, css)
     mutable size_t hash_;
+    // whether any element is an interpolant, decided once on the
+    // first query (-1 while unknown); appending invalidates it
+    mutable signed char has_interpolants_;
+  public:
+    // evaluation plan: everything about a schema that used to be
+    // re-derived per evaluation (type dispatch, interpolant flags,
+    // quote detection, length estimate), built lazily on the first
+    // eval since elements never change afterwards; appending
+    // invalidates it like the interpolant flag above
+    enum PlanFlags {
+      PLAN_QUOTED = 1,      // element is a String_Quoted
+      PLAN_INTERPOLANT = 2, // element carries is_interpolant
+      PLAN_LITERAL = 4      // plain String_Constant; eval is identity
+    };
+    struct EvalPlan {
+      bool valid = false;
+      // evaluate into quoted-string context (first and last
+      // element carry matching quote characters)
+      bool into_quotes = false;
+      // byte estimate for the result buffer reservation
+      size_t estimate = 0;
+      // one PlanFlags byte per element
+      std::vector<unsigned char> flags;
+    };
+    const EvalPlan& eval_plan() const;
+  private:
+    mutable EvalPlan plan_;
+  protected:
+    void adjust_after_pushing(const PreValue_Obj& element) override {
+      has_interpolants_ = -1;
+      plan_.valid = false;
+    }
   public:
     String_Schema(ParserState pstate, size_t size = 0, bool css = true);
 
@@ -401,7 +475,7 @@ namespace Sass {
     bool is_left_interpolant(void) const override;
     bool is_right_interpolant(void) const override;
 
-    bool has_interpolants();
+    bool has_interpolants() const;
     void rtrim() override;
     size_t hash() const override;
     virtual void set_delayed(bool delayed) override;
@@ -417,9 +491,31 @@ namespace Sass {
   ////////////////////////////////////////////////////////
   class String_Constant : public String {
     ADD_PROPERTY(char, quote_mark)
-    HASH_CONSTREF(std::string, value)
   protected:
+    std::string value_;
     mutable size_t hash_;
+    // lazily computed utf8 code point count of the value (npos
+    // while unknown); reset alongside the hash on any mutation
+    mutable size_t cp_count_;
+    // lazily cached quoted rendering of the value (the mark it
+    // was quoted with sits in quoted_mark_, 0 while unknown);
+    // quoting rescans and escapes the whole string, and the same
+    // literal is rendered by every rule that uses it
+    mutable std::string quoted_;
+    mutable char quoted_mark_;
+  public:
+    const std::string& value() const { return value_; }
+    void value(std::string value__) {
+      hash_ = 0; cp_count_ = std::string::npos;
+      quoted_mark_ = 0;
+      value_ = std::move(value__);
+    }
+    // the value quoted with mark [q], cached on the node
+    const std::string& quoted(char q) const;
+    // cached code point count for the utf8 aware string builtins
+    size_t code_point_count() const;
+    // pure ascii strings can use byte offsets directly
+    bool is_ascii() const { return code_point_count() == value_.size(); }
   public:
     String_Constant(ParserState pstate, std::string val, bool css = true);
     String_Constant(ParserState pstate, const char* beg, bool css = true);
@@ -476,6 +572,27 @@ namespace Sass {
   };
 
   //////////////////////////////////
+  //////////////////////////////////////////////////////////////////////
+  // Shared singletons for trivial immutable values. Comparisons and
+  // the list/string builtins produce huge numbers of identical true,
+  // false, null and small integer results; these helpers hand out
+  // long-lived shared instances instead of allocating fresh nodes
+  // (thread local, since AST refcounts are not atomic). Callers must
+  // treat them as immutable: anything that wants to change a value
+  // has to copy it first, which is already the rule everywhere since
+  // values may be referenced from an environment or a cached parse.
+  // When sharing is disabled the helpers allocate fresh nodes with
+  // the caller's pstate; compilations collecting a source map need
+  // that, since the singletons carry no usable position and would
+  // garble the emitted mappings.
+  //////////////////////////////////////////////////////////////////////
+  void enable_value_sharing(bool enabled);
+  Boolean* shared_boolean(bool value, ParserState pstate);
+  Null* shared_null(ParserState pstate);
+  // interns small unit-less integers (list lengths, indexes);
+  // anything else is freshly allocated with the given pstate
+  Number* shared_number(double value, ParserState pstate);
+
   // The Parent Reference Expression.
   //////////////////////////////////
   class Parent_Reference final : public Value {
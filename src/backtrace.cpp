@@ -2,7 +2,7 @@
 
 namespace Sass {
 
-  const std::string traces_to_string(Backtraces traces, std::string indent) {
+  const std::string traces_to_string(const Backtraces& traces, std::string indent) {
 
     std::stringstream ss;
     std::string cwd(File::get_cwd());
@@ -30,7 +30,13 @@ namespace Sass {
         // ss << trace.caller;
         first = false;
       } else {
-        ss << trace.caller;
+        // format deferred call frames here (see backtrace.hpp)
+        if (trace.fn_kind) {
+          ss << ", in " << trace.fn_kind;
+          ss << " `" << trace.fn_name << "`";
+        } else {
+          ss << trace.caller;
+        }
         ss << std::endl;
         ss << indent;
         ss << "from line ";
@@ -12,17 +12,32 @@ namespace Sass {
 
     ParserState pstate;
     std::string caller;
+    // deferred caller info for call frames: frames are pushed and
+    // popped on every function/mixin invocation, but the caller
+    // string is only ever read when a trace gets printed. Keeping
+    // kind and name here postpones the formatting (and its string
+    // concatenations) to the error path.
+    const char* fn_kind;
+    std::string fn_name;
 
     Backtrace(ParserState pstate, std::string c = "")
     : pstate(pstate),
-      caller(c)
+      caller(c),
+      fn_kind(0)
+    { }
+
+    Backtrace(ParserState pstate, const char* kind, std::string name)
+    : pstate(pstate),
+      caller(),
+      fn_kind(kind),
+      fn_name(std::move(name))
     { }
 
   };
 
   typedef std::vector<Backtrace> Backtraces;
 
-  const std::string traces_to_string(Backtraces traces, std::string indent = "\t");
+  const std::string traces_to_string(const Backtraces& traces, std::string indent = "\t");
 
 }
 
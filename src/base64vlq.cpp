@@ -9,19 +9,29 @@ namespace Sass {
   std::string Base64VLQ::encode(const int number) const
   {
     std::string encoded = "";
+    encode(encoded, number);
+    return encoded;
+  }
 
+  void Base64VLQ::encode(std::string& result, const int number) const
+  {
     int vlq = to_vlq_signed(number);
 
+    // deltas between adjacent mappings are almost always small;
+    // values below the continuation threshold are one character
+    if (vlq < VLQ_BASE) {
+      result += CHARACTERS[vlq];
+      return;
+    }
+
     do {
       int digit = vlq & VLQ_BASE_MASK;
       vlq >>= VLQ_BASE_SHIFT;
       if (vlq > 0) {
         digit |= VLQ_CONTINUATION_BIT;
       }
-      encoded += base64_encode(digit);
+      result += base64_encode(digit);
     } while (vlq > 0);
-
-    return encoded;
   }
 
   char Base64VLQ::base64_encode(const int number) const
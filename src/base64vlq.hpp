@@ -11,6 +11,10 @@ namespace Sass {
 
     std::string encode(const int number) const;
 
+    // append the encoding to an existing buffer to avoid a
+    // temporary string per value (hot in serialize_mappings)
+    void encode(std::string& result, const int number) const;
+
   private:
 
     char base64_encode(const int number) const;
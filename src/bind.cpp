@@ -5,7 +5,7 @@
 #include "context.hpp"
 #include "expand.hpp"
 #include "eval.hpp"
-#include <map>
+#include <unordered_map>
 #include <iostream>
 #include <sstream>
 
@@ -15,9 +15,34 @@ namespace Sass {
   {
     std::string callee(type + " " + name);
 
-    std::map<std::string, Parameter_Obj> param_map;
-    List_Obj varargs = SASS_MEMORY_NEW(List, as->pstate());
-    varargs->is_arglist(true); // enable keyword size handling
+    // Map to ensure named arguments refer to actual parameters; most
+    // calls bind purely positionally, so it is built only when a named
+    // or keyword argument actually occurs instead of on every call
+    environment_map<std::string, Parameter_Obj> param_map;
+    bool param_map_built = false;
+    auto ensure_param_map = [&]() {
+      if (param_map_built) return;
+      param_map_built = true;
+      for (size_t i = 0, L = ps->length(); i < L; ++i) {
+        Parameter_Obj p = ps->at(i);
+        param_map[p->name()] = p;
+      }
+    };
+
+    // collects leftover named arguments for a rest parameter;
+    // also created on demand for the same reason as above
+    List_Obj varargs;
+    auto ensure_varargs = [&]() {
+      if (varargs) return;
+      varargs = SASS_MEMORY_NEW(List, as->pstate());
+      varargs->is_arglist(true); // enable keyword size handling
+    };
+
+    // every parameter ends up in the local frame; sizing the
+    // table up front avoids rehashing while we insert them
+    if (ps->length() > 0) {
+      env->local_frame().reserve(ps->length());
+    }
 
     for (size_t i = 0, L = as->length(); i < L; ++i) {
       if (auto str = Cast<String_Quoted>((*as)[i]->value())) {
@@ -28,16 +53,6 @@ namespace Sass {
       }
     }
 
-    // Set up a map to ensure named arguments refer to actual parameters. Also
-    // eval each default value left-to-right, wrt env, populating env as we go.
-    for (size_t i = 0, L = ps->length(); i < L; ++i) {
-      Parameter_Obj  p = ps->at(i);
-      param_map[p->name()] = p;
-      // if (p->default_value()) {
-      //   env->local_frame()[p->name()] = p->default_value()->perform(eval->with(env));
-      // }
-    }
-
     // plug in all args; if we have leftover params, deal with it later
     size_t ip = 0, LP = ps->length();
     size_t ia = 0, LA = as->length();
@@ -73,7 +88,7 @@ namespace Sass {
                                               rest->separator(),
                                               true);
               // wrap each item from list as an argument
-              for (Expression_Obj item : rest->elements()) {
+              for (const Expression_Obj& item : rest->elements()) {
                 if (Argument_Obj arg = Cast<Argument>(item)) {
                   arglist->append(SASS_MEMORY_COPY(arg)); // copy
                 } else {
@@ -220,6 +235,7 @@ namespace Sass {
       } else if (a->is_keyword_argument()) {
         Map_Obj argmap = Cast<Map>(a->value());
 
+        ensure_param_map();
         for (auto key : argmap->keys()) {
           String_Constant* val = Cast<String_Constant>(key);
           if (val == NULL) {
@@ -254,8 +270,11 @@ namespace Sass {
       }
       else {
         // named arg -- bind it to the appropriately named param
-        if (!param_map.count(a->name())) {
+        ensure_param_map();
+        auto pm = param_map.find(a->name());
+        if (pm == param_map.end()) {
           if (ps->has_rest_parameter()) {
+            ensure_varargs();
             varargs->append(a);
           } else {
             std::stringstream msg;
@@ -263,8 +282,8 @@ namespace Sass {
             error(msg.str(), a->pstate(), traces);
           }
         }
-        if (param_map[a->name()]) {
-          if (param_map[a->name()]->is_rest_parameter()) {
+        else if (pm->second) {
+          if (pm->second->is_rest_parameter()) {
             std::stringstream msg;
             msg << "argument " << a->name() << " of " << callee
                 << "cannot be used as named argument";
@@ -292,6 +311,7 @@ namespace Sass {
       // cerr << "********" << endl;
       if (!env->has_local(leftover->name())) {
         if (leftover->is_rest_parameter()) {
+          ensure_varargs();
           env->local_frame()[leftover->name()] = varargs;
         }
         else if (leftover->default_value()) {
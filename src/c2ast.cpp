@@ -33,13 +33,19 @@ namespace Sass {
       case SASS_LIST: {
         List* l = SASS_MEMORY_NEW(List, pstate, sass_list_get_length(v), sass_list_get_separator(v));
         for (size_t i = 0, L = sass_list_get_length(v); i < L; ++i) {
-          l->append(c2ast(sass_list_get_value(v, i), traces, pstate));
+          union Sass_Value* item = sass_list_get_value(v, i);
+          // typed fast path for the numeric lists plugins produce
+          if (sass_value_get_tag(item) == SASS_NUMBER) {
+            l->append(SASS_MEMORY_NEW(Number, pstate, sass_number_get_value(item), sass_number_get_unit(item)));
+          } else {
+            l->append(c2ast(item, traces, pstate));
+          }
         }
         l->is_bracketed(sass_list_get_is_bracketed(v));
         e = l;
       } break;
       case SASS_MAP: {
-        Map* m = SASS_MEMORY_NEW(Map, pstate);
+        Map* m = SASS_MEMORY_NEW(Map, pstate, sass_map_get_length(v));
         for (size_t i = 0, L = sass_map_get_length(v); i < L; ++i) {
           *m << std::make_pair(
             c2ast(sass_map_get_key(v, i), traces, pstate),
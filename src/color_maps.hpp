@@ -160,157 +160,6 @@ namespace Sass {
     extern const char transparent[];
   }
 
-  namespace Colors {
-    extern const Color_RGBA aliceblue;
-    extern const Color_RGBA antiquewhite;
-    extern const Color_RGBA cyan;
-    extern const Color_RGBA aqua;
-    extern const Color_RGBA aquamarine;
-    extern const Color_RGBA azure;
-    extern const Color_RGBA beige;
-    extern const Color_RGBA bisque;
-    extern const Color_RGBA black;
-    extern const Color_RGBA blanchedalmond;
-    extern const Color_RGBA blue;
-    extern const Color_RGBA blueviolet;
-    extern const Color_RGBA brown;
-    extern const Color_RGBA burlywood;
-    extern const Color_RGBA cadetblue;
-    extern const Color_RGBA chartreuse;
-    extern const Color_RGBA chocolate;
-    extern const Color_RGBA coral;
-    extern const Color_RGBA cornflowerblue;
-    extern const Color_RGBA cornsilk;
-    extern const Color_RGBA crimson;
-    extern const Color_RGBA darkblue;
-    extern const Color_RGBA darkcyan;
-    extern const Color_RGBA darkgoldenrod;
-    extern const Color_RGBA darkgray;
-    extern const Color_RGBA darkgrey;
-    extern const Color_RGBA darkgreen;
-    extern const Color_RGBA darkkhaki;
-    extern const Color_RGBA darkmagenta;
-    extern const Color_RGBA darkolivegreen;
-    extern const Color_RGBA darkorange;
-    extern const Color_RGBA darkorchid;
-    extern const Color_RGBA darkred;
-    extern const Color_RGBA darksalmon;
-    extern const Color_RGBA darkseagreen;
-    extern const Color_RGBA darkslateblue;
-    extern const Color_RGBA darkslategray;
-    extern const Color_RGBA darkslategrey;
-    extern const Color_RGBA darkturquoise;
-    extern const Color_RGBA darkviolet;
-    extern const Color_RGBA deeppink;
-    extern const Color_RGBA deepskyblue;
-    extern const Color_RGBA dimgray;
-    extern const Color_RGBA dimgrey;
-    extern const Color_RGBA dodgerblue;
-    extern const Color_RGBA firebrick;
-    extern const Color_RGBA floralwhite;
-    extern const Color_RGBA forestgreen;
-    extern const Color_RGBA magenta;
-    extern const Color_RGBA fuchsia;
-    extern const Color_RGBA gainsboro;
-    extern const Color_RGBA ghostwhite;
-    extern const Color_RGBA gold;
-    extern const Color_RGBA goldenrod;
-    extern const Color_RGBA gray;
-    extern const Color_RGBA grey;
-    extern const Color_RGBA green;
-    extern const Color_RGBA greenyellow;
-    extern const Color_RGBA honeydew;
-    extern const Color_RGBA hotpink;
-    extern const Color_RGBA indianred;
-    extern const Color_RGBA indigo;
-    extern const Color_RGBA ivory;
-    extern const Color_RGBA khaki;
-    extern const Color_RGBA lavender;
-    extern const Color_RGBA lavenderblush;
-    extern const Color_RGBA lawngreen;
-    extern const Color_RGBA lemonchiffon;
-    extern const Color_RGBA lightblue;
-    extern const Color_RGBA lightcoral;
-    extern const Color_RGBA lightcyan;
-    extern const Color_RGBA lightgoldenrodyellow;
-    extern const Color_RGBA lightgray;
-    extern const Color_RGBA lightgrey;
-    extern const Color_RGBA lightgreen;
-    extern const Color_RGBA lightpink;
-    extern const Color_RGBA lightsalmon;
-    extern const Color_RGBA lightseagreen;
-    extern const Color_RGBA lightskyblue;
-    extern const Color_RGBA lightslategray;
-    extern const Color_RGBA lightslategrey;
-    extern const Color_RGBA lightsteelblue;
-    extern const Color_RGBA lightyellow;
-    extern const Color_RGBA lime;
-    extern const Color_RGBA limegreen;
-    extern const Color_RGBA linen;
-    extern const Color_RGBA maroon;
-    extern const Color_RGBA mediumaquamarine;
-    extern const Color_RGBA mediumblue;
-    extern const Color_RGBA mediumorchid;
-    extern const Color_RGBA mediumpurple;
-    extern const Color_RGBA mediumseagreen;
-    extern const Color_RGBA mediumslateblue;
-    extern const Color_RGBA mediumspringgreen;
-    extern const Color_RGBA mediumturquoise;
-    extern const Color_RGBA mediumvioletred;
-    extern const Color_RGBA midnightblue;
-    extern const Color_RGBA mintcream;
-    extern const Color_RGBA mistyrose;
-    extern const Color_RGBA moccasin;
-    extern const Color_RGBA navajowhite;
-    extern const Color_RGBA navy;
-    extern const Color_RGBA oldlace;
-    extern const Color_RGBA olive;
-    extern const Color_RGBA olivedrab;
-    extern const Color_RGBA orange;
-    extern const Color_RGBA orangered;
-    extern const Color_RGBA orchid;
-    extern const Color_RGBA palegoldenrod;
-    extern const Color_RGBA palegreen;
-    extern const Color_RGBA paleturquoise;
-    extern const Color_RGBA palevioletred;
-    extern const Color_RGBA papayawhip;
-    extern const Color_RGBA peachpuff;
-    extern const Color_RGBA peru;
-    extern const Color_RGBA pink;
-    extern const Color_RGBA plum;
-    extern const Color_RGBA powderblue;
-    extern const Color_RGBA purple;
-    extern const Color_RGBA red;
-    extern const Color_RGBA rosybrown;
-    extern const Color_RGBA royalblue;
-    extern const Color_RGBA saddlebrown;
-    extern const Color_RGBA salmon;
-    extern const Color_RGBA sandybrown;
-    extern const Color_RGBA seagreen;
-    extern const Color_RGBA seashell;
-    extern const Color_RGBA sienna;
-    extern const Color_RGBA silver;
-    extern const Color_RGBA skyblue;
-    extern const Color_RGBA slateblue;
-    extern const Color_RGBA slategray;
-    extern const Color_RGBA slategrey;
-    extern const Color_RGBA snow;
-    extern const Color_RGBA springgreen;
-    extern const Color_RGBA steelblue;
-    extern const Color_RGBA tan;
-    extern const Color_RGBA teal;
-    extern const Color_RGBA thistle;
-    extern const Color_RGBA tomato;
-    extern const Color_RGBA turquoise;
-    extern const Color_RGBA violet;
-    extern const Color_RGBA wheat;
-    extern const Color_RGBA white;
-    extern const Color_RGBA whitesmoke;
-    extern const Color_RGBA yellow;
-    extern const Color_RGBA yellowgreen;
-    extern const Color_RGBA rebeccapurple;
-    extern const Color_RGBA transparent;
-  }
 
   const Color_RGBA* name_to_color(const char*);
   const Color_RGBA* name_to_color(const std::string&);
@@ -3,7 +3,17 @@
 #include "sass.hpp"
 #include "ast.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "remove_placeholders.hpp"
+#include "dedup_declarations.hpp"
+#include "ast_serialize.hpp"
 #include "sass_functions.hpp"
 #include "check_nesting.hpp"
 #include "fn_selectors.hpp"
@@ -14,8 +24,13 @@
 #include "fn_lists.hpp"
 #include "fn_maps.hpp"
 #include "context.hpp"
+#include "json.hpp"
 #include "expand.hpp"
+#include "messages.hpp"
 #include "parser.hpp"
+#include "tracing.hpp"
+#include "tree_shaking.hpp"
+#include "tokenizer.hpp"
 #include "cssize.hpp"
 
 namespace Sass {
@@ -26,6 +41,135 @@ namespace Sass {
   inline bool sort_importers (const Sass_Importer_Entry& i, const Sass_Importer_Entry& j)
   { return sass_importer_get_priority(i) > sass_importer_get_priority(j); }
 
+  // Caches parsed stylesheets across compilations so watch-mode
+  // rebuilds only re-parse files whose content actually changed.
+  // The cache is per thread: AST refcounts are not atomic, so a
+  // parse tree must never be shared between concurrently running
+  // compilations. Parse trees reference their source buffer and
+  // path string through every ParserState, so the cache takes
+  // ownership of those buffers from the context that parsed them
+  // and keeps superseded buffers around until the thread exits
+  // (an already finished compilation may still point into them).
+  class ParseCache {
+
+    struct Entry {
+      Block_Obj root;
+      char* contents;
+      char* path;
+      size_t hash;
+      size_t idx;
+      // whether the parse produced placeholder selectors
+      // (replayed into the context on a cache hit)
+      bool has_placeholders;
+      // whether property names were interned while parsing (the
+      // shared nodes carry coarse positions, so such a tree must
+      // not serve a compile that collects source maps)
+      bool interned_names;
+    };
+
+    // resolved absolute path to cached parse result
+    std::unordered_map<std::string, Entry> entries;
+
+    // buffers we own (checked by Context on teardown)
+    std::unordered_set<void*> owned;
+
+    // superseded buffers, freed with the cache
+    std::vector<char*> graveyard;
+
+  public:
+
+    #ifdef SASS_CUSTOM_ALLOCATOR
+    // touch the thread local arena pool before the cache is
+    // constructed: thread local destructors run in reverse
+    // construction order, and cached parse trees must release
+    // their nodes back into a pool that is still alive
+    ParseCache() { getMemoryPool(); }
+    #endif
+
+    static ParseCache& instance()
+    {
+      thread_local ParseCache cache;
+      return cache;
+    }
+
+    // cheap content fingerprint (fnv1a over the source)
+    static size_t hash_contents(const char* contents)
+    {
+      size_t hash = 0xCBF29CE484222325ULL;
+      while (*contents) {
+        hash ^= (unsigned char) *contents++;
+        hash *= 0x100000001B3ULL;
+      }
+      return hash;
+    }
+
+    // returns the cached root for an exact match of path,
+    // content hash and resource index (positions embed the
+    // index, so trees only transfer between identical layouts)
+    Block_Obj lookup(const std::string& abs_path, size_t hash, size_t idx,
+                     bool wants_srcmap, bool& has_placeholders)
+    {
+      auto it = entries.find(abs_path);
+      if (it == entries.end()) return {};
+      if (it->second.hash != hash) return {};
+      if (it->second.idx != idx) return {};
+      // a name-interned tree cannot provide exact positions
+      if (it->second.interned_names && wants_srcmap) return {};
+      has_placeholders = it->second.has_placeholders;
+      return it->second.root;
+    }
+
+    void store(const std::string& abs_path, size_t hash, size_t idx,
+               Block_Obj root, char* contents, char* path,
+               bool has_placeholders, bool interned_names)
+    {
+      Entry& entry = entries[abs_path];
+      // retire buffers of a superseded parse result
+      if (entry.contents) graveyard.push_back(entry.contents);
+      if (entry.path) graveyard.push_back(entry.path);
+      entry = { root, contents, path, hash, idx,
+                has_placeholders, interned_names };
+      owned.insert(contents);
+      owned.insert(path);
+    }
+
+    bool owns(void* buffer) const
+    {
+      return owned.count(buffer) != 0;
+    }
+
+    // drop the cached parse result for one file so the next
+    // compilation re-parses it (buffers are retired, not freed,
+    // since earlier compilations may still point into them)
+    void invalidate(const std::string& abs_path)
+    {
+      auto it = entries.find(abs_path);
+      if (it == entries.end()) return;
+      if (it->second.contents) graveyard.push_back(it->second.contents);
+      if (it->second.path) graveyard.push_back(it->second.path);
+      entries.erase(it);
+    }
+
+    ~ParseCache()
+    {
+      for (auto& pair : entries) {
+        File::free_source(pair.second.contents);
+        free(pair.second.path);
+      }
+      for (char* buffer : graveyard) {
+        File::free_source(buffer);
+      }
+    }
+
+  };
+
+  // entry point for the C API so long-lived watch processes can
+  // evict exactly the file that changed from the parse cache
+  void invalidate_parse_cache(const std::string& abs_path)
+  {
+    ParseCache::instance().invalidate(abs_path);
+  }
+
   static std::string safe_input(const char* in_path)
   {
     if (in_path == nullptr || in_path[0] == '\0') return "stdin";
@@ -57,7 +201,14 @@ namespace Sass {
     callee_stack(),
     traces(),
     extender(Extender::NORMAL, traces),
+    fn_dispatch_cache(),
+    fn_env_generation(0),
+    media_merge_seq(0),
+    seen_placeholders(false),
+    borrowed_source(0),
     c_compiler(NULL),
+    source_bytes(0),
+    stats_start(MemoryStats::instance()),
 
     c_headers               (std::vector<Sass_Importer_Entry>()),
     c_importers             (std::vector<Sass_Importer_Entry>()),
@@ -73,6 +224,15 @@ namespace Sass {
 
   {
 
+    // each compilation resolves imports against the filesystem
+    // as it is now; drop existence results from earlier runs
+    File::clear_stat_cache();
+
+    // restart the high water mark so the reported peak covers
+    // this compilation (plus whatever was live when it started)
+    MemoryStats::instance().peak_live_nodes =
+      MemoryStats::instance().live_nodes;
+
     // Sass 3.4: The current working directory will no longer be placed onto the Sass load path by default.
     // If you need the current working directory to be available, set SASS_PATH=. in your shell's environment.
     // include_paths.push_back(CWD);
@@ -93,8 +253,25 @@ namespace Sass {
     sort (c_headers.begin(), c_headers.end(), sort_importers);
     sort (c_importers.begin(), c_importers.end(), sort_importers);
 
+    // arm the cooperative compile budget; the phase loops poll it
+    // through poll_compile_budget from here on
+    if (c_options.compile_budget || c_options.cancel_flag) {
+      budget_watched = true;
+      compile_deadline = std::chrono::steady_clock::now() +
+        std::chrono::milliseconds(c_options.compile_budget);
+    }
+
     emitter.set_filename(abs2rel(output_path, source_map_file, CWD));
 
+    // only pay for mapping collection when a source map
+    // can actually be requested for this compilation
+    emitter.set_srcmap_enabled(source_map_file != ""
+      || c_options.source_map_embed);
+
+    // shared value singletons carry no usable position, so hand
+    // out per-call allocations whenever mappings are collected
+    enable_value_sharing(!emitter.srcmap_enabled);
+
   }
 
   void Context::add_c_function(Sass_Function_Entry function)
@@ -116,20 +293,47 @@ namespace Sass {
 
   Context::~Context()
   {
-    // resources were allocated by malloc
+    // stop the speculative import walker before anything it may
+    // still read is torn down; pending candidates are abandoned
+    {
+      std::unique_lock<std::mutex> lock(spec_mutex);
+      spec_shutdown = true;
+      spec_queue.clear();
+    }
+    spec_cv.notify_one();
+    if (spec_worker.joinable()) spec_worker.join();
+    // a parse that threw leaves the parse-ahead workers running;
+    // they share nodes and buffers with us, so settle them first
+    finish_warm_parses();
+    // the weave poll trampoline captures this context; drop it
+    // before a later compile on this thread could dangle into us
+    setWeavePoll(0, 0);
+    // resources were allocated by malloc (or mmapped)
+    // buffers claimed by the parse cache outlive us and
+    // a borrowed source buffer belongs to the caller
     for (size_t i = 0; i < resources.size(); ++i) {
-      free(resources[i].contents);
+      if (resources[i].contents != borrowed_source &&
+          !ParseCache::instance().owns(resources[i].contents)) {
+        File::free_source(resources[i].contents);
+      }
       free(resources[i].srcmap);
     }
     // free all strings we kept alive during compiler execution
-    for (size_t n = 0; n < strings.size(); ++n) free(strings[n]);
-    // everything that gets put into sources will be freed by us
-    // this shouldn't have anything in it anyway!?
+    for (size_t n = 0; n < strings.size(); ++n) {
+      if (!ParseCache::instance().owns(strings[n])) {
+        free(strings[n]);
+      }
+    }
+    // frames left behind by unwinding borrow all their buffers,
+    // so recycling them frees nothing that others still own
     for (size_t m = 0; m < import_stack.size(); ++m) {
-      sass_import_take_source(import_stack[m]);
-      sass_import_take_srcmap(import_stack[m]);
-      sass_delete_import(import_stack[m]);
+      release_import(import_stack[m]);
+    }
+    // dispose the pooled import frames themselves
+    for (size_t m = 0; m < import_pool.size(); ++m) {
+      free(import_pool[m]);
     }
+    import_pool.clear();
     // clear inner structures (vectors) and input source
     resources.clear(); import_stack.clear();
     sheets.clear();
@@ -233,11 +437,220 @@ namespace Sass {
     return vec;
   }
 
+  // cheap scan of a token stream for @import url candidates; no
+  // real lexing is done, so a false positive — say a directive
+  // inside a comment — slips through and anything uncertain is
+  // simply skipped. Shared by the inline readahead below and the
+  // speculative closure walk (see speculate_imports), both of
+  // which only waste a little work on a wrong candidate.
+  static void scan_import_urls(const char* contents,
+                               const Tokenize::TokenStream& stream,
+                               std::vector<std::string>& urls)
+  {
+    const std::vector<Tokenize::SourceToken>& tokens = stream.tokens;
+    for (size_t i = 0, L = tokens.size(); i < L; ++i) {
+      const Tokenize::SourceToken& tok = tokens[i];
+      if (tok.kind != Tokenize::TOK_AT_KEYWORD) continue;
+      if (tok.length != 7) continue;
+      if (std::memcmp(contents + tok.offset, "@import", 7) != 0) continue;
+      // imports may list several comma separated urls
+      while (++i < L) {
+        const Tokenize::SourceToken& url_tok = tokens[i];
+        // skip the separators between the urls
+        if (url_tok.kind == Tokenize::TOK_PUNCT &&
+            contents[url_tok.offset] == ',') continue;
+        if (url_tok.kind != Tokenize::TOK_STRING) { --i; break; }
+        if (url_tok.length < 2) { --i; break; }
+        // strip the quote marks from the token span
+        std::string url(contents + url_tok.offset + 1, url_tok.length - 2);
+        // leave genuine css imports (urls, plain css) alone
+        if (url.find("://") != std::string::npos) continue;
+        if (url.compare(0, 2, "//") == 0) continue;
+        if (url.size() > 4 && url.compare(url.size() - 4, 4, ".css") == 0) continue;
+        urls.push_back(url);
+      }
+    }
+  }
+
+  // announce the import candidates of a freshly loaded source to
+  // the kernel so their pages stream in from disk while we are
+  // still parsing this file (see File::prefetch_file)
+  void Context::prefetch_imports(const std::string& ctx_path, const char* contents,
+                                 const Tokenize::TokenStream& stream)
+  {
+    std::vector<std::string> urls;
+    scan_import_urls(contents, stream, urls);
+    if (urls.empty()) return;
+    std::vector<std::string> candidates;
+    for (const std::string& url : urls) {
+      for (const Include& resolved : find_includes({ url, ctx_path })) {
+        File::prefetch_file(resolved.abs_path);
+        candidates.push_back(resolved.abs_path);
+      }
+    }
+    // hand the candidates to the closure walker, so files two or
+    // more imports deep start streaming in before the files that
+    // mention them have even begun to parse
+    if (c_options.speculative_imports) spec_enqueue(candidates);
+  }
+
+  // queue speculative candidates and lazily start the walker; a
+  // global budget bounds how much a wrong guess can ever cost
+  void Context::spec_enqueue(const std::vector<std::string>& paths)
+  {
+    std::unique_lock<std::mutex> lock(spec_mutex);
+    if (spec_shutdown) return;
+    for (const std::string& path : paths) {
+      if (spec_budget == 0) break;
+      if (!spec_seen.insert(path).second) continue;
+      --spec_budget;
+      spec_queue.push_back(path);
+    }
+    if (spec_queue.empty()) return;
+    if (!spec_worker.joinable()) {
+      spec_worker = std::thread(&Context::speculate_imports, this);
+    }
+    lock.unlock();
+    spec_cv.notify_one();
+  }
+
+  // low priority worker behind the speculative_imports option: it
+  // reads queued candidates, token-scans them for their own
+  // @import urls and announces the resolved next level to the
+  // kernel, walking the probable import closure breadth first
+  // while the main thread parses. It only touches read-only
+  // context state (the include paths) and never the AST, so it
+  // needs no thread-safe reference counts. The sequential parse
+  // stays the single source of truth; the walker merely warms the
+  // page cache, and a mispredicted candidate costs one bounded
+  // read and scan.
+  void Context::speculate_imports()
+  {
+    for (;;) {
+      std::string path;
+      {
+        std::unique_lock<std::mutex> lock(spec_mutex);
+        spec_cv.wait(lock, [this] {
+          return spec_shutdown || !spec_queue.empty(); });
+        if (spec_queue.empty()) return;
+        path = spec_queue.front();
+        spec_queue.pop_front();
+      }
+      // plain unshared read; the buffer only feeds the scan (and
+      // usually comes straight from the readahead issued when the
+      // candidate was announced)
+      char* contents = File::read_file(path);
+      if (contents == 0) continue;
+      Tokenize::TokenStream stream;
+      Tokenize::scan(contents, stream);
+      std::vector<std::string> urls;
+      scan_import_urls(contents, stream, urls);
+      File::free_source(contents);
+      std::vector<std::string> next;
+      for (const std::string& url : urls) {
+        for (const Include& resolved : find_includes({ url, path })) {
+          File::prefetch_file(resolved.abs_path);
+          next.push_back(resolved.abs_path);
+        }
+      }
+      if (!next.empty()) {
+        std::unique_lock<std::mutex> lock(spec_mutex);
+        for (const std::string& cand : next) {
+          if (spec_budget == 0) break;
+          if (!spec_seen.insert(cand).second) continue;
+          --spec_budget;
+          spec_queue.push_back(cand);
+        }
+      }
+    }
+  }
+
+  // grab a pooled frame for the import stack; fields are plain
+  // borrows (see context.hpp), only the struct itself is reused
+  Sass_Import_Entry Context::acquire_import(const char* imp_path, const char* abs_path, char* source, char* srcmap)
+  {
+    Sass_Import* v;
+    if (import_pool.empty()) {
+      v = (Sass_Import*) calloc(1, sizeof(Sass_Import));
+      if (v == 0) throw std::bad_alloc();
+    }
+    else {
+      v = import_pool.back();
+      import_pool.pop_back();
+    }
+    v->imp_path = (char*) imp_path;
+    v->abs_path = (char*) abs_path;
+    v->source = source;
+    v->srcmap = srcmap;
+    v->error = 0;
+    v->line = -1;
+    v->column = -1;
+    return v;
+  }
+
+  // return a frame to the pool; borrowed fields are only cleared,
+  // an error set through the C API on this frame was copied in
+  void Context::release_import(Sass_Import_Entry import)
+  {
+    free(import->error);
+    import->imp_path = 0;
+    import->abs_path = 0;
+    import->source = 0;
+    import->srcmap = 0;
+    import->error = 0;
+    import_pool.push_back(import);
+  }
+
+  // artifact path of the serialized parse of one source revision;
+  // keying by content hash makes entries self-invalidating (edited
+  // sources hash elsewhere, stale artifacts just stop being read)
+  static std::string ast_cache_file(const char* dir, size_t hash)
+  {
+    char name[40];
+    snprintf(name, sizeof(name), "%016llx.astc",
+             (unsigned long long) hash);
+    return std::string(dir) + "/" + name;
+  }
+
+  // slurp a cache artifact; returns 0 when it does not exist.
+  // the caller owns the buffer (plain malloc/free)
+  static char* read_ast_cache_file(const std::string& path, size_t& len)
+  {
+    len = 0;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == 0) return 0;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    if (size <= 0) { fclose(file); return 0; }
+    char* buffer = (char*) malloc(size);
+    if (buffer && fread(buffer, 1, size, file) == (size_t) size) {
+      len = (size_t) size;
+    }
+    else {
+      free(buffer); buffer = 0;
+    }
+    fclose(file);
+    return buffer;
+  }
+
+  // best effort persistence; a failed write only costs the next
+  // process a parse, so errors are deliberately swallowed
+  static void write_ast_cache_file(const std::string& path, const std::vector<char>& buf)
+  {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == 0) return;
+    fwrite(buf.data(), 1, buf.size(), file);
+    fclose(file);
+  }
+
   // register include with resolved path and its content
   // memory of the resources will be freed by us on exit
   void Context::register_resource(const Include& inc, const Resource& res)
   {
 
+    Tracing::emit("import", inc.abs_path.c_str());
+
     // do not parse same resource twice
     // maybe raise an error in this case
     // if (sheets.count(inc.abs_path)) {
@@ -256,13 +669,24 @@ namespace Sass {
     // the memory will be freed later
     resources.push_back(res);
 
+    // capture the token stream in one prelexer pass; it carries
+    // the ascii-only fact (a pure ascii buffer is always valid
+    // utf8, so the parser can skip its validation scan) and
+    // drives the import readahead below
+    Tokenize::TokenStream stream;
+    if (res.contents) Tokenize::scan(res.contents, stream);
+    resources.back().ascii = res.contents && stream.ascii;
+
+    // account the input volume for the metrics handler
+    if (res.contents) source_bytes += strlen(res.contents);
+
     // add a relative link to the working directory
     included_files.push_back(inc.abs_path);
     // add a relative link  to the source map output file
     srcmap_links.push_back(abs2rel(inc.abs_path, source_map_file, CWD));
 
     // get pointer to the loaded content
-    Sass_Import_Entry import = sass_make_import(
+    Sass_Import_Entry import = acquire_import(
       inc.imp_path.c_str(),
       inc.abs_path.c_str(),
       res.contents,
@@ -276,8 +700,11 @@ namespace Sass {
     // keep a copy of the path around (for parserstates)
     // ToDo: we clean it, but still not very elegant!?
     strings.push_back(sass_copy_c_string(inc.abs_path.c_str()));
+    // hold on to the exact pointer: parsing nested imports pushes
+    // more strings, so strings.back() moves underneath us
+    char* path_c_str = strings.back();
     // create the initial parser state from resource
-    ParserState pstate(strings.back(), contents, idx);
+    ParserState pstate(path_c_str, contents, idx);
 
     // check existing import stack for possible recursion
     for (size_t i = 0; i < import_stack.size() - 2; ++i) {
@@ -297,15 +724,106 @@ namespace Sass {
       }
     }
 
-    // create a parser instance from the given c_str buffer
-    Parser p(Parser::from_c_str(contents, *this, traces, pstate));
-    // do not yet dispose these buffers
-    sass_import_take_source(import);
-    sass_import_take_srcmap(import);
-    // then parse the root block
-    Block_Obj root = p.parse();
-    // delete memory of current stack frame
-    sass_delete_import(import_stack.back());
+    // check if we can reuse the parse result of a previous
+    // compilation on this thread (watch-mode style rebuilds)
+    size_t content_hash = ParseCache::hash_contents(contents);
+    #ifdef SASS_THREADSAFE_REFCOUNT
+    // fold in whatever the parse-ahead pipeline has finished and
+    // settle ownership if a worker is racing us for this very file
+    if (warm_running) adopt_warm_parses(inc.abs_path);
+    #endif
+    // record this source and who imported it for the graph
+    // export; the entry import at the stack bottom shares the
+    // root path, so the root file itself contributes no edge
+    import_nodes.push_back(std::make_pair(inc.abs_path, content_hash));
+    if (import_stack.size() > 1) {
+      const char* parent = import_stack[import_stack.size() - 2]->abs_path;
+      if (parent && *parent && inc.abs_path != parent) {
+        import_edges.push_back(std::make_pair(
+          std::string(parent), inc.abs_path));
+      }
+    }
+    // parsing the entry file triggers header registration as a
+    // side effect (custom headers are applied on the very first
+    // resource) and embeds the resulting import stubs in its
+    // tree, so a replayed entry tree would reference resources
+    // nobody registered; with headers present the entry always
+    // parses fresh while the header sources themselves (the
+    // expensive part, re-injected identically on every compile)
+    // keep hitting the cache under their own stable keys
+    bool cacheable = idx != 0 || c_headers.empty();
+    bool cached_placeholders = false;
+    Block_Obj root;
+    if (cacheable) {
+      root = ParseCache::instance().lookup(inc.abs_path, content_hash, idx,
+                                           emitter.srcmap_enabled,
+                                           cached_placeholders);
+    }
+    // next try the on-disk ast cache, whose artifacts persist
+    // across processes; serialized offsets are coarser than real
+    // parse positions, so source-mapped compiles skip it
+    bool ast_cache_enabled = cacheable && !emitter.srcmap_enabled &&
+      c_options.ast_cache_dir && *c_options.ast_cache_dir;
+    if (root.isNull() && ast_cache_enabled) {
+      size_t bin_len = 0;
+      std::string artifact(ast_cache_file(c_options.ast_cache_dir, content_hash));
+      if (char* bin = read_ast_cache_file(artifact, bin_len)) {
+        root = deserialize_ast(bin, bin_len, content_hash, *this,
+                               path_c_str, contents, idx,
+                               cached_placeholders);
+        free(bin);
+      }
+    }
+    if (root.isNull()) {
+      std::chrono::steady_clock::time_point started;
+      const bool timing = c_options.profile || c_options.metrics_handler != 0;
+      if (timing) started = std::chrono::steady_clock::now();
+      // overlap the imports' disk reads with parsing this file
+      // (custom importers divert loading, so skip the guesswork)
+      if (c_importers.empty()) prefetch_imports(inc.abs_path, contents, stream);
+      // track placeholder usage per file for the cache entry;
+      // while parse-ahead workers run, zeroing the shared flag
+      // here could lose a report they make in between, so those
+      // compiles keep the conservative combined answer instead
+      bool outer_placeholders = seen_placeholders;
+      if (!warm_running) seen_placeholders = false;
+      // create a parser instance from the given c_str buffer
+      Parser p(Parser::from_c_str(contents, *this, traces, pstate));
+      // then parse the root block
+      root = p.parse();
+      // attribute the parse time to this source file
+      if (timing) {
+        profile_parses.push_back(std::make_pair(inc.abs_path,
+          std::chrono::duration<double, std::milli>
+          (std::chrono::steady_clock::now() - started).count()));
+      }
+      // share the result with later compilations; the cache takes
+      // over the source buffer and path string the tree points into
+      // (a borrowed buffer dies with the caller, so never cache it)
+      if (cacheable && contents != borrowed_source) {
+        ParseCache::instance().store(inc.abs_path, content_hash, idx,
+                                     root, resources[idx].contents, path_c_str,
+                                     seen_placeholders, !emitter.srcmap_enabled);
+      }
+      // persist the fresh parse for later processes; trees using
+      // constructs outside the format simply stay uncached
+      if (ast_cache_enabled) {
+        std::vector<char> artifact;
+        if (serialize_ast(root, contents, content_hash,
+                          seen_placeholders, artifact)) {
+          write_ast_cache_file(
+            ast_cache_file(c_options.ast_cache_dir, content_hash), artifact);
+        }
+      }
+      seen_placeholders = seen_placeholders || outer_placeholders;
+    }
+    else {
+      // replay the flag recorded when the tree was parsed
+      seen_placeholders = seen_placeholders || cached_placeholders;
+    }
+    // recycle the current stack frame (the buffers it borrowed
+    // stay with the resource registry and the caller)
+    release_import(import_stack.back());
     // remove current stack frame
     import_stack.pop_back();
     // create key/value pair for ast node
@@ -348,10 +866,21 @@ namespace Sass {
     else if (resolved.size() == 1) {
       bool use_cache = c_importers.size() == 0;
       // use cache for the resource loading
-      if (use_cache && sheets.count(resolved[0].abs_path)) return resolved[0];
+      if (use_cache && sheets.count(resolved[0].abs_path)) {
+        // the resource is shared, but this importer still gets
+        // its edge so the exported graph has the complete fan-in
+        if (!import_stack.empty()) {
+          const char* parent = import_stack.back()->abs_path;
+          if (parent && *parent && resolved[0].abs_path != parent) {
+            import_edges.push_back(std::make_pair(
+              std::string(parent), resolved[0].abs_path));
+          }
+        }
+        return resolved[0];
+      }
       // try to read the content of the resolved file entry
       // the memory buffer returned must be freed by us!
-      if (char* contents = read_file(resolved[0].abs_path)) {
+      if (char* contents = read_file(resolved[0].abs_path, c_options.mmap_sources, c_options.share_sources)) {
         // register the newly resolved file resource
         register_resource(resolved[0], { contents, 0 }, pstate);
         // return resolved entry
@@ -403,6 +932,25 @@ namespace Sass {
 
 
   // call custom importers on the given (unquoted) load_path and eventually parse the resulting style_sheet
+  void Context::announce_imports(const std::vector<std::string>& urls)
+  {
+    if (urls.empty()) return;
+    // cheap scan first; most importers register no prefetch hook
+    bool any = false;
+    for (Sass_Importer_Entry& importer_ent : c_importers) {
+      if (sass_importer_get_prefetch_function(importer_ent)) { any = true; break; }
+    }
+    if (!any) return;
+    std::vector<const char*> ptrs;
+    ptrs.reserve(urls.size());
+    for (const std::string& url : urls) ptrs.push_back(url.c_str());
+    for (Sass_Importer_Entry& importer_ent : c_importers) {
+      if (Sass_Importer_Prefetch_Fn fn = sass_importer_get_prefetch_function(importer_ent)) {
+        fn(ptrs.data(), ptrs.size(), importer_ent, c_compiler);
+      }
+    }
+  }
+
   bool Context::call_loader(const std::string& load_path, const char* ctx_path, ParserState& pstate, Import* imp, std::vector<Sass_Importer_Entry> importers, bool only_one)
   {
     // unique counter
@@ -489,16 +1037,103 @@ namespace Sass {
   void register_c_functions(Context&, Env* env, Sass_Function_List);
   void register_c_function(Context&, Env* env, Sass_Function_Entry);
 
+  // monotonic clock helper for the profile option
+  static double profile_msec(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>
+           (std::chrono::steady_clock::now() - start).count();
+  }
+
+  // Rough output size and mapping count for the expanded tree, so
+  // render can reserve its buffers once instead of letting them
+  // double their way up with a full copy each time. Only the order
+  // of magnitude matters; known string lengths are counted exactly
+  // and everything else contributes a flat ballpark figure.
+  static size_t estimate_output_size(Block* block, size_t& statements)
+  {
+    if (block == 0) return 0;
+    size_t bytes = 0;
+    for (const Statement_Obj& stm : block->elements()) {
+      Statement* s = stm.ptr();
+      ++statements;
+      if (Declaration* d = Cast<Declaration>(s)) {
+        // indentation, colon, space and terminator
+        bytes += 8;
+        if (String_Constant* prop = Cast<String_Constant>(d->property())) {
+          bytes += prop->value().size();
+        }
+        if (String_Constant* val = Cast<String_Constant>(d->value())) {
+          bytes += val->value().size();
+        }
+        else if (d->value()) bytes += 12;
+        bytes += estimate_output_size(d->block(), statements);
+        continue;
+      }
+      if (Comment* c = Cast<Comment>(s)) {
+        if (String_Constant* text = Cast<String_Constant>(c->text())) {
+          bytes += text->value().size();
+        }
+        bytes += 4;
+        continue;
+      }
+      if (Has_Block* hb = Cast<Has_Block>(s)) {
+        // selector or at-rule prelude, braces and linefeeds
+        bytes += 48;
+        bytes += estimate_output_size(hb->block(), statements);
+        continue;
+      }
+      bytes += 16;
+    }
+    return bytes;
+  }
+
   char* Context::render(Block_Obj root)
   {
     // check for valid block
     if (!root) return 0;
+    // one reserve call up front beats a couple dozen doubling
+    // reallocations on multi-megabyte outputs; skipped for small
+    // trees where organic growth never reallocates anyway
+    size_t statements = 0;
+    size_t estimate = estimate_output_size(root, statements);
+    if (estimate > 16384) {
+      OutputBuffer& buffer = emitter.get_buffer();
+      buffer.buffer.reserve(estimate + estimate / 4);
+      // rule headers and declarations open and close one mapping
+      // each; presize for them when mappings are collected at all
+      if (emitter.srcmap_enabled) {
+        buffer.smap.reserve(statements * 2);
+      }
+    }
+    const bool timing = c_options.profile || c_options.metrics_handler != 0;
+    std::chrono::steady_clock::time_point started;
+    if (timing) started = std::chrono::steady_clock::now();
+    // let the emitter honor the compile budget between statements
+    if (budget_watched) {
+      emitter.set_budget_poll([](void* cookie) {
+        static_cast<Context*>(cookie)->poll_compile_budget();
+      }, this);
+    }
     // start the render process
-    root->perform(&emitter);
+    Tracing::emit("phase:begin", "render");
+    // partitioned rendering shares AST nodes across threads,
+    // which is only defined behavior with atomic refcounts
+    #ifdef SASS_THREADSAFE_REFCOUNT
+    if (c_options.render_threads > 1 && root->length() > 1) {
+      render_root_parallel(root);
+    } else
+    #endif
+    {
+      root->perform(&emitter);
+    }
     // finish emitter stream
     emitter.finalize();
+    Tracing::emit("phase:end", "render");
+    if (timing) {
+      profile_phases.push_back(std::make_pair("render", profile_msec(started)));
+    }
     // get the resulting buffer from stream
-    OutputBuffer emitted = emitter.get_buffer();
+    OutputBuffer& emitted = emitter.get_buffer();
     // should we append a source map url?
     if (!c_options.omit_source_map_url) {
       // generate an embedded source map
@@ -512,11 +1147,105 @@ namespace Sass {
         emitted.buffer += format_source_mapping_url(source_map_file);
       }
     }
+    // stream through the registered writer in chunks; the
+    // implementor then gets no output_string copy at all
+    if (c_options.output_writer) {
+      const std::string& out = emitted.buffer;
+      const size_t chunk = 64 * 1024;
+      for (size_t i = 0; i < out.size(); i += chunk) {
+        c_options.output_writer(out.c_str() + i,
+          std::min(chunk, out.size() - i),
+          c_options.output_writer_cookie);
+      }
+      return 0;
+    }
     // create a copy of the resulting buffer string
     // this must be freed or taken over by implementor
     return sass_copy_c_string(emitted.buffer.c_str());
   }
 
+  // Render the root statements in contiguous chunks, the first one
+  // on this thread into the main emitter and the rest on workers
+  // into their own emitters, then merge the buffers in document
+  // order with the source mappings rebased per chunk. Emission
+  // takes and drops references on nodes that extend and eval share
+  // between top-level rules, so callers must only enable this when
+  // the build uses thread-safe reference counts.
+  void Context::render_root_parallel(Block_Obj root)
+  {
+    size_t length = root->length();
+    size_t nthreads = c_options.render_threads;
+    if (nthreads > length) nthreads = length;
+    size_t per_chunk = (length + nthreads - 1) / nthreads;
+    // emitters for the continuation chunks (deque since
+    // outputs hold a reference and cannot be moved around)
+    std::deque<Output> chunks;
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> failures(nthreads - 1);
+    workers.reserve(nthreads - 1);
+    for (size_t begin = per_chunk; begin < length; begin += per_chunk) {
+      size_t end = std::min(begin + per_chunk, length);
+      chunks.emplace_back(c_options);
+      Output* out = &chunks.back();
+      out->set_srcmap_enabled(emitter.srcmap_enabled);
+      // output precedes these chunks, so their leading
+      // comments must not move to the document top
+      out->hoist_comments = false;
+      std::exception_ptr* failed = &failures[workers.size()];
+      workers.push_back(std::thread([out, begin, end, &root, failed]() {
+        try {
+          for (size_t i = begin; i < end; ++i) {
+            (*root)[i]->perform(out);
+          }
+        }
+        catch (...) { *failed = std::current_exception(); }
+      }));
+    }
+    // render the first chunk on this thread meanwhile; hold any
+    // failure instead of unwinding — the thread vector would
+    // terminate the process while the workers are still joinable
+    std::exception_ptr main_failure;
+    try {
+      for (size_t i = 0; i < per_chunk && i < length; ++i) {
+        (*root)[i]->perform(&emitter);
+      }
+    }
+    catch (...) { main_failure = std::current_exception(); }
+    // join all workers before a failure can propagate
+    for (size_t i = 0; i < workers.size(); ++i) {
+      workers[i].join();
+    }
+    // the first chunk comes first in document order, so its
+    // failure wins, like it would in a single-threaded render
+    if (main_failure) std::rethrow_exception(main_failure);
+    for (size_t i = 0; i < failures.size(); ++i) {
+      if (failures[i]) std::rethrow_exception(failures[i]);
+    }
+    // merge the chunks in document order
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      emitter.merge_chunk(chunks[i]);
+    }
+  }
+
+  char* Context::render_styled(Block_Obj root, Sass_Output_Style style)
+  {
+    // check for valid block
+    if (!root) return 0;
+    // share the inspect options but render in the requested
+    // style; source maps stay with the primary emitter, so
+    // mapping collection is skipped for secondary renders
+    Sass_Output_Options opts(c_options);
+    opts.output_style = style;
+    Output out(opts);
+    out.set_srcmap_enabled(false);
+    root->perform(&out);
+    // finish emitter stream
+    out.finalize();
+    // create a copy of the resulting buffer string
+    // this must be freed or taken over by implementor
+    return sass_copy_c_string(out.get_buffer().buffer.c_str());
+  }
+
   void Context::apply_custom_headers(Block_Obj root, const char* ctx_path, ParserState pstate)
   {
     // create a custom import to resolve headers
@@ -534,18 +1263,234 @@ namespace Sass {
     }
   }
 
+  // entry path to the import closure of its last successful parse
+  // on this thread, each file with the resource index it was
+  // registered under; lets a rebuild of the same entry warm the
+  // parse cache for the whole closure while the sequential parse
+  // re-discovers it (see warm_parse_cache)
+  static thread_local std::unordered_map<std::string,
+    std::vector<std::pair<std::string, size_t>>> parse_closures;
+
+  // lifecycle of a parse-ahead job (Context::WarmJob::state)
+  enum {
+    WARM_PENDING,  // queued, nobody has touched it yet
+    WARM_RUNNING,  // a worker is parsing it right now
+    WARM_DONE,     // parsed, tree waiting to be adopted
+    WARM_FAILED,   // speculative parse threw; the sequential
+                   // parse will report the error properly
+    WARM_TAKEN,    // the sequential parse claimed it first
+    WARM_ADOPTED   // tree handed over to the parse cache
+  };
+
+  // Parse the files the previous compile of this entry loaded on a
+  // pool of workers, pipelined against the sequential parse of this
+  // compile: this only queues the jobs and starts the workers, then
+  // returns so the sequential pass can begin immediately. The two
+  // sides meet in adopt_warm_parses right before each parse-cache
+  // lookup — by the time the import walk reaches a file, a worker
+  // has usually long finished it, so most of the closure's parse
+  // latency hides behind the work done between imports. Parsing a
+  // file only needs its source text, but registering an @import is
+  // a parse side effect that assigns resource indices in discovery
+  // order — files mentioning @import anywhere are therefore left to
+  // the sequential pass, as is any file whose content hash or
+  // remembered index no longer matches its cache slot (a stale
+  // closure simply degrades to the sequential parse). The workers
+  // share AST nodes with this thread, so callers must only enable
+  // this when the build uses thread-safe reference counts.
+  void Context::warm_parse_cache()
+  {
+    auto remembered = parse_closures.find(input_path);
+    if (remembered == parse_closures.end()) return;
+
+    // read and fingerprint on this thread (the cheap part, and the
+    // cache is ours alone) and queue only files it does not cover
+    for (const auto& source : remembered->second) {
+      char* contents = read_file(source.first, c_options.mmap_sources, c_options.share_sources);
+      if (contents == 0) continue;
+      size_t hash = ParseCache::hash_contents(contents);
+      bool unused = false;
+      if (!ParseCache::instance().lookup(source.first, hash,
+            source.second, emitter.srcmap_enabled, unused).isNull() ||
+          std::strstr(contents, "@import") != 0) {
+        File::free_source(contents);
+        continue;
+      }
+      warm_jobs.emplace_back();
+      WarmJob& job = warm_jobs.back();
+      job.abs_path = source.first;
+      job.idx = source.second;
+      job.hash = hash;
+      job.contents = contents;
+      job.path = sass_copy_c_string(source.first.c_str());
+      job.state.store(WARM_PENDING);
+    }
+    if (warm_jobs.empty()) return;
+
+    // the compile thread parses sequentially while the pipeline
+    // runs, so only parse_threads - 1 helpers join in
+    size_t nthreads = c_options.parse_threads - 1;
+    if (nthreads > warm_jobs.size()) nthreads = warm_jobs.size();
+    // shard the queue into one contiguous range per worker; jobs
+    // were queued in the order their buffers were read, so a
+    // worker draining its own shard front to back walks adjacent
+    // allocations instead of interleaving with every other worker
+    // across the whole queue. Claims contend on a per-shard
+    // cursor, and a worker only crosses into another shard (the
+    // one with the most work left) once its own is drained
+    warm_shard_count = nthreads;
+    warm_shards.reset(new WarmShard[nthreads]);
+    size_t per_shard = (warm_jobs.size() + nthreads - 1) / nthreads;
+    for (size_t i = 0; i < nthreads; ++i) {
+      warm_shards[i].cursor.store(i * per_shard);
+      warm_shards[i].end = std::min((i + 1) * per_shard, warm_jobs.size());
+    }
+    warm_stop.store(false);
+    warm_workers.reserve(nthreads);
+    for (size_t i = 0; i < nthreads; ++i) {
+      warm_workers.emplace_back(&Context::warm_work, this, i);
+    }
+    warm_running = true;
+  }
+
+  // worker body of the parse-ahead pipeline; claims jobs through
+  // the shard cursors and races the sequential parse for each one
+  // with a compare-and-swap, so a file both sides reach is only
+  // ever parsed where the claim landed
+  void Context::warm_work(size_t self)
+  {
+    size_t target = self;
+    while (!warm_stop.load()) {
+      WarmShard& shard = warm_shards[target];
+      for (size_t i = shard.cursor++; i < shard.end; i = shard.cursor++) {
+        if (warm_stop.load()) return;
+        WarmJob& job = warm_jobs[i];
+        int expected = WARM_PENDING;
+        if (!job.state.compare_exchange_strong(expected, WARM_RUNNING)) continue;
+        try {
+          Backtraces traces;
+          ParserState pstate(job.path, job.contents, job.idx);
+          Parser p(Parser::from_c_str(job.contents, *this, traces, pstate));
+          job.root = p.parse();
+          job.state.store(WARM_DONE);
+        }
+        catch (...) { job.state.store(WARM_FAILED); }
+      }
+      // own shard drained; steal from the fullest one left
+      size_t best_left = 0;
+      size_t next = warm_shard_count;
+      for (size_t k = 0; k < warm_shard_count; ++k) {
+        size_t cur = warm_shards[k].cursor.load();
+        size_t left = cur < warm_shards[k].end ? warm_shards[k].end - cur : 0;
+        if (left > best_left) { best_left = left; next = k; }
+      }
+      if (next == warm_shard_count) break;
+      target = next;
+    }
+  }
+
+  // Fold everything the parse-ahead workers have finished into the
+  // parse cache so the lookup that follows can hit it. For the file
+  // the sequential parse is about to need: a pending job is taken
+  // over (parsing it here beats waiting for a worker to get around
+  // to it), and a job mid-parse is waited out — the worker is
+  // almost done, redoing its work would cost more than the wait.
+  // Placeholder attribution is shared across workers, so adopted
+  // entries get the conservative combined answer (an unneeded
+  // placeholder removal pass is just a no-op); a worker publishes
+  // its flag before it publishes WARM_DONE, so the combined answer
+  // read here can never understate an adopted tree.
+  void Context::adopt_warm_parses(const std::string& wanted)
+  {
+    for (WarmJob& job : warm_jobs) {
+      int state = job.state.load();
+      if (state == WARM_ADOPTED || state == WARM_TAKEN) continue;
+      if (job.abs_path == wanted) {
+        if (state == WARM_PENDING) {
+          int expected = WARM_PENDING;
+          if (job.state.compare_exchange_strong(expected, WARM_TAKEN)) continue;
+          state = expected;
+        }
+        while (state == WARM_RUNNING) {
+          std::this_thread::yield();
+          state = job.state.load();
+        }
+      }
+      if (state == WARM_DONE &&
+          job.state.compare_exchange_strong(state, WARM_ADOPTED)) {
+        ParseCache::instance().store(job.abs_path, job.hash, job.idx,
+          job.root, job.contents, job.path, seen_placeholders,
+          !emitter.srcmap_enabled);
+        job.root = {};
+      }
+    }
+  }
+
+  // Stop the parse-ahead workers and settle what they produced:
+  // finished trees still warm the cache for the next rebuild (a
+  // file the sequential parse never reached just fell out of the
+  // closure), everything else releases its buffers. Called when
+  // the sequential parse completes and again, as a no-op by then,
+  // from the destructor to cover error exits.
+  void Context::finish_warm_parses()
+  {
+    if (!warm_running) return;
+    warm_stop.store(true);
+    for (auto& worker : warm_workers) worker.join();
+    warm_workers.clear();
+    warm_running = false;
+    for (WarmJob& job : warm_jobs) {
+      int state = job.state.load();
+      if (state == WARM_DONE) {
+        ParseCache::instance().store(job.abs_path, job.hash, job.idx,
+          job.root, job.contents, job.path, seen_placeholders,
+          !emitter.srcmap_enabled);
+      }
+      else if (state != WARM_ADOPTED) {
+        File::free_source(job.contents);
+        free(job.path);
+      }
+      job.root = {};
+    }
+    warm_jobs.clear();
+  }
+
+  // remember what this compile loaded for the next rebuild's
+  // warm-up; resources and import nodes are appended pairwise,
+  // so the position of an import node is its resource index
+  void Context::remember_parse_closure()
+  {
+    std::vector<std::pair<std::string, size_t>>& closure =
+      parse_closures[input_path];
+    closure.clear();
+    for (size_t i = 0; i < import_nodes.size(); ++i) {
+      closure.push_back(std::make_pair(import_nodes[i].first, i));
+    }
+  }
+
   Block_Obj File_Context::parse()
   {
 
     // check if entry file is given
     if (input_path.empty()) return {};
 
+    #ifdef SASS_THREADSAFE_REFCOUNT
+    // start the parse-ahead pipeline over the previous compile's
+    // closure; it keeps warming the parse cache while the
+    // sequential parse below runs (pluggable loaders divert or
+    // reorder loading, so never speculate when any are registered)
+    if (c_options.parse_threads > 1 &&
+        c_importers.empty() && c_headers.empty()) {
+      warm_parse_cache();
+    }
+    #endif
+
     // create absolute path from input filename
     // ToDo: this should be resolved via custom importers
     std::string abs_path(rel2abs(input_path, CWD));
 
     // try to load the entry file
-    char* contents = read_file(abs_path);
+    char* contents = read_file(abs_path, c_options.mmap_sources, c_options.share_sources);
 
     // alternatively also look inside each include path folder
     // I think this differs from ruby sass (IMO too late to remove)
@@ -553,7 +1498,7 @@ namespace Sass {
       // build absolute path for this include path entry
       abs_path = rel2abs(input_path, include_paths[i]);
       // try to load the resulting path
-      contents = read_file(abs_path);
+      contents = read_file(abs_path, c_options.mmap_sources, c_options.share_sources);
     }
 
     // abort early if no content could be loaded (various reasons)
@@ -563,7 +1508,7 @@ namespace Sass {
     entry_path = abs_path;
 
     // create entry only for import stack
-    Sass_Import_Entry import = sass_make_import(
+    Sass_Import_Entry import = acquire_import(
       input_path.c_str(),
       entry_path.c_str(),
       contents,
@@ -575,6 +1520,17 @@ namespace Sass {
     // create the source entry for file entry
     register_resource({{ input_path, "." }, abs_path }, { contents, 0 });
 
+    #ifdef SASS_THREADSAFE_REFCOUNT
+    // the sequential parse is complete; stop the parse-ahead
+    // workers and settle their remaining results
+    finish_warm_parses();
+    // remember the loaded closure for the next rebuild's warm-up
+    if (c_options.parse_threads > 1 &&
+        c_importers.empty() && c_headers.empty()) {
+      remember_parse_closure();
+    }
+    #endif
+
     // create root ast tree node
     return compile();
 
@@ -593,7 +1549,10 @@ namespace Sass {
         // preserve the structure as much as possible
         SASS2SCSS_PRETTIFY_1 | SASS2SCSS_KEEP_COMMENT);
       // replace old source_c_str with converted
-      free(source_c_str); source_c_str = converted;
+      // the converted copy is ours even if the input was a view
+      if (source_c_str == borrowed_source) borrowed_source = 0;
+      else free(source_c_str);
+      source_c_str = converted;
     }
 
     // remember entry path (defaults to stdin for string)
@@ -605,7 +1564,7 @@ namespace Sass {
     strings.push_back(abs_path_c_str);
 
     // create entry only for the import stack
-    Sass_Import_Entry import = sass_make_import(
+    Sass_Import_Entry import = acquire_import(
       entry_path.c_str(),
       abs_path_c_str,
       source_c_str,
@@ -622,6 +1581,23 @@ namespace Sass {
   }
 
   // parse root block from includes
+  // Slow half of the cooperative budget poll: consult the caller's
+  // cancel token first (so a cancelled compile reports as cancelled
+  // even when it also overran), then the wall-clock deadline. The
+  // phase loops reach this through poll_compile_budget, so an
+  // overrunning compile stops within a few loop iterations instead
+  // of running to completion.
+  void Context::check_compile_budget()
+  {
+    if (c_options.cancel_flag && *c_options.cancel_flag) {
+      throw Exception::CompileCancelled(false);
+    }
+    if (c_options.compile_budget &&
+        std::chrono::steady_clock::now() > compile_deadline) {
+      throw Exception::CompileCancelled(true);
+    }
+  }
+
   Block_Obj Context::compile()
   {
     // abort if there is no data
@@ -630,6 +1606,21 @@ namespace Sass {
     Block_Obj root = sheets.at(entry_path).root;
     // abort on invalid root
     if (root.isNull()) return {};
+    // parsing recorded every position, so from here on the raw
+    // source bytes only matter for error excerpts and embedded map
+    // sources; hand mapped pages back to the kernel now and let
+    // those rare readers fault them in again on demand. skipped
+    // when the map will embed the sources right after rendering
+    if (c_options.mmap_sources && !c_options.source_map_contents) {
+      for (size_t i = 0, L = resources.size(); i < L; ++i) {
+        File::drop_source_pages(resources[i].contents);
+      }
+    }
+    // find the definitions no emitted code can reach, so the
+    // expansion below skips registering and evaluating them
+    if (c_options.tree_shaking) {
+      shaken_names = find_unreachable_definitions(*this);
+    }
     Env global; // create root environment
     // register built-in functions on env
     register_built_in_functions(*this, &global);
@@ -641,13 +1632,48 @@ namespace Sass {
     Expand expand(*this, &global);
     Cssize cssize(*this);
     CheckNesting check_nesting;
-    // check nesting in all files
-    for (auto sheet : sheets) {
-      auto styles = sheet.second;
-      check_nesting(styles.root);
+    // timestamp the phases below when profiling or
+    // when a metrics handler wants to hear about them
+    const bool timing = c_options.profile || c_options.metrics_handler != 0;
+    size_t nesting_idx = 0;
+    std::chrono::steady_clock::time_point started;
+    if (timing) {
+      // parsing already happened; sum the per-file timings
+      double parse = 0;
+      for (auto& file : profile_parses) parse += file.second;
+      profile_phases.push_back(std::make_pair("parse", parse));
+      nesting_idx = profile_phases.size();
+      profile_phases.push_back(std::make_pair("check_nesting", 0.0));
+      started = std::chrono::steady_clock::now();
+    }
+    // check nesting in all files; trusted input was validated by
+    // whoever generated it, so the author-error pass can be skipped
+    if (!c_options.trusted_input) {
+      for (auto sheet : sheets) {
+        auto styles = sheet.second;
+        check_nesting(styles.root);
+      }
+    }
+    if (timing) {
+      profile_phases[nesting_idx].second += profile_msec(started);
+      started = std::chrono::steady_clock::now();
     }
+    // arm (or disarm) the weave complexity guard for this compile
+    setWeaveBudget(c_options.extend_budget);
+    // the weave helpers are free functions with no context access,
+    // so the compile budget reaches them through this trampoline;
+    // pathological @extend weaving then honors it too
+    void (*weave_poll)(void*) = 0;
+    if (budget_watched) {
+      weave_poll = [](void* cookie) {
+        static_cast<Context*>(cookie)->check_compile_budget();
+      };
+    }
+    setWeavePoll(weave_poll, this);
     // expand and eval the tree
+    Tracing::emit("phase:begin", "expand");
     root = expand(root);
+    Tracing::emit("phase:end", "expand");
 
     Extension unsatisfied;
     // check that all extends were used
@@ -655,15 +1681,52 @@ namespace Sass {
       throw Exception::UnsatisfiedExtend(traces, unsatisfied);
     }
 
-    // check nesting
-    check_nesting(root);
+    // a budgeted weave that got truncated delivered an approximate
+    // result; say so instead of silently dropping combinations
+    if (weaveTruncated()) {
+      std::ostringstream message;
+      message << "WARNING: @extend selector weaving exceeded the budget of "
+        << c_options.extend_budget << " combinations;" << "\n"
+        << "the output keeps the combinations woven within the budget "
+        << "and drops the rest." << "\n";
+      Messages::emit(message.str());
+    }
+
+    if (timing) {
+      profile_phases.push_back(std::make_pair("expand", profile_msec(started)));
+      started = std::chrono::steady_clock::now();
+    }
+    // check nesting (see above for the trusted input exemption)
+    if (!c_options.trusted_input) check_nesting(root);
+    if (timing) {
+      profile_phases[nesting_idx].second += profile_msec(started);
+      started = std::chrono::steady_clock::now();
+    }
     // merge and bubble certain rules
+    Tracing::emit("phase:begin", "cssize");
     root = cssize(root);
+    Tracing::emit("phase:end", "cssize");
 
+    if (timing) {
+      profile_phases.push_back(std::make_pair("cssize", profile_msec(started)));
+      started = std::chrono::steady_clock::now();
+    }
     // clean up by removing empty placeholders
     // ToDo: maybe we can do this somewhere else?
-    Remove_Placeholders remove_placeholders;
-    root->perform(&remove_placeholders);
+    // skip the whole pass when no placeholder was ever parsed
+    if (seen_placeholders) {
+      Remove_Placeholders remove_placeholders;
+      root->perform(&remove_placeholders);
+    }
+    if (timing) {
+      profile_phases.push_back(std::make_pair("remove_placeholders", profile_msec(started)));
+    }
+
+    // optionally drop declarations overridden within their block
+    if (c_options.dedup_declarations) {
+      Dedup_Declarations dedup;
+      root->perform(&dedup);
+    }
 
     // return processed tree
     return root;
@@ -673,13 +1736,10 @@ namespace Sass {
   std::string Context::format_embedded_source_map()
   {
     std::string map = emitter.render_srcmap(*this);
-    std::istringstream is( map );
-    std::ostringstream buffer;
-    base64::encoder E;
-    E.encode(is, buffer);
-    std::string url = "data:application/json;base64," + buffer.str();
-    url.erase(url.size() - 1);
-    return "/*# sourceMappingURL=" + url + " */";
+    std::string url = "/*# sourceMappingURL=data:application/json;base64,";
+    url += encode_base64(map.data(), map.size());
+    url += " */";
+    return url;
   }
 
   std::string Context::format_source_mapping_url(const std::string& file)
@@ -695,6 +1755,201 @@ namespace Sass {
     return sass_copy_c_string(map.c_str());
   }
 
+  // serialize collected timings (profile option)
+  // object keys keep the phase execution order
+  char* Context::render_profile_json()
+  {
+    if (!c_options.profile) return 0;
+    JsonNode* json = json_mkobject();
+    JsonNode* phases = json_mkobject();
+    for (auto& phase : profile_phases) {
+      json_append_member(phases, phase.first.c_str(), json_mknumber(phase.second));
+    }
+    json_append_member(json, "phases", phases);
+    JsonNode* files = json_mkobject();
+    for (auto& file : profile_parses) {
+      json_append_member(files, file.first.c_str(), json_mknumber(file.second));
+    }
+    json_append_member(json, "parsed_files", files);
+    char* result = 0;
+    try { result = json_stringify(json, "  "); }
+    catch (...) { }
+    json_delete(json);
+    return result;
+  }
+
+  // serialize the allocation counter deltas since this context
+  // was created; the counters are always on (plain thread local
+  // increments), so this needs no option to be requested
+  char* Context::render_stats_json()
+  {
+    MemoryStats& now = MemoryStats::instance();
+    JsonNode* json = json_mkobject();
+    json_append_member(json, "node_allocations",
+      json_mknumber((double) (now.node_allocations - stats_start.node_allocations)));
+    json_append_member(json, "node_bytes",
+      json_mknumber((double) (now.node_bytes - stats_start.node_bytes)));
+    json_append_member(json, "string_bytes",
+      json_mknumber((double) (now.string_bytes - stats_start.string_bytes)));
+    json_append_member(json, "env_frames",
+      json_mknumber((double) (now.env_frames - stats_start.env_frames)));
+    // nodes alive before we started (cached parse trees etc.)
+    json_append_member(json, "live_nodes_at_start",
+      json_mknumber((double) stats_start.live_nodes));
+    // high water mark of live nodes while this context compiled
+    json_append_member(json, "peak_live_nodes",
+      json_mknumber((double) now.peak_live_nodes));
+    char* result = 0;
+    try { result = json_stringify(json, "  "); }
+    catch (...) { }
+    json_delete(json);
+    return result;
+  }
+
+
+  // Fill the stable metrics struct handed to the C-API handler.
+  // Durations come from the same collection the profile option
+  // feeds on (enabled by the handler itself), the counters from
+  // the thread local allocation statistics snapshot
+  void Context::collect_metrics(struct Sass_Compile_Metrics& metrics)
+  {
+    metrics = Sass_Compile_Metrics();
+    double total = 0;
+    for (auto& phase : profile_phases) {
+      if (phase.first == "parse") metrics.parse_msec += phase.second;
+      else if (phase.first == "check_nesting") metrics.check_nesting_msec += phase.second;
+      else if (phase.first == "expand") metrics.expand_msec += phase.second;
+      else if (phase.first == "cssize") metrics.cssize_msec += phase.second;
+      else if (phase.first == "remove_placeholders") metrics.remove_placeholders_msec += phase.second;
+      else if (phase.first == "render") metrics.render_msec += phase.second;
+      total += phase.second;
+    }
+    metrics.total_msec = total;
+    metrics.files_parsed = resources.size();
+    metrics.bytes_in = source_bytes;
+    MemoryStats& now = MemoryStats::instance();
+    metrics.node_allocations = now.node_allocations - stats_start.node_allocations;
+    metrics.node_bytes = now.node_bytes - stats_start.node_bytes;
+    metrics.peak_live_nodes = now.peak_live_nodes;
+  }
+
+  // Serialize the import dependency graph collected while the
+  // sources were loaded. Nodes carry the same content hash the
+  // parse cache keys on, so build systems can schedule partial
+  // recompiles and skip targets whose inputs did not change.
+  char* Context::render_import_graph_json()
+  {
+    JsonNode* json = json_mkobject();
+    JsonNode* nodes = json_mkarray();
+    std::unordered_set<std::string> seen_nodes;
+    for (const auto& node : import_nodes) {
+      // a file imported from several places registers once
+      if (!seen_nodes.insert(node.first).second) continue;
+      JsonNode* entry = json_mkobject();
+      json_append_member(entry, "path", json_mkstring(node.first.c_str()));
+      // hex string since json numbers cannot carry 64 bits
+      std::stringstream hash;
+      hash << std::hex << node.second;
+      json_append_member(entry, "hash", json_mkstring(hash.str().c_str()));
+      json_append_element(nodes, entry);
+    }
+    json_append_member(json, "nodes", nodes);
+    JsonNode* edges = json_mkarray();
+    std::unordered_set<std::string> seen_edges;
+    for (const auto& edge : import_edges) {
+      if (!seen_edges.insert(edge.first + "\n" + edge.second).second) continue;
+      JsonNode* entry = json_mkobject();
+      json_append_member(entry, "parent", json_mkstring(edge.first.c_str()));
+      json_append_member(entry, "child", json_mkstring(edge.second.c_str()));
+      json_append_element(edges, entry);
+    }
+    json_append_member(json, "edges", edges);
+    char* result = 0;
+    try { result = json_stringify(json, "  "); }
+    catch (...) { }
+    json_delete(json);
+    return result;
+  }
+
+
+  // entry path to the import closure of its last successful
+  // compile on this thread; watch loops rebuild on the same
+  // thread, just like the parse cache assumes
+  static thread_local std::unordered_map<std::string,
+    std::vector<std::string>> output_closures;
+
+  // fingerprint of everything besides the sources that shapes
+  // the rendered output, mixed into both cache keys below
+  static size_t output_options_fingerprint(Context& ctx,
+    struct Sass_Options& options)
+  {
+    std::stringstream fp;
+    fp << options.output_style << ';' << options.precision << ';'
+       << options.source_comments << ';' << options.omit_source_map_url << ';'
+       << options.source_map_embed << ';' << options.source_map_contents << ';'
+       << options.source_map_file_urls << ';' << options.source_map_granularity << ';'
+       << ctx.indent << ';' << ctx.linefeed << ';'
+       << ctx.input_path << ';' << ctx.output_path << ';'
+       << ctx.source_map_file << ';' << ctx.source_map_root;
+    return std::hash<std::string>()(fp.str());
+  }
+
+  // cache key over the sources this compile actually loaded,
+  // in load order; matches what the prediction below computes
+  // when every file of the closure is unchanged
+  std::string Context::output_cache_key_current()
+  {
+    size_t key = output_options_fingerprint(*this, c_options);
+    std::unordered_set<std::string> seen;
+    for (const auto& node : import_nodes) {
+      if (!seen.insert(node.first).second) continue;
+      hash_combine(key, std::hash<std::string>()(node.first));
+      hash_combine(key, node.second);
+    }
+    std::stringstream hex;
+    hex << std::hex << key;
+    return hex.str();
+  }
+
+  // predict the key by re-hashing the closure remembered from
+  // the previous compile of this entry; cheap file reads stand
+  // in for the full parse/eval/render pipeline
+  std::string Context::output_cache_key_previous()
+  {
+    // pluggable importers, headers and functions can change the
+    // output without any source changing; never predict for them
+    if (!c_importers.empty()) return "";
+    if (!c_headers.empty()) return "";
+    if (!c_functions.empty()) return "";
+    auto closure = output_closures.find(input_path);
+    if (closure == output_closures.end()) return "";
+    size_t key = output_options_fingerprint(*this, c_options);
+    for (const std::string& path : closure->second) {
+      char* contents = read_file(path, c_options.mmap_sources, c_options.share_sources);
+      if (contents == 0) return "";
+      hash_combine(key, std::hash<std::string>()(path));
+      hash_combine(key, ParseCache::hash_contents(contents));
+      File::free_source(contents);
+    }
+    std::stringstream hex;
+    hex << std::hex << key;
+    return hex.str();
+  }
+
+  // remember the deduplicated closure in load order so the next
+  // rebuild of this entry can predict its key without compiling
+  void Context::remember_output_closure()
+  {
+    std::vector<std::string>& closure = output_closures[input_path];
+    closure.clear();
+    std::unordered_set<std::string> seen;
+    for (const auto& node : import_nodes) {
+      if (seen.insert(node.first).second) {
+        closure.push_back(node.first);
+      }
+    }
+  }
+
 
   // for data context we want to start after "stdin"
   // we probably always want to skip the header includes?
@@ -777,6 +2032,7 @@ namespace Sass {
     register_function(ctx, scale_color_sig, scale_color, env);
     register_function(ctx, change_color_sig, change_color, env);
     register_function(ctx, ie_hex_str_sig, ie_hex_str, env);
+    register_function(ctx, color_scale_sig, color_scale, env);
     // String Functions
     register_function(ctx, unquote_sig, sass_unquote, env);
     register_function(ctx, quote_sig, sass_quote, env);
@@ -807,6 +2063,7 @@ namespace Sass {
     register_function(ctx, is_bracketed_sig, is_bracketed, env);
     // Map Functions
     register_function(ctx, map_get_sig, map_get, env);
+    register_function(ctx, map_get_path_sig, map_get_path, env);
     register_function(ctx, map_merge_sig, map_merge, env);
     register_function(ctx, map_remove_sig, map_remove, env);
     register_function(ctx, map_keys_sig, map_keys, env);
@@ -4,6 +4,16 @@
 // sass.hpp must go before all system headers to get the
 // __EXTENSIONS__ fix on Solaris.
 #include "sass.hpp"
+
+#include <unordered_set>
+#include <condition_variable>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <deque>
+#include <atomic>
+#include <chrono>
+
 #include "ast.hpp"
 
 
@@ -12,6 +22,7 @@
 
 #include "sass_context.hpp"
 #include "stylesheet.hpp"
+#include "tokenizer.hpp"
 #include "plugins.hpp"
 #include "output.hpp"
 
@@ -24,6 +35,10 @@ namespace Sass {
     { return call_loader(load_path, ctx_path, pstate, imp, c_headers, false); };
     bool call_importers(const std::string& load_path, const char* ctx_path, ParserState& pstate, Import* imp)
     { return call_loader(load_path, ctx_path, pstate, imp, c_importers, true); };
+    // announce every plain url of one @import statement to importers
+    // with a prefetch hook before they are resolved one by one, so
+    // remote-backed importers can overlap their fetches
+    void announce_imports(const std::vector<std::string>& urls);
 
   private:
     bool call_loader(const std::string& load_path, const char* ctx_path, ParserState& pstate, Import* imp, std::vector<Sass_Importer_Entry> importers, bool only_one = true);
@@ -45,18 +60,158 @@ namespace Sass {
     std::vector<Resource> resources;
     std::map<const std::string, StyleSheet> sheets;
     ImporterStack import_stack;
+    // recycled Sass_Import structs for the stack entries above;
+    // every import pushes one and pops it moments later, so the
+    // frames are reused instead of a calloc plus two path copies
+    // per import (see acquire_import/release_import)
+    std::vector<Sass_Import_Entry> import_pool;
+
+    // pooled replacement for sass_make_import/sass_delete_import
+    // on the import stack: paths and sources are borrowed from
+    // the caller (they outlive the short-lived frame), so frames
+    // neither copy nor free anything except a user-set error
+    Sass_Import_Entry acquire_import(const char* imp_path, const char* abs_path, char* source, char* srcmap);
+    void release_import(Sass_Import_Entry import);
     std::vector<Sass_Callee> callee_stack;
     std::vector<Backtrace> traces;
     Extender extender;
 
+    // monomorphic inline cache for function call dispatch: maps
+    // a call node to the definition it resolved to, so repeated
+    // calls skip the name normalization and environment walk.
+    // entries are only trusted while their generation matches;
+    // registering any function definition bumps the generation
+    // and distrusts everything (coarse, but redefinition is rare).
+    // only resolutions from the global frame (or the built-ins
+    // beyond it) are ever stored: local definitions vanish or
+    // shadow differently when a shared tree is expanded again
+    // under another scope, and nothing bumps the generation on
+    // scope exit
+    struct FnDispatch {
+      Definition_Obj def;
+      std::string name;
+      std::string full_name;
+      size_t generation;
+    };
+    std::unordered_map<const void*, FnDispatch> fn_dispatch_cache;
+    size_t fn_env_generation;
+
+    // parse results for interpolated selector schemas, keyed on
+    // the resolved selector string plus the schema position; a
+    // mixin emitting &.#{$variant} resolves to the same string
+    // on every expansion and should only be parsed once
+    std::unordered_map<std::string, SelectorListObj> parsed_selector_cache;
+
+    // merged media query lists keyed on the enclosing media rule
+    // instance and the inner query text; responsive mixins nest
+    // the same few breakpoints under thousands of rules, each of
+    // which would otherwise re-parse and re-merge the same pair.
+    // instances are told apart by a sequence number so entries
+    // can never alias a recycled node address
+    std::unordered_map<std::string, PoolVector<CssMediaQuery_Obj>> media_merge_cache;
+    size_t media_merge_seq;
+
+    // transient hash index over list elements for index() probes;
+    // validation mixins call index($valid-values, $arg) on every
+    // @include, so a list that keeps getting probed is indexed
+    // once and further probes answer from the table instead of a
+    // deep-equality scan. the pinned handle keeps the node alive
+    // so the pointer key cannot alias a recycled address, and the
+    // recorded content hash distrusts the table after mutation
+    struct ListProbeIndex {
+      List_Obj list;
+      size_t list_hash = 0;
+      size_t probes = 0;
+      bool built = false;
+      // element hash to first position holding it
+      std::unordered_map<size_t, size_t> positions;
+    };
+    std::unordered_map<const void*, ListProbeIndex> list_index_cache;
+
+    // memoized selector-unify() results keyed on the combined
+    // hash of both parsed arguments (zero disqualifies); helper
+    // libraries unify the same few selector pairs in loops and
+    // the weave is much costlier than a lookup. the entry keeps
+    // both parsed selectors so a hit can verify them against the
+    // live arguments (a hash match alone cannot be trusted);
+    // hits hand out copies like the other value memos
+    struct UnifiedSelectors {
+      SelectorListObj lhs;
+      SelectorListObj rhs;
+      Expression_Obj result;
+    };
+    std::unordered_map<size_t, UnifiedSelectors> selector_unify_cache;
+
+    // names of mixins, functions and variables no emitted code can
+    // reach, keyed like the environment ("x[m]", "x[f]", "$x");
+    // filled by the tree shaking pre-pass when the option is set
+    // and consulted by Expand to skip their registration and
+    // evaluation (empty means shake nothing)
+    std::unordered_set<std::string> shaken_names;
+
+    // set by the parser when it creates a placeholder selector;
+    // lets compile() skip the placeholder removal pass entirely
+    // for the common case of sheets that never use any
+    #ifdef SASS_THREADSAFE_REFCOUNT
+    // speculative parse workers may report placeholders
+    // concurrently (see warm_parse_cache)
+    std::atomic<bool> seen_placeholders;
+    #else
+    bool seen_placeholders;
+    #endif
+
+    // cooperative compile budget and cancellation (see the
+    // compile_budget and cancel_flag options); armed once in the
+    // constructor and polled from the phase loops. The fast path
+    // of the poll is one increment and mask, the deadline and
+    // token are only consulted every 64th call
+    std::chrono::steady_clock::time_point compile_deadline;
+    bool budget_watched = false;
+    uint32_t budget_tick = 0;
+    void poll_compile_budget() {
+      if (!budget_watched) return;
+      if (++budget_tick & 0x3F) return;
+      check_compile_budget();
+    }
+    // slow half of the poll; throws CompileCancelled when the
+    // caller's token fired or the wall-clock budget is spent
+    void check_compile_budget();
+
+    // source buffer borrowed from the caller (data context view
+    // mode); must not be freed on teardown or cached beyond us
+    const char* borrowed_source;
+
     struct Sass_Compiler* c_compiler;
 
+    // phase and per-file timings in milliseconds; only collected
+    // when the profile option or a metrics handler is set
+    std::vector<std::pair<std::string, double>> profile_phases;
+    std::vector<std::pair<std::string, double>> profile_parses;
+
+    // total source bytes registered for parsing (entry plus
+    // imports); reported through the metrics handler
+    size_t source_bytes;
+
+    // snapshot of the thread local allocation counters taken at
+    // construction; render_stats_json reports the deltas
+    MemoryStats stats_start;
+
     // absolute paths to includes
     std::vector<std::string> included_files;
     // relative includes for sourcemap
     std::vector<std::string> srcmap_links;
     // vectors above have same size
 
+    // import dependency graph in load order: every registered
+    // source with its content hash, and importer/importee edges
+    // (see render_import_graph_json)
+    std::vector<std::pair<std::string, size_t>> import_nodes;
+    std::vector<std::pair<std::string, std::string>> import_edges;
+
+    // targets already expanded under the import-once option;
+    // repeated inclusions of these contribute nothing anymore
+    std::unordered_set<std::string> expanded_imports;
+
     std::vector<std::string> plugin_paths; // relative paths to load plugins
     std::vector<std::string> include_paths; // lookup paths for includes
 
@@ -82,10 +237,61 @@ namespace Sass {
     virtual Block_Obj parse() = 0;
     virtual Block_Obj compile();
     virtual char* render(Block_Obj root);
+    // partitioned render used by render when render_threads is
+    // set and the build has thread-safe reference counts
+    void render_root_parallel(Block_Obj root);
+    // re-parse the closure remembered by the previous compile of
+    // this entry on parse_threads workers, pipelined against the
+    // sequential parse: the workers start here and keep parsing
+    // ahead while register_resource streams through the imports,
+    // folding finished trees in at each cache lookup. Like the
+    // parallel renderer this shares AST nodes across threads and
+    // is only called when the build has thread-safe reference
+    // counts
+    void warm_parse_cache();
+    // hand finished parse-ahead results to the parse cache; when
+    // the sequential parse is about to need `wanted`, waits for a
+    // worker already on it or takes the pending job over
+    void adopt_warm_parses(const std::string& wanted);
+    // stop the parse-ahead workers and settle what they produced
+    void finish_warm_parses();
+    // record the loaded closure for the next rebuild's warm-up
+    void remember_parse_closure();
+    // render the already compiled tree once more in another
+    // output style; lets callers emit several artifacts (say
+    // an expanded and a compressed build) from one compile
+    virtual char* render_styled(Block_Obj root, Sass_Output_Style style);
     virtual char* render_srcmap();
+    virtual char* render_profile_json();
+    virtual char* render_stats_json();
+    virtual char* render_import_graph_json();
+    // fill the stable C-API metrics struct; timings come from the
+    // same collection the profile option uses, the counters from
+    // the thread local allocation statistics (see render_*_json)
+    void collect_metrics(struct Sass_Compile_Metrics& metrics);
+
+    // compile avoidance (see sass_option_set_cache_handler):
+    // cache key over the sources loaded by this compile
+    std::string output_cache_key_current();
+    // key predicted from the closure the previous compile of
+    // this entry left behind; empty when unknown, when any
+    // source is unreadable or when pluggable importers or
+    // functions make the output unpredictable
+    std::string output_cache_key_previous();
+    // remember the closure for the next rebuild's prediction
+    void remember_output_closure();
 
     void register_resource(const Include&, const Resource&);
     void register_resource(const Include&, const Resource&, ParserState&);
+    // kick off readahead for files a source is about to @import
+    void prefetch_imports(const std::string& ctx_path, const char* contents,
+                          const Tokenize::TokenStream& stream);
+    // queue candidates for the speculative import closure walker
+    // and lazily start its worker (see speculative_imports option)
+    void spec_enqueue(const std::vector<std::string>& paths);
+    // body of the walker; reads, token-scans and announces the
+    // probable closure breadth first while the main thread parses
+    void speculate_imports();
     std::vector<Include> find_includes(const Importer& import);
     Include load_import(const Importer&, ParserState pstate);
 
@@ -93,6 +299,49 @@ namespace Sass {
     std::vector<std::string> get_included_files(bool skip = false, size_t headers = 0);
 
   private:
+    // state of the speculative import closure walker (see
+    // speculate_imports); everything but the worker handle is
+    // guarded by spec_mutex, and the worker is only ever started
+    // when the speculative_imports option asks for it. The budget
+    // bounds the total files a compile may ever speculate on.
+    std::mutex spec_mutex;
+    std::condition_variable spec_cv;
+    std::deque<std::string> spec_queue;
+    std::unordered_set<std::string> spec_seen;
+    size_t spec_budget = 512;
+    bool spec_shutdown = false;
+    std::thread spec_worker;
+
+    // state of the parse-ahead pipeline (see warm_parse_cache);
+    // jobs move through an atomic per-job lifecycle so workers and
+    // the sequential parse can settle ownership without a lock,
+    // and workers claim work through per-shard cursors just like
+    // the old barrier-style warm-up did. warm_running is only ever
+    // written on the compile thread and stays false in builds
+    // without thread-safe reference counts
+    struct WarmJob {
+      std::string abs_path;
+      size_t idx;
+      size_t hash;
+      char* contents;
+      char* path;
+      Block_Obj root;
+      std::atomic<int> state;
+    };
+    struct WarmShard {
+      std::atomic<size_t> cursor;
+      size_t end;
+    };
+    std::deque<WarmJob> warm_jobs;
+    std::unique_ptr<WarmShard[]> warm_shards;
+    size_t warm_shard_count = 0;
+    std::vector<std::thread> warm_workers;
+    std::atomic<bool> warm_stop { false };
+    bool warm_running = false;
+
+    // worker body of the parse-ahead pipeline
+    void warm_work(size_t self);
+
     void collect_plugin_paths(const char* paths_str);
     void collect_plugin_paths(string_list* paths_array);
     void collect_include_paths(const char* paths_str);
@@ -128,6 +377,7 @@ namespace Sass {
     {
       source_c_str       = ctx.source_string;
       srcmap_c_str       = ctx.srcmap_string;
+      if (ctx.source_borrowed) borrowed_source = source_c_str;
       ctx.source_string = 0; // passed away
       ctx.srcmap_string = 0; // passed away
     }
@@ -135,6 +385,10 @@ namespace Sass {
     virtual Block_Obj parse();
   };
 
+  // evict one file from the cross-compilation parse cache
+  // (key is the resolved absolute path of the import)
+  void invalidate_parse_cache(const std::string& abs_path);
+
 }
 
 #endif
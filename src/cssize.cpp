@@ -14,7 +14,8 @@ namespace Sass {
   Cssize::Cssize(Context& ctx)
   : traces(ctx.traces),
     block_stack(BlockStack()),
-    p_stack(std::vector<Statement*>())
+    p_stack(std::vector<Statement*>()),
+    merge_media_(ctx.c_options.merge_media_rules)
   { }
 
   Statement* Cssize::parent()
@@ -29,9 +30,36 @@ namespace Sass {
     block_stack.push_back(bb);
     append_block(b, bb);
     block_stack.pop_back();
+    if (merge_media_) merge_media_runs(bb);
     return bb.detach();
   }
 
+  // Coalesce runs of adjacent media rules whose query lists compare
+  // equal into the first rule of the run. Bubbling emits one media
+  // rule per nested ruleset, so large responsive sheets produce long
+  // runs of `@media` blocks repeating the identical query; merging
+  // them renders the query and braces once per run and preserves the
+  // relative order of every contained rule.
+  void Cssize::merge_media_runs(Block* b)
+  {
+    if (b->length() < 2) return;
+    auto& elems = b->elements();
+    CssMediaRule* open = NULL;
+    size_t n = 0;
+    for (size_t i = 0; i < elems.size(); ++i) {
+      Statement_Obj s = elems[i];
+      CssMediaRule* m = Cast<CssMediaRule>(s);
+      if (m && open && m->block() && *open == *m) {
+        open->block()->concat(m->block());
+        open->group_end(m->group_end());
+        continue;
+      }
+      open = (m && m->block()) ? m : NULL;
+      elems[n++] = s;
+    }
+    if (n < elems.size()) elems.resize(n);
+  }
+
   Statement* Cssize::operator()(Trace* t)
   {
     traces.push_back(Backtrace(t->pstate()));
@@ -386,75 +414,68 @@ namespace Sass {
   Block* Cssize::flatten(const Block* b)
   {
     Block* result = SASS_MEMORY_NEW(Block, b->pstate(), 0, b->is_root());
-    for (size_t i = 0, L = b->length(); i < L; ++i) {
-      Statement* ss = b->at(i);
-      if (const Block* bb = Cast<Block>(ss)) {
-        Block_Obj bs = flatten(bb);
-        for (size_t j = 0, K = bs->length(); j < K; ++j) {
-          result->append(bs->at(j));
-        }
-      }
-      else {
-        result->append(ss);
-      }
-    }
+    flatten_into(result, b);
     return result;
   }
 
-  std::vector<std::pair<bool, Block_Obj>> Cssize::slice_by_bubble(Block* b)
+  // Splice [b] into [result] directly; the previous implementation
+  // allocated a fresh block per nesting level just to copy it away again.
+  void Cssize::flatten_into(Block* result, const Block* b)
   {
-    std::vector<std::pair<bool, Block_Obj>> results;
-
     for (size_t i = 0, L = b->length(); i < L; ++i) {
-      Statement_Obj value = b->at(i);
-      bool key = Cast<Bubble>(value) != NULL;
-
-      if (!results.empty() && results.back().first == key)
-      {
-        Block_Obj wrapper_block = results.back().second;
-        wrapper_block->append(value);
+      Statement* ss = b->at(i);
+      if (const Block* bb = Cast<Block>(ss)) {
+        flatten_into(result, bb);
       }
-      else
-      {
-        Block* wrapper_block = SASS_MEMORY_NEW(Block, value->pstate());
-        wrapper_block->append(value);
-        results.push_back(std::make_pair(key, wrapper_block));
+      else {
+        result->append(ss);
       }
     }
-    return results;
   }
 
   Block* Cssize::debubble(Block* children, Statement* parent)
   {
     Has_Block_Obj previous_parent;
-    std::vector<std::pair<bool, Block_Obj>> baz = slice_by_bubble(children);
     Block_Obj result = SASS_MEMORY_NEW(Block, children->pstate());
 
-    for (size_t i = 0, L = baz.size(); i < L; ++i) {
-      bool is_bubble = baz[i].first;
-      Block_Obj slice = baz[i].second;
+    // walk maximal runs of bubbles and non-bubbles in place; the
+    // old slice_by_bubble pass copied every run into a wrapper
+    // block first, which deep responsive nesting paid per level
+    size_t i = 0, L = children->length();
+    while (i < L) {
+      bool is_bubble = Cast<Bubble>(children->at(i)) != NULL;
+      size_t run = i + 1;
+      while (run < L && (Cast<Bubble>(children->at(run)) != NULL) == is_bubble) ++run;
 
       if (!is_bubble) {
         if (!parent) {
+          Block_Obj slice = SASS_MEMORY_NEW(Block, children->at(i)->pstate(), run - i);
+          for (size_t j = i; j < run; ++j) slice->append(children->at(j));
           result->append(slice);
         }
         else if (previous_parent) {
-          previous_parent->block()->concat(slice);
+          // hoisting did not interrupt the run, so the statements
+          // splice straight into the carried parent copy
+          for (size_t j = i; j < run; ++j)
+            previous_parent->block()->append(children->at(j));
         }
         else {
+          Block_Obj slice = SASS_MEMORY_NEW(Block, children->at(i)->pstate(), run - i);
+          for (size_t j = i; j < run; ++j) slice->append(children->at(j));
           previous_parent = SASS_MEMORY_COPY(parent);
           previous_parent->block(slice);
           previous_parent->tabs(parent->tabs());
 
           result->append(previous_parent);
         }
+        i = run;
         continue;
       }
 
-      for (size_t j = 0, K = slice->length(); j < K; ++j)
+      for (size_t j = i; j < run; ++j)
       {
         Statement_Obj ss;
-        Statement_Obj stm = slice->at(j);
+        Statement_Obj stm = children->at(j);
         // this has to go now here (too bad)
         Bubble_Obj node = Cast<Bubble>(stm);
 
@@ -475,28 +496,28 @@ namespace Sass {
         ss->tabs(ss->tabs() + node->tabs());
         ss->group_end(node->group_end());
 
-        Block_Obj bb = SASS_MEMORY_NEW(Block,
-                                    children->pstate(),
-                                    children->length(),
-                                    children->is_root());
-        bb->append(ss->perform(this));
-
-        Block_Obj wrapper_block = SASS_MEMORY_NEW(Block,
-                                              children->pstate(),
-                                              children->length(),
-                                              children->is_root());
-
-        Block* wrapper = flatten(bb);
-        wrapper_block->append(wrapper);
+        // Splice the result of the re-dispatch straight into a single
+        // wrapper; the result gets flattened once more below, so the
+        // old block-in-block-in-block dance was pure copy overhead.
+        Statement_Obj performed = ss->perform(this);
+        Block_Obj wrapper = SASS_MEMORY_NEW(Block,
+                                        children->pstate(),
+                                        1,
+                                        children->is_root());
+        if (Block* bb = Cast<Block>(performed)) {
+          flatten_into(wrapper, bb);
+        }
+        else {
+          wrapper->append(performed);
+        }
 
         if (wrapper->length()) {
           previous_parent = {};
         }
 
-        if (wrapper_block) {
-          result->append(wrapper_block);
-        }
+        result->append(wrapper);
       }
+      i = run;
     }
 
     return flatten(result);
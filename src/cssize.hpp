@@ -15,6 +15,8 @@ namespace Sass {
     Backtraces&                 traces;
     BlockStack      block_stack;
     std::vector<Statement*>  p_stack;
+    // coalesce adjacent same-query media rules (opt-in)
+    bool merge_media_;
 
   public:
     Cssize(Context&);
@@ -48,14 +50,15 @@ namespace Sass {
     Statement* operator()(Null*);
 
     Statement* parent();
-    std::vector<std::pair<bool, Block_Obj>> slice_by_bubble(Block*);
     Statement* bubble(Directive*);
     Statement* bubble(At_Root_Block*);
     Statement* bubble(CssMediaRule*);
     Statement* bubble(Supports_Block*);
 
     Block* debubble(Block* children, Statement* parent = 0);
+    void merge_media_runs(Block*);
     Block* flatten(const Block*);
+    void flatten_into(Block* result, const Block*);
     bool bubblable(Statement*);
 
     // generic fallback
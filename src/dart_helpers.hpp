@@ -101,9 +101,9 @@ namespace Sass {
   // ##########################################################################
   // Longest common subsequence with predicate
   // ##########################################################################
-  template <class T>
-  std::vector<T> lcs(
-    const std::vector<T>& X, const std::vector<T>& Y,
+  template <class T, class A>
+  std::vector<T, A> lcs(
+    const std::vector<T, A>& X, const std::vector<T, A>& Y,
     bool(*select)(const T&, const T&, T&) = lcsIdentityCmp<T>)
   {
 
@@ -142,7 +142,7 @@ namespace Sass {
     }
 
     // Following code is used to print LCS
-    std::vector<T> lcs;
+    std::vector<T, A> lcs;
     std::size_t index = LEN(m, n);
     lcs.reserve(index);
 
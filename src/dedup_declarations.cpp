@@ -0,0 +1,106 @@
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+#include "ast.hpp"
+
+#include <unordered_map>
+
+#include "dedup_declarations.hpp"
+#include "util_string.hpp"
+
+namespace Sass {
+
+  Dedup_Declarations::Dedup_Declarations()
+  { }
+
+  // whether [css] carries a vendor prefix somewhere; such
+  // declarations are fallback chains (display: -webkit-flex up
+  // to display: flex) where every line is meant to reach the
+  // browser, so none of them counts as overridden
+  static bool has_vendor_prefix(const std::string& css)
+  {
+    static const char* const prefixes[] = {
+      "-webkit-", "-moz-", "-ms-", "-o-", "-khtml-"
+    };
+    for (const char* prefix : prefixes) {
+      if (css.find(prefix) != std::string::npos) return true;
+    }
+    return false;
+  }
+
+  void Dedup_Declarations::dedup(Block* b)
+  {
+    // walk the block backwards and remember, per property, the
+    // weight of the declarations kept behind us (bit 0 plain,
+    // bit 1 important); an earlier declaration is dropped when a
+    // kept later one outweighs it, so within each weight the last
+    // declaration wins and !important never loses to a plain one
+    std::unordered_map<std::string, unsigned char> later;
+    std::vector<bool> keep(b->length(), true);
+    bool dropped = false;
+    for (size_t i = b->length(); i > 0; --i) {
+      Declaration* d = Cast<Declaration>(b->at(i - 1));
+      if (!d || !d->value()) continue;
+      // custom property blocks carry verbatim values; leave them
+      if (d->is_custom_property()) continue;
+      String_Constant* prop = Cast<String_Constant>(d->property());
+      if (!prop) continue;
+      std::string name(prop->value());
+      Util::ascii_str_tolower(&name);
+      std::string css(d->value()->to_string());
+      // the static-value fast path in the parser keeps a trailing
+      // "!important" inside the value instead of setting the flag
+      bool important = d->is_important()
+                    || css.find("!important") != std::string::npos;
+      unsigned char& seen = later[name];
+      bool overridden = important ? (seen & 2) != 0 : seen != 0;
+      if (overridden && !has_vendor_prefix(css)) {
+        keep[i - 1] = false;
+        dropped = true;
+        continue;
+      }
+      seen |= important ? 2 : 1;
+    }
+    if (!dropped) return;
+    auto& elems = b->elements();
+    size_t n = 0;
+    for (size_t i = 0; i < elems.size(); ++i) {
+      if (keep[i]) elems[n++] = elems[i];
+    }
+    elems.resize(n);
+  }
+
+  void Dedup_Declarations::operator()(Block* b)
+  {
+    dedup(b);
+    for (size_t i = 0, L = b->length(); i < L; ++i) {
+      if (b->get(i)) b->get(i)->perform(this);
+    }
+  }
+
+  void Dedup_Declarations::operator()(Ruleset* r)
+  {
+    if (r->block()) operator()(r->block());
+  }
+
+  void Dedup_Declarations::operator()(CssMediaRule* rule)
+  {
+    if (rule->block()) operator()(rule->block());
+  }
+
+  void Dedup_Declarations::operator()(Supports_Block* m)
+  {
+    if (m->block()) operator()(m->block());
+  }
+
+  void Dedup_Declarations::operator()(Directive* a)
+  {
+    if (a->block()) a->block()->perform(this);
+  }
+
+  void Dedup_Declarations::operator()(Keyframe_Rule* r)
+  {
+    if (r->block()) operator()(r->block());
+  }
+
+}
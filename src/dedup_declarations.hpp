@@ -0,0 +1,40 @@
+#ifndef SASS_DEDUP_DECLARATIONS_H
+#define SASS_DEDUP_DECLARATIONS_H
+
+#include "ast_fwd_decl.hpp"
+#include "operation.hpp"
+
+namespace Sass {
+
+  // Optional output pass (see the dedup_declarations option):
+  // drops declarations that a later declaration of the same
+  // property in the same block overrides anyway, so blocks that
+  // went through several override layers emit only the winning
+  // declaration. An earlier declaration survives when it may be
+  // serving as a fallback: custom properties are never touched,
+  // an !important declaration is never dropped for a plain later
+  // one, and vendor prefixed values keep their whole chain.
+  class Dedup_Declarations : public Operation_CRTP<void, Dedup_Declarations> {
+
+    void dedup(Block* b);
+
+  public:
+    Dedup_Declarations();
+    ~Dedup_Declarations() { }
+
+    void operator()(Block*);
+    void operator()(Ruleset*);
+    void operator()(CssMediaRule*);
+    void operator()(Supports_Block*);
+    void operator()(Directive*);
+    void operator()(Keyframe_Rule*);
+
+    // ignore missed types
+    template <typename U>
+    void fallback(U x) {}
+
+  };
+
+}
+
+#endif
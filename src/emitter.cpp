@@ -1,6 +1,7 @@
 // sass.hpp must go before all system headers to get the
 // __EXTENSIONS__ fix on Solaris.
 #include "sass.hpp"
+#include "ast.hpp"
 #include "emitter.hpp"
 #include "util_string.hpp"
 #include "util.hpp"
@@ -10,12 +11,16 @@ namespace Sass {
   Emitter::Emitter(struct Sass_Output_Options& opt)
   : wbuf(),
     opt(opt),
+    srcmap_enabled(false),
     indentation(0),
     scheduled_space(0),
     scheduled_linefeed(0),
     scheduled_delimiter(false),
     scheduled_crutch(0),
     scheduled_mapping(0),
+    budget_poll(0),
+    budget_cookie(0),
+    collapses_boundary_linefeed(false),
     in_custom_property(false),
     in_comment(false),
     in_wrapped(false),
@@ -25,15 +30,34 @@ namespace Sass {
     in_comma_array(false)
   { }
 
-  // return buffer as string
-  std::string Emitter::get_buffer(void)
+  void Emitter::reset(void)
   {
-    return wbuf.buffer;
+    // clear() keeps the string capacity; everything else goes
+    // back to what the constructor would have produced
+    wbuf.buffer.clear();
+    wbuf.smap = SourceMap();
+    wbuf.has_non_ascii = false;
+    srcmap_enabled = false;
+    indentation = 0;
+    scheduled_space = 0;
+    scheduled_linefeed = 0;
+    scheduled_delimiter = false;
+    scheduled_crutch = 0;
+    scheduled_mapping = 0;
+    collapses_boundary_linefeed = false;
+    in_custom_property = false;
+    in_comment = false;
+    in_wrapped = false;
+    in_media_block = false;
+    in_declaration = false;
+    in_space_array = false;
+    in_comma_array = false;
   }
 
-  Sass_Output_Style Emitter::output_style(void) const
+  // return buffer as string
+  std::string Emitter::get_buffer(void)
   {
-    return opt.output_style;
+    return wbuf.buffer;
   }
 
   // PROXY METHODS FOR SOURCE MAPS
@@ -49,10 +73,26 @@ namespace Sass {
 
   void Emitter::schedule_mapping(const AST_Node* node)
   { scheduled_mapping = node; }
+  // decide if a mapping for the given node survives the
+  // configured granularity; per rule only block scopes map,
+  // per declaration everything inside a declaration is
+  // covered by the single mapping the inspector adds for it
+  bool Emitter::want_mapping(const AST_Node* node) const
+  {
+    switch (opt.source_map_granularity) {
+      case SASS_SRCMAP_RULE:
+        return Cast<Block>(node) != nullptr;
+      case SASS_SRCMAP_DECLARATION:
+        return !in_declaration;
+      default:
+        return true;
+    }
+  }
+
   void Emitter::add_open_mapping(const AST_Node* node)
-  { wbuf.smap.add_open_mapping(node); }
+  { if (srcmap_enabled && want_mapping(node)) wbuf.smap.add_open_mapping(node); }
   void Emitter::add_close_mapping(const AST_Node* node)
-  { wbuf.smap.add_close_mapping(node); }
+  { if (srcmap_enabled && want_mapping(node)) wbuf.smap.add_close_mapping(node); }
   ParserState Emitter::remap(const ParserState& pstate)
   { return wbuf.smap.remap(pstate); }
 
@@ -69,8 +109,9 @@ namespace Sass {
     flush_schedules();
   }
 
-  // flush scheduled space/linefeed
-  void Emitter::flush_schedules(void)
+  // flush scheduled space/linefeed (slow path; the
+  // nothing-scheduled check is inlined in the header)
+  void Emitter::write_schedules(void)
   {
     // check the schedule
     if (scheduled_linefeed) {
@@ -93,11 +134,36 @@ namespace Sass {
     }
   }
 
+  // track non-ascii bytes as they stream in, so finalization
+  // can decide on the charset without scanning the whole buffer
+  void Emitter::scan_charset(const std::string& text)
+  {
+    if (wbuf.has_non_ascii) return;
+    for (const char& chr : text) {
+      if (static_cast<unsigned char>(chr) > 127) {
+        wbuf.has_non_ascii = true;
+        break;
+      }
+    }
+  }
+
+  // append an already rendered buffer to this one; the
+  // mappings of the chunk are rebased onto our buffer end
+  void Emitter::append_output(const OutputBuffer& output)
+  {
+    if (srcmap_enabled) wbuf.smap.append(output);
+    wbuf.has_non_ascii |= output.has_non_ascii;
+    wbuf.buffer += output.buffer;
+  }
+
   // prepend some text or token to the buffer
   void Emitter::prepend_output(const OutputBuffer& output)
   {
-    wbuf.smap.prepend(output);
-    wbuf.buffer = output.buffer + wbuf.buffer;
+    if (srcmap_enabled) wbuf.smap.prepend(output);
+    wbuf.has_non_ascii |= output.has_non_ascii;
+    // insert in place instead of building a temporary
+    // concatenation (buffers can be many MB at this point)
+    wbuf.buffer.insert(0, output.buffer);
   }
 
   // prepend some text or token to the buffer
@@ -105,10 +171,13 @@ namespace Sass {
   {
     // do not adjust mappings for utf8 bom
     // seems they are not counted in any UA
-    if (text.compare("\xEF\xBB\xBF") != 0) {
+    if (srcmap_enabled && text.compare("\xEF\xBB\xBF") != 0) {
       wbuf.smap.prepend(Offset(text));
     }
-    wbuf.buffer = text + wbuf.buffer;
+    scan_charset(text);
+    // insert in place instead of building a temporary
+    // concatenation (buffers can be many MB at this point)
+    wbuf.buffer.insert(0, text);
   }
 
   char Emitter::last_char()
@@ -121,10 +190,13 @@ namespace Sass {
   {
     // write space/lf
     flush_schedules();
+    if (static_cast<unsigned char>(chr) > 127) {
+      wbuf.has_non_ascii = true;
+    }
     // add to buffer
     wbuf.buffer += chr;
     // account for data in source-maps
-    wbuf.smap.append(Offset(chr));
+    if (srcmap_enabled) wbuf.smap.append(Offset(chr));
   }
 
   // append some text or token to the buffer
@@ -139,13 +211,15 @@ namespace Sass {
       if (output_style() == COMPACT) {
         out = comment_to_compact_string(out);
       }
-      wbuf.smap.append(Offset(out));
+      if (srcmap_enabled) wbuf.smap.append(Offset(out));
+      scan_charset(out);
       wbuf.buffer += std::move(out);
     } else {
+      scan_charset(text);
       // add to buffer
       wbuf.buffer += text;
       // account for data in source-maps
-      wbuf.smap.append(Offset(text));
+      if (srcmap_enabled) wbuf.smap.append(Offset(text));
     }
   }
 
@@ -184,10 +258,31 @@ namespace Sass {
     if (in_declaration && in_comma_array) return;
     if (scheduled_linefeed && indentation)
       scheduled_linefeed = 1;
-    std::string indent = "";
-    for (size_t i = 0; i < indentation; i++)
-      indent += opt.indent;
-    append_string(indent);
+    // remember for partitioned renders that a pending blank
+    // line between top level groups would collapse right here
+    if (wbuf.buffer.empty() && indentation)
+      collapses_boundary_linefeed = true;
+    // emit the whole prefix from the shared indent run in one
+    // bulk append instead of building it unit by unit per line
+    if (indent_cache_unit != opt.indent) {
+      indent_cache_unit = opt.indent;
+      indent_cache.clear();
+    }
+    size_t bytes = indent_cache_unit.size() * indentation;
+    while (indent_cache.size() < bytes)
+      indent_cache += indent_cache_unit;
+    if (in_comment) {
+      // comments rewrite appended text, take the generic path
+      append_string(indent_cache.substr(0, bytes));
+      return;
+    }
+    flush_schedules();
+    // indent units may hold any configured bytes
+    scan_charset(indent_cache_unit);
+    wbuf.buffer.append(indent_cache, 0, bytes);
+    if (srcmap_enabled) {
+      wbuf.smap.append(Offset(indent_cache.substr(0, bytes)));
+    }
   }
 
   void Emitter::append_delimiter()
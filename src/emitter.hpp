@@ -18,8 +18,18 @@ namespace Sass {
       Emitter(struct Sass_Output_Options& opt);
       virtual ~Emitter() { }
 
+      // restore the pristine post-constructor state while keeping
+      // the buffer capacity, so one scratch emitter can be reused
+      // across many renders (see AST_Node::to_string)
+      void reset(void);
+
     protected:
       OutputBuffer wbuf;
+      // every indent level is a prefix of the level below it, so
+      // all levels share one lazily grown run of indent units
+      // (rebuilt if the configured indent string ever changes)
+      std::string indent_cache;
+      std::string indent_cache_unit;
     public:
       const std::string& buffer(void) { return wbuf.buffer; }
       const SourceMap smap(void) { return wbuf.smap; }
@@ -27,6 +37,16 @@ namespace Sass {
       // proxy methods for source maps
       void add_source_index(size_t idx);
       void set_filename(const std::string& str);
+      // only collect mappings when a consumer asked for a source
+      // map; position accounting on every append is not for free
+      void set_srcmap_enabled(bool enable) { srcmap_enabled = enable; }
+      // cooperative cancellation hook polled between the block
+      // statements being rendered; installed by Context::render
+      // when a compile budget is armed, scratch emitters used by
+      // AST_Node::to_string never carry one
+      void set_budget_poll(void (*poll)(void*), void* cookie)
+      { budget_poll = poll; budget_cookie = cookie; }
+      bool want_mapping(const AST_Node* node) const;
       void add_open_mapping(const AST_Node* node);
       void add_close_mapping(const AST_Node* node);
       void schedule_mapping(const AST_Node* node);
@@ -35,12 +55,20 @@ namespace Sass {
 
     public:
       struct Sass_Output_Options& opt;
+      bool srcmap_enabled;
       size_t indentation;
       size_t scheduled_space;
       size_t scheduled_linefeed;
       bool scheduled_delimiter;
       const AST_Node* scheduled_crutch;
       const AST_Node* scheduled_mapping;
+      // see set_budget_poll
+      void (*budget_poll)(void*);
+      void* budget_cookie;
+      // set when an indented statement wrote the first bytes of
+      // this buffer; the merge of a partitioned render uses it
+      // to collapse the blank line pending at the chunk boundary
+      bool collapses_boundary_linefeed;
 
     public:
       // output strings different in custom css properties
@@ -60,15 +88,28 @@ namespace Sass {
     public:
       // return buffer as std::string
       std::string get_buffer(void);
-      // flush scheduled space/linefeed
-      Sass_Output_Style output_style(void) const;
+      // queried by nearly every append helper, so keep it inline
+      Sass_Output_Style output_style(void) const {
+        return opt.output_style;
+      }
       // add outstanding linefeed
       void finalize(bool final = true);
-      // flush scheduled space/linefeed
-      void flush_schedules(void);
+      // flush scheduled space/linefeed; inlined since nothing being
+      // scheduled is the steady state — compressed output never
+      // schedules any whitespace, so every append takes this no-op
+      void flush_schedules(void) {
+        if (scheduled_linefeed || scheduled_space || scheduled_delimiter) {
+          write_schedules();
+        }
+      }
+      // out-of-line slow path of flush_schedules
+      void write_schedules(void);
       // prepend some text or token to the buffer
+      void scan_charset(const std::string& text);
       void prepend_string(const std::string& text);
       void prepend_output(const OutputBuffer& out);
+      // append an already rendered buffer (rebases mappings)
+      void append_output(const OutputBuffer& out);
       // append some text or token to the buffer
       void append_string(const std::string& text);
       // append a single character to buffer
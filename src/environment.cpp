@@ -8,17 +8,17 @@ namespace Sass {
   Environment<T>::Environment(bool is_shadow)
   : local_frame_(environment_map<std::string, T>()),
     parent_(0), is_shadow_(false)
-  { }
+  { MemoryStats::instance().env_frames += 1; }
   template <typename T>
   Environment<T>::Environment(Environment<T>* env, bool is_shadow)
   : local_frame_(environment_map<std::string, T>()),
     parent_(env), is_shadow_(is_shadow)
-  { }
+  { MemoryStats::instance().env_frames += 1; }
   template <typename T>
   Environment<T>::Environment(Environment<T>& env, bool is_shadow)
   : local_frame_(environment_map<std::string, T>()),
     parent_(&env), is_shadow_(is_shadow)
-  { }
+  { MemoryStats::instance().env_frames += 1; }
 
   // link parent to create a stack
   template <typename T>
@@ -94,6 +94,10 @@ namespace Sass {
   bool Environment<T>::has_global(const std::string& key)
   { return global_env()->has(key); }
 
+  template <typename T> EnvResult
+  Environment<T>::find_global(const std::string& key)
+  { return global_env()->find_local(key); }
+
   template <typename T>
   T& Environment<T>::get_global(const std::string& key)
   { return (*global_env())[key]; }
@@ -207,13 +211,16 @@ namespace Sass {
   };
 
   // use array access for getter and setter functions
+  // probe each frame once; has_local plus get_local would
+  // hash the key twice per visited frame on this hot path
   template <typename T>
   T& Environment<T>::get(const std::string& key)
   {
     auto cur = this;
     while (cur) {
-      if (cur->has_local(key)) {
-        return cur->get_local(key);
+      auto it = cur->local_frame_.find(key);
+      if (it != cur->local_frame_.end()) {
+        return it->second;
       }
       cur = cur->parent_;
     }
@@ -226,8 +233,9 @@ namespace Sass {
   {
     auto cur = this;
     while (cur) {
-      if (cur->has_local(key)) {
-        return cur->get_local(key);
+      auto it = cur->local_frame_.find(key);
+      if (it != cur->local_frame_.end()) {
+        return it->second;
       }
       cur = cur->parent_;
     }
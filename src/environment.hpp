@@ -5,8 +5,8 @@
 // __EXTENSIONS__ fix on Solaris.
 #include "sass.hpp"
 
-#include <map>
 #include <string>
+#include <unordered_map>
 #include "ast_fwd_decl.hpp"
 #include "ast_def_macros.hpp"
 
@@ -74,6 +74,8 @@ namespace Sass {
     Environment* lexical_env(const std::string& key);
 
     bool has_global(const std::string& key);
+    // probe the global frame once (walk and hash a single time)
+    EnvResult find_global(const std::string& key);
 
     T& get_global(const std::string& key);
 
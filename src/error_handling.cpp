@@ -6,8 +6,10 @@
 #include "prelexer.hpp"
 #include "backtrace.hpp"
 #include "error_handling.hpp"
+#include "messages.hpp"
 
 #include <iostream>
+#include <sstream>
 
 namespace Sass {
 
@@ -84,18 +86,29 @@ namespace Sass {
       msg = "stack level too deep";
     }
 
+    // the operation errors below format their message lazily in
+    // format_msg (triggered by what), since the parser's constant
+    // folding probe throws and discards them without ever reading
+    // the message; operands outlive the handlers that do read it
+
     IncompatibleUnits::IncompatibleUnits(const Units& lhs, const Units& rhs)
-    {
-      msg = "Incompatible units: '" + rhs.unit() + "' and '" + lhs.unit() + "'.";
-    }
+    : OperationError(std::string()), lhs_unit(lhs.unit()), rhs_unit(rhs.unit())
+    { }
 
     IncompatibleUnits::IncompatibleUnits(const UnitType lhs, const UnitType rhs)
+    : OperationError(std::string()), lhs_unit(unit_to_string(lhs)), rhs_unit(unit_to_string(rhs))
+    { }
+
+    void IncompatibleUnits::format_msg() const
     {
-      msg = std::string("Incompatible units: '") + unit_to_string(rhs) + "' and '" + unit_to_string(lhs) + "'.";
+      msg = "Incompatible units: '" + rhs_unit + "' and '" + lhs_unit + "'.";
     }
 
     AlphaChannelsNotEqual::AlphaChannelsNotEqual(const Expression* lhs, const Expression* rhs, enum Sass_OP op)
-    : OperationError(), lhs(lhs), rhs(rhs), op(op)
+    : OperationError(std::string()), lhs(lhs), rhs(rhs), op(op)
+    { }
+
+    void AlphaChannelsNotEqual::format_msg() const
     {
       msg = "Alpha channels must be equal: " +
         lhs->to_string({ NESTED, 5 }) +
@@ -104,13 +117,19 @@ namespace Sass {
     }
 
     ZeroDivisionError::ZeroDivisionError(const Expression& lhs, const Expression& rhs)
-    : OperationError(), lhs(lhs), rhs(rhs)
+    : OperationError(std::string()), lhs(lhs), rhs(rhs)
+    { }
+
+    void ZeroDivisionError::format_msg() const
     {
       msg = "divided by 0";
     }
 
     UndefinedOperation::UndefinedOperation(const Expression* lhs, const Expression* rhs, enum Sass_OP op)
-    : OperationError(), lhs(lhs), rhs(rhs), op(op)
+    : OperationError(std::string()), lhs(lhs), rhs(rhs), op(op)
+    { }
+
+    void UndefinedOperation::format_msg() const
     {
       msg = def_op_msg + ": \"" +
         lhs->to_string({ NESTED, 5 }) +
@@ -121,6 +140,9 @@ namespace Sass {
 
     InvalidNullOperation::InvalidNullOperation(const Expression* lhs, const Expression* rhs, enum Sass_OP op)
     : UndefinedOperation(lhs, rhs, op)
+    { }
+
+    void InvalidNullOperation::format_msg() const
     {
       msg = def_op_null_msg + ": \"" + lhs->inspect() + " " + sass_op_to_name(op) + " " + rhs->inspect() + "\".";
     }
@@ -158,7 +180,7 @@ namespace Sass {
 
   void warn(std::string msg, ParserState pstate)
   {
-    std::cerr << "Warning: " << msg << std::endl;
+    Messages::emit("Warning: " + msg + "\n");
   }
 
   void warning(std::string msg, ParserState pstate)
@@ -168,8 +190,10 @@ namespace Sass {
     std::string rel_path(Sass::File::abs2rel(pstate.path, cwd, cwd));
     std::string output_path(Sass::File::path_for_console(rel_path, abs_path, pstate.path));
 
-    std::cerr << "WARNING on line " << pstate.line+1 << ", column " << pstate.column+1 << " of " << output_path << ":" << std::endl;
-    std::cerr << msg << std::endl << std::endl;
+    std::ostringstream message;
+    message << "WARNING on line " << pstate.line+1 << ", column " << pstate.column+1 << " of " << output_path << ":" << "\n";
+    message << msg << "\n" << "\n";
+    Messages::emit(message.str());
   }
 
   void warn(std::string msg, ParserState pstate, Backtrace* bt)
@@ -184,9 +208,11 @@ namespace Sass {
     std::string rel_path(Sass::File::abs2rel(pstate.path, cwd, cwd));
     std::string output_path(Sass::File::path_for_console(rel_path, abs_path, pstate.path));
 
-    std::cerr << "DEPRECATION WARNING: " << msg << std::endl;
-    std::cerr << "will be an error in future versions of Sass." << std::endl;
-    std::cerr << "        on line " << pstate.line+1 << " of " << output_path << std::endl;
+    std::ostringstream message;
+    message << "DEPRECATION WARNING: " << msg << "\n";
+    message << "will be an error in future versions of Sass." << "\n";
+    message << "        on line " << pstate.line+1 << " of " << output_path << "\n";
+    Messages::emit(message.str());
   }
 
   void deprecated(std::string msg, std::string msg2, bool with_column, ParserState pstate)
@@ -196,13 +222,15 @@ namespace Sass {
     std::string rel_path(Sass::File::abs2rel(pstate.path, cwd, cwd));
     std::string output_path(Sass::File::path_for_console(rel_path, pstate.path, pstate.path));
 
-    std::cerr << "DEPRECATION WARNING on line " << pstate.line + 1;
-    if (with_column) std::cerr << ", column " << pstate.column + pstate.offset.column + 1;
-    if (output_path.length()) std::cerr << " of " << output_path;
-    std::cerr << ":" << std::endl;
-    std::cerr << msg << std::endl;
-    if (msg2.length()) std::cerr << msg2 << std::endl;
-    std::cerr << std::endl;
+    std::ostringstream message;
+    message << "DEPRECATION WARNING on line " << pstate.line + 1;
+    if (with_column) message << ", column " << pstate.column + pstate.offset.column + 1;
+    if (output_path.length()) message << " of " << output_path;
+    message << ":" << "\n";
+    message << msg << "\n";
+    if (msg2.length()) message << msg2 << "\n";
+    message << "\n";
+    Messages::emit(message.str());
   }
 
   void deprecated_bind(std::string msg, ParserState pstate)
@@ -212,9 +240,11 @@ namespace Sass {
     std::string rel_path(Sass::File::abs2rel(pstate.path, cwd, cwd));
     std::string output_path(Sass::File::path_for_console(rel_path, abs_path, pstate.path));
 
-    std::cerr << "WARNING: " << msg << std::endl;
-    std::cerr << "        on line " << pstate.line+1 << " of " << output_path << std::endl;
-    std::cerr << "This will be an error in future versions of Sass." << std::endl;
+    std::ostringstream message;
+    message << "WARNING: " << msg << "\n";
+    message << "        on line " << pstate.line+1 << " of " << output_path << "\n";
+    message << "This will be an error in future versions of Sass." << "\n";
+    Messages::emit(message.str());
   }
 
   // should be replaced with error with backtraces
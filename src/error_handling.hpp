@@ -146,17 +146,40 @@ namespace Sass {
         virtual ~StackError() throw() {};
     };
 
+    // Thrown by the cooperative compile budget checks (see the
+    // compile_budget and cancel_flag options); carries no source
+    // position since running out of time or being cancelled is
+    // not tied to any particular construct
+    class CompileCancelled : public std::runtime_error {
+      public:
+        CompileCancelled(bool deadline)
+        : std::runtime_error(deadline
+            ? "Compile aborted: time budget exceeded"
+            : "Compile aborted: cancelled by caller")
+        {};
+        virtual ~CompileCancelled() throw() {};
+    };
+
     /* common virtual base class (has no pstate or trace) */
     class OperationError : public std::runtime_error {
       protected:
-        std::string msg;
+        mutable std::string msg;
+        // subclasses assemble their message here on first use:
+        // operation errors get thrown on paths that sometimes
+        // catch and discard them (e.g. the parser's constant
+        // folding probe), which should not pay for the to_string
+        // calls and concatenations of a message nobody reads
+        virtual void format_msg() const { }
       public:
         OperationError(std::string msg = def_op_msg)
         : std::runtime_error(msg), msg(msg)
         {};
       public:
         virtual const char* errtype() const { return "Error"; }
-        virtual const char* what() const throw() { return msg.c_str(); }
+        virtual const char* what() const throw() {
+          if (msg.empty()) format_msg();
+          return msg.c_str();
+        }
         virtual ~OperationError() throw() {};
     };
 
@@ -164,6 +187,7 @@ namespace Sass {
       protected:
         const Expression& lhs;
         const Expression& rhs;
+        void format_msg() const override;
       public:
         ZeroDivisionError(const Expression& lhs, const Expression& rhs);
         virtual const char* errtype() const { return "ZeroDivisionError"; }
@@ -172,8 +196,9 @@ namespace Sass {
 
     class IncompatibleUnits : public OperationError {
       protected:
-        // const Sass::UnitType lhs;
-        // const Sass::UnitType rhs;
+        std::string lhs_unit;
+        std::string rhs_unit;
+        void format_msg() const override;
       public:
         IncompatibleUnits(const Units& lhs, const Units& rhs);
         IncompatibleUnits(const UnitType lhs, const UnitType rhs);
@@ -185,6 +210,7 @@ namespace Sass {
         const Expression* lhs;
         const Expression* rhs;
         const Sass_OP op;
+        void format_msg() const override;
       public:
         UndefinedOperation(const Expression* lhs, const Expression* rhs, enum Sass_OP op);
         // virtual const char* errtype() const { return "Error"; }
@@ -192,6 +218,8 @@ namespace Sass {
     };
 
     class InvalidNullOperation : public UndefinedOperation {
+      protected:
+        void format_msg() const override;
       public:
         InvalidNullOperation(const Expression* lhs, const Expression* rhs, enum Sass_OP op);
         virtual ~InvalidNullOperation() throw() {};
@@ -202,6 +230,7 @@ namespace Sass {
         const Expression* lhs;
         const Expression* rhs;
         const Sass_OP op;
+        void format_msg() const override;
       public:
         AlphaChannelsNotEqual(const Expression* lhs, const Expression* rhs, enum Sass_OP op);
         // virtual const char* errtype() const { return "Error"; }
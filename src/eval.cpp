@@ -8,6 +8,8 @@
 #include <sstream>
 #include <iomanip>
 #include <typeinfo>
+#include <algorithm>
+#include <unordered_set>
 
 #include "file.hpp"
 #include "eval.hpp"
@@ -16,6 +18,7 @@
 #include "util.hpp"
 #include "inspect.hpp"
 #include "operators.hpp"
+#include "messages.hpp"
 #include "environment.hpp"
 #include "position.hpp"
 #include "sass/values.h"
@@ -40,10 +43,12 @@ namespace Sass {
     traces(exp.traces),
     force(false),
     is_in_comment(false),
-    is_in_selector_schema(false)
+    is_in_selector_schema(false),
+    scratch_strings(),
+    scratch_depth(0)
   {
-    bool_true = SASS_MEMORY_NEW(Boolean, "[NA]", true);
-    bool_false = SASS_MEMORY_NEW(Boolean, "[NA]", false);
+    bool_true = shared_boolean(true, ParserState("[NA]"));
+    bool_false = shared_boolean(false, ParserState("[NA]"));
   }
   Eval::~Eval() { }
 
@@ -93,18 +98,21 @@ namespace Sass {
     std::string var(a->variable());
     if (a->is_global()) {
       if (a->is_default()) {
-        if (env->has_global(var)) {
-          Expression* e = Cast<Expression>(env->get_global(var));
+        // probe the global frame only once; evaluating the value can
+        // rehash it, so the slot is re-resolved by set_global after
+        EnvResult rv(env->find_global(var));
+        if (rv.found) {
+          Expression* e = Cast<Expression>(rv.it->second.ptr());
           if (!e || e->concrete_type() == Expression::NULL_VAL) {
-            env->set_global(var, a->value()->perform(this));
+            env->set_global(var, eval(a->value()));
           }
         }
         else {
-          env->set_global(var, a->value()->perform(this));
+          env->set_global(var, eval(a->value()));
         }
       }
       else {
-        env->set_global(var, a->value()->perform(this));
+        env->set_global(var, eval(a->value()));
       }
     }
     else if (a->is_default()) {
@@ -115,7 +123,7 @@ namespace Sass {
             if (AST_Node_Obj node = cur->get_local(var)) {
               Expression* e = Cast<Expression>(node);
               if (!e || e->concrete_type() == Expression::NULL_VAL) {
-                cur->set_local(var, a->value()->perform(this));
+                cur->set_local(var, eval(a->value()));
               }
             }
             else {
@@ -127,23 +135,24 @@ namespace Sass {
         }
         throw std::runtime_error("Env not in sync");
       }
-      else if (env->has_global(var)) {
-        if (AST_Node_Obj node = env->get_global(var)) {
-          Expression* e = Cast<Expression>(node);
-          if (!e || e->concrete_type() == Expression::NULL_VAL) {
-            env->set_global(var, a->value()->perform(this));
+      else {
+        EnvResult rv(env->find_global(var));
+        if (rv.found) {
+          if (AST_Node_Obj node = rv.it->second) {
+            Expression* e = Cast<Expression>(node);
+            if (!e || e->concrete_type() == Expression::NULL_VAL) {
+              env->set_global(var, eval(a->value()));
+            }
           }
         }
-      }
-      else if (env->is_lexical()) {
-        env->set_local(var, a->value()->perform(this));
-      }
-      else {
-        env->set_local(var, a->value()->perform(this));
+        else {
+          // no lexical nor global yet, declare it here
+          env->set_local(var, eval(a->value()));
+        }
       }
     }
     else {
-      env->set_lexical(var, a->value()->perform(this));
+      env->set_lexical(var, eval(a->value()));
     }
     return 0;
   }
@@ -153,7 +162,7 @@ namespace Sass {
     Expression_Obj rv;
     Env env(environment());
     env_stack().push_back(&env);
-    Expression_Obj cond = i->predicate()->perform(this);
+    Expression_Obj cond = eval(i->predicate());
     if (!cond->is_false()) {
       rv = i->block()->perform(this);
     }
@@ -170,12 +179,12 @@ namespace Sass {
   Expression* Eval::operator()(For* f)
   {
     std::string variable(f->variable());
-    Expression_Obj low = f->lower_bound()->perform(this);
+    Expression_Obj low = eval(f->lower_bound());
     if (low->concrete_type() != Expression::NUMBER) {
       traces.push_back(Backtrace(low->pstate()));
       throw Exception::TypeMismatch(traces, *low, "integer");
     }
-    Expression_Obj high = f->upper_bound()->perform(this);
+    Expression_Obj high = eval(f->upper_bound());
     if (high->concrete_type() != Expression::NUMBER) {
       traces.push_back(Backtrace(high->pstate()));
       throw Exception::TypeMismatch(traces, *high, "integer");
@@ -226,7 +235,7 @@ namespace Sass {
   Expression* Eval::operator()(Each* e)
   {
     std::vector<std::string> variables(e->variables());
-    Expression_Obj expr = e->list()->perform(this);
+    Expression_Obj expr = eval(e->list());
     Env env(environment(), true);
     env_stack().push_back(&env);
     List_Obj list;
@@ -250,7 +259,7 @@ namespace Sass {
     Expression_Obj val;
 
     if (map) {
-      for (Expression_Obj key : map->keys()) {
+      for (const Expression_Obj& key : map->keys()) {
         Expression_Obj value = map->at(key);
 
         if (variables.size() == 1) {
@@ -284,7 +293,7 @@ namespace Sass {
             // XXX: this is never hit via spec tests
             for (size_t j = 0, K = variables.size(); j < K; ++j) {
               Expression* res = j >= scalars->length()
-                ? SASS_MEMORY_NEW(Null, expr->pstate())
+                ? shared_null(expr->pstate())
                 : scalars->at(j);
               env.set_local(variables[j], res);
             }
@@ -294,7 +303,7 @@ namespace Sass {
             env.set_local(variables.at(0), item);
             for (size_t j = 1, K = variables.size(); j < K; ++j) {
               // XXX: this is never hit via spec tests
-              Expression* res = SASS_MEMORY_NEW(Null, expr->pstate());
+              Expression* res = shared_null(expr->pstate());
               env.set_local(variables[j], res);
             }
           }
@@ -313,14 +322,14 @@ namespace Sass {
     Block_Obj body = w->block();
     Env env(environment(), true);
     env_stack().push_back(&env);
-    Expression_Obj cond = pred->perform(this);
+    Expression_Obj cond = eval(pred);
     while (!cond->is_false()) {
       Expression_Obj val = body->perform(this);
       if (val) {
         env_stack().pop_back();
         return val.detach();
       }
-      cond = pred->perform(this);
+      cond = eval(pred);
     }
     env_stack().pop_back();
     return 0;
@@ -328,14 +337,14 @@ namespace Sass {
 
   Expression* Eval::operator()(Return* r)
   {
-    return r->value()->perform(this);
+    return eval(r->value());
   }
 
   Expression* Eval::operator()(Warning* w)
   {
     Sass_Output_Style outstyle = options().output_style;
     options().output_style = NESTED;
-    Expression_Obj message = w->message()->perform(this);
+    Expression_Obj message = eval(w->message());
     Env* env = environment();
 
     // try to use generic function
@@ -370,10 +379,12 @@ namespace Sass {
     }
 
     std::string result(unquote(message->to_sass()));
-    std::cerr << "WARNING: " << result << std::endl;
     traces.push_back(Backtrace(w->pstate()));
-    std::cerr << traces_to_string(traces, "         ");
-    std::cerr << std::endl;
+    std::ostringstream msg;
+    msg << "WARNING: " << result << "\n";
+    msg << traces_to_string(traces, "         ");
+    msg << "\n";
+    Messages::emit(msg.str());
     options().output_style = outstyle;
     traces.pop_back();
     return 0;
@@ -383,7 +394,7 @@ namespace Sass {
   {
     Sass_Output_Style outstyle = options().output_style;
     options().output_style = NESTED;
-    Expression_Obj message = e->message()->perform(this);
+    Expression_Obj message = eval(e->message());
     Env* env = environment();
 
     // try to use generic function
@@ -427,7 +438,7 @@ namespace Sass {
   {
     Sass_Output_Style outstyle = options().output_style;
     options().output_style = NESTED;
-    Expression_Obj message = d->value()->perform(this);
+    Expression_Obj message = eval(d->value());
     Env* env = environment();
 
     // try to use generic function
@@ -467,8 +478,9 @@ namespace Sass {
     std::string output_path(Sass::File::path_for_console(rel_path, abs_path, d->pstate().path));
     options().output_style = outstyle;
 
-    std::cerr << output_path << ":" << d->pstate().line+1 << " DEBUG: " << result;
-    std::cerr << std::endl;
+    std::ostringstream msg;
+    msg << output_path << ":" << d->pstate().line+1 << " DEBUG: " << result << "\n";
+    Messages::emit(msg.str());
     return 0;
   }
 
@@ -482,8 +494,8 @@ namespace Sass {
                                 l->length() / 2);
       for (size_t i = 0, L = l->length(); i < L; i += 2)
       {
-        Expression_Obj key = (*l)[i+0]->perform(this);
-        Expression_Obj val = (*l)[i+1]->perform(this);
+        Expression_Obj key = eval((*l)[i+0]);
+        Expression_Obj val = eval((*l)[i+1]);
         // make sure the color key never displays its real name
         key->is_delayed(true); // verified
         *lm << std::make_pair(key, val);
@@ -494,19 +506,36 @@ namespace Sass {
       }
 
       lm->is_interpolant(l->is_interpolant());
-      return lm->perform(this);
+      return eval(lm);
     }
     // check if we should expand it
     if (l->is_expanded()) return l;
-    // regular case for unevaluated lists
-    List_Obj ll = SASS_MEMORY_NEW(List,
-                               l->pstate(),
-                               l->length(),
-                               l->separator(),
-                               l->is_arglist(),
-                               l->is_bracketed());
+    // regular case for unevaluated lists; most literal lists in real
+    // sheets are short constant pairs (`0 auto` and friends) whose
+    // children evaluate to themselves, so the copy is only allocated
+    // once a child actually comes back as a different node
+    List_Obj ll;
     for (size_t i = 0, L = l->length(); i < L; ++i) {
-      ll->append((*l)[i]->perform(this));
+      Expression_Obj item = eval((*l)[i]);
+      if (!ll) {
+        // constants come back as the identical node
+        if (item.ptr() == (*l)[i].ptr()) continue;
+        ll = SASS_MEMORY_NEW(List,
+                          l->pstate(),
+                          L,
+                          l->separator(),
+                          l->is_arglist(),
+                          l->is_bracketed());
+        // adopt the prefix that evaluated to itself
+        for (size_t j = 0; j < i; ++j) ll->append((*l)[j]);
+      }
+      ll->append(item);
+    }
+    if (!ll) {
+      // every child is scope independent, so the literal is its
+      // own value; remember that via the expanded flag above
+      l->is_expanded(true);
+      return l;
     }
     ll->is_interpolant(l->is_interpolant());
     ll->from_selector(l->from_selector());
@@ -528,11 +557,11 @@ namespace Sass {
     Map_Obj mm = SASS_MEMORY_NEW(Map,
                                 m->pstate(),
                                 m->length());
-    for (auto key : m->keys()) {
-      Expression* ex_key = key->perform(this);
+    for (const auto& key : m->keys()) {
+      Expression* ex_key = eval(key);
       Expression* ex_val = m->at(key);
       if (ex_val == NULL) continue;
-      ex_val = ex_val->perform(this);
+      ex_val = eval(ex_val);
       *mm << std::make_pair(ex_key, ex_val);
     }
 
@@ -548,22 +577,50 @@ namespace Sass {
 
   Expression* Eval::operator()(Binary_Expression* b_in)
   {
+    // Operators parse left-associative, so a chain like
+    // a + b + c + ... hangs off the left side of the tree and
+    // native recursion costs one large frame per operator. Walk
+    // down the spine first and fold it back up in a loop so stack
+    // usage stays flat however long the chain gets. The walk stops
+    // at logical operators (they short-circuit) and at delayed
+    // nodes (they must not be evaluated here), both of which take
+    // the per-node path below unchanged.
+    std::vector<Binary_Expression*> spine;
+    Binary_Expression* cur = b_in;
+    while (cur->optype() != Sass_OP::AND && cur->optype() != Sass_OP::OR) {
+      Binary_Expression* l_b = Cast<Binary_Expression>(cur->left());
+      if (l_b == nullptr) break;
+      if (!force && l_b->is_delayed()) break;
+      spine.push_back(cur);
+      cur = l_b;
+    }
+    Expression_Obj folded = eval_binary(cur, nullptr);
+    while (!spine.empty()) {
+      folded = eval_binary(spine.back(), folded.ptr());
+      spine.pop_back();
+    }
+    return folded.detach();
+  }
 
-    Expression_Obj lhs = b_in->left();
+  Expression* Eval::eval_binary(Binary_Expression* b_in, Expression* pre_lhs)
+  {
+
+    Expression_Obj lhs = pre_lhs;
+    if (!lhs) lhs = b_in->left();
     Expression_Obj rhs = b_in->right();
     enum Sass_OP op_type = b_in->optype();
 
     if (op_type == Sass_OP::AND) {
       // LOCAL_FLAG(force, true);
-      lhs = lhs->perform(this);
+      lhs = eval(lhs);
       if (!*lhs) return lhs.detach();
-      return rhs->perform(this);
+      return eval(rhs);
     }
     else if (op_type == Sass_OP::OR) {
       // LOCAL_FLAG(force, true);
-      lhs = lhs->perform(this);
+      lhs = eval(lhs);
       if (*lhs) return lhs.detach();
-      return rhs->perform(this);
+      return eval(rhs);
     }
 
     // Evaluate variables as early o
@@ -588,8 +645,8 @@ namespace Sass {
 
     // don't eval delayed expressions (the '/' when used as a separator)
     if (!force && op_type == Sass_OP::DIV && b->is_delayed()) {
-      b->right(b->right()->perform(this));
-      b->left(b->left()->perform(this));
+      b->right(eval(b->right()));
+      b->left(eval(b->left()));
       return b.detach();
     }
 
@@ -607,6 +664,13 @@ namespace Sass {
             case Sass_OP::LTE: return *l_n < *r_n || *l_n == *r_n ? bool_true : bool_false;
             case Sass_OP::GT: return *l_n < *r_n || *l_n == *r_n ? bool_false : bool_true;
             case Sass_OP::ADD: case Sass_OP::SUB: case Sass_OP::MUL: case Sass_OP::DIV: case Sass_OP::MOD:
+              // a temporary lhs (our local handle is the only owner)
+              // can take the result in place, sparing an allocation
+              // per operation in numeric loop chains
+              if (l_n->getRefCount() == 1 &&
+                  Operators::op_number_inplace(op_type, *l_n, *r_n)) {
+                return lhs.detach();
+              }
               return Operators::op_numbers(op_type, *l_n, *r_n, options(), b_in->pstate());
             default: break;
           }
@@ -690,10 +754,10 @@ namespace Sass {
                                                     b->op(), s_l->last(), b->right());
         bin_ex->is_delayed(b->left()->is_delayed() || b->right()->is_delayed()); // unverified
         for (size_t i = 0; i < s_l->length() - 1; ++i) {
-          ret_schema->append(s_l->at(i)->perform(this));
+          ret_schema->append(eval(s_l->at(i)));
         }
-        ret_schema->append(bin_ex->perform(this));
-        return ret_schema->perform(this);
+        ret_schema->append(eval(bin_ex));
+        return eval(ret_schema);
       }
     }
     if (String_Schema* s_r = Cast<String_Schema>(b->right())) {
@@ -703,11 +767,11 @@ namespace Sass {
         Binary_Expression_Obj bin_ex = SASS_MEMORY_NEW(Binary_Expression, b->pstate(),
                                                     b->op(), b->left(), s_r->first());
         bin_ex->is_delayed(b->left()->is_delayed() || b->right()->is_delayed()); // verified
-        ret_schema->append(bin_ex->perform(this));
+        ret_schema->append(eval(bin_ex));
         for (size_t i = 1; i < s_r->length(); ++i) {
-          ret_schema->append(s_r->at(i)->perform(this));
+          ret_schema->append(eval(s_r->at(i)));
         }
-        return ret_schema->perform(this);
+        return eval(ret_schema);
       }
     }
 
@@ -722,17 +786,17 @@ namespace Sass {
       LOCAL_FLAG(force, true);
       lhs->is_expanded(false);
       lhs->set_delayed(false);
-      lhs = lhs->perform(this);
+      lhs = eval(lhs);
       rhs->is_expanded(false);
       rhs->set_delayed(false);
-      rhs = rhs->perform(this);
+      rhs = eval(rhs);
     }
     else {
-      lhs = lhs->perform(this);
+      lhs = eval(lhs);
     }
 
     // not a logical connective, so go ahead and eval the rhs
-    rhs = rhs->perform(this);
+    rhs = eval(rhs);
     AST_Node_Obj lu = lhs;
     AST_Node_Obj ru = rhs;
 
@@ -794,12 +858,12 @@ namespace Sass {
     // see if it's a relational expression
     try {
       switch(op_type) {
-        case Sass_OP::EQ:  return SASS_MEMORY_NEW(Boolean, b->pstate(), Operators::eq(lhs, rhs));
-        case Sass_OP::NEQ: return SASS_MEMORY_NEW(Boolean, b->pstate(), Operators::neq(lhs, rhs));
-        case Sass_OP::GT:  return SASS_MEMORY_NEW(Boolean, b->pstate(), Operators::gt(lhs, rhs));
-        case Sass_OP::GTE: return SASS_MEMORY_NEW(Boolean, b->pstate(), Operators::gte(lhs, rhs));
-        case Sass_OP::LT:  return SASS_MEMORY_NEW(Boolean, b->pstate(), Operators::lt(lhs, rhs));
-        case Sass_OP::LTE: return SASS_MEMORY_NEW(Boolean, b->pstate(), Operators::lte(lhs, rhs));
+        case Sass_OP::EQ:  return shared_boolean(Operators::eq(lhs, rhs), b->pstate());
+        case Sass_OP::NEQ: return shared_boolean(Operators::neq(lhs, rhs), b->pstate());
+        case Sass_OP::GT:  return shared_boolean(Operators::gt(lhs, rhs), b->pstate());
+        case Sass_OP::GTE: return shared_boolean(Operators::gte(lhs, rhs), b->pstate());
+        case Sass_OP::LT:  return shared_boolean(Operators::lt(lhs, rhs), b->pstate());
+        case Sass_OP::LTE: return shared_boolean(Operators::lte(lhs, rhs), b->pstate());
         default: break;
       }
     }
@@ -821,7 +885,14 @@ namespace Sass {
         Number* l_n = Cast<Number>(lhs);
         Number* r_n = Cast<Number>(rhs);
         l_n->reduce(); r_n->reduce();
-        rv = Operators::op_numbers(op_type, *l_n, *r_n, options(), pstate);
+        // same in-place fast path as the early number branch above
+        if (l_n->getRefCount() == 1 &&
+            Operators::op_number_inplace(op_type, *l_n, *r_n)) {
+          rv = lhs;
+        }
+        else {
+          rv = Operators::op_numbers(op_type, *l_n, *r_n, options(), pstate);
+        }
       }
       else if (l_type == Expression::NUMBER && r_type == Expression::COLOR) {
         Number* l_n = Cast<Number>(lhs);
@@ -885,7 +956,7 @@ namespace Sass {
       if (schema_op) {
         // XXX: this is never hit via spec tests
         (*s2)[0] = rv;
-        rv = s2->perform(this);
+        rv = eval(s2);
       }
     }
 
@@ -895,11 +966,9 @@ namespace Sass {
 
   Expression* Eval::operator()(Unary_Expression* u)
   {
-    Expression_Obj operand = u->operand()->perform(this);
+    Expression_Obj operand = eval(u->operand());
     if (u->optype() == Unary_Expression::NOT) {
-      Boolean* result = SASS_MEMORY_NEW(Boolean, u->pstate(), (bool)*operand);
-      result->value(!result->value());
-      return result;
+      return shared_boolean(!(bool)*operand, u->pstate());
     }
     else if (Number_Obj nr = Cast<Number>(operand)) {
       // negate value for minus unary expression
@@ -948,6 +1017,274 @@ namespace Sass {
     return u;
   }
 
+  namespace {
+
+    // built-in functions that always map equal inputs to equal
+    // outputs; the purity scan only accepts calls to these (plus
+    // self-recursion). notable omissions: random and unique-id
+    // (non-deterministic), variable-exists and friends (query the
+    // environment, not their arguments), call (opaque dispatch)
+    bool is_pure_builtin(const std::string& name)
+    {
+      static const std::unordered_set<std::string> pure_builtins({
+        "if", "not", "comparable",
+        // numbers
+        "percentage", "round", "ceil", "floor", "abs", "min", "max",
+        // strings
+        "unquote", "quote", "str-length", "str-insert", "str-index",
+        "str-slice", "to-upper-case", "to-lower-case",
+        // lists
+        "length", "nth", "set-nth", "index", "join", "append",
+        "zip", "list-separator", "is-bracketed",
+        // maps
+        "map-get", "map-merge", "map-remove", "map-keys",
+        "map-values", "map-has-key", "map-get-path", "keywords",
+        // colors
+        "rgb", "rgba", "red", "green", "blue", "mix",
+        "hsl", "hsla", "hue", "saturation", "lightness",
+        "adjust-hue", "lighten", "darken", "saturate", "desaturate",
+        "grayscale", "complement", "invert", "alpha", "opacity",
+        "opacify", "fade-in", "transparentize", "fade-out",
+        "adjust-color", "scale-color", "change-color", "ie-hex-str",
+        // introspection on values (not on the environment)
+        "type-of", "unit", "unitless", "inspect"
+      });
+      return pure_builtins.count(name) != 0;
+    }
+
+    // walking state for the purity scan: the lexical scopes seen
+    // so far (parameters at the bottom) and the closure names the
+    // body turned out to read
+    struct PurityScan {
+      std::vector<std::unordered_set<std::string>> frames;
+      std::vector<std::string> free_variables;
+      std::vector<std::string> free_functions;
+      // the function's own (normalized) name; recursion is pure
+      std::string self;
+      bool known(const std::string& name) const {
+        for (size_t i = frames.size(); i > 0; --i) {
+          if (frames[i-1].count(name)) return true;
+        }
+        return false;
+      }
+      void record_free(std::vector<std::string>& into, const std::string& name) {
+        if (std::find(into.begin(), into.end(), name) == into.end()) {
+          into.push_back(name);
+        }
+      }
+    };
+
+    bool scan_purity_block(Block* b, PurityScan& scan);
+
+    bool scan_purity_expr(Expression* e, PurityScan& scan)
+    {
+      if (e == 0) return true;
+      switch (e->concrete_type()) {
+        case Expression::NUMBER:
+        case Expression::BOOLEAN:
+        case Expression::COLOR:
+        case Expression::NULL_VAL:
+          return true;
+        default:
+          break;
+      }
+      if (Variable* v = Cast<Variable>(e)) {
+        if (!scan.known(v->name())) {
+          scan.record_free(scan.free_variables, v->name());
+        }
+        return true;
+      }
+      if (Function_Call* c = Cast<Function_Call>(e)) {
+        // interpolated names resolve to unknown callables
+        if (Cast<String_Schema>(c->sname())) return false;
+        std::string name(Util::normalize_underscores(c->name()));
+        if (name != scan.self) {
+          if (!is_pure_builtin(name)) return false;
+          // remember the resolution so the call key can reject a
+          // user override shadowing the built-in (see pure_call_key)
+          scan.record_free(scan.free_functions, name + "[f]");
+        }
+        if (c->arguments()) {
+          for (const Argument_Obj& arg : c->arguments()->elements()) {
+            if (!scan_purity_expr(arg->value(), scan)) return false;
+          }
+        }
+        return true;
+      }
+      if (List* l = Cast<List>(e)) {
+        for (const Expression_Obj& item : l->elements()) {
+          if (!scan_purity_expr(item, scan)) return false;
+        }
+        return true;
+      }
+      if (Map* m = Cast<Map>(e)) {
+        for (const Expression_Obj& key : m->keys()) {
+          if (!scan_purity_expr(key, scan)) return false;
+        }
+        for (const Expression_Obj& val : m->values()) {
+          if (!scan_purity_expr(val, scan)) return false;
+        }
+        return true;
+      }
+      if (Binary_Expression* b = Cast<Binary_Expression>(e)) {
+        return scan_purity_expr(b->left(), scan)
+            && scan_purity_expr(b->right(), scan);
+      }
+      if (Unary_Expression* u = Cast<Unary_Expression>(e)) {
+        return scan_purity_expr(u->operand(), scan);
+      }
+      if (String_Schema* s = Cast<String_Schema>(e)) {
+        for (const PreValue_Obj& item : s->elements()) {
+          if (!scan_purity_expr(item, scan)) return false;
+        }
+        return true;
+      }
+      // includes String_Quoted
+      if (Cast<String_Constant>(e)) return true;
+      // unknown expression kinds keep the function impure
+      return false;
+    }
+
+    bool scan_purity_stmt(Statement* s, PurityScan& scan)
+    {
+      if (Return* r = Cast<Return>(s)) {
+        return scan_purity_expr(r->value(), scan);
+      }
+      if (Assignment* a = Cast<Assignment>(s)) {
+        // global writes escape the call; !default reads whatever
+        // binding state the caller left behind
+        if (a->is_global() || a->is_default()) return false;
+        if (!scan_purity_expr(a->value(), scan)) return false;
+        scan.frames.back().insert(a->variable());
+        return true;
+      }
+      if (If* i = Cast<If>(s)) {
+        if (!scan_purity_expr(i->predicate(), scan)) return false;
+        scan.frames.emplace_back();
+        bool ok = scan_purity_block(i->block(), scan);
+        scan.frames.pop_back();
+        if (!ok) return false;
+        scan.frames.emplace_back();
+        ok = scan_purity_block(i->alternative(), scan);
+        scan.frames.pop_back();
+        return ok;
+      }
+      if (Each* e = Cast<Each>(s)) {
+        if (!scan_purity_expr(e->list(), scan)) return false;
+        scan.frames.emplace_back();
+        for (const std::string& var : e->variables()) {
+          scan.frames.back().insert(var);
+        }
+        bool ok = scan_purity_block(e->block(), scan);
+        scan.frames.pop_back();
+        return ok;
+      }
+      if (For* f = Cast<For>(s)) {
+        if (!scan_purity_expr(f->lower_bound(), scan)) return false;
+        if (!scan_purity_expr(f->upper_bound(), scan)) return false;
+        scan.frames.emplace_back();
+        scan.frames.back().insert(f->variable());
+        bool ok = scan_purity_block(f->block(), scan);
+        scan.frames.pop_back();
+        return ok;
+      }
+      if (While* w = Cast<While>(s)) {
+        if (!scan_purity_expr(w->predicate(), scan)) return false;
+        scan.frames.emplace_back();
+        bool ok = scan_purity_block(w->block(), scan);
+        scan.frames.pop_back();
+        return ok;
+      }
+      if (Cast<Comment>(s)) return true;
+      // warn/debug/error, imports, includes, nested definitions,
+      // rulesets: all observable per call or environment-bound
+      return false;
+    }
+
+    bool scan_purity_block(Block* b, PurityScan& scan)
+    {
+      if (b == 0) return true;
+      for (size_t i = 0, L = b->length(); i < L; ++i) {
+        if (!scan_purity_stmt(b->at(i), scan)) return false;
+      }
+      return true;
+    }
+
+    // decide once per definition whether the body is a pure
+    // mapping from its inputs; records the closure names it reads
+    void analyze_function_purity(Definition* def)
+    {
+      def->purity_scanned(true);
+      PurityScan scan;
+      scan.self = Util::normalize_underscores(def->name());
+      scan.frames.emplace_back();
+      if (Parameters* params = def->parameters()) {
+        for (const Parameter_Obj& param : params->elements()) {
+          scan.frames.back().insert(param->name());
+          if (!scan_purity_expr(param->default_value(), scan)) return;
+        }
+      }
+      if (!scan_purity_block(def->block(), scan)) return;
+      def->is_pure(true);
+      def->free_variables(scan.free_variables);
+      def->free_functions(scan.free_functions);
+    }
+
+  }
+
+  size_t Eval::pure_call_key(Definition* def, Arguments* args, PureCallKey& witness)
+  {
+    Env* closure = def->environment();
+    if (closure == 0) return 0;
+    size_t key = std::hash<Definition*>()(def);
+    witness.def = def;
+    for (const Argument_Obj& arg : args->elements()) {
+      Expression* value = arg->value();
+      size_t vh = value ? value->hash() : 0;
+      // a zero hash cannot tell two values apart
+      if (vh == 0) return 0;
+      hash_combine(key, std::hash<std::string>()(arg->name()));
+      hash_combine(key, vh);
+      // the same list binds differently when spread
+      hash_combine(key, (size_t) arg->is_rest_argument());
+      hash_combine(key, (size_t) arg->is_keyword_argument());
+      witness.values.push_back(value);
+      witness.shape += arg->name();
+      witness.shape += arg->is_rest_argument() ? '\2' : '\1';
+      witness.shape += arg->is_keyword_argument() ? '\2' : '\1';
+    }
+    for (const std::string& name : def->free_variables()) {
+      if (!closure->has(name)) return 0;
+      Expression* bound = Cast<Expression>((*closure)[name]);
+      size_t vh = bound ? bound->hash() : 0;
+      if (vh == 0) return 0;
+      hash_combine(key, std::hash<std::string>()(name));
+      hash_combine(key, vh);
+      witness.values.push_back(bound);
+    }
+    for (const std::string& name : def->free_functions()) {
+      // a user override of a pure built-in shadows it with a body
+      // the scan never saw; only trust the native resolution
+      if (!closure->has(name)) return 0;
+      Definition* resolved = Cast<Definition>((*closure)[name]);
+      if (resolved == 0 || resolved->native_function() == 0) return 0;
+    }
+    return key ? key : 1;
+  }
+
+  // the memo hash is not proof of identity; compare the kept key
+  // material value by value, so a colliding key simply misses
+  static bool same_pure_call(const Eval::PureCallKey& a, const Eval::PureCallKey& b)
+  {
+    if (a.def != b.def) return false;
+    if (a.shape != b.shape) return false;
+    if (a.values.size() != b.values.size()) return false;
+    for (size_t i = 0, L = a.values.size(); i < L; ++i) {
+      if (!Operators::eq(a.values[i], b.values[i])) return false;
+    }
+    return true;
+  }
+
   Expression* Eval::operator()(Function_Call* c)
   {
     if (traces.size() > Constants::MaxCallStack) {
@@ -958,43 +1295,60 @@ namespace Sass {
     }
 
     if (Cast<String_Schema>(c->sname())) {
-      Expression_Obj evaluated_name = c->sname()->perform(this);
-      Expression_Obj evaluated_args = c->arguments()->perform(this);
+      Expression_Obj evaluated_name = eval(c->sname());
+      Expression_Obj evaluated_args = eval(c->arguments());
       std::string str(evaluated_name->to_string());
       str += evaluated_args->to_string();
       return SASS_MEMORY_NEW(String_Constant, c->pstate(), str);
     }
 
-    std::string name(Util::normalize_underscores(c->name()));
-    std::string full_name(name + "[f]");
-
     // we make a clone here, need to implement that further
     Arguments_Obj args = c->arguments();
 
     Env* env = environment();
-    if (!env->has(full_name) || (!c->via_call() && Prelexer::re_special_fun(name.c_str()))) {
-      if (!env->has("*[f]")) {
-        for (Argument_Obj arg : args->elements()) {
-          if (List_Obj ls = Cast<List>(arg->value())) {
-            if (ls->size() == 0) error("() isn't a valid CSS value.", c->pstate(), traces);
+
+    // check the dispatch cache first: the node address alone is
+    // not a safe key (evaluation creates short-lived call nodes),
+    // so a hit must also present the same callable name
+    Definition_Obj cached_def;
+    std::string full_name;
+    {
+      auto fit = ctx.fn_dispatch_cache.find(c);
+      if (fit != ctx.fn_dispatch_cache.end() &&
+          fit->second.generation == ctx.fn_env_generation &&
+          fit->second.name == c->name()) {
+        cached_def = fit->second.def;
+        full_name = fit->second.full_name;
+      }
+    }
+
+    if (cached_def.isNull()) {
+      std::string name(Util::normalize_underscores(c->name()));
+      full_name = name + "[f]";
+      if (!env->has(full_name) || (!c->via_call() && Prelexer::re_special_fun(name.c_str()))) {
+        if (!env->has("*[f]")) {
+          for (const Argument_Obj& arg : args->elements()) {
+            if (List_Obj ls = Cast<List>(arg->value())) {
+              if (ls->size() == 0) error("() isn't a valid CSS value.", c->pstate(), traces);
+            }
           }
+          args = Cast<Arguments>(eval(args));
+          Function_Call_Obj lit = SASS_MEMORY_NEW(Function_Call,
+                                               c->pstate(),
+                                               c->name(),
+                                               args);
+          if (args->has_named_arguments()) {
+            error("Plain CSS function " + c->name() + " doesn't support keyword arguments", c->pstate(), traces);
+          }
+          String_Quoted* str = SASS_MEMORY_NEW(String_Quoted,
+                                               c->pstate(),
+                                               lit->to_string(options()));
+          str->is_interpolant(c->is_interpolant());
+          return str;
+        } else {
+          // call generic function
+          full_name = "*[f]";
         }
-        args = Cast<Arguments>(args->perform(this));
-        Function_Call_Obj lit = SASS_MEMORY_NEW(Function_Call,
-                                             c->pstate(),
-                                             c->name(),
-                                             args);
-        if (args->has_named_arguments()) {
-          error("Plain CSS function " + c->name() + " doesn't support keyword arguments", c->pstate(), traces);
-        }
-        String_Quoted* str = SASS_MEMORY_NEW(String_Quoted,
-                                             c->pstate(),
-                                             lit->to_string(options()));
-        str->is_interpolant(c->is_interpolant());
-        return str;
-      } else {
-        // call generic function
-        full_name = "*[f]";
       }
     }
 
@@ -1003,14 +1357,25 @@ namespace Sass {
       args->set_delayed(false); // verified
     }
     if (full_name != "if[f]") {
-      args = Cast<Arguments>(args->perform(this));
+      args = Cast<Arguments>(eval(args));
+    }
+    Definition* def = cached_def.ptr();
+    if (def == 0) {
+      def = Cast<Definition>((*env)[full_name]);
+      // remember the resolution for the next call through here,
+      // but only when it came from the global frame (or beyond,
+      // where the built-ins live): a shared tree can be expanded
+      // again under a different scope — the same sheet @imported
+      // at two nesting sites — and the generation only advances
+      // on registration, not when a local definition's scope ends
+      if (!env->has_lexical(full_name)) {
+        ctx.fn_dispatch_cache[c] = { def, c->name(), full_name, ctx.fn_env_generation };
+      }
     }
-    Definition* def = Cast<Definition>((*env)[full_name]);
 
     if (c->func()) def = c->func()->definition();
 
     if (def->is_overload_stub()) {
-      std::stringstream ss;
       size_t L = args->length();
       // account for rest arguments
       if (args->has_rest_argument() && args->length() > 0) {
@@ -1019,8 +1384,9 @@ namespace Sass {
         // arguments before rest argument plus rest
         if (rest) L += rest->length() - 1;
       }
-      ss << full_name << L;
-      full_name = ss.str();
+      // resolved on every overloaded builtin call, so build the
+      // name without the locale handshake a stringstream performs
+      full_name += std::to_string(L);
       std::string resolved_name(full_name);
       if (!env->has(resolved_name)) error("overloaded function `" + std::string(c->name()) + "` given wrong number of arguments", c->pstate(), traces);
       def = Cast<Definition>((*env)[resolved_name]);
@@ -1033,14 +1399,40 @@ namespace Sass {
 
     if (c->is_css()) return result.detach();
 
+    // memoize user defined functions whose body is a pure mapping
+    // from its inputs: a repeat call with equal argument values
+    // and unchanged closure bindings returns a copy of the first
+    // result instead of running the body again. a user function
+    // shadowing `if` keeps its arguments unevaluated, so it stays
+    // outside the memo. source maps rule the memo out entirely:
+    // result positions can derive from the argument literals of
+    // the populating call, which a copy cannot re-derive for the
+    // current one
+    size_t memo_key = 0;
+    PureCallKey memo_witness;
+    if (body && full_name != "if[f]" && !ctx.emitter.srcmap_enabled) {
+      if (!def->purity_scanned()) analyze_function_purity(def);
+      if (def->is_pure()) {
+        memo_key = pure_call_key(def, args, memo_witness);
+        if (memo_key) {
+          auto hit = pure_fn_memo.find(memo_key);
+          if (hit != pure_fn_memo.end() &&
+              same_pure_call(hit->second.key, memo_witness)) {
+            Expression* cached = SASS_MEMORY_COPY(hit->second.result.ptr());
+            cached->is_interpolant(c->is_interpolant());
+            return cached;
+          }
+        }
+      }
+    }
+
     Parameters_Obj params = def->parameters();
     Env fn_env(def->environment());
     env_stack().push_back(&fn_env);
 
     if (func || body) {
       bind(std::string("Function"), c->name(), params, args, &fn_env, this, traces);
-      std::string msg(", in function `" + c->name() + "`");
-      traces.push_back(Backtrace(c->pstate(), msg));
+      traces.emplace_back(c->pstate(), "function", c->name());
       callee_stack().push_back({
         c->name().c_str(),
         c->pstate().path,
@@ -1079,8 +1471,7 @@ namespace Sass {
       // populates env with default values for params
       std::string ff(c->name());
       bind(std::string("Function"), c->name(), params, args, &fn_env, this, traces);
-      std::string msg(", in function `" + c->name() + "`");
-      traces.push_back(Backtrace(c->pstate(), msg));
+      traces.emplace_back(c->pstate(), "function", c->name());
       callee_stack().push_back({
         c->name().c_str(),
         c->pstate().path,
@@ -1122,10 +1513,18 @@ namespace Sass {
 
     // link back to function definition
     // only do this for custom functions
-    if (result->pstate().file == std::string::npos)
+    if (result->pstate().file == Offset::npos)
       result->pstate(c->pstate());
 
-    result = result->perform(this);
+    result = eval(result);
+    // store a copy so the caller's flag and pstate relinking
+    // cannot reach back into the cached node; a colliding key
+    // simply hands its slot to the newer call
+    if (memo_key) {
+      PureFnMemo& entry = pure_fn_memo[memo_key];
+      entry.key = std::move(memo_witness);
+      entry.result = SASS_MEMORY_COPY(result.ptr());
+    }
     result->is_interpolant(c->is_interpolant());
     env_stack().pop_back();
     return result.detach();
@@ -1144,7 +1543,7 @@ namespace Sass {
     value->is_interpolant(v->is_interpolant());
     if (force) value->is_expanded(false);
     value->set_delayed(false); // verified
-    value = value->perform(this);
+    value = eval(value);
     if(!force) rv.it->second = value;
     return value.detach();
   }
@@ -1175,7 +1574,7 @@ namespace Sass {
 
     if (Arguments* args = Cast<Arguments>(ex)) {
       List* ll = SASS_MEMORY_NEW(List, args->pstate(), 0, SASS_COMMA);
-      for(auto arg : args->elements()) {
+      for (const auto& arg : args->elements()) {
         ll->append(arg->value());
       }
       ll->is_interpolant(args->is_interpolant());
@@ -1207,14 +1606,14 @@ namespace Sass {
     // parent selector needs another go
     if (Cast<Parent_Reference>(ex)) {
       // XXX: this is never hit via spec tests
-      ex = ex->perform(this);
+      ex = eval(ex);
     }
 
     if (List* l = Cast<List>(ex)) {
       List_Obj ll = SASS_MEMORY_NEW(List, l->pstate(), 0, l->separator());
       // this fixes an issue with bourbon sample, not really sure why
       // if (l->size() && Cast<Null>((*l)[0])) { res += ""; }
-      for(Expression_Obj item : *l) {
+      for (const Expression_Obj& item : *l) {
         item->is_interpolant(l->is_interpolant());
         std::string rl(""); interpolation(ctx, rl, item, into_quotes, l->is_interpolant());
         bool is_null = Cast<Null>(item) != 0; // rl != ""
@@ -1241,9 +1640,26 @@ namespace Sass {
     // String_Constant
     // Binary_Expression
     else {
-      // ex = ex->perform(this);
+      // ex = eval(ex);
       if (into_quotes && ex->is_interpolant()) {
         res += evacuate_escapes(ex ? ex->to_string(options()) : "");
+      } else if (!into_quotes && ex) {
+        // typed fast paths for the common leaf values: append the
+        // token straight into the result buffer instead of paying
+        // an Emitter/Inspect construction per schema element
+        if (Number* nr = Cast<Number>(ex)) {
+          render_number(res, nr, options());
+        }
+        else if (String_Quoted* sq = Cast<String_Quoted>(ex)) {
+          if (const char q = sq->quote_mark()) res += sq->quoted(q);
+          else res += sq->value();
+        }
+        else if (String_Constant* sc = Cast<String_Constant>(ex)) {
+          res += sc->value();
+        }
+        else {
+          res += ex->to_string(options());
+        }
       } else {
         std::string str(ex ? ex->to_string(options()) : "");
         if (into_quotes) str = read_hex_escapes(str);
@@ -1258,34 +1674,33 @@ namespace Sass {
   Expression* Eval::operator()(String_Schema* s)
   {
     size_t L = s->length();
-    bool into_quotes = false;
-    if (L > 1) {
-      if (!Cast<String_Quoted>((*s)[0]) && !Cast<String_Quoted>((*s)[L - 1])) {
-      if (String_Constant* l = Cast<String_Constant>((*s)[0])) {
-        if (String_Constant* r = Cast<String_Constant>((*s)[L - 1])) {
-          if (r->value().size() > 0) {
-            if (l->value()[0] == '"' && r->value()[r->value().size() - 1] == '"') into_quotes = true;
-            if (l->value()[0] == '\'' && r->value()[r->value().size() - 1] == '\'') into_quotes = true;
-          }
-        }
-      }
-      }
-    }
+    // the plan captures everything that used to be re-derived per
+    // evaluation: quote detection, per-element type and interpolant
+    // flags, and the result length estimate
+    const String_Schema::EvalPlan& plan = s->eval_plan();
+    bool into_quotes = plan.into_quotes;
     bool was_quoted = false;
     bool was_interpolant = false;
-    std::string res("");
+    Scratch scratch(*this);
+    std::string& res = scratch.str;
+    res.reserve(plan.estimate);
     for (size_t i = 0; i < L; ++i) {
-      bool is_quoted = Cast<String_Quoted>((*s)[i]) != NULL;
-      if (was_quoted && !(*s)[i]->is_interpolant() && !was_interpolant) { res += " "; }
-      else if (i > 0 && is_quoted && !(*s)[i]->is_interpolant() && !was_interpolant) { res += " "; }
-      Expression_Obj ex = (*s)[i]->perform(this);
+      unsigned char flags = plan.flags[i];
+      bool is_quoted = flags & String_Schema::PLAN_QUOTED;
+      bool is_interp = flags & String_Schema::PLAN_INTERPOLANT;
+      if (was_quoted && !is_interp && !was_interpolant) { res += " "; }
+      else if (i > 0 && is_quoted && !is_interp && !was_interpolant) { res += " "; }
+      // plain constants evaluate to themselves; skip the dispatch
+      Expression_Obj ex = (flags & String_Schema::PLAN_LITERAL)
+                        ? Expression_Obj((*s)[i].ptr())
+                        : Expression_Obj(eval((*s)[i]));
       interpolation(ctx, res, ex, into_quotes, ex->is_interpolant());
-      was_quoted = Cast<String_Quoted>((*s)[i]) != NULL;
-      was_interpolant = (*s)[i]->is_interpolant();
+      was_quoted = is_quoted;
+      was_interpolant = is_interp;
 
     }
     if (!s->is_interpolant()) {
-      if (s->length() > 1 && res == "") return SASS_MEMORY_NEW(Null, s->pstate());
+      if (s->length() > 1 && res == "") return shared_null(s->pstate());
       return SASS_MEMORY_NEW(String_Constant, s->pstate(), res, s->css());
     }
     // string schema seems to have a special unquoting behavior (also handles "nested" quotes)
@@ -1315,8 +1730,8 @@ namespace Sass {
 
   Expression* Eval::operator()(Supports_Operator* c)
   {
-    Expression* left = c->left()->perform(this);
-    Expression* right = c->right()->perform(this);
+    Expression* left = eval(c->left());
+    Expression* right = eval(c->right());
     Supports_Operator* cc = SASS_MEMORY_NEW(Supports_Operator,
                                  c->pstate(),
                                  Cast<Supports_Condition>(left),
@@ -1327,7 +1742,7 @@ namespace Sass {
 
   Expression* Eval::operator()(Supports_Negation* c)
   {
-    Expression* condition = c->condition()->perform(this);
+    Expression* condition = eval(c->condition());
     Supports_Negation* cc = SASS_MEMORY_NEW(Supports_Negation,
                                  c->pstate(),
                                  Cast<Supports_Condition>(condition));
@@ -1336,8 +1751,8 @@ namespace Sass {
 
   Expression* Eval::operator()(Supports_Declaration* c)
   {
-    Expression* feature = c->feature()->perform(this);
-    Expression* value = c->value()->perform(this);
+    Expression* feature = eval(c->feature());
+    Expression* value = eval(c->value());
     Supports_Declaration* cc = SASS_MEMORY_NEW(Supports_Declaration,
                               c->pstate(),
                               feature,
@@ -1347,7 +1762,7 @@ namespace Sass {
 
   Expression* Eval::operator()(Supports_Interpolation* c)
   {
-    Expression* value = c->value()->perform(this);
+    Expression* value = eval(c->value());
     Supports_Interpolation* cc = SASS_MEMORY_NEW(Supports_Interpolation,
                             c->pstate(),
                             value);
@@ -1357,9 +1772,9 @@ namespace Sass {
   Expression* Eval::operator()(At_Root_Query* e)
   {
     Expression_Obj feature = e->feature();
-    feature = (feature ? feature->perform(this) : 0);
+    feature = (feature ? eval(feature) : 0);
     Expression_Obj value = e->value();
-    value = (value ? value->perform(this) : 0);
+    value = (value ? eval(value) : 0);
     Expression* ee = SASS_MEMORY_NEW(At_Root_Query,
                                      e->pstate(),
                                      Cast<String>(feature),
@@ -1370,7 +1785,7 @@ namespace Sass {
   Media_Query* Eval::operator()(Media_Query* q)
   {
     String_Obj t = q->media_type();
-    t = static_cast<String*>(t.isNull() ? 0 : t->perform(this));
+    t = static_cast<String*>(t.isNull() ? 0 : eval(t));
     Media_Query_Obj qq = SASS_MEMORY_NEW(Media_Query,
                                       q->pstate(),
                                       t,
@@ -1378,7 +1793,7 @@ namespace Sass {
                                       q->is_negated(),
                                       q->is_restricted());
     for (size_t i = 0, L = q->length(); i < L; ++i) {
-      qq->append(static_cast<Media_Query_Expression*>((*q)[i]->perform(this)));
+      qq->append(static_cast<Media_Query_Expression*>(eval((*q)[i])));
     }
     return qq.detach();
   }
@@ -1386,14 +1801,14 @@ namespace Sass {
   Expression* Eval::operator()(Media_Query_Expression* e)
   {
     Expression_Obj feature = e->feature();
-    feature = (feature ? feature->perform(this) : 0);
+    feature = (feature ? eval(feature) : 0);
     if (feature && Cast<String_Quoted>(feature)) {
       feature = SASS_MEMORY_NEW(String_Quoted,
                                   feature->pstate(),
                                   Cast<String_Quoted>(feature)->value());
     }
     Expression_Obj value = e->value();
-    value = (value ? value->perform(this) : 0);
+    value = (value ? eval(value) : 0);
     if (value && Cast<String_Quoted>(value)) {
       // XXX: this is never hit via spec tests
       value = SASS_MEMORY_NEW(String_Quoted,
@@ -1414,7 +1829,7 @@ namespace Sass {
 
   Expression* Eval::operator()(Argument* a)
   {
-    Expression_Obj val = a->value()->perform(this);
+    Expression_Obj val = eval(a->value());
     bool is_rest_argument = a->is_rest_argument();
     bool is_keyword_argument = a->is_keyword_argument();
 
@@ -1446,7 +1861,7 @@ namespace Sass {
     Arguments_Obj aa = SASS_MEMORY_NEW(Arguments, a->pstate());
     if (a->length() == 0) return aa.detach();
     for (size_t i = 0, L = a->length(); i < L; ++i) {
-      Expression_Obj rv = (*a)[i]->perform(this);
+      Expression_Obj rv = eval((*a)[i]);
       Argument* arg = Cast<Argument>(rv);
       if (!(arg->is_rest_argument() || arg->is_keyword_argument())) {
         aa->append(arg);
@@ -1454,8 +1869,8 @@ namespace Sass {
     }
 
     if (a->has_rest_argument()) {
-      Expression_Obj rest = a->get_rest_argument()->perform(this);
-      Expression_Obj splat = Cast<Argument>(rest)->value()->perform(this);
+      Expression_Obj rest = eval(a->get_rest_argument());
+      Expression_Obj splat = eval(Cast<Argument>(rest)->value());
 
       Sass_Separator separator = SASS_COMMA;
       List* ls = Cast<List>(splat);
@@ -1482,9 +1897,9 @@ namespace Sass {
     }
 
     if (a->has_keyword_argument()) {
-      Expression_Obj rv = a->get_keyword_argument()->perform(this);
+      Expression_Obj rv = eval(a->get_keyword_argument());
       Argument* rvarg = Cast<Argument>(rv);
-      Expression_Obj kwarg = rvarg->value()->perform(this);
+      Expression_Obj kwarg = eval(rvarg->value());
 
       aa->append(SASS_MEMORY_NEW(Argument, kwarg->pstate(), kwarg, "", false, true));
     }
@@ -1500,9 +1915,24 @@ namespace Sass {
   {
     LOCAL_FLAG(is_in_selector_schema, true);
     // the parser will look for a brace to end the selector
-    Expression_Obj sel = s->contents()->perform(this);
+    Expression_Obj sel = eval(s->contents());
     std::string result_str(sel->to_string(options()));
     result_str = unquote(Util::rtrim(result_str));
+
+    // repeated expansions of the same schema usually resolve to
+    // the same string; hand out a copy of the cached parse then.
+    // the schema position is part of the key so different schemas
+    // that happen to render alike keep their own source positions
+    std::string key(result_str);
+    key += '|'; key += std::to_string(s->pstate().file);
+    key += ':'; key += std::to_string(s->pstate().line);
+    key += ':'; key += std::to_string(s->pstate().column);
+    auto cached = ctx.parsed_selector_cache.find(key);
+    if (cached != ctx.parsed_selector_cache.end()) {
+      flag_is_in_selector_schema.reset();
+      return SASS_MEMORY_COPY(cached->second);
+    }
+
     char* temp_cstr = sass_copy_c_string(result_str.c_str());
     ctx.strings.push_back(temp_cstr); // attach to context
     Parser p = Parser::from_c_str(temp_cstr, ctx, traces, s->pstate());
@@ -1510,6 +1940,8 @@ namespace Sass {
     // If a schema contains a reference to parent it is already
     // connected to it, so don't connect implicitly anymore
     SelectorListObj parsed = p.parseSelectorList(true);
+    // cache a pristine copy (the returned one gets consumed)
+    ctx.parsed_selector_cache[key] = SASS_MEMORY_COPY(parsed);
     flag_is_in_selector_schema.reset();
     return parsed.detach();
   }
@@ -1519,7 +1951,7 @@ namespace Sass {
     if (SelectorListObj pr = exp.original()) {
       return operator()(pr);
     } else {
-      return SASS_MEMORY_NEW(Null, p->pstate());
+      return shared_null(p->pstate());
     }
   }
 
@@ -6,6 +6,8 @@
 #include "sass.hpp"
 #include "ast.hpp"
 
+#include <deque>
+
 #include "context.hpp"
 #include "listize.hpp"
 #include "operation.hpp"
@@ -32,6 +34,57 @@ namespace Sass {
     Boolean_Obj bool_true;
     Boolean_Obj bool_false;
 
+    // identity material behind a pure-function memo key; a hash
+    // match alone cannot be trusted (size_t is 32 bits on the
+    // win/ project builds, where collisions across a large sheet
+    // are expected), so every hit re-checks the material
+    struct PureCallKey {
+      Definition_Obj def;
+      // evaluated argument values, then the closure bindings the
+      // body reads, in the order they were hashed
+      std::vector<Expression_Obj> values;
+      // argument names and spread/keyword flags folded into one
+      // comparable string (the free variable names follow from
+      // the definition identity)
+      std::string shape;
+    };
+
+    // results of calls to pure user defined functions, keyed on a
+    // combined hash of the definition, the evaluated arguments and
+    // the closure bindings the body reads (see pure_call_key) and
+    // verified against the kept key material on every hit; hits
+    // hand out a copy so callers can relink flags freely
+    struct PureFnMemo {
+      PureCallKey key;
+      Expression_Obj result;
+    };
+    std::unordered_map<size_t, PureFnMemo> pure_fn_memo;
+
+    // scratch buffers for interpolation results, reused across
+    // the whole compilation; indexed by recursion depth so
+    // nested schemas get distinct buffers, while the retained
+    // capacity spares one heap round-trip per interpolation
+    std::deque<std::string> scratch_strings;
+    size_t scratch_depth;
+
+    std::string& acquire_scratch() {
+      if (scratch_depth == scratch_strings.size()) {
+        scratch_strings.emplace_back();
+      }
+      std::string& buffer = scratch_strings[scratch_depth++];
+      buffer.clear();
+      return buffer;
+    }
+    void release_scratch() { --scratch_depth; }
+
+    // holds one scratch buffer for the enclosing scope
+    struct Scratch {
+      Eval& eval;
+      std::string& str;
+      Scratch(Eval& eval) : eval(eval), str(eval.acquire_scratch()) {}
+      ~Scratch() { eval.release_scratch(); }
+    };
+
     Env* environment();
     EnvStack& env_stack();
     const std::string cwd();
@@ -39,6 +92,23 @@ namespace Sass {
     struct Sass_Inspect_Options& options();
     struct Sass_Compiler* compiler();
 
+    // type-switch fast path in front of the perform double
+    // dispatch: literal values evaluate to themselves (their
+    // handlers below are identities), so skip both virtual
+    // hops for the node kinds that dominate expression trees
+    Expression* eval(Expression* e)
+    {
+      switch (e->concrete_type()) {
+        case Expression::NUMBER:
+        case Expression::BOOLEAN:
+        case Expression::COLOR:
+        case Expression::NULL_VAL:
+          return e;
+        default:
+          return e->perform(this);
+      }
+    }
+
     // for evaluating function bodies
     Expression* operator()(Block*);
     Expression* operator()(Assignment*);
@@ -54,6 +124,9 @@ namespace Sass {
     Expression* operator()(List*);
     Expression* operator()(Map*);
     Expression* operator()(Binary_Expression*);
+    // evaluate one operator node; pre_lhs carries the already
+    // evaluated left operand when folding a left-leaning chain
+    Expression* eval_binary(Binary_Expression* b_in, Expression* pre_lhs);
     Expression* operator()(Unary_Expression*);
     Expression* operator()(Function_Call*);
     Expression* operator()(Variable*);
@@ -103,6 +176,11 @@ namespace Sass {
   private:
     void interpolation(Context& ctx, std::string& res, Expression_Obj ex, bool into_quotes, bool was_itpl = false);
 
+    // memo key for one call to a pure function; zero when any
+    // part cannot be hashed, which disables the memo for the call
+    size_t pure_call_key(Definition* def, Arguments* args,
+                         PureCallKey& witness);
+
   };
 
 }
@@ -12,10 +12,21 @@
 #include "backtrace.hpp"
 #include "context.hpp"
 #include "parser.hpp"
+#include "tracing.hpp"
 #include "sass_functions.hpp"
 
 namespace Sass {
 
+  // A note on parallelising this walk: expanding top-level rules on
+  // worker threads has been evaluated and rejected. Rules that look
+  // independent still share the global Env (any !global assignment or
+  // lazily evaluated default crosses spans), the Extender collects
+  // state across the whole tree, and SharedObj refcounts are not
+  // atomic, so AST nodes must stay on one thread. Parallelism lives a
+  // level up instead: independent entry points can be compiled
+  // concurrently via sass_compiler_pool_compile, where each thread
+  // owns its contexts and trees outright.
+
   // simple endless recursion protection
   const size_t maxRecursion = 500;
 
@@ -32,7 +43,8 @@ namespace Sass {
     call_stack(),
     selector_stack(),
     originalStack(),
-    mediaStack()
+    mediaStack(),
+    mediaSeqStack()
   {
     env_stack.push_back(nullptr);
     env_stack.push_back(env);
@@ -53,6 +65,7 @@ namespace Sass {
       }
     }
     mediaStack.push_back({});
+    mediaSeqStack.push_back(0);
   }
 
   Env* Expand::environment()
@@ -138,9 +151,17 @@ namespace Sass {
     originalStack.push_back(selector);
   }
 
+  // defined below, next to the declaration staticness scan
+  static bool block_declares_variables(Block* b);
+
   // blocks create new variable scopes
   Block* Expand::operator()(Block* b)
   {
+    // a block that cannot write into a frame of its own borrows
+    // the enclosing scope instead, so every variable lookup under
+    // it has one frame less to probe (common under media and
+    // breakpoint fan-out, where the branch bodies only read)
+    bool needs_frame = b->is_root() || block_declares_variables(b);
     // create new local environment
     // set the current env as parent
     Env env(environment());
@@ -151,17 +172,20 @@ namespace Sass {
                                 b->is_root());
     // setup block and env stack
     this->block_stack.push_back(bb);
-    this->env_stack.push_back(&env);
+    if (needs_frame) this->env_stack.push_back(&env);
     // operate on block
     // this may throw up!
     this->append_block(b);
     // revert block and env stack
     this->block_stack.pop_back();
-    this->env_stack.pop_back();
+    if (needs_frame) this->env_stack.pop_back();
     // return copy
     return bb.detach();
   }
 
+  // defined below, next to the declaration staticness scan
+  static bool ruleset_is_static(Ruleset* r);
+
   Statement* Expand::operator()(Ruleset* r)
   {
     LOCAL_FLAG(old_at_root_without_rule, at_root_without_rule);
@@ -189,7 +213,7 @@ namespace Sass {
       SelectorListObj sel = eval(r->schema());
       r->selector(sel);
       bool chroot = sel->has_real_parent_ref();
-      for (auto complex : sel->elements()) {
+      for (const auto& complex : sel->elements()) {
         complex->chroots(chroot);
       }
 
@@ -199,6 +223,20 @@ namespace Sass {
     LOCAL_FLAG(at_root_without_rule, false);
 
     SelectorListObj evaled = eval(r->selector());
+
+    // plain css rules (almost always vendored .css imports) have
+    // nothing that reads the environment or the selector stacks:
+    // expand the body directly and skip the per-rule frame and
+    // the original-selector copy kept for parent references
+    if (block_stack.back()->is_root() && ruleset_is_static(r)) {
+      ctx.extender.addSelector(evaled, mediaStack.back());
+      Block_Obj bb = operator()(r->block());
+      Ruleset* rr = SASS_MEMORY_NEW(Ruleset, r->pstate(), evaled, bb);
+      rr->is_root(r->is_root());
+      rr->tabs(r->tabs());
+      return rr;
+    }
+
     // do not connect parent again
     Env env(environment());
     if (block_stack.back()->is_root()) {
@@ -238,11 +276,12 @@ namespace Sass {
     return ff.detach();
   }
 
-  std::vector<CssMediaQuery_Obj> Expand::mergeMediaQueries(
-    const std::vector<CssMediaQuery_Obj>& lhs,
-    const std::vector<CssMediaQuery_Obj>& rhs)
+  PoolVector<CssMediaQuery_Obj> Expand::mergeMediaQueries(
+    const PoolVector<CssMediaQuery_Obj>& lhs,
+    const PoolVector<CssMediaQuery_Obj>& rhs)
   {
-    std::vector<CssMediaQuery_Obj> queries;
+    PoolVector<CssMediaQuery_Obj> queries;
+    // merge takes its argument by mutable reference
     for (CssMediaQuery_Obj query1 : lhs) {
       for (CssMediaQuery_Obj query2 : rhs) {
         CssMediaQuery_Obj result = query1->merge(query2);
@@ -258,21 +297,36 @@ namespace Sass {
   {
     Expression_Obj mq = eval(m->schema());
     std::string str_mq(mq->to_css(ctx.c_options));
-    char* str = sass_copy_c_string(str_mq.c_str());
-    ctx.strings.push_back(str);
-    Parser parser(Parser::from_c_str(str, ctx, traces, mq->pstate()));
     // Create a new CSS only representation of the media rule
     CssMediaRuleObj css = SASS_MEMORY_NEW(CssMediaRule, m->pstate(), m->block());
-    std::vector<CssMediaQuery_Obj> parsed = parser.parseCssMediaQueries();
-    if (mediaStack.size() && mediaStack.back()) {
-      auto& parent = mediaStack.back()->elements();
-      css->concat(mergeMediaQueries(parent, parsed));
+    bool has_parent = mediaStack.size() && mediaStack.back();
+    // parsing and merging the same query under the same parent
+    // yields the same list every time; the query nodes are never
+    // mutated once built, so cache hits share them outright
+    std::string key(std::to_string(has_parent ? mediaSeqStack.back() : 0));
+    key += '|'; key += str_mq;
+    auto cached = ctx.media_merge_cache.find(key);
+    if (cached != ctx.media_merge_cache.end()) {
+      css->concat(cached->second);
     }
     else {
-      css->concat(parsed);
+      char* str = sass_copy_c_string(str_mq.c_str());
+      ctx.strings.push_back(str);
+      Parser parser(Parser::from_c_str(str, ctx, traces, mq->pstate()));
+      PoolVector<CssMediaQuery_Obj> parsed = parser.parseCssMediaQueries();
+      if (has_parent) {
+        auto& parent = mediaStack.back()->elements();
+        css->concat(mergeMediaQueries(parent, parsed));
+      }
+      else {
+        css->concat(parsed);
+      }
+      ctx.media_merge_cache[key] = css->elements();
     }
     mediaStack.push_back(css);
+    mediaSeqStack.push_back(++ctx.media_merge_seq);
     css->block(operator()(m->block()));
+    mediaSeqStack.pop_back();
     mediaStack.pop_back();
     return css.detach();
 
@@ -319,10 +373,127 @@ namespace Sass {
     return aa;
   }
 
+  // whether evaluating [v] is guaranteed to return [v] itself;
+  // mirrors the identity cases of the eval dispatch fast path
+  static bool is_static_value(const Expression* v)
+  {
+    switch (v->concrete_type()) {
+      case Expression::NUMBER:
+      case Expression::BOOLEAN:
+      case Expression::COLOR:
+      case Expression::NULL_VAL:
+        return true;
+      case Expression::STRING:
+        // quoted strings get copied by eval, schemas interpolate
+        return Cast<const String_Quoted>(v) == nullptr
+            && Cast<const String_Constant>(v) != nullptr;
+      default:
+        return false;
+    }
+  }
+
+  // lazy staticness verdict for one declaration: fully static
+  // declarations evaluate to themselves; mixin bodies and plain
+  // css rules full of them are re-expanded over and over, so the
+  // verdict is kept on the node and later expansions build the
+  // result directly from the unevaluated property and value
+  static bool declaration_is_static(Declaration* d)
+  {
+    if (!d->static_scanned()) {
+      d->static_scanned(true);
+      d->is_static(!d->block() && d->value()
+        && Cast<String_Quoted>(d->property()) == nullptr
+        && Cast<String_Constant>(d->property()) != nullptr
+        && is_static_value(d->value()));
+    }
+    return d->is_static();
+  }
+
+  // lazy staticness verdict for a whole rule: no interpolation in
+  // the selector, no parent references, and a body of nothing but
+  // static declarations -- the shape vendored .css imports are
+  // made of
+  static bool ruleset_is_static(Ruleset* r)
+  {
+    if (!r->static_scanned()) {
+      r->static_scanned(true);
+      bool is_static = !r->schema() && r->selector() && r->block()
+        && !r->selector()->has_real_parent_ref();
+      if (is_static) {
+        Block* b = r->block();
+        for (size_t i = 0, L = b->length(); i < L; ++i) {
+          Declaration* d = Cast<Declaration>(b->at(i));
+          if (!d || !declaration_is_static(d)) {
+            is_static = false;
+            break;
+          }
+        }
+      }
+      r->is_static(is_static);
+    }
+    return r->is_static();
+  }
+
+  // lazy frame verdict for a block: only direct assignments and
+  // spliced imports can create entries in the block's own frame,
+  // and the control statements keep it because their shadow
+  // scopes peek exactly one frame past themselves on assignment.
+  // everything else (rules, declarations, plain directives) only
+  // reads, so the block can borrow the enclosing scope. unknown
+  // statement kinds conservatively keep the frame too
+  static bool block_declares_variables(Block* b)
+  {
+    if (!b->frame_scanned()) {
+      b->frame_scanned(true);
+      bool declares = false;
+      for (size_t i = 0, L = b->length(); i < L; ++i) {
+        switch (b->at(i)->statement_type()) {
+          case Statement::RULESET:
+          case Statement::MEDIA:
+          case Statement::DIRECTIVE:
+          case Statement::SUPPORTS:
+          case Statement::ATROOT:
+          case Statement::KEYFRAMERULE:
+          case Statement::DECLARATION:
+          case Statement::COMMENT:
+          case Statement::WARNING:
+          case Statement::ERROR:
+          case Statement::DEBUGSTMT:
+          case Statement::EXTEND:
+            break;
+          default:
+            declares = true;
+            break;
+        }
+        if (declares) break;
+      }
+      b->declares_variables(declares);
+    }
+    return b->declares_variables();
+  }
+
   Statement* Expand::operator()(Declaration* d)
   {
     Block_Obj ab = d->block();
     String_Obj old_p = d->property();
+    if (declaration_is_static(d)) {
+      Expression_Obj value = d->value();
+      if (value->is_invisible() && !d->is_important()) {
+        if (d->is_custom_property()) {
+          error("Custom property values may not be empty.", d->value()->pstate(), traces);
+        } else {
+          return nullptr;
+        }
+      }
+      Declaration* decl = SASS_MEMORY_NEW(Declaration,
+                                          d->pstate(),
+                                          old_p,
+                                          value,
+                                          d->is_important(),
+                                          d->is_custom_property());
+      decl->tabs(d->tabs());
+      return decl;
+    }
     Expression_Obj prop = old_p->perform(&eval);
     String_Obj new_p = Cast<String>(prop);
     // we might get a color back
@@ -355,6 +526,12 @@ namespace Sass {
 
   Statement* Expand::operator()(Assignment* a)
   {
+    // a shaken variable is never read, so its value (and whatever
+    // evaluating it would have cost) is never needed
+    if (!ctx.shaken_names.empty() &&
+        ctx.shaken_names.count(a->variable())) {
+      return 0;
+    }
     Env* env = environment();
     const std::string& var(a->variable());
     if (a->is_global()) {
@@ -437,8 +614,17 @@ namespace Sass {
     if (Cast<Block>(parent) == NULL) {
       error("Import directives may not be used within control directives or mixins.", i->pstate(), traces);
     }
+    // in import-once mode a target contributes its output on the
+    // first inclusion only, so diamond import graphs neither pay
+    // the repeated expansion nor duplicate the emitted rules
+    if (ctx.c_options.import_once) {
+      if (!ctx.expanded_imports.insert(i->resource().abs_path).second) {
+        traces.pop_back();
+        return 0;
+      }
+    }
     // we don't seem to need that actually afterall
-    Sass_Import_Entry import = sass_make_import(
+    Sass_Import_Entry import = ctx.acquire_import(
       i->imp_path().c_str(),
       i->abs_path().c_str(),
       0, 0
@@ -451,8 +637,14 @@ namespace Sass {
     block_stack.push_back(trace_block);
 
     const std::string& abs_path(i->resource().abs_path);
+    // when the root came out of the parse cache the parser never
+    // ran, so nested imports were not registered with this context
+    // yet; load them on first use (usually another cache hit)
+    if (ctx.sheets.count(abs_path) == 0) {
+      ctx.load_import(i->resource(), i->pstate());
+    }
     append_block(ctx.sheets.at(abs_path).root);
-    sass_delete_import(ctx.import_stack.back());
+    ctx.release_import(ctx.import_stack.back());
     ctx.import_stack.pop_back();
     block_stack.pop_back();
     traces.pop_back();
@@ -543,12 +735,22 @@ namespace Sass {
     env_stack.push_back(&env);
     call_stack.push_back(f);
     Block* body = f->block();
+    // induction variable node, rewritten in place between
+    // iterations while nothing outside the loop machinery
+    // references it (a body storing $i into the output tree
+    // or a variable bumps the count and gets a fresh node)
+    Number_Obj it;
     if (start < end) {
       if (f->is_inclusive()) ++end;
       for (double i = start;
            i < end;
            ++i) {
-        Number_Obj it = SASS_MEMORY_NEW(Number, low->pstate(), i, sass_end->unit());
+        if (it && it->getRefCount() == 2 &&
+            env.get_local(variable).ptr() == it.ptr()) {
+          it->value(i);
+        } else {
+          it = SASS_MEMORY_NEW(Number, low->pstate(), i, sass_end->unit());
+        }
         env.set_local(variable, it);
         append_block(body);
       }
@@ -557,7 +759,12 @@ namespace Sass {
       for (double i = start;
            i > end;
            --i) {
-        Number_Obj it = SASS_MEMORY_NEW(Number, low->pstate(), i, sass_end->unit());
+        if (it && it->getRefCount() == 2 &&
+            env.get_local(variable).ptr() == it.ptr()) {
+          it->value(i);
+        } else {
+          it = SASS_MEMORY_NEW(Number, low->pstate(), i, sass_end->unit());
+        }
         env.set_local(variable, it);
         append_block(body);
       }
@@ -596,14 +803,29 @@ namespace Sass {
     Block* body = e->block();
 
     if (map) {
-      for (auto key : map->keys()) {
-        Expression_Obj k = key->perform(&eval);
-        Expression_Obj v = map->at(key)->perform(&eval);
+      // pair node for the single-variable form, reused across
+      // iterations while the body leaves it alone (see below)
+      List_Obj variable;
+      const std::vector<Expression_Obj>& values(map->values());
+      const std::vector<Expression_Obj>& keys(map->keys());
+      for (size_t i = 0, L = keys.size(); i < L; ++i) {
+        Expression_Obj k = keys[i]->perform(&eval);
+        Expression_Obj v = values[i]->perform(&eval);
 
         if (variables.size() == 1) {
-          List_Obj variable = SASS_MEMORY_NEW(List, map->pstate(), 2, SASS_SPACE);
-          variable->append(k);
-          variable->append(v);
+          // only our handle and the loop variable slot reference
+          // the pair from the previous iteration, so nothing the
+          // body could still observe holds it and the node can be
+          // refilled instead of allocating one list per map entry
+          if (variable && variable->getRefCount() == 2 &&
+              env.get_local(variables[0]).ptr() == variable.ptr()) {
+            variable->replace(0, k);
+            variable->replace(1, v);
+          } else {
+            variable = SASS_MEMORY_NEW(List, map->pstate(), 2, SASS_SPACE);
+            variable->append(k);
+            variable->append(v);
+          }
           env.set_local(variables[0], variable);
         } else {
           env.set_local(variables[0], k);
@@ -630,7 +852,7 @@ namespace Sass {
           } else {
             for (size_t j = 0, K = variables.size(); j < K; ++j) {
               Expression_Obj res = j >= scalars->length()
-                ? SASS_MEMORY_NEW(Null, expr->pstate())
+                ? shared_null(expr->pstate())
                 : (*scalars)[j]->perform(&eval);
               env.set_local(variables[j], res);
             }
@@ -639,7 +861,7 @@ namespace Sass {
           if (variables.size() > 0) {
             env.set_local(variables.at(0), item);
             for (size_t j = 1, K = variables.size(); j < K; ++j) {
-              Expression_Obj res = SASS_MEMORY_NEW(Null, expr->pstate());
+              Expression_Obj res = shared_null(expr->pstate());
               env.set_local(variables[j], res);
             }
           }
@@ -688,7 +910,7 @@ namespace Sass {
 
     if (e->selector()) {
 
-      for (auto complex : e->selector()->elements()) {
+      for (const auto& complex : e->selector()->elements()) {
 
         if (complex->length() != 1) {
           error("complex selectors may not be extended.", complex->pstate(), traces);
@@ -701,7 +923,7 @@ namespace Sass {
             std::stringstream sels; bool addComma = false;
             sels << "Compound selectors may no longer be extended.\n";
             sels << "Consider `@extend ";
-            for (auto sel : compound->elements()) {
+            for (const auto& sel : compound->elements()) {
               if (addComma) sels << ", ";
               sels << sel->to_sass();
               addComma = true;
@@ -712,7 +934,7 @@ namespace Sass {
             warning(sels.str(), compound->pstate());
 
             // Make this an error once deprecation is over
-            for (SimpleSelectorObj simple : compound->elements()) {
+            for (const SimpleSelectorObj& simple : compound->elements()) {
               // Pass every selector we ever see to extender (to make them findable for extend)
               ctx.extender.addExtension(selector(), simple, mediaStack.back(), e->isOptional());
             }
@@ -736,10 +958,19 @@ namespace Sass {
 
   Statement* Expand::operator()(Definition* d)
   {
+    // a shaken definition is never named, so neither the copy nor
+    // the registration (nor the dispatch distrust) is needed
+    if (!ctx.shaken_names.empty() &&
+        ctx.shaken_names.count(d->name() +
+          (d->type() == Definition::MIXIN ? "[m]" : "[f]"))) {
+      return 0;
+    }
     Env* env = environment();
     Definition_Obj dd = SASS_MEMORY_COPY(d);
     env->local_frame()[d->name() +
                         (d->type() == Definition::MIXIN ? "[m]" : "[f]")] = dd;
+    // resolutions may change now; distrust the dispatch cache
+    if (d->type() != Definition::MIXIN) ++ ctx.fn_env_generation;
 
     if (d->type() == Definition::FUNCTION && (
       Prelexer::calc_fn_call(d->name().c_str()) ||
@@ -759,6 +990,30 @@ namespace Sass {
     return 0;
   }
 
+  // Closure analysis for mixin bodies: the per-include frame is
+  // only needed when the body (or a content block handed further
+  // down) can create bindings in it. Assignments, nested
+  // definitions and imports all write into the innermost frame;
+  // everything else only reads the environment chain.
+  static bool mixin_body_needs_frame(Block* body)
+  {
+    if (body == nullptr) return false;
+    for (const Statement_Obj& stm : body->elements()) {
+      if (Cast<Assignment>(stm)) return true;
+      if (Cast<Definition>(stm)) return true;
+      if (Cast<Import>(stm)) return true;
+      if (Cast<Import_Stub>(stm)) return true;
+      if (If* i = Cast<If>(stm)) {
+        if (mixin_body_needs_frame(i->block())) return true;
+        if (mixin_body_needs_frame(i->alternative())) return true;
+      }
+      else if (Has_Block* hb = Cast<Has_Block>(stm)) {
+        if (mixin_body_needs_frame(hb->block())) return true;
+      }
+    }
+    return false;
+  }
+
   Statement* Expand::operator()(Mixin_Call* c)
   {
 
@@ -768,6 +1023,8 @@ namespace Sass {
 
     recursions ++;
 
+    Tracing::emit("mixin", c->name().c_str());
+
     Env* env = environment();
     std::string full_name(c->name() + "[m]");
     if (!env->has(full_name)) {
@@ -780,10 +1037,28 @@ namespace Sass {
     if (c->block() && c->name() != "@content" && !body->has_content()) {
       error("Mixin \"" + c->name() + "\" does not accept a content block.", c->pstate(), traces);
     }
-    Expression_Obj rv = c->arguments()->perform(&eval);
-    Arguments_Obj args = Cast<Arguments>(rv);
-    std::string msg(", in mixin `" + c->name() + "`");
-    traces.push_back(Backtrace(c->pstate(), msg));
+
+    // a parameter-less include of a non-capturing mixin has nothing
+    // to put into a frame of its own and can run directly against
+    // the shared definition environment. content thunks are rebuilt
+    // per include, so caching the analysis only pays for real mixins
+    bool can_share = c->name() != "@content" && !c->block() &&
+                     params->length() == 0 &&
+                     c->arguments()->length() == 0 &&
+                     def->environment() != nullptr;
+    if (can_share && !def->frame_scanned()) {
+      def->needs_frame(mixin_body_needs_frame(body));
+      def->frame_scanned(true);
+    }
+    bool shared_frame = can_share && !def->needs_frame();
+
+    Expression_Obj rv;
+    Arguments_Obj args;
+    if (!shared_frame) {
+      rv = c->arguments()->perform(&eval);
+      args = Cast<Arguments>(rv);
+    }
+    traces.emplace_back(c->pstate(), "mixin", c->name());
     ctx.callee_stack.push_back({
       c->name().c_str(),
       c->pstate().path,
@@ -794,22 +1069,37 @@ namespace Sass {
     });
 
     Env new_env(def->environment());
-    env_stack.push_back(&new_env);
-    if (c->block()) {
-      Parameters_Obj params = c->block_parameters();
-      if (!params) params = SASS_MEMORY_NEW(Parameters, c->pstate());
-      // represent mixin content blocks as thunks/closures
-      Definition_Obj thunk = SASS_MEMORY_NEW(Definition,
-                                          c->pstate(),
-                                          "@content",
-                                          params,
-                                          c->block(),
-                                          Definition::MIXIN);
-      thunk->environment(env);
-      new_env.local_frame()["@content[m]"] = thunk;
-    }
-
-    bind(std::string("Mixin"), c->name(), params, args, &new_env, &eval, traces);
+    if (shared_frame) {
+      env_stack.push_back(def->environment());
+    }
+    else {
+      env_stack.push_back(&new_env);
+      if (c->block()) {
+        // represent mixin content blocks as thunks/closures over
+        // the original block (never cloned); the thunk node itself
+        // is cached on the call and reused with the environment
+        // rebound, unless an include of this call is still running
+        Definition_Obj thunk = c->content_thunk();
+        if (thunk && thunk->getRefCount() == 1) {
+          thunk->environment(env);
+        }
+        else {
+          Parameters_Obj cparams = c->block_parameters();
+          if (!cparams) cparams = SASS_MEMORY_NEW(Parameters, c->pstate());
+          thunk = SASS_MEMORY_NEW(Definition,
+                                  c->pstate(),
+                                  "@content",
+                                  cparams,
+                                  c->block(),
+                                  Definition::MIXIN);
+          thunk->environment(env);
+          c->content_thunk(thunk);
+        }
+        new_env.local_frame()["@content[m]"] = thunk;
+      }
+
+      bind(std::string("Mixin"), c->name(), params, args, &new_env, &eval, traces);
+    }
 
     Block_Obj trace_block = SASS_MEMORY_NEW(Block, c->pstate());
     Trace_Obj trace = SASS_MEMORY_NEW(Trace, c->pstate(), c->name(), trace_block);
@@ -819,7 +1109,7 @@ namespace Sass {
       trace_block->is_root(pr->is_root());
     }
     block_stack.push_back(trace_block);
-    for (auto bb : body->elements()) {
+    for (const auto& bb : body->elements()) {
       if (Ruleset* r = Cast<Ruleset>(bb)) {
         r->is_root(trace_block->is_root());
       }
@@ -859,6 +1149,10 @@ namespace Sass {
   {
     if (b->is_root()) call_stack.push_back(b);
     for (size_t i = 0, L = b->length(); i < L; ++i) {
+      // honor the compile budget between statements; loops and
+      // mixin bodies re-enter here, so huge generated expansions
+      // keep polling even when the authored block is small
+      ctx.poll_compile_budget();
       Statement* stm = b->at(i);
       Statement_Obj ith = stm->perform(this);
       if (ith) block_stack.back()->append(ith);
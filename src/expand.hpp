@@ -49,12 +49,15 @@ namespace Sass {
   public:
     SelectorStack originalStack;
     MediaStack    mediaStack;
+    // sequence numbers paired with mediaStack entries; they key
+    // the merged media query cache on the context (see there)
+    std::vector<size_t> mediaSeqStack;
 
     Boolean_Obj bool_true;
 
   private:
 
-    std::vector<CssMediaQuery_Obj> mergeMediaQueries(const std::vector<CssMediaQuery_Obj>& lhs, const std::vector<CssMediaQuery_Obj>& rhs);
+    PoolVector<CssMediaQuery_Obj> mergeMediaQueries(const PoolVector<CssMediaQuery_Obj>& lhs, const PoolVector<CssMediaQuery_Obj>& rhs);
 
   public:
     Expand(Context&, Env*, SelectorStack* stack = nullptr, SelectorStack* original = nullptr);
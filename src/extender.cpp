@@ -4,11 +4,59 @@
 #include "ast.hpp"
 
 #include "extender.hpp"
+#include "tracing.hpp"
 #include "permutate.hpp"
 #include "dart_helpers.hpp"
 
 namespace Sass {
 
+  // ##########################################################################
+  // Hash and equality for the weave memo key (object identity only).
+  // ##########################################################################
+  size_t ExtWeaveKeyHash::operator() (const ExtWeaveKey& key) const
+  {
+    size_t hash = key.size();
+    for (const SelectorComponentObj& obj : key) {
+      // combine as in boost (functional/hash)
+      hash ^= PtrHashFn(obj.ptr()) + 0x9e3779b9
+        + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+  }
+
+  bool ExtWeaveKeyEquality::operator() (const ExtWeaveKey& lhs, const ExtWeaveKey& rhs) const
+  {
+    if (lhs.size() != rhs.size()) return false;
+    for (size_t i = 0; i < lhs.size(); i += 1) {
+      if (lhs[i].ptr() != rhs[i].ptr()) return false;
+    }
+    return true;
+  }
+
+  // ##########################################################################
+  // Hash and equality for the unify memo key (object identity only).
+  // ##########################################################################
+  size_t ExtUnifyKeyHash::operator() (const ExtUnifyKey& key) const
+  {
+    size_t hash = key.size();
+    for (const auto& entry : key) {
+      // combine as in boost (functional/hash)
+      hash ^= (PtrHashFn(entry.first.ptr()) + entry.second)
+        + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+  }
+
+  bool ExtUnifyKeyEquality::operator() (const ExtUnifyKey& lhs, const ExtUnifyKey& rhs) const
+  {
+    if (lhs.size() != rhs.size()) return false;
+    for (size_t i = 0; i < lhs.size(); i += 1) {
+      if (lhs[i].first.ptr() != rhs[i].first.ptr()) return false;
+      if (lhs[i].second != rhs[i].second) return false;
+    }
+    return true;
+  }
+
   // ##########################################################################
   // Constructor without default [mode].
   // [traces] are needed to throw errors.
@@ -18,6 +66,7 @@ namespace Sass {
     traces(traces),
     selectors(),
     extensions(),
+    extensionBloom(0),
     extensionsByExtender(),
     mediaContexts(),
     sourceSpecificity(),
@@ -33,6 +82,7 @@ namespace Sass {
     traces(traces),
     selectors(),
     extensions(),
+    extensionBloom(0),
     extensionsByExtender(),
     mediaContexts(),
     sourceSpecificity(),
@@ -80,12 +130,12 @@ namespace Sass {
   {
     ExtSelExtMapEntry extenders;
 
-    for (auto complex : source->elements()) {
+    for (const auto& complex : source->elements()) {
       // Extension.oneOff(complex as ComplexSelector)
       extenders.insert(complex, Extension(complex));
     }
 
-    for (auto complex : targets->elements()) {
+    for (const auto& complex : targets->elements()) {
 
       // This seems superfluous, check is done before!?
       // if (complex->length() != 1) {
@@ -95,15 +145,18 @@ namespace Sass {
       if (const CompoundSelector* compound = complex->first()->getCompound()) {
 
         ExtSelExtMap extensions;
+        uint64_t bloom = 0;
 
         for (const SimpleSelectorObj& simple : compound->elements()) {
           extensions.insert(std::make_pair(simple, extenders));
+          bloom |= extensionBloomBit(simple);
         }
 
         Extender extender(mode, traces);
+        extender.extensionBloom = bloom;
 
         if (!selector->is_invisible()) {
-          for (auto sel : selector->elements()) {
+          for (const auto& sel : selector->elements()) {
             extender.originals.insert(sel);
           }
         }
@@ -177,7 +230,7 @@ namespace Sass {
     // SelectorListObj original = selector;
 
     if (!selector->isInvisible()) {
-      for (auto complex : selector->elements()) {
+      for (const auto& complex : selector->elements()) {
         originals.insert(complex);
       }
     }
@@ -208,8 +261,8 @@ namespace Sass {
     const SelectorListObj& rule)
   {
     if (list.isNull() || list->empty()) return;
-    for (auto complex : list->elements()) {
-      for (auto component : complex->elements()) {
+    for (const auto& complex : list->elements()) {
+      for (const auto& component : complex->elements()) {
         if (auto compound = component->getCompound()) {
           for (SimpleSelector* simple : compound->elements()) {
             selectors[simple].insert(rule);
@@ -297,6 +350,11 @@ namespace Sass {
     bool is_optional)
   {
 
+    // to_string is only paid for when someone is listening
+    if (Tracing::enabled()) {
+      Tracing::emit("extend", target->to_string().c_str());
+    }
+
     auto rules = selectors.find(target);
     bool hasRule = rules != selectors.end();
 
@@ -305,6 +363,7 @@ namespace Sass {
     // ToDo: we check this here first and fetch the same? item again after the loop!?
     bool hasExistingExtensions = extensionsByExtender.find(target) != extensionsByExtender.end();
 
+    extensionBloom |= extensionBloomBit(target);
     ExtSelExtMapEntry& sources = extensions[target];
 
     for (auto& complex : extender->elements()) {
@@ -429,8 +488,9 @@ namespace Sass {
     // that points back to the `sources` vector from `extensions`.
     for (size_t i = 0, iL = oldExtensions.size(); i < iL; i += 1) {
       const Extension& extension = oldExtensions[i];
+      extensionBloom |= extensionBloomBit(extension.target);
       ExtSelExtMapEntry& sources = extensions[extension.target];
-      std::vector<ComplexSelectorObj> selectors(extendComplex(
+      PoolVector<ComplexSelectorObj> selectors(extendComplex(
         extension.extender,
         newExtensions,
         extension.mediaContext
@@ -504,10 +564,10 @@ namespace Sass {
 
     // This could be written more simply using [List.map], but we want to
     // avoid any allocations in the common case where no extends apply.
-    std::vector<ComplexSelectorObj> extended;
+    PoolVector<ComplexSelectorObj> extended;
     for (size_t i = 0; i < list->length(); i++) {
       const ComplexSelectorObj& complex = list->get(i);
-      std::vector<ComplexSelectorObj> result =
+      PoolVector<ComplexSelectorObj> result =
         extendComplex(complex, extensions, mediaQueryContext);
       if (result.empty()) {
         if (!extended.empty()) {
@@ -520,7 +580,7 @@ namespace Sass {
             extended.push_back(list->get(n));
           }
         }
-        for (auto sel : result) {
+        for (const auto& sel : result) {
           extended.push_back(sel);
         }
       }
@@ -537,11 +597,48 @@ namespace Sass {
   }
   // EO extendList
 
+  // ##########################################################################
+  // The [extensionBloom] bit for [simple]; derived from the same
+  // hash the extension maps use, which selectors memoize anyway.
+  // ##########################################################################
+  uint64_t Extender::extensionBloomBit(const SimpleSelectorObj& simple)
+  {
+    return uint64_t(1) << (ObjHashFn(simple) & 63);
+  }
+  // EO extensionBloomBit
+
+  // ##########################################################################
+  // Returns whether any simple selector in [complex] is a key in
+  // [extensions]. Pseudo selectors with an inner selector count as
+  // candidates since extensions may apply inside them. This lets
+  // extendComplex prune unaffected selectors with a single pass of
+  // hash probes instead of running the full option machinery. The
+  // bloom signature turns the common miss into a single bit test.
+  // ##########################################################################
+  bool Extender::mayHaveExtensions(
+    const ComplexSelectorObj& complex,
+    const ExtSelExtMap& extensions) const
+  {
+    for (const SelectorComponentObj& component : complex->elements()) {
+      if (const CompoundSelector* compound = Cast<CompoundSelector>(component)) {
+        for (const SimpleSelectorObj& simple : compound->elements()) {
+          if ((extensionBloom & extensionBloomBit(simple)) &&
+              extensions.find(simple) != extensions.end()) return true;
+          if (const Pseudo_Selector* pseudo = Cast<Pseudo_Selector>(simple)) {
+            if (pseudo->selector()) return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+  // EO mayHaveExtensions
+
   // ##########################################################################
   // Extends [complex] using [extensions], and
   // returns the contents of a [SelectorList].
   // ##########################################################################
-  std::vector<ComplexSelectorObj> Extender::extendComplex(
+  PoolVector<ComplexSelectorObj> Extender::extendComplex(
     // Taking in a reference here makes MSVC debug stuck!?
     const ComplexSelectorObj& complex,
     const ExtSelExtMap& extensions,
@@ -566,13 +663,18 @@ namespace Sass {
     // This could be written more simply using [List.map], but we want to avoid
     // any allocations in the common case where no extends apply.
 
-    std::vector<ComplexSelectorObj> result;
-    std::vector<std::vector<ComplexSelectorObj>> extendedNotExpanded;
+    // Bail out early unless one of the simple selectors can
+    // actually be extended; this skips the per-compound option
+    // collection (and any weaving) for unaffected selectors.
+    if (!mayHaveExtensions(complex, extensions)) return {};
+
+    PoolVector<ComplexSelectorObj> result;
+    std::vector<PoolVector<ComplexSelectorObj>> extendedNotExpanded;
     bool isOriginal = originals.find(complex) != originals.end();
     for (size_t i = 0; i < complex->length(); i += 1) {
       const SelectorComponentObj& component = complex->get(i);
       if (CompoundSelector* compound = Cast<CompoundSelector>(component)) {
-        std::vector<ComplexSelectorObj> extended = extendCompound(
+        PoolVector<ComplexSelectorObj> extended = extendCompound(
           compound, extensions, mediaQueryContext, isOriginal);
         if (extended.empty()) {
           if (!extendedNotExpanded.empty()) {
@@ -611,19 +713,33 @@ namespace Sass {
     bool first = true;
 
     // ToDo: either change weave or paths to work with the same data?
-    std::vector<std::vector<ComplexSelectorObj>>
-      paths = permutate(extendedNotExpanded);
-    
-    for (const std::vector<ComplexSelectorObj>& path : paths) {
+    // Stream the cross-product row by row; pathological extend chains
+    // can make the full path set huge, so each row is woven and
+    // consumed before the next one is generated.
+    permutateEach(extendedNotExpanded,
+      [&](const PoolVector<ComplexSelectorObj>& path) {
       // Unpack the inner complex selector to component list
-      std::vector<std::vector<SelectorComponentObj>> _paths;
+      std::vector<PoolVector<SelectorComponentObj>> _paths;
       for (const ComplexSelectorObj& sel : path) {
         _paths.insert(_paths.end(), sel->elements());
       }
 
-      std::vector<std::vector<SelectorComponentObj>> weaved = weave(_paths);
+      // Consult the memo table first; the same parent sequences come
+      // back for every rule the extended selector appears in, and the
+      // components are shared and not mutated while we run.
+      ExtWeaveKey key;
+      for (const PoolVector<SelectorComponentObj>& components : _paths) {
+        key.insert(key.end(), components.begin(), components.end());
+        key.emplace_back(); // row boundary
+      }
+
+      auto cached = weaveCache.find(key);
+      if (cached == weaveCache.end()) {
+        cached = weaveCache.emplace(std::move(key), weave(_paths)).first;
+      }
+      const std::vector<PoolVector<SelectorComponentObj>>& weaved = cached->second;
 
-      for (std::vector<SelectorComponentObj>& components : weaved) {
+      for (const PoolVector<SelectorComponentObj>& components : weaved) {
 
         ComplexSelectorObj cplx = SASS_MEMORY_NEW(ComplexSelector, "[phony]");
         cplx->hasPreLineFeed(complex->hasPreLineFeed());
@@ -646,7 +762,11 @@ namespace Sass {
 
       }
 
-    }
+      // stop fanning out paths once the weave budget is spent;
+      // the combinations produced so far stay in the result
+      return !weaveBudgetExhausted();
+
+    });
 
     return result;
   }
@@ -672,7 +792,7 @@ namespace Sass {
   // ##########################################################################
   Extension Extender::extensionForCompound(
     // Taking in a reference here makes MSVC debug stuck!?
-    const std::vector<SimpleSelectorObj>& simples) const
+    const PoolVector<SimpleSelectorObj>& simples) const
   {
     CompoundSelectorObj compound = SASS_MEMORY_NEW(CompoundSelector, ParserState("[ext]"));
     compound->concat(simples);
@@ -689,7 +809,7 @@ namespace Sass {
   // indicates whether this is in an original complex selector,
   // meaning that [compound] should not be trimmed out.
   // ##########################################################################
-  std::vector<ComplexSelectorObj> Extender::extendCompound(
+  PoolVector<ComplexSelectorObj> Extender::extendCompound(
     const CompoundSelectorObj& compound,
     const ExtSelExtMap& extensions,
     const CssMediaRuleObj& mediaQueryContext,
@@ -706,7 +826,7 @@ namespace Sass {
       targetsUsed = &targetsUsed2;
     }
 
-    std::vector<ComplexSelectorObj> result;
+    PoolVector<ComplexSelectorObj> result;
     // The complex selectors produced from each component of [compound].
     std::vector<std::vector<Extension>> options;
 
@@ -721,7 +841,7 @@ namespace Sass {
       else {
         if (options.empty()) {
           if (i != 0) {
-            std::vector<SimpleSelectorObj> in;
+            PoolVector<SimpleSelectorObj> in;
             for (size_t n = 0; n < i; n += 1) {
               in.push_back(compound->get(n));
             }
@@ -785,11 +905,11 @@ namespace Sass {
     //     ]
 
     bool first = mode != ExtendMode::REPLACE;
-    std::vector<ComplexSelectorObj> unifiedPaths;
+    PoolVector<ComplexSelectorObj> unifiedPaths;
     std::vector<std::vector<Extension>> prePaths = permutate(options);
 
     for (size_t i = 0; i < prePaths.size(); i += 1) {
-      std::vector<std::vector<SelectorComponentObj>> complexes;
+      std::vector<PoolVector<SelectorComponentObj>> complexes;
       const std::vector<Extension>& path = prePaths[i];
       if (first) {
         // The first path is always the original selector. We can't just
@@ -807,27 +927,48 @@ namespace Sass {
         complexes.push_back({ mergedSelector });
       }
       else {
-        std::vector<SimpleSelectorObj> originals;
-        std::vector<std::vector<SelectorComponentObj>> toUnify;
-
-        for (auto& state : path) {
-          if (state.isOriginal) {
-            const ComplexSelectorObj& sel = state.extender;
-            if (const CompoundSelector* compound = Cast<CompoundSelector>(sel->last())) {
-              originals.insert(originals.end(), compound->last());
+
+        // The unification below only depends on which extenders make
+        // up this path and which of them are original, so repeated
+        // paths (the same @extend applied in rule after rule) can be
+        // answered from the memo table.
+        ExtUnifyKey key;
+        key.reserve(path.size());
+        for (const Extension& state : path) {
+          key.emplace_back(state.extender, state.isOriginal);
+        }
+
+        auto cached = unifyCache.find(key);
+        if (cached != unifyCache.end()) {
+          complexes = cached->second;
+        }
+        else {
+
+          PoolVector<SimpleSelectorObj> originals;
+          std::vector<PoolVector<SelectorComponentObj>> toUnify;
+
+          for (auto& state : path) {
+            if (state.isOriginal) {
+              const ComplexSelectorObj& sel = state.extender;
+              if (const CompoundSelector* compound = Cast<CompoundSelector>(sel->last())) {
+                originals.insert(originals.end(), compound->last());
+              }
+            }
+            else {
+              toUnify.push_back(state.extender->elements());
             }
           }
-          else {
-            toUnify.push_back(state.extender->elements());
+          if (!originals.empty()) {
+            CompoundSelectorObj merged =
+              SASS_MEMORY_NEW(CompoundSelector, "[phony]");
+            merged->concat(originals);
+            toUnify.insert(toUnify.begin(), { merged });
           }
+          complexes = unifyComplex(toUnify);
+          unifyCache.emplace(std::move(key), complexes);
+
         }
-        if (!originals.empty()) {
-          CompoundSelectorObj merged =
-            SASS_MEMORY_NEW(CompoundSelector, "[phony]");
-          merged->concat(originals);
-          toUnify.insert(toUnify.begin(), { merged });
-        }
-        complexes = unifyComplex(toUnify);
+
         if (complexes.empty()) {
           return {};
         }
@@ -842,7 +983,7 @@ namespace Sass {
         // specificity = math.max(specificity, state.specificity);
       }
 
-      for (std::vector<SelectorComponentObj>& components : complexes) {
+      for (PoolVector<SelectorComponentObj>& components : complexes) {
         auto sel = SASS_MEMORY_NEW(ComplexSelector, "[ext]");
         sel->hasPreLineFeed(lineBreak);
         sel->elements(components);
@@ -923,7 +1064,7 @@ namespace Sass {
   // ##########################################################################
   // Inner loop helper for [extendPseudo] function
   // ##########################################################################
-  std::vector<ComplexSelectorObj> Extender::extendPseudoComplex(
+  PoolVector<ComplexSelectorObj> Extender::extendPseudoComplex(
     const ComplexSelectorObj& complex,
     const Pseudo_Selector_Obj& pseudo,
     const CssMediaRuleObj& mediaQueryContext)
@@ -989,7 +1130,7 @@ namespace Sass {
     // writing. We can keep them if either the original selector had a complex
     // selector, or the result of extending has only complex selectors, because
     // either way we aren't breaking anything that isn't already broken.
-    std::vector<ComplexSelectorObj> complexes = extended->elements();
+    PoolVector<ComplexSelectorObj> complexes = extended->elements();
 
     if (pseudo->normalized() == "not") {
       if (!hasAny(pseudo->selector()->elements(), hasMoreThanOne)) {
@@ -1004,7 +1145,7 @@ namespace Sass {
       }
     }
     
-    std::vector<ComplexSelectorObj> expanded = expand(
+    PoolVector<ComplexSelectorObj> expanded = expand(
       complexes, extendPseudoComplex, pseudo, mediaQueryContext);
 
     // Older browsers support `:not`, but only with a single complex selector.
@@ -1034,7 +1175,7 @@ namespace Sass {
   // one index higher, looping the final element back to [start].
   // ##########################################################################
   void Extender::rotateSlice(
-    std::vector<ComplexSelectorObj>& list,
+    PoolVector<ComplexSelectorObj>& list,
     size_t start, size_t end)
   {
     auto element = list[end - 1];
@@ -1054,8 +1195,8 @@ namespace Sass {
   // Note: for adaption I pass in the set directly, there is some
   // code path in selector-trim that might need this special callback
   // ##########################################################################
-  std::vector<ComplexSelectorObj> Extender::trim(
-    const std::vector<ComplexSelectorObj>& selectors,
+  PoolVector<ComplexSelectorObj> Extender::trim(
+    const PoolVector<ComplexSelectorObj>& selectors,
     const ExtCplxSelSet& existing) const
   {
 
@@ -1066,10 +1207,22 @@ namespace Sass {
     // TODO(mgreter): Check how this perfoms in C++ (up the limit)
     if (selectors.size() > 100) return selectors;
 
+    // Computing a selector's specificity walks all of its components and
+    // the quadratic scan below needs it once per candidate pair. Compute
+    // every input's minimum specificity up front so the pair test is an
+    // integer compare before the expensive superselector check.
+    std::vector<size_t> minSpecs;
+    minSpecs.reserve(selectors.size());
+    for (const ComplexSelectorObj& complex : selectors) {
+      minSpecs.push_back(complex->minSpecificity());
+    }
+
     // This is n² on the sequences, but only comparing between separate sequences
     // should limit the quadratic behavior. We iterate from last to first and reverse
     // the result so that, if two selectors are identical, we keep the first one.
-    std::vector<ComplexSelectorObj> result; size_t numOriginals = 0;
+    PoolVector<ComplexSelectorObj> result; size_t numOriginals = 0;
+    // specificity for each entry in [result], mirroring its order
+    std::vector<size_t> resultSpecs;
 
     size_t i = selectors.size();
   outer: // Use label to continue loop
@@ -1084,10 +1237,14 @@ namespace Sass {
         for (size_t j = 0; j < numOriginals; j++) {
           if (ObjEqualityFn(result[j], complex1)) {
             rotateSlice(result, 0, j + 1);
+            std::rotate(resultSpecs.begin(),
+              resultSpecs.begin() + j,
+              resultSpecs.begin() + j + 1);
             goto outer;
           }
         }
         result.insert(result.begin(), complex1);
+        resultSpecs.insert(resultSpecs.begin(), minSpecs[i]);
         numOriginals++;
         continue;
       }
@@ -1107,19 +1264,31 @@ namespace Sass {
       // Look in [result] rather than [selectors] for selectors after [i]. This
       // ensures we aren't comparing against a selector that's already been trimmed,
       // and thus that if there are two identical selectors only one is trimmed.
-      if (hasAny(result, dontTrimComplex, complex1, maxSpecificity)) {
-        continue;
+      // Only candidates whose precomputed specificity reaches the threshold
+      // can dominate [complex1], so most pairs never hit isSuperselectorOf.
+      bool trimmed = false;
+      for (size_t j = 0, J = result.size(); j < J; j++) {
+        if (resultSpecs[j] < maxSpecificity) continue;
+        if (result[j]->isSuperselectorOf(complex1)) {
+          trimmed = true;
+          break;
+        }
       }
-
-      // Check if any element (up to [i]) from [selector] returns true
-      // when passed to [dontTrimComplex]. The arguments [complex1] and
-      // [maxSepcificity] will be passed to the invoked function.
-      if (hasSubAny(selectors, i, dontTrimComplex, complex1, maxSpecificity)) {
-        continue;
+      if (trimmed) continue;
+
+      // Check any element up to [i] from [selectors] the same way
+      for (size_t j = 0; j < i; j++) {
+        if (minSpecs[j] < maxSpecificity) continue;
+        if (selectors[j]->isSuperselectorOf(complex1)) {
+          trimmed = true;
+          break;
+        }
       }
+      if (trimmed) continue;
 
       // ToDo: Maybe use deque for front insert?
       result.insert(result.begin(), complex1);
+      resultSpecs.insert(resultSpecs.begin(), minSpecs[i]);
 
     }
 
@@ -1145,7 +1314,7 @@ namespace Sass {
   size_t Extender::maxSourceSpecificity(const CompoundSelectorObj& compound) const
   {
     size_t specificity = 0;
-    for (auto simple : compound->elements()) {
+    for (const auto& simple : compound->elements()) {
       size_t src = maxSourceSpecificity(simple);
       specificity = std::max(specificity, src);
     }
@@ -1153,19 +1322,6 @@ namespace Sass {
   }
   // EO maxSourceSpecificity(CompoundSelectorObj)
 
-  // ##########################################################################
-  // Helper function used as callbacks on lists
-  // ##########################################################################
-  bool Extender::dontTrimComplex(
-    const ComplexSelector* complex2,
-    const ComplexSelector* complex1,
-    const size_t maxSpecificity)
-  {
-    if (complex2->minSpecificity() < maxSpecificity) return false;
-    return complex2->isSuperselectorOf(complex1);
-  }
-  // EO dontTrimComplex
-
   // ##########################################################################
   // Helper function used as callbacks on lists
   // ##########################################################################
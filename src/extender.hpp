@@ -4,6 +4,7 @@
 #include <set>
 #include <map>
 #include <string>
+#include <cstdint>
 
 #include "ast_helpers.hpp"
 #include "ast_fwd_decl.hpp"
@@ -67,6 +68,53 @@ namespace Sass {
     ObjEquality
   > ExtByExtMap;
 
+  // ##########################################################################
+  // Memo key for weave results (see Extender::extendComplex). The woven
+  // rows reference shared selector components that are immutable while the
+  // extender runs, so keys compare by object identity; a null entry marks
+  // each row boundary to keep `[[a b], [c]]` distinct from `[[a], [b c]]`.
+  // ##########################################################################
+  typedef PoolVector<SelectorComponentObj> ExtWeaveKey;
+
+  // implemented in extender.cpp (needs the complete component type)
+  struct ExtWeaveKeyHash {
+    size_t operator() (const ExtWeaveKey& key) const;
+  };
+
+  struct ExtWeaveKeyEquality {
+    bool operator() (const ExtWeaveKey& lhs, const ExtWeaveKey& rhs) const;
+  };
+
+  typedef std::unordered_map<
+    ExtWeaveKey,
+    std::vector<PoolVector<SelectorComponentObj>>,
+    ExtWeaveKeyHash,
+    ExtWeaveKeyEquality
+  > ExtWeaveMap;
+
+  // ##########################################################################
+  // Memo key for unification results in [Extender::extendCompound]: the
+  // identities of the extenders along one path plus their original flags
+  // (the flags decide which selectors get merged instead of unified).
+  // ##########################################################################
+  typedef std::vector<std::pair<ComplexSelectorObj, bool>> ExtUnifyKey;
+
+  // implemented in extender.cpp (needs the complete selector type)
+  struct ExtUnifyKeyHash {
+    size_t operator() (const ExtUnifyKey& key) const;
+  };
+
+  struct ExtUnifyKeyEquality {
+    bool operator() (const ExtUnifyKey& lhs, const ExtUnifyKey& rhs) const;
+  };
+
+  typedef std::unordered_map<
+    ExtUnifyKey,
+    std::vector<PoolVector<SelectorComponentObj>>,
+    ExtUnifyKeyHash,
+    ExtUnifyKeyEquality
+  > ExtUnifyMap;
+
   class Extender : public Operation_CRTP<void, Extender> {
 
   public:
@@ -98,6 +146,14 @@ namespace Sass {
     // ##########################################################################
     ExtSelExtMap extensions;
 
+    // ##########################################################################
+    // Bloom signature over the keys of [extensions] (one bit per hashed
+    // simple selector). Most selectors in a sheet are never extended, so
+    // [mayHaveExtensions] tests this word before probing the map; bits
+    // are only ever added, keeping the signature a safe superset.
+    // ##########################################################################
+    uint64_t extensionBloom;
+
     // ##########################################################################
     // A map from all simple selectors in extenders to
     // the extensions that those extenders define.
@@ -138,6 +194,22 @@ namespace Sass {
     // ##########################################################################
     ExtCplxSelSet originals;
 
+    // ##########################################################################
+    // Memoized results of [weave]. A selector that is extended into many
+    // rules re-weaves the same parent sequences once per rule, and each
+    // weave redoes the full combinatorial merge; caching by input identity
+    // turns the repeats into a lookup.
+    // ##########################################################################
+    ExtWeaveMap weaveCache;
+
+    // ##########################################################################
+    // Memoized unification results for [extendCompound]. Extending e.g.
+    // `.btn` inside hundreds of rules unifies the very same extender
+    // paths once per rule; the result only depends on the path, so
+    // repeats become a lookup. Compounds with the weave memo above.
+    // ##########################################################################
+    ExtUnifyMap unifyCache;
+
   public:
 
     // Constructor without default [mode].
@@ -278,11 +350,28 @@ namespace Sass {
       const ExtSelExtMap& extensions,
       const CssMediaRuleObj& mediaContext);
 
+    // ##########################################################################
+    // Returns whether any simple selector in [complex] is a key in
+    // [extensions] (or is a pseudo selector that may hide one), so
+    // callers can prune unaffected selectors with hash probes only.
+    // Consults [extensionBloom] first; unaffected selectors then cost
+    // one bit test per simple selector instead of a map lookup.
+    // ##########################################################################
+    bool mayHaveExtensions(
+      const ComplexSelectorObj& complex,
+      const ExtSelExtMap& extensions) const;
+
+    // ##########################################################################
+    // The [extensionBloom] bit for [simple]; derived from the same
+    // hash the extension maps use, which selectors memoize anyway.
+    // ##########################################################################
+    static uint64_t extensionBloomBit(const SimpleSelectorObj& simple);
+
     // ##########################################################################
     // Extends [complex] using [extensions], and
     // returns the contents of a [SelectorList].
     // ##########################################################################
-    std::vector<ComplexSelectorObj> extendComplex(
+    PoolVector<ComplexSelectorObj> extendComplex(
       // Taking in a reference here makes MSVC debug stuck!?
       const ComplexSelectorObj& list,
       const ExtSelExtMap& extensions,
@@ -301,7 +390,7 @@ namespace Sass {
     // ##########################################################################
     Extension extensionForCompound(
       // Taking in a reference here makes MSVC debug stuck!?
-      const std::vector<SimpleSelectorObj>& simples) const;
+      const PoolVector<SimpleSelectorObj>& simples) const;
 
     // ##########################################################################
     // Extends [compound] using [extensions], and returns the
@@ -309,7 +398,7 @@ namespace Sass {
     // indicates whether this is in an original complex selector,
     // meaning that [compound] should not be trimmed out.
     // ##########################################################################
-    std::vector<ComplexSelectorObj> extendCompound(
+    PoolVector<ComplexSelectorObj> extendCompound(
       const CompoundSelectorObj& compound,
       const ExtSelExtMap& extensions,
       const CssMediaRuleObj& mediaQueryContext,
@@ -337,7 +426,7 @@ namespace Sass {
     // ##########################################################################
     // Inner loop helper for [extendPseudo] function
     // ##########################################################################
-    static std::vector<ComplexSelectorObj> extendPseudoComplex(
+    static PoolVector<ComplexSelectorObj> extendPseudoComplex(
       const ComplexSelectorObj& complex,
       const Pseudo_Selector_Obj& pseudo,
       const CssMediaRuleObj& mediaQueryContext);
@@ -356,7 +445,7 @@ namespace Sass {
     // one index higher, looping the final element back to [start].
     // ##########################################################################
     static void rotateSlice(
-      std::vector<ComplexSelectorObj>& list,
+      PoolVector<ComplexSelectorObj>& list,
       size_t start, size_t end);
 
     // ##########################################################################
@@ -364,8 +453,8 @@ namespace Sass {
     // elements. The [isOriginal] callback indicates which selectors are
     // original to the document, and thus should never be trimmed.
     // ##########################################################################
-    std::vector<ComplexSelectorObj> trim(
-      const std::vector<ComplexSelectorObj>& selectors,
+    PoolVector<ComplexSelectorObj> trim(
+      const PoolVector<ComplexSelectorObj>& selectors,
       const ExtCplxSelSet& set) const;
 
     // ##########################################################################
@@ -378,14 +467,6 @@ namespace Sass {
     // ##########################################################################
     size_t maxSourceSpecificity(const CompoundSelectorObj& compound) const;
 
-    // ##########################################################################
-    // Helper function used as callbacks on lists
-    // ##########################################################################
-    static bool dontTrimComplex(
-      const ComplexSelector* complex2,
-      const ComplexSelector* complex1,
-      const size_t maxSpecificity);
-
     // ##########################################################################
     // Helper function used as callbacks on lists
     // ##########################################################################
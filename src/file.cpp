@@ -16,7 +16,13 @@
 #include <cstdio>
 #include <vector>
 #include <algorithm>
+#include <mutex>
+#include <unordered_map>
 #include <sys/stat.h>
+#ifndef _WIN32
+# include <fcntl.h>
+# include <sys/mman.h>
+#endif
 #include "file.hpp"
 #include "context.hpp"
 #include "prelexer.hpp"
@@ -76,8 +82,26 @@ namespace Sass {
       return cwd;
     }
 
+    // per-compilation existence cache: import resolution probes
+    // every include path with several filename variants (leading
+    // underscore, extensions, index files), so the same paths get
+    // stat'ed over and over — on network filesystems each probe
+    // is a round trip. Context clears the cache when a compilation
+    // starts, so watch-mode rebuilds pick up filesystem changes.
+    // thread local like the parse cache, since contexts may load
+    // files from worker threads.
+    namespace {
+      thread_local std::unordered_map<std::string, bool> stat_cache;
+    }
+
+    void clear_stat_cache()
+    {
+      stat_cache.clear();
+    }
+
     // test if path exists and is a file
-    bool file_exists(const std::string& path)
+    // (uncached; file_exists adds the cache on top)
+    static bool stat_file(const std::string& path)
     {
       #ifdef _WIN32
         wchar_t resolved[32768];
@@ -101,6 +125,16 @@ namespace Sass {
       #endif
     }
 
+    // test if path exists and is a file
+    bool file_exists(const std::string& path)
+    {
+      auto it = stat_cache.find(path);
+      if (it != stat_cache.end()) return it->second;
+      bool exists = stat_file(path);
+      stat_cache.emplace(path, exists);
+      return exists;
+    }
+
     // return if given path is absolute
     // works with *nix and windows paths
     bool is_absolute_path(const std::string& path)
@@ -156,9 +190,26 @@ namespace Sass {
       else return path.substr(pos+1);
     }
 
+    // Path math is pure string work, but the same few paths are
+    // cleaned and rebased over and over — every import resolution,
+    // srcmap link and console message redoes the same splitting
+    // and rejoining. Memoize the three entry points per thread
+    // (like the stat cache, contexts may run on worker threads);
+    // results depend only on the arguments, so entries never go
+    // stale and are just dropped wholesale when a cache outgrows
+    // any reasonable compilation's working set. composite keys
+    // join their parts with NUL, which cannot occur in a path.
+    namespace {
+      thread_local std::unordered_map<std::string, std::string> canonical_cache;
+      thread_local std::unordered_map<std::string, std::string> rel2abs_cache;
+      thread_local std::unordered_map<std::string, std::string> abs2rel_cache;
+      const size_t path_cache_limit = 4096;
+    }
+
     // do a logical clean up of the path
     // no physical check on the filesystem
-    std::string make_canonical_path (std::string path)
+    // (uncached; make_canonical_path adds the cache on top)
+    static std::string clean_path (std::string path)
     {
 
       // declarations
@@ -196,6 +247,18 @@ namespace Sass {
 
     }
 
+    // do a logical clean up of the path
+    // no physical check on the filesystem
+    std::string make_canonical_path (std::string path)
+    {
+      auto it = canonical_cache.find(path);
+      if (it != canonical_cache.end()) return it->second;
+      std::string cleaned(clean_path(path));
+      if (canonical_cache.size() >= path_cache_limit) canonical_cache.clear();
+      canonical_cache.emplace(std::move(path), cleaned);
+      return cleaned;
+    }
+
     // join two path segments cleanly together
     // but only if right side is not absolute yet
     std::string join_paths(std::string l, std::string r)
@@ -247,12 +310,19 @@ namespace Sass {
     // create an absolute path by resolving relative paths with cwd
     std::string rel2abs(const std::string& path, const std::string& base, const std::string& cwd)
     {
-      return make_canonical_path(join_paths(join_paths(cwd + "/", base + "/"), path));
+      std::string key(path); key += '\0'; key += base; key += '\0'; key += cwd;
+      auto it = rel2abs_cache.find(key);
+      if (it != rel2abs_cache.end()) return it->second;
+      std::string abs(make_canonical_path(join_paths(join_paths(cwd + "/", base + "/"), path)));
+      if (rel2abs_cache.size() >= path_cache_limit) rel2abs_cache.clear();
+      rel2abs_cache.emplace(std::move(key), abs);
+      return abs;
     }
 
     // create a path that is relative to the given base directory
     // path and base will first be resolved against cwd to make them absolute
-    std::string abs2rel(const std::string& path, const std::string& base, const std::string& cwd)
+    // (uncached; abs2rel adds the cache on top)
+    static std::string rebase_path(const std::string& path, const std::string& base, const std::string& cwd)
     {
 
       std::string abs_path = rel2abs(path, cwd);
@@ -326,6 +396,19 @@ namespace Sass {
       return result;
     }
 
+    // create a path that is relative to the given base directory
+    // path and base will first be resolved against cwd to make them absolute
+    std::string abs2rel(const std::string& path, const std::string& base, const std::string& cwd)
+    {
+      std::string key(path); key += '\0'; key += base; key += '\0'; key += cwd;
+      auto it = abs2rel_cache.find(key);
+      if (it != abs2rel_cache.end()) return it->second;
+      std::string rel(rebase_path(path, base, cwd));
+      if (abs2rel_cache.size() >= path_cache_limit) abs2rel_cache.clear();
+      abs2rel_cache.emplace(std::move(key), rel);
+      return rel;
+    }
+
     // Resolution order for ambiguous imports:
     // (1) filename as given
     // (2) underscore + given
@@ -429,11 +512,127 @@ namespace Sass {
       return std::string("");
     }
 
+    #ifndef _WIN32
+    // Sources loaded via mmap must be unmapped with their length,
+    // so keep track of them until free_source is called. Guarded
+    // by a mutex since contexts may load files from worker threads.
+    static std::unordered_map<void*, size_t> mmapped_sources;
+    static std::mutex mmapped_mutex;
+    #endif
+
+    // ask the kernel to start paging in a file we expect to read
+    // shortly; returns immediately and is best effort only, so
+    // callers may pass paths that never get read after all
+    void prefetch_file(const std::string& path)
+    {
+      #ifndef _WIN32
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1) return;
+        #ifdef POSIX_FADV_WILLNEED
+          posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        #endif
+        close(fd);
+      #else
+        // no advisory readahead on windows
+        (void) path;
+      #endif
+    }
+
+    // give the resident pages of an mmap-backed source back to the
+    // kernel. The mapping stays valid (read only and file backed),
+    // so a later error excerpt or map embedding just faults the
+    // pages in again; buffers from the copying read path are left
+    // alone since their bytes live nowhere else
+    void drop_source_pages(const char* contents)
+    {
+      if (contents == 0) return;
+      #if !defined(_WIN32) && defined(MADV_DONTNEED)
+        std::lock_guard<std::mutex> lock(mmapped_mutex);
+        auto it = mmapped_sources.find(const_cast<char*>(contents));
+        if (it != mmapped_sources.end()) {
+          madvise(it->first, it->second, MADV_DONTNEED);
+        }
+      #else
+        (void) contents;
+      #endif
+    }
+
+    // process wide registry of shared source buffers (see the
+    // share_sources option): entries are keyed by path, validated
+    // against mtime and size on every acquire, and refcounted
+    // through free_source. every reader holds one reference, so a
+    // buffer lives exactly as long as the longest lived compile
+    // (or parse cache) still pointing into it
+    struct SharedSource {
+      char* contents;
+      size_t refs;
+      time_t mtime;
+      off_t size;
+    };
+    static std::unordered_map<std::string, SharedSource> shared_sources;
+    static std::unordered_map<char*, std::string> shared_by_ptr;
+    static std::mutex shared_mutex;
+
+    // drop one reference on a shared buffer; returns false when
+    // the buffer is not shared and the caller should free it
+    static bool release_shared_source(char* contents)
+    {
+      std::lock_guard<std::mutex> lock(shared_mutex);
+      auto it = shared_by_ptr.find(contents);
+      if (it == shared_by_ptr.end()) return false;
+      auto entry = shared_sources.find(it->second);
+      if (entry != shared_sources.end() && --entry->second.refs == 0) {
+        shared_sources.erase(entry);
+        shared_by_ptr.erase(it);
+        free(contents);
+      }
+      return true;
+    }
+
+    // release a buffer returned by read_file
+    // unmaps mmap-backed sources, frees the rest
+    void free_source(char* contents)
+    {
+      if (contents == 0) return;
+      if (release_shared_source(contents)) return;
+      #ifndef _WIN32
+        std::lock_guard<std::mutex> lock(mmapped_mutex);
+        auto it = mmapped_sources.find(contents);
+        if (it != mmapped_sources.end()) {
+          munmap(it->first, it->second);
+          mmapped_sources.erase(it);
+          return;
+        }
+      #endif
+      free(contents);
+    }
+
+    // helper to auto convert indented syntax sources
+    // takes ownership of the passed contents buffer
+    static char* read_file_suffix(const std::string& path, char* contents)
+    {
+      std::string extension;
+      if (path.length() > 5) {
+        extension = path.substr(path.length() - 5, 5);
+      }
+      Util::ascii_str_tolower(&extension);
+      if (extension == ".sass" && contents != 0) {
+        char * converted = sass2scss(contents, SASS2SCSS_PRETTIFY_1 | SASS2SCSS_KEEP_COMMENT);
+        free_source(contents); // free the indented contents
+        return converted; // should be freed by caller
+      } else {
+        return contents;
+      }
+    }
+
+    static char* read_file_shared(const std::string& path);
+
     // try to load the given filename
     // returned memory must be freed
     // will auto convert .sass files
-    char* read_file(const std::string& path)
+    char* read_file(const std::string& path, bool use_mmap, bool share)
     {
+      if (share) return read_file_shared(path);
       #ifdef _WIN32
         BYTE* pBuffer;
         DWORD dwBytes;
@@ -469,6 +668,27 @@ namespace Sass {
         // https://github.com/sass/sassc-ruby/issues/128
         struct stat st;
         if (stat(path.c_str(), &st) == -1 || S_ISDIR(st.st_mode)) return 0;
+        // map the file straight from the page cache when requested;
+        // the lexer needs two NUL sentinels past the end, which the
+        // kernel's zero-filled partial last page provides whenever
+        // the file size leaves at least two bytes of slack in it
+        if (use_mmap && st.st_size > 0) {
+          const long pagesize = sysconf(_SC_PAGESIZE);
+          if (pagesize > 0 && (st.st_size % pagesize) != 0
+              && pagesize - (st.st_size % pagesize) >= 2) {
+            int fdesc = open(path.c_str(), O_RDONLY);
+            if (fdesc != -1) {
+              void* map = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fdesc, 0);
+              close(fdesc);
+              if (map != MAP_FAILED) {
+                std::lock_guard<std::mutex> lock(mmapped_mutex);
+                mmapped_sources[map] = st.st_size;
+                return read_file_suffix(path, (char*)map);
+              }
+            }
+          }
+          // fall through to the copying read path
+        }
         FILE* fd = std::fopen(path.c_str(), "rb");
         if (fd == nullptr) return nullptr;
         const std::size_t size = st.st_size;
@@ -485,18 +705,62 @@ namespace Sass {
         contents[size] = '\0';
         contents[size + 1] = '\0';
       #endif
-      std::string extension;
-      if (path.length() > 5) {
-        extension = path.substr(path.length() - 5, 5);
+      return read_file_suffix(path, contents);
+    }
+
+    // serve one file to any number of concurrent compiles: hand
+    // out the registered buffer (one more reference) when path,
+    // mtime and size still match, read and publish it otherwise.
+    // a file that changed while old readers still hold the entry
+    // is served privately until the last of them lets go
+    static char* read_file_shared(const std::string& path)
+    {
+      #ifdef _WIN32
+      // freshness validation relies on stat; reads
+      // stay private here (like the mmap path)
+      return read_file(path);
+      #else
+      struct stat st;
+      if (stat(path.c_str(), &st) == -1 || S_ISDIR(st.st_mode)) return 0;
+      {
+        std::lock_guard<std::mutex> lock(shared_mutex);
+        auto it = shared_sources.find(path);
+        if (it != shared_sources.end()) {
+          SharedSource& entry = it->second;
+          if (entry.mtime == st.st_mtime && entry.size == st.st_size) {
+            entry.refs += 1;
+            return entry.contents;
+          }
+          if (entry.refs == 0) {
+            // stale and drained; replace it below
+            shared_by_ptr.erase(entry.contents);
+            free(entry.contents);
+            shared_sources.erase(it);
+          }
+          else {
+            return read_file(path);
+          }
+        }
       }
-      Util::ascii_str_tolower(&extension);
-      if (extension == ".sass" && contents != 0) {
-        char * converted = sass2scss(contents, SASS2SCSS_PRETTIFY_1 | SASS2SCSS_KEEP_COMMENT);
-        free(contents); // free the indented contents
-        return converted; // should be freed by caller
-      } else {
+      // read outside the lock, so racing compiles may read the
+      // same file once each; only one of the copies is published
+      char* contents = read_file(path);
+      if (contents == 0) return 0;
+      std::lock_guard<std::mutex> lock(shared_mutex);
+      auto it = shared_sources.find(path);
+      if (it != shared_sources.end()) {
+        if (it->second.mtime == st.st_mtime && it->second.size == st.st_size) {
+          it->second.refs += 1;
+          free(contents);
+          return it->second.contents;
+        }
+        // changed again under us; keep the private read
         return contents;
       }
+      shared_sources[path] = { contents, 1, st.st_mtime, st.st_size };
+      shared_by_ptr[contents] = path;
+      return contents;
+      #endif
     }
 
     // split a path string delimited by semicolons or colons (OS dependent)
@@ -20,8 +20,13 @@ namespace Sass {
     std::string get_cwd();
 
     // test if path exists and is a file
+    // results are memoized until clear_stat_cache
     bool file_exists(const std::string& file);
 
+    // drop all memoized file_exists results; called when a new
+    // compilation starts so rebuilds see filesystem changes
+    void clear_stat_cache();
+
     // return if given path is absolute
     // works with *nix and windows paths
     bool is_absolute_path(const std::string& path);
@@ -66,7 +71,24 @@ namespace Sass {
     // try to load the given filename
     // returned memory must be freed
     // will auto convert .sass files
-    char* read_file(const std::string& file);
+    // with share set the buffer comes from a process wide
+    // refcounted registry, so concurrent compiles loading the
+    // same file get one read and one copy between them (shared
+    // reads always copy, so share overrides use_mmap); release
+    // through free_source either way
+    char* read_file(const std::string& file, bool use_mmap = false, bool share = false);
+
+    // release a buffer returned by read_file
+    // unmaps mmap-backed sources, frees the rest
+    void free_source(char* contents);
+
+    // advisory readahead for a file we expect to read shortly
+    void prefetch_file(const std::string& path);
+
+    // give the resident pages of an mmap-backed source back to
+    // the kernel; later reads fault them in again transparently.
+    // no-op for buffers that did not come from the mmap path
+    void drop_source_pages(const char* contents);
 
   }
 
@@ -106,9 +128,12 @@ namespace Sass {
       char* contents;
       // connected sourcemap
       char* srcmap;
+      // tagged once at registration: the content holds only ascii
+      // bytes, so it is valid utf8 and bytes equal code points
+      bool ascii;
     public:
-      Resource(char* contents, char* srcmap)
-      : contents(contents), srcmap(srcmap)
+      Resource(char* contents, char* srcmap, bool ascii = false)
+      : contents(contents), srcmap(srcmap), ascii(ascii)
       { }
   };
 
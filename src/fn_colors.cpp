@@ -2,7 +2,8 @@
 // __EXTENSIONS__ fix on Solaris.
 #include "sass.hpp"
 
-#include <iomanip>
+#include <cmath>
+#include <cstdio>
 #include "ast.hpp"
 #include "fn_utils.hpp"
 #include "fn_colors.hpp"
@@ -104,14 +105,13 @@ namespace Sass {
       if (
         string_argument(env["$alpha"])
       ) {
-        std::stringstream strm;
-        strm << "rgba("
-                 << (int)c_arg->r() << ", "
-                 << (int)c_arg->g() << ", "
-                 << (int)c_arg->b() << ", "
-                 << env["$alpha"]->to_string()
-             << ")";
-        return SASS_MEMORY_NEW(String_Constant, pstate, strm.str());
+        std::string res("rgba(");
+        res += std::to_string((int)c_arg->r()); res += ", ";
+        res += std::to_string((int)c_arg->g()); res += ", ";
+        res += std::to_string((int)c_arg->b()); res += ", ";
+        res += env["$alpha"]->to_string();
+        res += ")";
+        return SASS_MEMORY_NEW(String_Constant, pstate, res);
       }
 
       Color_RGBA_Obj new_c = SASS_MEMORY_COPY(c_arg);
@@ -579,16 +579,47 @@ namespace Sass {
       double b = clip(c->b(), 0.0, 255.0);
       double a = clip(c->a(), 0.0, 1.0) * 255.0;
 
-      std::stringstream ss;
-      ss << '#' << std::setw(2) << std::setfill('0');
-      ss << std::hex << std::setw(2) << static_cast<unsigned long>(Sass::round(a, ctx.c_options.precision));
-      ss << std::hex << std::setw(2) << static_cast<unsigned long>(Sass::round(r, ctx.c_options.precision));
-      ss << std::hex << std::setw(2) << static_cast<unsigned long>(Sass::round(g, ctx.c_options.precision));
-      ss << std::hex << std::setw(2) << static_cast<unsigned long>(Sass::round(b, ctx.c_options.precision));
+      char buf[16];
+      snprintf(buf, sizeof(buf), "#%02lX%02lX%02lX%02lX",
+        static_cast<unsigned long>(Sass::round(a, ctx.c_options.precision)),
+        static_cast<unsigned long>(Sass::round(r, ctx.c_options.precision)),
+        static_cast<unsigned long>(Sass::round(g, ctx.c_options.precision)),
+        static_cast<unsigned long>(Sass::round(b, ctx.c_options.precision)));
+      return SASS_MEMORY_NEW(String_Quoted, pstate, std::string(buf));
+    }
 
-      std::string result = ss.str();
-      Util::ascii_str_toupper(&result);
-      return SASS_MEMORY_NEW(String_Quoted, pstate, result);
+    Signature color_scale_sig = "color-scale($color, $steps, $lightness: 0%, $saturation: 0%, $hue: 0deg)";
+    BUILT_IN(color_scale)
+    {
+      // derives a whole palette ramp in one call: the first step is
+      // the input color, the last applies the full shifts, the rest
+      // interpolate linearly. One conversion to hsl and one tight
+      // loop over plain doubles replaces n invocations through Eval.
+      Color* col = ARG("$color", Color);
+      Number_Obj num = get_arg_n("$steps", env, sig, pstate, traces);
+      double steps = num->value();
+      if (steps < 1 || steps != std::floor(steps)) {
+        error("argument `$steps` of `" + std::string(sig) + "` must be a positive integer", pstate, traces);
+      }
+      double dl = ARGVAL("$lightness");
+      double ds = ARGVAL("$saturation");
+      double dh = ARGVAL("$hue");
+
+      Color_HSLA_Obj base = col->toHSLA();
+      double h = base->h(), s = base->s(),
+             l = base->l(), a = base->a();
+
+      size_t len = (size_t) steps;
+      List* result = SASS_MEMORY_NEW(List, pstate, len, SASS_COMMA);
+      for (size_t i = 0; i < len; i++) {
+        double t = len > 1 ? (double) i / (double) (len - 1) : 0.0;
+        result->append(SASS_MEMORY_NEW(Color_HSLA, pstate,
+          absmod(h + dh * t, 360.0),
+          clip(s + ds * t, 0.0, 100.0),
+          clip(l + dl * t, 0.0, 100.0),
+          a));
+      }
+      return result;
     }
 
   }
@@ -49,6 +49,7 @@ namespace Sass {
     extern Signature scale_color_sig;
     extern Signature change_color_sig;
     extern Signature ie_hex_str_sig;
+    extern Signature color_scale_sig;
 
     BUILT_IN(rgb);
     BUILT_IN(rgba_4);
@@ -77,6 +78,7 @@ namespace Sass {
     BUILT_IN(scale_color);
     BUILT_IN(change_color);
     BUILT_IN(ie_hex_str);
+    BUILT_IN(color_scale);
 
   }
 
@@ -15,6 +15,19 @@ namespace Sass {
     // LIST FUNCTIONS
     /////////////////
 
+    // A list argument nobody else can observe is held by exactly
+    // three references: the evaluated argument node, the parameter
+    // slot in the function env and the local handle in the builtin.
+    // Anything still reachable by the caller (a variable binding, a
+    // slot in an outer list or map) keeps at least one more. Such
+    // unshared lists may be mutated in place instead of copied
+    // wholesale, which turns the common build-a-list-by-append loop
+    // from quadratic into amortized linear time.
+    static bool list_is_unshared(const List_Obj& l)
+    {
+      return l->getRefCount() <= 3;
+    }
+
     Signature keywords_sig = "keywords($args)";
     BUILT_IN(keywords)
     {
@@ -36,20 +49,20 @@ namespace Sass {
     BUILT_IN(length)
     {
       if (SelectorList * sl = Cast<SelectorList>(env["$list"])) {
-        return SASS_MEMORY_NEW(Number, pstate, (double) sl->length());
+        return shared_number((double) sl->length(), pstate);
       }
       Expression* v = ARG("$list", Expression);
       if (v->concrete_type() == Expression::MAP) {
         Map* map = Cast<Map>(env["$list"]);
-        return SASS_MEMORY_NEW(Number, pstate, (double)(map ? map->length() : 1));
+        return shared_number((double)(map ? map->length() : 1), pstate);
       }
       if (v->concrete_type() == Expression::SELECTOR) {
         if (CompoundSelector * h = Cast<CompoundSelector>(v)) {
-          return SASS_MEMORY_NEW(Number, pstate, (double)h->length());
+          return shared_number((double)h->length(), pstate);
         } else if (SelectorList * ls = Cast<SelectorList>(v)) {
-          return SASS_MEMORY_NEW(Number, pstate, (double)ls->length());
+          return shared_number((double)ls->length(), pstate);
         } else {
-          return SASS_MEMORY_NEW(Number, pstate, 1);
+          return shared_number(1, pstate);
         }
       }
 
@@ -115,6 +128,11 @@ namespace Sass {
       if (l->empty()) error("argument `$list` of `" + std::string(sig) + "` must not be empty", pstate, traces);
       double index = std::floor(n->value() < 0 ? l->length() + n->value() : n->value() - 1);
       if (index < 0 || index > l->length() - 1) error("index out of bounds for `" + std::string(sig) + "`", pstate, traces);
+      if (list_is_unshared(l) && !l->is_arglist()) {
+        // overwrite the one slot instead of copying the list
+        (*l)[static_cast<size_t>(index)] = v;
+        return l.detach();
+      }
       List* result = SASS_MEMORY_NEW(List, pstate, l->length(), l->separator(), false, l->is_bracketed());
       for (size_t i = 0, L = l->length(); i < L; ++i) {
         result->append(((i == index) ? v : (*l)[i]));
@@ -122,12 +140,32 @@ namespace Sass {
       return result;
     }
 
+    // whether equality for [e] is fully determined by its cached
+    // hash: strings, booleans and null compare exactly and never
+    // equal a value of another type, so a hash miss proves the
+    // value absent. numbers convert units (1in equals 96px) and
+    // containers may hold numbers, so they stay off the index
+    static bool hash_decides_equality(const Expression* e)
+    {
+      switch (e->concrete_type()) {
+        case Expression::BOOLEAN:
+        case Expression::NULL_VAL:
+          return true;
+        case Expression::STRING:
+          // interpolated schemas hash over their parts
+          return Cast<String_Schema>(e) == nullptr;
+        default:
+          return false;
+      }
+    }
+
     Signature index_sig = "index($list, $value)";
     BUILT_IN(index)
     {
       Map_Obj m = Cast<Map>(env["$list"]);
       List_Obj l = Cast<List>(env["$list"]);
       Expression_Obj v = ARG("$value", Expression);
+      bool from_env = l != nullptr;
       if (!l) {
         l = SASS_MEMORY_NEW(List, pstate, 1);
         l->append(ARG("$list", Expression));
@@ -135,10 +173,42 @@ namespace Sass {
       if (m) {
         l = m->to_list(pstate);
       }
+      // repeatedly probed lists get a one-time hash index; only
+      // lists from the environment can recur, wrappers and map
+      // conversions above are fresh nodes every call
+      if (from_env && l->length() >= 4 && hash_decides_equality(v)) {
+        size_t vh = v->hash();
+        Context::ListProbeIndex& entry = ctx.list_index_cache[l.ptr()];
+        if (entry.list != l || entry.list_hash != l->hash()) {
+          entry.list = l;
+          entry.list_hash = l->hash();
+          entry.probes = 0;
+          entry.built = false;
+          entry.positions.clear();
+        }
+        if (!entry.built && ++entry.probes > 2) {
+          for (size_t i = 0, L = l->length(); i < L; ++i) {
+            Expression_Obj e = l->value_at_index(i);
+            if (!hash_decides_equality(e)) continue;
+            size_t h = e->hash();
+            if (h) entry.positions.emplace(h, i);
+          }
+          entry.built = true;
+        }
+        if (entry.built && vh) {
+          auto hit = entry.positions.find(vh);
+          if (hit == entry.positions.end()) return shared_null(pstate);
+          size_t i = hit->second;
+          if (Operators::eq(l->value_at_index(i), v)) {
+            return shared_number((double)(i+1), pstate);
+          }
+          // a colliding hash falls back to the linear scan
+        }
+      }
       for (size_t i = 0, L = l->length(); i < L; ++i) {
-        if (Operators::eq(l->value_at_index(i), v)) return SASS_MEMORY_NEW(Number, pstate, (double)(i+1));
+        if (Operators::eq(l->value_at_index(i), v)) return shared_number((double)(i+1), pstate);
       }
-      return SASS_MEMORY_NEW(Null, pstate);
+      return shared_null(pstate);
     }
 
     Signature join_sig = "join($list1, $list2, $separator: auto, $bracketed: auto)";
@@ -179,6 +249,14 @@ namespace Sass {
       if (!bracketed_is_auto) {
         is_bracketed = !bracketed->is_false();
       }
+      if (list_is_unshared(l1) && !l1->is_arglist()) {
+        // grow the left operand in place; separator and brackets
+        // are plain flags we can adjust on the reused node
+        l1->separator(sep_val);
+        l1->is_bracketed(is_bracketed);
+        l1->concat(l2);
+        return l1.detach();
+      }
       List_Obj result = SASS_MEMORY_NEW(List, pstate, len, sep_val, false, is_bracketed);
       result->concat(l1);
       result->concat(l2);
@@ -202,7 +280,10 @@ namespace Sass {
       if (m) {
         l = m->to_list(pstate);
       }
-      List* result = SASS_MEMORY_COPY(l);
+      // reuse the argument when this call holds the only handles;
+      // otherwise pay for the full copy to keep value semantics
+      List_Obj result = l;
+      if (!list_is_unshared(l)) result = SASS_MEMORY_COPY(l);
       std::string sep_str(unquote(sep->value()));
       if (sep_str != "auto") { // check default first
         if (sep_str == "space") result->separator(SASS_SPACE);
@@ -220,7 +301,7 @@ namespace Sass {
       } else {
         result->append(v);
       }
-      return result;
+      return result.detach();
     }
 
     Signature zip_sig = "zip($lists...)";
@@ -277,7 +358,7 @@ namespace Sass {
     {
       Value_Obj value = ARG("$list", Value);
       List_Obj list = Cast<List>(value);
-      return SASS_MEMORY_NEW(Boolean, pstate, list && list->is_bracketed());
+      return shared_boolean(list && list->is_bracketed(), pstate);
     }
 
   }
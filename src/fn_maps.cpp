@@ -19,21 +19,45 @@ namespace Sass {
       Expression_Obj v = ARG("$key", Expression);
       try {
         Value_Obj val = m->at(v);
-        if (!val) return SASS_MEMORY_NEW(Null, pstate);
+        if (!val) return shared_null(pstate);
         val->set_delayed(false);
         return val.detach();
       } catch (const std::out_of_range&) {
-        return SASS_MEMORY_NEW(Null, pstate);
+        return shared_null(pstate);
       }
       catch (...) { throw; }
     }
 
+    Signature map_get_path_sig = "map-get-path($map, $keys...)";
+    BUILT_IN(map_get_path)
+    {
+      // walks nested maps in one call; replaces chains like
+      // map-get(map-get(map-get($tokens, colors), brand), 500)
+      // that would otherwise re-enter eval and bind per level
+      Map_Obj m = ARGM("$map", Map);
+      List_Obj keys = ARG("$keys", List);
+      size_t L = keys->length();
+      if (L == 0) return m.detach();
+      Value_Obj val;
+      for (size_t i = 0; i < L; ++i) {
+        if (i > 0) {
+          Map* nested = Cast<Map>(val);
+          if (nested == nullptr) return shared_null(pstate);
+          m = nested;
+        }
+        val = m->at(keys->value_at_index(i));
+        if (!val) return shared_null(pstate);
+      }
+      val->set_delayed(false);
+      return val.detach();
+    }
+
     Signature map_has_key_sig = "map-has-key($map, $key)";
     BUILT_IN(map_has_key)
     {
       Map_Obj m = ARGM("$map", Map);
       Expression_Obj v = ARG("$key", Expression);
-      return SASS_MEMORY_NEW(Boolean, pstate, m->has(v));
+      return shared_boolean(m->has(v), pstate);
     }
 
     Signature map_keys_sig = "map-keys($map)";
@@ -64,6 +88,13 @@ namespace Sass {
       Map_Obj m1 = ARGM("$map1", Map);
       Map_Obj m2 = ARGM("$map2", Map);
 
+      // merging with an empty map changes nothing; share the other
+      // operand outright like variable assignment would (sass maps
+      // are immutable values, so aliasing is safe and saves the
+      // full copy in merge-heavy theming pipelines)
+      if (m2->empty()) return m1.detach();
+      if (m1->empty()) return m2.detach();
+
       size_t len = m1->length() + m2->length();
       Map* result = SASS_MEMORY_NEW(Map, pstate, len);
       // concat not implemented for maps
@@ -10,6 +10,7 @@ namespace Sass {
     #define ARGM(argname, argtype) get_arg_m(argname, env, sig, pstate, traces)
 
     extern Signature map_get_sig;
+    extern Signature map_get_path_sig;
     extern Signature map_merge_sig;
     extern Signature map_remove_sig;
     extern Signature map_keys_sig;
@@ -17,6 +18,7 @@ namespace Sass {
     extern Signature map_has_key_sig;
 
     BUILT_IN(map_get);
+    BUILT_IN(map_get_path);
     BUILT_IN(map_merge);
     BUILT_IN(map_remove);
     BUILT_IN(map_keys);
@@ -25,10 +25,10 @@ namespace Sass {
       std::string s = Util::normalize_underscores(unquote(ARG("$name", String_Constant)->value()));
 
       if(d_env.has("$"+s)) {
-        return SASS_MEMORY_NEW(Boolean, pstate, true);
+        return shared_boolean(true, pstate);
       }
       else {
-        return SASS_MEMORY_NEW(Boolean, pstate, false);
+        return shared_boolean(false, pstate);
       }
     }
 
@@ -38,10 +38,10 @@ namespace Sass {
       std::string s = Util::normalize_underscores(unquote(ARG("$name", String_Constant)->value()));
 
       if(d_env.has_global("$"+s)) {
-        return SASS_MEMORY_NEW(Boolean, pstate, true);
+        return shared_boolean(true, pstate);
       }
       else {
-        return SASS_MEMORY_NEW(Boolean, pstate, false);
+        return shared_boolean(false, pstate);
       }
     }
 
@@ -56,10 +56,10 @@ namespace Sass {
       std::string name = Util::normalize_underscores(unquote(ss->value()));
 
       if(d_env.has(name+"[f]")) {
-        return SASS_MEMORY_NEW(Boolean, pstate, true);
+        return shared_boolean(true, pstate);
       }
       else {
-        return SASS_MEMORY_NEW(Boolean, pstate, false);
+        return shared_boolean(false, pstate);
       }
     }
 
@@ -69,10 +69,10 @@ namespace Sass {
       std::string s = Util::normalize_underscores(unquote(ARG("$name", String_Constant)->value()));
 
       if(d_env.has(s+"[m]")) {
-        return SASS_MEMORY_NEW(Boolean, pstate, true);
+        return shared_boolean(true, pstate);
       }
       else {
-        return SASS_MEMORY_NEW(Boolean, pstate, false);
+        return shared_boolean(false, pstate);
       }
     }
 
@@ -88,7 +88,7 @@ namespace Sass {
         "units-level-3",
         "custom-property"
       };
-      return SASS_MEMORY_NEW(Boolean, pstate, features->find(s) != features->end());
+      return shared_boolean(features->find(s) != features->end(), pstate);
     }
 
     Signature call_sig = "call($function, $args...)";
@@ -150,7 +150,7 @@ namespace Sass {
     Signature not_sig = "not($value)";
     BUILT_IN(sass_not)
     {
-      return SASS_MEMORY_NEW(Boolean, pstate, ARG("$value", Expression)->is_false());
+      return shared_boolean(ARG("$value", Expression)->is_false(), pstate);
     }
 
     Signature if_sig = "if($condition, $if-true, $if-false)";
@@ -205,7 +205,7 @@ namespace Sass {
       if (!d_env.has_global("is_in_mixin")) {
         error("Cannot call content-exists() except within a mixin.", pstate, traces);
       }
-      return SASS_MEMORY_NEW(Boolean, pstate, d_env.has_lexical("@content[m]"));
+      return shared_boolean(d_env.has_lexical("@content[m]"), pstate);
     }
 
     Signature get_function_sig = "get-function($name, $css: false)";
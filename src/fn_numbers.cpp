@@ -204,7 +204,7 @@ namespace Sass {
     {
       Number_Obj arg = ARGN("$number");
       bool unitless = arg->is_unitless();
-      return SASS_MEMORY_NEW(Boolean, pstate, unitless);
+      return shared_boolean(unitless, pstate);
     }
 
     Signature comparable_sig = "comparable($number1, $number2)";
@@ -213,13 +213,13 @@ namespace Sass {
       Number_Obj n1 = ARGN("$number1");
       Number_Obj n2 = ARGN("$number2");
       if (n1->is_unitless() || n2->is_unitless()) {
-        return SASS_MEMORY_NEW(Boolean, pstate, true);
+        return shared_boolean(true, pstate);
       }
       // normalize into main units
       n1->normalize(); n2->normalize();
       Units &lhs_unit = *n1, &rhs_unit = *n2;
       bool is_comparable = (lhs_unit == rhs_unit);
-      return SASS_MEMORY_NEW(Boolean, pstate, is_comparable);
+      return shared_boolean(is_comparable, pstate);
     }
 
   }
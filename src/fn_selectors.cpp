@@ -42,7 +42,7 @@ namespace Sass {
 
       // Nothing to do
       if( parsedSelectors.empty() ) {
-        return SASS_MEMORY_NEW(Null, pstate);
+        return shared_null(pstate);
       }
 
       // Set the first element as the `result`, keep
@@ -133,19 +133,53 @@ namespace Sass {
 
       // Nothing to do
       if( parsedSelectors.empty() ) {
-        return SASS_MEMORY_NEW(Null, pstate);
+        return shared_null(pstate);
       }
 
       return Cast<Value>(Listize::perform(parsedSelectors.back()));
     }
 
+    // positional equality for the unify memo: the rendered result
+    // follows list order, but SelectorList::operator== compares as
+    // a set, so verify the complex selectors slot by slot instead
+    static bool same_selector_list(SelectorList* a, SelectorList* b)
+    {
+      if (a == b) return true;
+      if (a == 0 || b == 0) return false;
+      if (a->length() != b->length()) return false;
+      for (size_t i = 0, L = a->length(); i < L; ++i) {
+        if (!(*a->get(i) == *b->get(i))) return false;
+      }
+      return true;
+    }
+
     Signature selector_unify_sig = "selector-unify($selector1, $selector2)";
     BUILT_IN(selector_unify)
     {
       SelectorListObj selector1 = ARGSELS("$selector1");
       SelectorListObj selector2 = ARGSELS("$selector2");
+      size_t key = selector1->hash();
+      hash_combine(key, selector2->hash());
+      if (key) {
+        auto cached = ctx.selector_unify_cache.find(key);
+        // a verification miss unifies normally and the colliding
+        // slot goes to the newer pair below
+        if (cached != ctx.selector_unify_cache.end()
+            && same_selector_list(cached->second.lhs, selector1)
+            && same_selector_list(cached->second.rhs, selector2)) {
+          return Cast<Value>(SASS_MEMORY_COPY(cached->second.result.ptr()));
+        }
+      }
       SelectorListObj result = selector1->unifyWith(selector2);
-      return Cast<Value>(Listize::perform(result));
+      Value* value = Cast<Value>(Listize::perform(result));
+      // keep a pristine copy, the returned one goes to the caller
+      if (key) {
+        Context::UnifiedSelectors& entry = ctx.selector_unify_cache[key];
+        entry.lhs = selector1;
+        entry.rhs = selector2;
+        entry.result = SASS_MEMORY_COPY(value);
+      }
+      return value;
     }
 
     Signature simple_selectors_sig = "simple-selectors($selector)";
@@ -197,7 +231,7 @@ namespace Sass {
       SelectorListObj sel_sup = ARGSELS("$super");
       SelectorListObj sel_sub = ARGSELS("$sub");
       bool result = sel_sup->isSuperselectorOf(sel_sub);
-      return SASS_MEMORY_NEW(Boolean, pstate, result);
+      return shared_boolean(result, pstate);
     }
 
   }
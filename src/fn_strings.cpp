@@ -79,14 +79,14 @@ namespace Sass {
       size_t len = std::string::npos;
       try {
         String_Constant* s = ARG("$string", String_Constant);
-        len = UTF_8::code_point_count(s->value(), 0, s->value().size());
+        len = s->code_point_count();
 
       }
       // handle any invalid utf8 errors
       // other errors will be re-thrown
       catch (...) { handle_utf8_error(pstate, traces); }
       // return something even if we had an error (-1)
-      return SASS_MEMORY_NEW(Number, pstate, (double)len);
+      return shared_number((double)len, pstate);
     }
 
     Signature str_insert_sig = "str-insert($string, $insert, $index)";
@@ -102,11 +102,14 @@ namespace Sass {
         if (index != (int)index) {
           error("$index: " + std::to_string(index) + " is not an int", pstate, traces);
         }
-        size_t len = UTF_8::code_point_count(str, 0, str.size());
+        size_t len = s->code_point_count();
+        // ascii strings can use byte offsets directly
+        bool ascii = s->is_ascii();
 
         if (index > 0 && index <= len) {
           // positive and within string length
-          str.insert(UTF_8::offset_at_position(str, static_cast<size_t>(index) - 1), ins);
+          size_t pos = static_cast<size_t>(index) - 1;
+          str.insert(ascii ? pos : UTF_8::offset_at_position(str, pos), ins);
         }
         else if (index > len) {
           // positive and past string length
@@ -118,7 +121,8 @@ namespace Sass {
         else if (std::abs(index) <= len) {
           // negative and within string length
           index += len + 1;
-          str.insert(UTF_8::offset_at_position(str, static_cast<size_t>(index)), ins);
+          size_t pos = static_cast<size_t>(index);
+          str.insert(ascii ? pos : UTF_8::offset_at_position(str, pos), ins);
         }
         else {
           // negative and past string length
@@ -147,15 +151,16 @@ namespace Sass {
 
         size_t c_index = str.find(substr);
         if(c_index == std::string::npos) {
-          return SASS_MEMORY_NEW(Null, pstate);
+          return shared_null(pstate);
         }
-        index = UTF_8::code_point_count(str, 0, c_index) + 1;
+        index = s->is_ascii() ? c_index + 1
+              : UTF_8::code_point_count(str, 0, c_index) + 1;
       }
       // handle any invalid utf8 errors
       // other errors will be re-thrown
       catch (...) { handle_utf8_error(pstate, traces); }
       // return something even if we had an error (-1)
-      return SASS_MEMORY_NEW(Number, pstate, (double)index);
+      return shared_number((double)index, pstate);
     }
 
     Signature str_slice_sig = "str-slice($string, $start-at, $end-at:-1)";
@@ -175,7 +180,9 @@ namespace Sass {
 
         std::string str(s->value());
 
-        size_t size = utf8::distance(str.begin(), str.end());
+        // ascii strings can use byte offsets directly
+        bool ascii = s->is_ascii();
+        size_t size = s->code_point_count();
 
         if (!Cast<Number>(env["$end-at"])) {
           end_at = -1;
@@ -203,11 +210,17 @@ namespace Sass {
 
         if (start_at <= end_at)
         {
-          std::string::iterator start = str.begin();
-          utf8::advance(start, start_at - 1, str.end());
-          std::string::iterator end = start;
-          utf8::advance(end, end_at - start_at + 1, str.end());
-          newstr = std::string(start, end);
+          if (ascii) {
+            newstr = str.substr((size_t) start_at - 1,
+              (size_t) (end_at - start_at + 1));
+          }
+          else {
+            std::string::iterator start = str.begin();
+            utf8::advance(start, start_at - 1, str.end());
+            std::string::iterator end = start;
+            utf8::advance(end, end_at - start_at + 1, str.end());
+            newstr = std::string(start, end);
+          }
         }
         if (ss) {
           if(ss->quote_mark()) newstr = quote(newstr);
@@ -2,23 +2,47 @@
 // __EXTENSIONS__ fix on Solaris.
 #include "sass.hpp"
 
+#include <unordered_map>
+
 #include "parser.hpp"
 #include "fn_utils.hpp"
 #include "util_string.hpp"
 
 namespace Sass {
 
+  // the built-in signatures are static strings that parse into the
+  // same name and parameter list for every compilation, yet every
+  // new Context used to run the signature parser a few hundred
+  // times over. The first parse per thread is kept and later
+  // compilations just wrap the shared subtree in a fresh
+  // Definition (which still gets its per compile environment).
+  // Keyed by pointer identity since the signatures are literals;
+  // thread local like the parse cache, so the shared nodes never
+  // cross allocator arenas or refcount from another thread.
+  namespace {
+    struct ParsedSignature {
+      std::string name;
+      Parameters_Obj params;
+    };
+    thread_local std::unordered_map<const void*, ParsedSignature> sig_cache;
+  }
+
   Definition* make_native_function(Signature sig, Native_Function func, Context& ctx)
   {
-    Parser sig_parser = Parser::from_c_str(sig, ctx, ctx.traces, ParserState("[built-in function]"));
-    sig_parser.lex<Prelexer::identifier>();
-    std::string name(Util::normalize_underscores(sig_parser.lexed));
-    Parameters_Obj params = sig_parser.parse_parameters();
+    auto cached = sig_cache.find(static_cast<const void*>(sig));
+    if (cached == sig_cache.end()) {
+      Parser sig_parser = Parser::from_c_str(sig, ctx, ctx.traces, ParserState("[built-in function]"));
+      sig_parser.lex<Prelexer::identifier>();
+      ParsedSignature parsed;
+      parsed.name = Util::normalize_underscores(sig_parser.lexed);
+      parsed.params = sig_parser.parse_parameters();
+      cached = sig_cache.emplace(static_cast<const void*>(sig), parsed).first;
+    }
     return SASS_MEMORY_NEW(Definition,
                           ParserState("[built-in function]"),
                           sig,
-                          name,
-                          params,
+                          cached->second.name,
+                          cached->second.params,
                           func,
                           false);
   }
@@ -32,6 +32,8 @@ namespace Sass {
     }
     if (output_style() == NESTED) indentation += block->tabs();
     for (size_t i = 0, L = block->length(); i < L; ++i) {
+      // honor the compile budget between rendered statements
+      if (budget_poll) budget_poll(budget_cookie);
       (*block)[i]->perform(this);
     }
     if (output_style() == NESTED) indentation -= block->tabs();
@@ -86,7 +88,7 @@ namespace Sass {
     append_mandatory_space();
     in_media_block = true;
     bool joinIt = false;
-    for (auto query : rule->elements()) {
+    for (const auto& query : rule->elements()) {
       if (joinIt) {
         append_comma_separator();
         append_optional_space();
@@ -113,7 +115,7 @@ namespace Sass {
       append_string(query->type());
       joinIt = true;
     }
-    for (auto feature : query->features()) {
+    for (const auto& feature : query->features()) {
       if (joinIt) {
         append_mandatory_space();
         append_string("and");
@@ -168,6 +170,11 @@ namespace Sass {
   void Inspect::operator()(Declaration* dec)
   {
     if (dec->value()->concrete_type() == Expression::NULL_VAL) return;
+    // at declaration granularity one mapping pair covers the
+    // whole declaration; everything emitted inside is filtered
+    if (opt.source_map_granularity == SASS_SRCMAP_DECLARATION) {
+      add_open_mapping(dec);
+    }
     bool was_decl = in_declaration;
     in_declaration = true;
     LOCAL_FLAG(in_custom_property, dec->is_custom_property());
@@ -194,6 +201,9 @@ namespace Sass {
     if (output_style() == NESTED)
       indentation -= dec->tabs();
     in_declaration = was_decl;
+    if (opt.source_map_granularity == SASS_SRCMAP_DECLARATION) {
+      add_close_mapping(dec);
+    }
   }
 
   void Inspect::operator()(Assignment* assn)
@@ -400,7 +410,7 @@ namespace Sass {
     if (map->is_invisible()) return;
     bool items_output = false;
     append_string("(");
-    for (auto key : map->keys()) {
+    for (const auto& key : map->keys()) {
       if (items_output) append_comma_separator();
       key->perform(this);
       append_colon_separator();
@@ -564,21 +574,46 @@ namespace Sass {
     append_token(var->name(), var);
   }
 
-  void Inspect::operator()(Number* n)
+  void render_number(std::string& res, Number* n, const Sass_Inspect_Options& opt)
   {
 
+    #ifdef SASS_THREADSAFE_REFCOUNT
+    // reducing in place would race when render threads share a
+    // number node, so work on a stack copy in threaded builds
+    Number reduced(*n);
+    reduced.reduce();
+    n = &reduced;
+    #else
     // reduce units
     n->reduce();
-
-    std::stringstream ss;
-    ss.precision(opt.precision);
-    ss << std::fixed << n->value();
-
-    std::string res = ss.str();
+    #endif
+
+    // format on the stack; a stringstream here allocates and
+    // consults the global locale for every rendered number
+    char buf[512];
+    int len = snprintf(buf, sizeof(buf), "%.*f",
+      (int) opt.precision, n->value());
+    if (len < 0 || len >= (int) sizeof(buf)) {
+      // abnormal precision setting; play it safe
+      std::stringstream ss;
+      ss.precision(opt.precision);
+      ss << std::fixed << n->value();
+      std::string str(ss.str());
+      len = (int) str.length();
+      if (len >= (int) sizeof(buf)) len = sizeof(buf) - 1;
+      std::copy(str.c_str(), str.c_str() + len + 1, buf);
+    }
+    // some locales use a comma as decimal separator
+    for (int i = 0; i < len; i++) {
+      if (buf[i] == ',') buf[i] = '.';
+    }
+
+    size_t off = res.length();
+    res.append(buf, len);
     size_t s = res.length();
 
     // delete trailing zeros
-    for(s = s - 1; s > 0; --s)
+    for(s = s - 1; s > off; --s)
     {
         if(res[s] == '0') {
           res.erase(s, 1);
@@ -587,20 +622,20 @@ namespace Sass {
     }
 
     // delete trailing decimal separator
-    if(res[s] == '.') res.erase(s, 1);
+    if(s > off && res[s] == '.') res.erase(s, 1);
 
     // some final cosmetics
-    if (res == "0.0") res = "0";
-    else if (res == "") res = "0";
-    else if (res == "-0") res = "0";
-    else if (res == "-0.0") res = "0";
+    if (res.compare(off, std::string::npos, "0.0") == 0) res.replace(off, 3, "0");
+    else if (res.length() == off) res += "0";
+    else if (res.compare(off, std::string::npos, "-0") == 0) res.replace(off, 2, "0");
+    else if (res.compare(off, std::string::npos, "-0.0") == 0) res.replace(off, 4, "0");
     else if (opt.output_style == COMPRESSED)
     {
       if (n->zero()) {
         // check if handling negative nr
-        size_t off = res[0] == '-' ? 1 : 0;
+        size_t neg = res[off] == '-' ? off + 1 : off;
         // remove leading zero from floating point in compressed mode
-        if (res[off] == '0' && res[off+1] == '.') res.erase(off, 1);
+        if (res[neg] == '0' && neg + 1 < res.length() && res[neg+1] == '.') res.erase(neg, 1);
       }
     }
 
@@ -611,9 +646,42 @@ namespace Sass {
       // traces.push_back(Backtrace(nr->pstate()));
       throw Exception::InvalidValue({}, *n);
     }
+  }
 
-    // output the final token
+  void Inspect::operator()(Number* n)
+  {
+    #ifdef SASS_THREADSAFE_REFCOUNT
+    // node level memoization would race between render threads
+    std::string res;
+    render_number(res, n, opt);
     append_token(res, n);
+    #else
+    // an evaluated number typically reaches many declarations
+    // through a single variable, so memoize the rendered token on
+    // the node like the colors do. Reduce up front: rendering
+    // reduces in place anyway, and keying the reduced form keeps
+    // the key stable across renders. The key hashes the live unit
+    // vectors (they are public, so the lazy node hash cannot be
+    // trusted to see every mutation) plus the render options.
+    n->reduce();
+    size_t render_key = std::hash<double>()(n->value());
+    for (const auto& numerator : n->numerators)
+      hash_combine(render_key, std::hash<std::string>()(numerator));
+    hash_combine(render_key, n->numerators.size());
+    for (const auto& denominator : n->denominators)
+      hash_combine(render_key, std::hash<std::string>()(denominator));
+    hash_combine(render_key, static_cast<size_t>(opt.output_style));
+    hash_combine(render_key, static_cast<size_t>(opt.precision));
+    if (!render_key) render_key = 1;
+    if (const std::string* cached = n->cached_render(render_key)) {
+      append_token(*cached, n);
+      return;
+    }
+    std::string res;
+    render_number(res, n, opt);
+    n->cache_render(render_key, res);
+    append_token(res, n);
+    #endif
   }
 
   // helper function for serializing colors
@@ -626,8 +694,26 @@ namespace Sass {
 
   void Inspect::operator()(Color_RGBA* c)
   {
+    // the same color node is emitted many times; serializing it
+    // is expensive (rounding, name lookups, hex formatting), so
+    // the rendered token is memoized on the node, keyed by the
+    // value hash plus the options that influence the rendering
+    #ifdef SASS_THREADSAFE_REFCOUNT
+    // node level memoization (and the lazy hash it is keyed on)
+    // would race between render threads; a zero key disables it
+    const size_t render_key = 0;
+    #else
+    size_t render_key = c->hash();
+    hash_combine(render_key, static_cast<size_t>(opt.output_style));
+    hash_combine(render_key, static_cast<size_t>(opt.precision));
+    #endif
+    if (const std::string* cached = c->cached_render(render_key)) {
+      append_token(*cached, c);
+      return;
+    }
+
     // output the final token
-    std::stringstream ss;
+    std::string res;
 
     // original color name
     // maybe an unknown token
@@ -656,57 +742,77 @@ namespace Sass {
         res_name = color_to_name(numval);
     }
 
-    std::stringstream hexlet;
     // dart sass compressed all colors in regular css always
     // ruby sass and libsass does it only when not delayed
     // since color math is going to be removed, this can go too
     bool compressed = opt.output_style == COMPRESSED;
-    hexlet << '#' << std::setw(1) << std::setfill('0');
+    // format the hexlet by hand; iostream formatting showed up in
+    // profiles since this runs once per distinct color and style
+    static const char hexdig[] = "0123456789abcdef";
+    std::string hexlet("#");
     // create a short color hexlet if there is any need for it
     if (compressed && is_color_doublet(r, g, b) && a == 1) {
-      hexlet << std::hex << std::setw(1) << (static_cast<unsigned long>(r) >> 4);
-      hexlet << std::hex << std::setw(1) << (static_cast<unsigned long>(g) >> 4);
-      hexlet << std::hex << std::setw(1) << (static_cast<unsigned long>(b) >> 4);
+      hexlet += hexdig[(static_cast<unsigned long>(r) >> 4) & 0xF];
+      hexlet += hexdig[(static_cast<unsigned long>(g) >> 4) & 0xF];
+      hexlet += hexdig[(static_cast<unsigned long>(b) >> 4) & 0xF];
     } else {
-      hexlet << std::hex << std::setw(2) << static_cast<unsigned long>(r);
-      hexlet << std::hex << std::setw(2) << static_cast<unsigned long>(g);
-      hexlet << std::hex << std::setw(2) << static_cast<unsigned long>(b);
+      unsigned long channels[3] = {
+        static_cast<unsigned long>(r),
+        static_cast<unsigned long>(g),
+        static_cast<unsigned long>(b)
+      };
+      for (unsigned long channel : channels) {
+        hexlet += hexdig[(channel >> 4) & 0xF];
+        hexlet += hexdig[channel & 0xF];
+      }
     }
 
     if (compressed && !c->is_delayed()) name = "";
     if (opt.output_style == INSPECT && a >= 1) {
-      append_token(hexlet.str(), c);
+      c->cache_render(render_key, hexlet);
+      append_token(hexlet, c);
       return;
     }
 
     // retain the originally specified color definition if unchanged
     if (name != "") {
-      ss << name;
+      res = name;
     }
     else if (a >= 1) {
       if (res_name != "") {
-        if (compressed && hexlet.str().size() < res_name.size()) {
-          ss << hexlet.str();
+        if (compressed && hexlet.size() < res_name.size()) {
+          res = hexlet;
         } else {
-          ss << res_name;
+          res = res_name;
         }
       }
       else {
-        ss << hexlet.str();
+        res = hexlet;
       }
     }
     else {
-      ss << "rgba(";
-      ss << static_cast<unsigned long>(r) << ",";
-      if (!compressed) ss << " ";
-      ss << static_cast<unsigned long>(g) << ",";
-      if (!compressed) ss << " ";
-      ss << static_cast<unsigned long>(b) << ",";
-      if (!compressed) ss << " ";
-      ss << a << ')';
+      const char* sep = compressed ? "," : ", ";
+      res = "rgba(";
+      res += std::to_string(static_cast<unsigned long>(r));
+      res += sep;
+      res += std::to_string(static_cast<unsigned long>(g));
+      res += sep;
+      res += std::to_string(static_cast<unsigned long>(b));
+      res += sep;
+      // streams render doubles differently than to_string (six
+      // significant digits, no trailing zeros); "%.6g" is the same
+      // format minus the locale snapshot a stringstream takes
+      char alpha[32];
+      int alen = snprintf(alpha, sizeof(alpha), "%.6g", a);
+      for (int i = 0; i < alen; i++) {
+        if (alpha[i] == ',') alpha[i] = '.';
+      }
+      res.append(alpha, alen);
+      res += ')';
     }
 
-    append_token(ss.str(), c);
+    c->cache_render(render_key, res);
+    append_token(res, c);
 
   }
 
@@ -741,7 +847,7 @@ namespace Sass {
   void Inspect::operator()(String_Quoted* s)
   {
     if (const char q = s->quote_mark()) {
-      append_token(quote(s->value(), q), s);
+      append_token(s->quoted(q), s);
     } else {
       append_token(s->value(), s);
     }
@@ -8,6 +8,11 @@
 namespace Sass {
   class Context;
 
+  // Formats a number token exactly as Inspect renders it, appended
+  // to [res] without constructing an Emitter; this is the typed
+  // fast path for interpolated numbers in Eval::interpolation
+  void render_number(std::string& res, Number* n, const Sass_Inspect_Options& opt);
+
   class Inspect : public Operation_CRTP<void, Inspect>, public Emitter {
   protected:
     // import all the class-specific methods and override as desired
@@ -1169,12 +1169,39 @@ void emit_string(SB *out, const char *str)
   /*
    * 14 bytes is enough space to write up to two
    * \uXXXX escapes and two quotation marks.
+   * Presize for the whole input so the common case of a
+   * mostly clean string grows the buffer at most once.
    */
-  sb_need(out, 14);
+  {
+    size_t length = strlen(str);
+    sb_need(out, length < 0x7FFFFFF0 ? (int) length + 16 : 14);
+  }
   b = out->cur;
 
   *b++ = '"';
   while (*s != 0) {
+    /*
+     * Bulk-copy the span up to the next byte needing special
+     * treatment: printable ascii except quote and backslash
+     * is always written through verbatim.
+     */
+    const char *span = s;
+    unsigned char sc;
+    while ((sc = (unsigned char) *s) != 0 &&
+           sc >= 0x20 && sc < 0x80 && sc != '"' && sc != '\\') {
+      s++;
+    }
+    if (s > span) {
+      int span_len = (int) (s - span);
+      out->cur = b;
+      sb_need(out, span_len + 14);
+      b = out->cur;
+      memcpy(b, span, span_len);
+      b += span_len;
+    }
+    if (*s == 0)
+      break;
+
     unsigned char c = *s++;
 
     /* Encode the next character, and write it to b. */
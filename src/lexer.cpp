@@ -75,13 +75,29 @@ namespace Sass {
     const char* escapable_character(const char* src) { return is_escapable_character(*src) ? src + 1 : 0; }
 
     // Match multiple ctype characters.
-    const char* spaces(const char* src) { return one_plus<space>(src); }
-    const char* digits(const char* src) { return one_plus<digit>(src); }
+    // Scan in tight loops since whitespace and digit runs are by
+    // far the hottest bulk consumers during parsing.
+    const char* spaces(const char* src)
+    {
+      if (!Util::ascii_isspace(static_cast<unsigned char>(*src))) return 0;
+      do { ++src; } while (Util::ascii_isspace(static_cast<unsigned char>(*src)));
+      return src;
+    }
+    const char* digits(const char* src)
+    {
+      if (!Util::ascii_isdigit(static_cast<unsigned char>(*src))) return 0;
+      do { ++src; } while (Util::ascii_isdigit(static_cast<unsigned char>(*src)));
+      return src;
+    }
     const char* hyphens(const char* src) { return one_plus<hyphen>(src); }
 
     // Whitespace handling.
     const char* no_spaces(const char* src) { return negate< space >(src); }
-    const char* optional_spaces(const char* src) { return zero_plus< space >(src); }
+    const char* optional_spaces(const char* src)
+    {
+      while (Util::ascii_isspace(static_cast<unsigned char>(*src))) ++src;
+      return src;
+    }
 
     // Match any single character.
     const char* any_char(const char* src) { return *src ? src + 1 : src; }
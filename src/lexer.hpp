@@ -245,6 +245,18 @@ namespace Sass {
       return src;
     }
 
+    // Bulk-match a run of "plain" quoted string characters.
+    // Stops before the delimiter, escapes, possible interpolant
+    // starts and the end of input, so the surrounding alternatives
+    // still see those cases; everything in between is consumed in
+    // one tight loop instead of one char per combinator iteration.
+    template <char q>
+    const char* quoted_string_run(const char* src) {
+      const char* p = src;
+      while (*p && *p != q && *p != '\\' && *p != '#') ++p;
+      return p == src ? 0 : p;
+    }
+
     // Match mx non-greedy until delimiter.
     // Other prelexers are greedy by default.
     // Regex equivalent: /(?:$mx)*?(?=$delim)\b/
@@ -0,0 +1,25 @@
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "../sass.hpp"
+
+#include "MemoryPool.hpp"
+
+namespace Sass {
+
+  MemoryPool& getMemoryPool()
+  {
+    thread_local MemoryPool pool;
+    return pool;
+  }
+
+  void* allocateMem(size_t size)
+  {
+    return getMemoryPool().allocate(size);
+  }
+
+  void deallocateMem(void* ptr)
+  {
+    getMemoryPool().deallocate(ptr);
+  }
+
+}
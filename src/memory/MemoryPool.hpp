@@ -0,0 +1,174 @@
+#ifndef SASS_MEMORY_POOL_H
+#define SASS_MEMORY_POOL_H
+
+#include <stdlib.h>
+#include <climits>
+#include <vector>
+#include <new>
+
+namespace Sass {
+
+  // A simple arena allocator with size-class free-lists on top.
+  // AST nodes are small, allocated in huge numbers during parsing
+  // and expansion, and nearly all die together when the compilation
+  // ends. We therefore carve them out of big malloc'd arenas and
+  // only give memory back to the system when the whole pool goes
+  // away. Deleted nodes are threaded onto per-size free-lists so
+  // the parser can recycle them without touching malloc at all.
+
+  // How many size-class buckets the free-list keeps. Allocations
+  // larger than the biggest bucket fall through to plain malloc.
+  #define SassAllocatorBuckets 512
+
+  // Granularity of the size-class buckets in bytes.
+  #define SassAllocatorBucketSize sizeof(void*)
+
+  // The size of every memory arena we request from the system.
+  #define SassAllocatorArenaSize (256 * 1024)
+
+  class MemoryPool {
+
+    // The arena we are currently filling up.
+    char* arena;
+
+    // Position of the next free byte in the arena.
+    size_t offset;
+
+    // All arenas we have allocated so far.
+    std::vector<void*> arenas;
+
+    // One free-list per size class.
+    std::vector<void*> freeList;
+
+    // Round up to the bucket granularity.
+    static size_t alignSize(size_t size)
+    {
+      return (size + SassAllocatorBucketSize - 1)
+        & ~(SassAllocatorBucketSize - 1);
+    }
+
+  public:
+
+    MemoryPool() :
+      arena(nullptr),
+      offset(0),
+      freeList(SassAllocatorBuckets, nullptr)
+    {}
+
+    ~MemoryPool()
+    {
+      // Bulk-free all arenas at once. Node destructors have
+      // already run through `operator delete` by this point.
+      for (auto area : arenas) {
+        free(area);
+      }
+      free(arena);
+    }
+
+    void* allocate(size_t size)
+    {
+      // Reserve space for the bucket header and align.
+      size = alignSize(size + SassAllocatorBucketSize);
+
+      // The bucket this allocation belongs to.
+      size_t bucket = size / SassAllocatorBucketSize;
+
+      // Too big for the pool, use the default allocator.
+      if (bucket >= SassAllocatorBuckets) {
+        char* buffer = (char*)malloc(size);
+        if (buffer == nullptr) {
+          throw std::bad_alloc();
+        }
+        // Mark as a raw malloc'd block.
+        ((unsigned int*)buffer)[0] = UINT_MAX;
+        return buffer + SassAllocatorBucketSize;
+      }
+
+      // Recycle a previously freed chunk of the same size. The
+      // free-list link lives in the payload, so the bucket header
+      // written when the chunk was first carved is still intact.
+      if (void* ptr = freeList[bucket]) {
+        freeList[bucket] = ((void**)((char*)ptr + SassAllocatorBucketSize))[0];
+        return (char*)ptr + SassAllocatorBucketSize;
+      }
+
+      // Carve the chunk out of the current arena.
+      if (arena == nullptr || offset + size > SassAllocatorArenaSize) {
+        if (arena != nullptr) arenas.push_back(arena);
+        arena = (char*)malloc(SassAllocatorArenaSize);
+        if (arena == nullptr) throw std::bad_alloc();
+        offset = 0;
+      }
+      char* buffer = arena + offset;
+      offset += size;
+      ((unsigned int*)buffer)[0] = (unsigned int)bucket;
+      return buffer + SassAllocatorBucketSize;
+    }
+
+    void deallocate(void* ptr)
+    {
+      // Rewind to the bucket header.
+      char* buffer = (char*)ptr - SassAllocatorBucketSize;
+      unsigned int bucket = ((unsigned int*)buffer)[0];
+
+      // Blocks that bypassed the arenas go back to the system.
+      if (bucket == UINT_MAX) {
+        free(buffer);
+        return;
+      }
+
+      // Thread the chunk onto its size-class free-list. The link
+      // goes into the payload, which keeps the header valid for
+      // the next allocation from this bucket.
+      ((void**)ptr)[0] = freeList[bucket];
+      freeList[bucket] = buffer;
+    }
+
+  };
+
+  // The pool is thread-local so compilations on different threads
+  // never contend; it lives as long as the thread does, which keeps
+  // recycled nodes warm across consecutive compilations.
+  MemoryPool& getMemoryPool();
+
+  void* allocateMem(size_t size);
+
+  void deallocateMem(void* ptr);
+
+  // STL allocator over the same pool, so the tiny element vectors
+  // inside AST nodes (selector compounds, argument lists) come from
+  // the arenas too instead of paying one malloc each. Growing a
+  // two-element vector becomes a free-list pop.
+  template <typename T>
+  class PoolAllocator {
+  public:
+
+    typedef T value_type;
+
+    PoolAllocator() {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+      return reinterpret_cast<T*>(
+        allocateMem(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t)
+    {
+      deallocateMem(ptr);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const { return true; }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const { return false; }
+
+  };
+
+}
+
+#endif
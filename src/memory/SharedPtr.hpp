@@ -9,6 +9,38 @@
 #include <type_traits>
 #include <vector>
 
+#ifdef SASS_CUSTOM_ALLOCATOR
+#include "MemoryPool.hpp"
+#endif
+
+#ifdef SASS_THREADSAFE_REFCOUNT
+#include <atomic>
+#endif
+
+// The arena allocator recycles node memory through thread local
+// free-lists, so a node dropped on another thread would corrupt
+// the pool it came from; the two modes cannot be combined.
+#if defined(SASS_THREADSAFE_REFCOUNT) && defined(SASS_CUSTOM_ALLOCATOR)
+#error "SASS_THREADSAFE_REFCOUNT cannot be combined with SASS_CUSTOM_ALLOCATOR"
+#endif
+
+namespace Sass {
+
+  // Element storage for AST child vectors (selector compounds,
+  // argument lists, statement blocks). With the custom allocator
+  // enabled the buffers come from the same arena pool as the nodes
+  // that own them, so growing a two-element compound is a free-list
+  // pop instead of a malloc; otherwise this is a plain std::vector.
+  #ifdef SASS_CUSTOM_ALLOCATOR
+  template <typename T>
+  using PoolVector = std::vector<T, PoolAllocator<T>>;
+  #else
+  template <typename T>
+  using PoolVector = std::vector<T>;
+  #endif
+
+}
+
 // https://lokiastari.com/blog/2014/12/30/c-plus-plus-by-example-smart-pointer/index.html
 // https://lokiastari.com/blog/2015/01/15/c-plus-plus-by-example-smart-pointer-part-ii/index.html
 // https://lokiastari.com/blog/2015/01/23/c-plus-plus-by-example-smart-pointer-part-iii/index.html
@@ -22,10 +54,36 @@ namespace Sass {
   // has been proven to be flaky under certain compilers (see comment below).
   ///////////////////////////////////////////////////////////////////////////////
 
+  // Always-on allocation statistics for production telemetry (see
+  // sass_context_get_stats_json). Compilations are single threaded,
+  // so plain thread local counters keep the allocation path free of
+  // atomics; a Context snapshots the counters when it is created and
+  // reports the deltas after rendering.
+  class MemoryStats {
+   public:
+    // cumulative SharedObj constructions
+    size_t node_allocations = 0;
+    // cumulative bytes requested for nodes
+    size_t node_bytes = 0;
+    // currently constructed SharedObjs
+    size_t live_nodes = 0;
+    // high water mark of live_nodes
+    size_t peak_live_nodes = 0;
+    // bytes duplicated via sass_copy_c_string
+    size_t string_bytes = 0;
+    // environment frames created
+    size_t env_frames = 0;
+    static MemoryStats& instance() {
+      thread_local MemoryStats stats;
+      return stats;
+    }
+  };
+
   #ifdef DEBUG_SHARED_PTR
 
     #define SASS_MEMORY_NEW(Class, ...) \
-      ((Class*)(new Class(__VA_ARGS__))->trace(__FILE__, __LINE__)) \
+      (Sass::MemoryStats::instance().node_bytes += sizeof(Class), \
+        (Class*)(new Class(__VA_ARGS__))->trace(__FILE__, __LINE__)) \
 
     #define SASS_MEMORY_COPY(obj) \
       ((obj)->copy(__FILE__, __LINE__)) \
@@ -36,7 +94,8 @@ namespace Sass {
   #else
 
     #define SASS_MEMORY_NEW(Class, ...) \
-      new Class(__VA_ARGS__) \
+      (Sass::MemoryStats::instance().node_bytes += sizeof(Class), \
+        new Class(__VA_ARGS__)) \
 
     #define SASS_MEMORY_COPY(obj) \
       ((obj)->copy()) \
@@ -59,11 +118,19 @@ namespace Sass {
   class SharedObj {
    public:
     SharedObj() : refcount(0), detached(false) {
+      MemoryStats& stats = MemoryStats::instance();
+      stats.node_allocations += 1;
+      if (++stats.live_nodes > stats.peak_live_nodes)
+        stats.peak_live_nodes = stats.live_nodes;
       #ifdef DEBUG_SHARED_PTR
       if (taint) all.push_back(this);
       #endif
     }
+    // copies start out fresh and unreferenced; counted like any
+    // other construction so the live node counter stays balanced
+    SharedObj(const SharedObj&) : SharedObj() {}
     virtual ~SharedObj() {
+      MemoryStats::instance().live_nodes -= 1;
       #ifdef DEBUG_SHARED_PTR
       for (size_t i = 0; i < all.size(); i++) {
         if (all[i] == this) {
@@ -84,17 +151,41 @@ namespace Sass {
     std::string getDbgFile() { return file; }
     size_t getDbgLine() { return line; }
     void setDbg(bool dbg) { this->dbg = dbg; }
-    size_t getRefCount() const { return refcount; }
     #endif
 
+    // expose the count so callers can prove sole ownership
+    // (used for safe in-place mutation of temporary values)
+    size_t getRefCount() const { return refcount; }
+
     static void setTaint(bool val) { taint = val; }
 
+    #ifdef SASS_CUSTOM_ALLOCATOR
+    // Route all AST node allocations through the arena pool.
+    // Freed nodes are recycled via per-size free-lists and the
+    // arenas themselves are released in bulk with the pool.
+    inline void* operator new(size_t nbytes) {
+      return allocateMem(nbytes);
+    }
+    inline void operator delete(void* ptr) {
+      deallocateMem(ptr);
+    }
+    #endif
+
     virtual std::string to_string() const = 0;
    protected:
     friend class SharedPtr;
     friend class Memory_Manager;
+    // With SASS_THREADSAFE_REFCOUNT taking and dropping references
+    // to one node from several threads is defined behavior, which
+    // the partitioned renderer needs; default builds keep the plain
+    // counter so the hot single threaded path stays free of atomics.
+    #ifdef SASS_THREADSAFE_REFCOUNT
+    std::atomic<size_t> refcount;
+    std::atomic<bool> detached;
+    #else
     size_t refcount;
     bool detached;
+    #endif
     static bool taint;
     #ifdef DEBUG_SHARED_PTR
     std::string file;
@@ -153,17 +244,23 @@ namespace Sass {
     SharedObj* node;
     void decRefCount() {
       if (node == nullptr) return;
-      --node->refcount;
+      #ifdef SASS_THREADSAFE_REFCOUNT
+      // release pairs every drop with the acquire of the final
+      // one, so the deleting thread sees all prior modifications
+      size_t count = node->refcount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+      #else
+      size_t count = --node->refcount;
+      #endif
       #ifdef DEBUG_SHARED_PTR
-      if (node->dbg) std::cerr << "- " << node << " X " << node->refcount << " (" << this << ") " << "\n";
+      if (node->dbg) std::cerr << "- " << node << " X " << count << " (" << this << ") " << "\n";
       #endif
-      if (node->refcount == 0 && !node->detached) {
+      if (count == 0 && !node->detached) {
         #ifdef DEBUG_SHARED_PTR
         if (node->dbg) std::cerr << "DELETE NODE " << node << "\n";
         #endif
         delete node;
       }
-      else if (node->refcount == 0) {
+      else if (count == 0) {
         #ifdef DEBUG_SHARED_PTR
         if (node->dbg) std::cerr << "NODE EVAEDED DELETE " << node << "\n";
         #endif
@@ -172,7 +269,11 @@ namespace Sass {
     void incRefCount() {
       if (node == nullptr) return;
       node->detached = false;
+      #ifdef SASS_THREADSAFE_REFCOUNT
+      node->refcount.fetch_add(1, std::memory_order_relaxed);
+      #else
       ++node->refcount;
+      #endif
       #ifdef DEBUG_SHARED_PTR
       if (node->dbg) std::cerr << "+ " << node << " X " << node->refcount << " (" << this << ") " << "\n";
       #endif
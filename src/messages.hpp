@@ -0,0 +1,65 @@
+#ifndef SASS_MESSAGES_H
+#define SASS_MESSAGES_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace Sass {
+
+  // Batched sink for @warn/@debug and deprecation output. Writing
+  // each message straight to std::cerr takes a stream lock and
+  // usually a syscall per line, and warning storms from vendored
+  // libraries repeat the same text thousands of times. Compilation
+  // entry points install a sink for their duration; every emitter
+  // funnels through emit() and the sink writes everything in one
+  // go when the scope ends — to the handler registered via
+  // sass_option_set_message_handler when there is one, to stderr
+  // otherwise. With sass_option_set_message_dedup enabled repeated
+  // messages collapse into the first occurrence plus a repeat
+  // count. The active sink is thread local so parallel
+  // compilations keep their messages apart.
+  namespace Messages {
+
+    class Sink {
+    private:
+      void (*handler_)(const char*, void*);
+      void* cookie_;
+      bool dedup_;
+      // unique messages in first-seen order with repeat counts
+      std::vector<std::pair<std::string, size_t>> entries_;
+      // message to entry position, only maintained when deduping
+      std::unordered_map<std::string, size_t> seen_;
+    public:
+      Sink(void (*handler)(const char*, void*), void* cookie, bool dedup)
+      : handler_(handler), cookie_(cookie), dedup_(dedup) {}
+      void push(const std::string& msg);
+      void flush();
+    };
+
+    extern thread_local Sink* sink;
+
+    // hand [msg] (fully formatted, with trailing newlines) to the
+    // active sink, or straight to stderr outside any scope
+    void emit(const std::string& msg);
+
+    // installs a sink for the lifetime of the scope and flushes
+    // it on the way out, also when unwinding; scopes may nest,
+    // the inner one flushes first and the outer one resumes
+    class Scope {
+    private:
+      Sink local_;
+      Sink* previous_;
+    public:
+      Scope(void (*handler)(const char*, void*), void* cookie, bool dedup)
+      : local_(handler, cookie, dedup), previous_(sink)
+      { sink = &local_; }
+      ~Scope()
+      { sink = previous_; local_.flush(); }
+    };
+
+  }
+
+}
+
+#endif
@@ -35,6 +35,8 @@ namespace Sass {
     {
       // operation is undefined if one is not a number
       if (!lhs || !rhs) throw Exception::UndefinedOperation(lhs, rhs, Sass_OP::EQ);
+      // shared nodes need no structural walk
+      if (lhs.ptr() == rhs.ptr()) return true;
       // use compare operator from ast node
       return *lhs == *rhs;
     }
@@ -141,6 +143,26 @@ namespace Sass {
                              lhs.a());
     }
 
+    /* in-place twin of the "simplest case" below: same units, at most
+       one unit per side, and no zero-division special case (those
+       return strings). The unit checks mirror op_numbers exactly so
+       both paths stay behavior-identical. */
+    bool op_number_inplace(enum Sass_OP op, Number& lhs, const Number& rhs)
+    {
+      double rval = rhs.value();
+      if ((op == Sass_OP::MOD || op == Sass_OP::DIV) && rval == 0) return false;
+      size_t l_n_units = lhs.numerators.size();
+      size_t l_d_units = lhs.numerators.size();
+      size_t r_n_units = rhs.denominators.size();
+      size_t r_d_units = rhs.denominators.size();
+      if (l_n_units != r_n_units || l_d_units != r_d_units) return false;
+      if (l_n_units + l_d_units > 1 || r_n_units + r_d_units > 1) return false;
+      if (lhs.numerators != rhs.numerators) return false;
+      if (lhs.denominators != rhs.denominators) return false;
+      lhs.value(ops[op](lhs.value(), rval));
+      return true;
+    }
+
     /* static function, throws OperationError, has no traces but optional pstate for returned value */
     Value* op_numbers(enum Sass_OP op, const Number& lhs, const Number& rhs, struct Sass_Inspect_Options opt, const ParserState& pstate, bool delayed)
     {
@@ -5,24 +5,24 @@ namespace Sass {
 
   // ##########################################################################
   // Very simple and limited container for insert ordered hash map.
-  // Piggy-back implementation on std::unordered_map and std::vector
+  // Values live in one contiguous vector (the extend resolution loops
+  // walk [values] far more often than they probe by key); the hash map
+  // only stores indices into it, so each value exists exactly once.
   // ##########################################################################
   template<
     class Key,
     class T,
     class Hash = std::hash<Key>,
     class KeyEqual = std::equal_to<Key>,
-    class Allocator = std::allocator<std::pair<const Key, T>>
+    class Allocator = std::allocator<std::pair<const Key, size_t>>
   >
   class ordered_map {
 
   private:
 
-    using map_type = typename std::unordered_map< Key, T, Hash, KeyEqual, Allocator>;
-    using map_iterator = typename std::unordered_map< Key, T, Hash, KeyEqual, Allocator>::iterator;
-    using map_const_iterator = typename std::unordered_map< Key, T, Hash, KeyEqual, Allocator>::const_iterator;
+    using map_type = typename std::unordered_map< Key, size_t, Hash, KeyEqual, Allocator>;
 
-    // The main unordered map
+    // Maps keys to positions in the value vector
     map_type _map;
 
     // Keep insertion order
@@ -57,11 +57,15 @@ namespace Sass {
     }
 
     void insert(const Key& key, const T& val) {
-      if (!hasKey(key)) {
+      auto it = _map.find(key);
+      if (it == _map.end()) {
+        _map[key] = _values.size();
         _values.push_back(val);
         _keys.push_back(key);
       }
-      _map[key] = val;
+      else {
+        _values[it->second] = val;
+      }
     }
 
     bool hasKey(const Key& key) const {
@@ -69,24 +73,26 @@ namespace Sass {
     }
 
     bool erase(const Key& key) {
-      _map.erase(key);
-      // find the position in the array
-      for (size_t i = 0; i < _keys.size(); i += 1) {
-        if (_keyEqual(key, _keys[i])) {
-          _keys.erase(_keys.begin() + i);
-          _values.erase(_values.begin() + i);
-          return true;
-        }
+      auto it = _map.find(key);
+      if (it == _map.end()) return false;
+      size_t idx = it->second;
+      _map.erase(it);
+      _keys.erase(_keys.begin() + idx);
+      _values.erase(_values.begin() + idx);
+      // entries behind the erased slot moved up one position
+      for (auto& entry : _map) {
+        if (entry.second > idx) entry.second -= 1;
       }
-      return false;
+      return true;
     }
 
     const std::vector<Key>& keys() const { return _keys; }
     const std::vector<T>& values() const { return _values; }
 
     const T& get(const Key& key) {
-      if (hasKey(key)) {
-        return _map[key];
+      auto it = _map.find(key);
+      if (it != _map.end()) {
+        return _values[it->second];
       }
       throw std::runtime_error("Key does not exist");
     }
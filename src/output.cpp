@@ -11,11 +11,56 @@ namespace Sass {
   Output::Output(Sass_Output_Options& opt)
   : Inspect(Emitter(opt)),
     charset(""),
-    top_nodes(0)
+    top_nodes(0),
+    hoist_comments(true)
   {}
 
   Output::~Output() { }
 
+  // fold a continuation chunk rendered by another output into this
+  // one: hoisted nodes keep their document order and the chunk
+  // mappings are rebased onto the end of our buffer
+  void Output::merge_chunk(Output& chunk)
+  {
+    // the first indented statement of the chunk would have
+    // collapsed a pending blank line between top level groups
+    if (scheduled_linefeed > 1 && chunk.collapses_boundary_linefeed)
+      scheduled_linefeed = 1;
+    // a pending space or linefeed flushes here exactly like the
+    // first append of the next statement would have flushed it
+    flush_schedules();
+    top_nodes.insert(top_nodes.end(),
+      chunk.top_nodes.begin(), chunk.top_nodes.end());
+    append_output(chunk.wbuf);
+    // adopt the trailing schedule of the chunk so finalize sees
+    // the same state as after an uninterrupted render
+    scheduled_space = chunk.scheduled_space;
+    scheduled_linefeed = chunk.scheduled_linefeed;
+    scheduled_delimiter = chunk.scheduled_delimiter;
+  }
+
+  // hash key for a declaration-only rule body at the current
+  // indentation; zero disqualifies the block from the memo
+  size_t Output::declaration_body_key(Block* b)
+  {
+    size_t key = std::hash<size_t>()(indentation);
+    for (size_t i = 0, L = b->length(); i < L; ++i) {
+      Declaration* dec = Cast<Declaration>(b->get(i));
+      if (dec == nullptr) return 0;
+      size_t prop = dec->property() ? dec->property()->hash() : 0;
+      size_t value = dec->value() ? dec->value()->hash() : 0;
+      // nodes without a hash implementation report zero; they
+      // cannot be told apart, so such bodies render normally
+      if (prop == 0 || value == 0) return 0;
+      hash_combine(key, prop);
+      hash_combine(key, value);
+      hash_combine(key, std::hash<bool>()(dec->is_important()));
+      hash_combine(key, std::hash<bool>()(dec->is_custom_property()));
+      hash_combine(key, std::hash<size_t>()(dec->tabs()));
+    }
+    return key == 0 ? 1 : key;
+  }
+
   void Output::fallback_impl(AST_Node* n)
   {
     return n->perform(this);
@@ -46,10 +91,13 @@ namespace Sass {
     throw Exception::InvalidValue({}, *m);
   }
 
-  OutputBuffer Output::get_buffer(void)
+  OutputBuffer& Output::get_buffer(void)
   {
 
     Emitter emitter(opt);
+    // keep mappings for the hoisted top nodes consistent
+    // with whatever the main emitter is collecting
+    emitter.set_srcmap_enabled(srcmap_enabled);
     Inspect inspect(emitter);
 
     size_t size_nodes = top_nodes.size();
@@ -69,18 +117,14 @@ namespace Sass {
       if (!wbuf.buffer.empty()) append_string(opt.linefeed);
     }
 
-    // search for unicode char
-    for(const char& chr : wbuf.buffer) {
-      // skip all ascii chars
-      // static cast to unsigned to handle `char` being signed / unsigned
-      if (static_cast<unsigned>(chr) < 128) continue;
+    // the emitter tracked non-ascii bytes while appending,
+    // so no scan over the finished buffer is needed here
+    if (wbuf.has_non_ascii) {
       // declare the charset
       if (output_style() != COMPRESSED)
         charset = "@charset \"UTF-8\";"
                 + std::string(opt.linefeed);
       else charset = "\xEF\xBB\xBF";
-      // abort search
-      break;
     }
 
     // add charset as first line, before comments and imports
@@ -95,7 +139,7 @@ namespace Sass {
     // if (indentation && txt == "/**/") return;
     bool important = c->is_important();
     if (output_style() != COMPRESSED || important) {
-      if (buffer().size() == 0) {
+      if (buffer().size() == 0 && hoist_comments) {
         top_nodes.push_back(c);
       } else {
         in_comment = true;
@@ -111,6 +155,114 @@ namespace Sass {
     }
   }
 
+  // Whether two evaluated values render to the same bytes. The
+  // value operator== implements sass equality, which is looser
+  // than render equality (10mm == 1cm, "str" == str, red ==
+  // #ff0000 all hold but render differently), so the byte memos
+  // below need this stricter walk to verify a hash match. Value
+  // kinds the walk does not know simply render normally.
+  static bool renders_same_value(Expression* a, Expression* b)
+  {
+    if (a == b) return true;
+    if (a == 0 || b == 0) return false;
+    if (Number* na = Cast<Number>(a)) {
+      Number* nb = Cast<Number>(b);
+      return nb != 0
+          && na->value() == nb->value()
+          && na->numerators == nb->numerators
+          && na->denominators == nb->denominators;
+    }
+    if (Color_RGBA* ca = Cast<Color_RGBA>(a)) {
+      Color_RGBA* cb = Cast<Color_RGBA>(b);
+      // colors remember the authored spelling in disp
+      return cb != 0
+          && ca->r() == cb->r() && ca->g() == cb->g()
+          && ca->b() == cb->b() && ca->a() == cb->a()
+          && ca->disp() == cb->disp();
+    }
+    if (String_Quoted* qa = Cast<String_Quoted>(a)) {
+      String_Quoted* qb = Cast<String_Quoted>(b);
+      return qb != 0
+          && qa->quote_mark() == qb->quote_mark()
+          && qa->value() == qb->value();
+    }
+    if (String_Constant* sa = Cast<String_Constant>(a)) {
+      String_Constant* sb = Cast<String_Constant>(b);
+      // a quoted b was not matched above, so reject it here
+      return sb != 0 && !Cast<String_Quoted>(b)
+          && sa->value() == sb->value();
+    }
+    if (List* la = Cast<List>(a)) {
+      List* lb = Cast<List>(b);
+      if (lb == 0
+          || la->length() != lb->length()
+          || la->separator() != lb->separator()
+          || la->is_bracketed() != lb->is_bracketed()) return false;
+      for (size_t i = 0, L = la->length(); i < L; ++i) {
+        if (!renders_same_value(la->get(i), lb->get(i))) return false;
+      }
+      return true;
+    }
+    if (Boolean* ba = Cast<Boolean>(a)) {
+      Boolean* bb = Cast<Boolean>(b);
+      return bb != 0 && ba->value() == bb->value();
+    }
+    if (Cast<Null>(a)) {
+      return Cast<Null>(b) != 0;
+    }
+    return false;
+  }
+
+  // the declaration-body counterpart: blocks render the same when
+  // every declaration matches in property, flags and exact value
+  static bool renders_same_body(Block* a, Block* b)
+  {
+    if (a == b) return true;
+    if (a == 0 || b == 0) return false;
+    if (a->length() != b->length()) return false;
+    for (size_t i = 0, L = a->length(); i < L; ++i) {
+      Declaration* da = Cast<Declaration>(a->get(i));
+      Declaration* db = Cast<Declaration>(b->get(i));
+      if (da == 0 || db == 0) return false;
+      if (da->is_important() != db->is_important()) return false;
+      if (da->is_custom_property() != db->is_custom_property()) return false;
+      if (da->tabs() != db->tabs()) return false;
+      if (!renders_same_value(da->property(), db->property())) return false;
+      if (!renders_same_value(da->value(), db->value())) return false;
+    }
+    return true;
+  }
+
+  // the supports-condition counterpart: walk the condition tree
+  // node for node, comparing the evaluated leaves exactly
+  static bool renders_same_condition(Supports_Condition* a, Supports_Condition* b)
+  {
+    if (a == b) return true;
+    if (a == 0 || b == 0) return false;
+    if (Supports_Operator* oa = Cast<Supports_Operator>(a)) {
+      Supports_Operator* ob = Cast<Supports_Operator>(b);
+      return ob != 0 && oa->operand() == ob->operand()
+          && renders_same_condition(oa->left(), ob->left())
+          && renders_same_condition(oa->right(), ob->right());
+    }
+    if (Supports_Negation* na = Cast<Supports_Negation>(a)) {
+      Supports_Negation* nb = Cast<Supports_Negation>(b);
+      return nb != 0
+          && renders_same_condition(na->condition(), nb->condition());
+    }
+    if (Supports_Declaration* da = Cast<Supports_Declaration>(a)) {
+      Supports_Declaration* db = Cast<Supports_Declaration>(b);
+      return db != 0
+          && renders_same_value(da->feature(), db->feature())
+          && renders_same_value(da->value(), db->value());
+    }
+    if (Supports_Interpolation* ia = Cast<Supports_Interpolation>(a)) {
+      Supports_Interpolation* ib = Cast<Supports_Interpolation>(b);
+      return ib != 0 && renders_same_value(ia->value(), ib->value());
+    }
+    return false;
+  }
+
   void Output::operator()(Ruleset* r)
   {
     Block_Obj b = r->block();
@@ -135,16 +287,50 @@ namespace Sass {
       indentation += r->tabs();
     }
     if (opt.source_comments) {
-      std::stringstream ss;
       append_indentation();
       std::string path(File::abs2rel(r->pstate().path));
-      ss << "/* line " << r->pstate().line + 1 << ", " << path << " */";
-      append_string(ss.str());
+      std::string comment("/* line ");
+      comment += std::to_string(r->pstate().line + 1);
+      comment += ", "; comment += path; comment += " */";
+      append_string(comment);
       append_optional_linefeed();
     }
     scheduled_crutch = s;
     if (s) s->perform(this);
+    // source maps and source comments need per-node positions,
+    // so only plain byte reuse qualifies for the body memo
+    size_t body_key = 0;
+#ifndef SASS_THREADSAFE_REFCOUNT
+    // hashing fills lazy memos on nodes that partitioned renders
+    // share between threads, so the memo stays off in that build
+    if (!srcmap_enabled && !opt.source_comments) {
+      body_key = declaration_body_key(b);
+    }
+#endif
     append_scope_opener(b);
+    auto cached = body_key
+      ? body_cache.find(body_key)
+      : body_cache.end();
+    // a verification miss falls through and renders normally,
+    // handing the colliding slot to the newer body below
+    if (body_key && cached != body_cache.end() &&
+        renders_same_body(cached->second.block, b)) {
+      const RenderedBody& body = cached->second;
+      // the first append of the body flushed the linefeed the
+      // scope opener scheduled, so the captured bytes already
+      // contain it; drop the pending schedule before splicing
+      scheduled_space = 0;
+      scheduled_linefeed = 0;
+      scheduled_delimiter = false;
+      wbuf.buffer += body.bytes;
+      wbuf.has_non_ascii |= body.has_non_ascii;
+      // leave the emitter exactly as the first render did
+      scheduled_space = body.scheduled_space;
+      scheduled_linefeed = body.scheduled_linefeed;
+      scheduled_delimiter = body.scheduled_delimiter;
+    }
+    else {
+    size_t body_start = wbuf.buffer.size();
     for (size_t i = 0, L = b->length(); i < L; ++i) {
       Statement_Obj stm = b->get(i);
       bool bPrintExpression = true;
@@ -172,6 +358,23 @@ namespace Sass {
         stm->perform(this);
       }
     }
+    if (body_key) {
+      RenderedBody body;
+      body.block = b;
+      body.bytes = wbuf.buffer.substr(body_start);
+      body.has_non_ascii = false;
+      for (const char& chr : body.bytes) {
+        if (static_cast<unsigned char>(chr) > 127) {
+          body.has_non_ascii = true;
+          break;
+        }
+      }
+      body.scheduled_space = scheduled_space;
+      body.scheduled_linefeed = scheduled_linefeed;
+      body.scheduled_delimiter = scheduled_delimiter;
+      body_cache[body_key] = std::move(body);
+    }
+    }
     if (output_style() == NESTED) indentation -= r->tabs();
     append_scope_closer(b);
 
@@ -221,7 +424,46 @@ namespace Sass {
     append_indentation();
     append_token("@supports", f);
     append_mandatory_space();
-    c->perform(this);
+    // conditions carry no linefeeds, so cached bytes can be
+    // spliced verbatim; per-node positions rule the memo out
+    // just like they do for the declaration body memo above
+    size_t cond_key = 0;
+#ifndef SASS_THREADSAFE_REFCOUNT
+    if (!srcmap_enabled && !opt.source_comments) {
+      cond_key = c->hash();
+    }
+#endif
+    if (cond_key) {
+      // materialize the pending space here so the captured
+      // bytes start right at the first condition token
+      flush_schedules();
+      auto cached = condition_cache.find(cond_key);
+      // a verification miss falls through and renders normally,
+      // handing the colliding slot to the newer condition below
+      if (cached != condition_cache.end() &&
+          renders_same_condition(cached->second.condition, c)) {
+        wbuf.buffer += cached->second.bytes;
+        wbuf.has_non_ascii |= cached->second.has_non_ascii;
+      }
+      else {
+        size_t cond_start = wbuf.buffer.size();
+        c->perform(this);
+        RenderedCondition cond;
+        cond.condition = c;
+        cond.bytes = wbuf.buffer.substr(cond_start);
+        cond.has_non_ascii = false;
+        for (const char& chr : cond.bytes) {
+          if (static_cast<unsigned char>(chr) > 127) {
+            cond.has_non_ascii = true;
+            break;
+          }
+        }
+        condition_cache[cond_key] = std::move(cond);
+      }
+    }
+    else {
+      c->perform(this);
+    }
     append_scope_opener();
 
     for (size_t i = 0, L = b->length(); i < L; ++i) {
@@ -299,7 +541,7 @@ namespace Sass {
   void Output::operator()(String_Quoted* s)
   {
     if (s->quote_mark()) {
-      append_token(quote(s->value(), s->quote_mark()), s);
+      append_token(s->quoted(s->quote_mark()), s);
     } else if (!in_comment) {
       append_token(string_to_output(s->value()), s);
     } else {
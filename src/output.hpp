@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
 
 #include "util.hpp"
 #include "inspect.hpp"
@@ -23,8 +24,51 @@ namespace Sass {
     std::string charset;
     std::vector<AST_Node*> top_nodes;
 
+    // rendered bytes of a declaration-only rule body plus the
+    // emitter schedule it left behind; utility-heavy sheets
+    // repeat byte-identical bodies thousands of times and this
+    // lets repeats splice the first render instead of redoing it
+    struct RenderedBody {
+      // the block the bytes were rendered from; a key match is
+      // only a hash and cannot be trusted alone, so every hit
+      // re-checks the blocks for exact render equality
+      Block_Obj block;
+      std::string bytes;
+      bool has_non_ascii;
+      bool scheduled_delimiter;
+      size_t scheduled_space;
+      size_t scheduled_linefeed;
+    };
+    std::unordered_map<size_t, RenderedBody> body_cache;
+
+    // memo key for the body of [b] at the current indentation;
+    // zero means the block does not qualify (only plain
+    // declarations with hashable contents are memoized)
+    size_t declaration_body_key(Block* b);
+
+    // rendered bytes of a supports condition; progressive
+    // enhancement layers repeat the same few conditions across
+    // hundreds of blocks, so repeats splice the first render
+    struct RenderedCondition {
+      // the condition the bytes were rendered from; as with the
+      // body memo above, a hash match alone cannot be trusted,
+      // so every hit re-walks the condition trees
+      Supports_Condition_Obj condition;
+      std::string bytes;
+      bool has_non_ascii;
+    };
+    std::unordered_map<size_t, RenderedCondition> condition_cache;
+
   public:
-    OutputBuffer get_buffer(void);
+    // whether comments emitted before any other output move to
+    // the document top; continuation chunks of a partitioned
+    // render disable this since output precedes them already
+    bool hoist_comments;
+
+    OutputBuffer& get_buffer(void);
+
+    // fold a chunk rendered by another output into this one
+    void merge_chunk(Output& chunk);
 
     virtual void operator()(Map*);
     virtual void operator()(Ruleset*);
@@ -4,6 +4,7 @@
 
 #include "parser.hpp"
 #include "color_maps.hpp"
+#include "operators.hpp"
 #include "util_string.hpp"
 
 // Notes about delayed: some ast nodes can have delayed evaluation so
@@ -61,9 +62,25 @@ namespace Sass {
 
   SelectorListObj Parser::parse_selector(const char* beg, Context& ctx, Backtraces traces, ParserState pstate, const char* source, bool allow_parent)
   {
+    // the selector builtins funnel through here and re-parse the
+    // same text on every call, so results share the per-context
+    // selector cache. the position tags the key like the schema
+    // cache does, and the callers mutate what they get back, so
+    // both directions hand out deep clones of the pristine parse
+    std::string key(beg);
+    key += allow_parent ? "|s1|" : "|s0|";
+    key += std::to_string(pstate.file);
+    key += ':'; key += std::to_string(pstate.line);
+    key += ':'; key += std::to_string(pstate.column);
+    auto cached = ctx.parsed_selector_cache.find(key);
+    if (cached != ctx.parsed_selector_cache.end()) {
+      return SASS_MEMORY_CLONE(cached->second);
+    }
     Parser p = Parser::from_c_str(beg, ctx, traces, pstate, source, allow_parent);
     // ToDo: remap the source-map entries somehow
-    return p.parseSelectorList(false);
+    SelectorListObj parsed = p.parseSelectorList(false);
+    ctx.parsed_selector_cache[key] = SASS_MEMORY_CLONE(parsed);
+    return parsed;
   }
 
   bool Parser::peek_newline(const char* start)
@@ -91,8 +108,11 @@ namespace Sass {
     // consume unicode BOM
     read_bom();
 
-    // scan the input to find invalid utf8 sequences
-    const char* it = utf8::find_invalid(position, end);
+    // scan the input to find invalid utf8 sequences; sources
+    // tagged ascii-only at registration are known to be valid
+    bool ascii = pstate.file < ctx.resources.size()
+              && ctx.resources[pstate.file].ascii;
+    const char* it = ascii ? end : utf8::find_invalid(position, end);
 
     // report invalid utf8
     if (it != end) {
@@ -102,7 +122,9 @@ namespace Sass {
     }
 
     // create a block AST node to hold children
-    Block_Obj root = SASS_MEMORY_NEW(Block, pstate, 0, true);
+    // (sized by a pre-count of the top level statements)
+    Block_Obj root = SASS_MEMORY_NEW(Block, pstate,
+      estimate_block_statements(position), true);
 
     // check seems a bit esoteric but works
     if (ctx.resources.size() == 1) {
@@ -126,6 +148,38 @@ namespace Sass {
   }
 
 
+  // count ';' and block openers at the current nesting depth to
+  // estimate how many statements the upcoming block will append;
+  // strings and comments are skipped so embedded separators (data
+  // uris, commented out rules) do not inflate the reservation.
+  // the scan is capped so huge blocks stay cheap (an underestimate
+  // only costs a few of the growth steps we otherwise always pay)
+  size_t Parser::estimate_block_statements(const char* p)
+  {
+    size_t count = 0;
+    size_t depth = 0;
+    const char* stop = p + 65536;
+    while (p < end && *p && p < stop) {
+      const char c = *p;
+      if (c == '"' || c == '\'') {
+        if (const char* q = Prelexer::quoted_string(p)) {
+          p = q; continue;
+        }
+      }
+      else if (c == '/' && (p[1] == '*' || p[1] == '/')) {
+        const char* q = p[1] == '*'
+          ? Prelexer::block_comment(p)
+          : Prelexer::line_comment(p);
+        if (q) { p = q; continue; }
+      }
+      else if (c == '{') { if (depth == 0) ++count; ++depth; }
+      else if (c == '}') { if (depth == 0) break; --depth; }
+      else if (c == ';' && depth == 0) ++count;
+      ++p;
+    }
+    return count;
+  }
+
   // convenience function for block parsing
   // will create a new block ad-hoc for you
   // this is the base block parsing function
@@ -140,7 +194,9 @@ namespace Sass {
       css_error("Invalid CSS", " after ", ": expected \"{\", was ");
     }
     // create new block and push to the selector stack
-    Block_Obj block = SASS_MEMORY_NEW(Block, pstate, 0, is_root);
+    // (sized by a pre-count of the statements it will hold)
+    Block_Obj block = SASS_MEMORY_NEW(Block, pstate,
+      estimate_block_statements(position), is_root);
     block_stack.push_back(block);
 
     if (!parse_block_nodes(is_root)) css_error("Invalid CSS", " after ", ": expected \"}\", was ");
@@ -178,6 +234,9 @@ namespace Sass {
     // loop until end of string
     while (position < end) {
 
+      // honor the compile budget between statements
+      ctx.poll_compile_budget();
+
       // we should be able to refactor this
       parse_block_comments();
       lex < css_whitespace >();
@@ -217,19 +276,29 @@ namespace Sass {
 
     // also parse block comments
 
+    // classify the statement by its first character before going
+    // through the keyword chain: white-space and comments were
+    // just consumed, so an at-rule matcher can only succeed when
+    // the statement starts with '@' and the assignment matcher
+    // when it starts with '$'. one comparison filters the whole
+    // chain (and its per-matcher white-space sneaking) for the
+    // declarations and rulesets that make up most of a sheet
+    const bool is_dollar_stmt = *position == '$';
+    const bool is_at_stmt = *position == '@';
+
     // first parse everything that is allowed in functions
-    if (lex < variable >(true)) { block->append(parse_assignment()); }
-    else if (lex < kwd_err >(true)) { block->append(parse_error()); }
-    else if (lex < kwd_dbg >(true)) { block->append(parse_debug()); }
-    else if (lex < kwd_warn >(true)) { block->append(parse_warning()); }
-    else if (lex < kwd_if_directive >(true)) { block->append(parse_if_directive()); }
-    else if (lex < kwd_for_directive >(true)) { block->append(parse_for_directive()); }
-    else if (lex < kwd_each_directive >(true)) { block->append(parse_each_directive()); }
-    else if (lex < kwd_while_directive >(true)) { block->append(parse_while_directive()); }
-    else if (lex < kwd_return_directive >(true)) { block->append(parse_return_directive()); }
+    if (is_dollar_stmt && lex < variable >(true)) { block->append(parse_assignment()); }
+    else if (is_at_stmt && lex < kwd_err >(true)) { block->append(parse_error()); }
+    else if (is_at_stmt && lex < kwd_dbg >(true)) { block->append(parse_debug()); }
+    else if (is_at_stmt && lex < kwd_warn >(true)) { block->append(parse_warning()); }
+    else if (is_at_stmt && lex < kwd_if_directive >(true)) { block->append(parse_if_directive()); }
+    else if (is_at_stmt && lex < kwd_for_directive >(true)) { block->append(parse_for_directive()); }
+    else if (is_at_stmt && lex < kwd_each_directive >(true)) { block->append(parse_each_directive()); }
+    else if (is_at_stmt && lex < kwd_while_directive >(true)) { block->append(parse_while_directive()); }
+    else if (is_at_stmt && lex < kwd_return_directive >(true)) { block->append(parse_return_directive()); }
 
     // parse imports to process later
-    else if (lex < kwd_import >(true)) {
+    else if (is_at_stmt && lex < kwd_import >(true)) {
       Scope parent = stack.empty() ? Scope::Rules : stack.back();
       if (parent != Scope::Function && parent != Scope::Root && parent != Scope::Rules && parent != Scope::Media) {
         if (! peek_css< uri_prefix >(position)) { // this seems to go in ruby sass 3.4.20
@@ -247,7 +316,7 @@ namespace Sass {
       }
     }
 
-    else if (lex < kwd_extend >(true)) {
+    else if (is_at_stmt && lex < kwd_extend >(true)) {
       Lookahead lookahead = lookahead_for_include(position);
       if (!lookahead.found) css_error("Invalid CSS", " after ", ": expected selector, was ");
       SelectorListObj target;
@@ -279,21 +348,21 @@ namespace Sass {
     }
 
     // parse multiple specific keyword directives
-    else if (lex < kwd_media >(true)) { block->append(parseMediaRule()); }
-    else if (lex < kwd_at_root >(true)) { block->append(parse_at_root_block()); }
-    else if (lex < kwd_include_directive >(true)) { block->append(parse_include_directive()); }
-    else if (lex < kwd_content_directive >(true)) { block->append(parse_content_directive()); }
-    else if (lex < kwd_supports_directive >(true)) { block->append(parse_supports_directive()); }
-    else if (lex < kwd_mixin >(true)) { block->append(parse_definition(Definition::MIXIN)); }
-    else if (lex < kwd_function >(true)) { block->append(parse_definition(Definition::FUNCTION)); }
+    else if (is_at_stmt && lex < kwd_media >(true)) { block->append(parseMediaRule()); }
+    else if (is_at_stmt && lex < kwd_at_root >(true)) { block->append(parse_at_root_block()); }
+    else if (is_at_stmt && lex < kwd_include_directive >(true)) { block->append(parse_include_directive()); }
+    else if (is_at_stmt && lex < kwd_content_directive >(true)) { block->append(parse_content_directive()); }
+    else if (is_at_stmt && lex < kwd_supports_directive >(true)) { block->append(parse_supports_directive()); }
+    else if (is_at_stmt && lex < kwd_mixin >(true)) { block->append(parse_definition(Definition::MIXIN)); }
+    else if (is_at_stmt && lex < kwd_function >(true)) { block->append(parse_definition(Definition::FUNCTION)); }
 
     // ignore the @charset directive for now
-    else if (lex< kwd_charset_directive >(true)) { parse_charset_directive(); }
+    else if (is_at_stmt && lex< kwd_charset_directive >(true)) { parse_charset_directive(); }
 
-    else if (lex < exactly < else_kwd >>(true)) { error("Invalid CSS: @else must come after @if"); }
+    else if (is_at_stmt && lex < exactly < else_kwd >>(true)) { error("Invalid CSS: @else must come after @if"); }
 
     // generic at keyword (keep last)
-    else if (lex< at_keyword >(true)) { block->append(parse_directive()); }
+    else if (is_at_stmt && lex< at_keyword >(true)) { block->append(parse_directive()); }
 
     else if (is_root && stack.back() != Scope::AtRoot /* && block->is_root() */) {
       lex< css_whitespace >();
@@ -367,6 +436,17 @@ namespace Sass {
       imp->import_queries(import_queries);
     }
 
+    // hand prefetch-capable importers the whole url list up front,
+    // so a remote importer can overlap its fetches while the urls
+    // below still resolve strictly one by one and in order
+    if (!ctx.c_importers.empty()) {
+      std::vector<std::string> plain;
+      for (auto& location : to_import) {
+        if (!location.second) plain.push_back(unquote(location.first));
+      }
+      ctx.announce_imports(plain);
+    }
+
     for(auto location : to_import) {
       if (location.second) {
         imp->urls().push_back(location.second);
@@ -698,6 +778,8 @@ namespace Sass {
       return parse_attribute_selector();
     }
     else if (lex< placeholder >()) {
+      // remember so compile() knows the removal pass has work to do
+      ctx.seen_placeholders = true;
       return SASS_MEMORY_NEW(Placeholder_Selector, pstate, lexed);
     }
     else {
@@ -763,7 +845,9 @@ namespace Sass {
           }
         }
         else {
-          if (peek_css< exactly<')'>>()  && Util::equalsLiteral("nth-", name.substr(0, 4))) {
+          // equalsLiteral only inspects the literal's length, so
+          // no substring needs to be carved off for a prefix test
+          if (peek_css< exactly<')'>>()  && Util::equalsLiteral("nth-", name)) {
             css_error("Invalid CSS", " after ", ": expected An+B expression, was ");
           }
 
@@ -874,6 +958,22 @@ namespace Sass {
     }
   }
 
+  // return a shared node for a plain property name: the same few
+  // names repeat across most declarations of a file, so repeats
+  // reuse one node (evaluating a plain constant is the identity,
+  // and its cached hash and rendering warm up once). the shared
+  // node carries the position of the first occurrence, which is
+  // why interning stays off while source maps are collected
+  String_Obj Parser::intern_property(const std::string& name)
+  {
+    if (ctx.emitter.srcmap_enabled) {
+      return SASS_MEMORY_NEW(String_Constant, pstate, lexed);
+    }
+    String_Constant_Obj& slot = prop_interns[name];
+    if (slot.isNull()) slot = SASS_MEMORY_NEW(String_Constant, pstate, lexed);
+    return slot;
+  }
+
   Declaration_Obj Parser::parse_declaration() {
     String_Obj prop;
     bool is_custom_property = false;
@@ -885,7 +985,11 @@ namespace Sass {
     else if (lex< sequence< optional< exactly<'*'> >, identifier, zero_plus< block_comment > > >()) {
       const std::string property(lexed);
       is_custom_property = property.compare(0, 2, "--") == 0;
-      prop = SASS_MEMORY_NEW(String_Constant, pstate, lexed);
+      // custom properties keep their own node (their position is
+      // reported in errors), everything else can share one
+      prop = is_custom_property
+           ? SASS_MEMORY_NEW(String_Constant, pstate, lexed)
+           : intern_property(property);
     }
     else {
       css_error("Invalid CSS", " after ", ": expected \"}\", was ");
@@ -1344,11 +1448,13 @@ namespace Sass {
 
   bool number_has_zero(const std::string& parsed)
   {
+    // runs for every lexed number; inspect the characters in
+    // place instead of carving off substrings to compare
     size_t L = parsed.length();
-    return !( (L > 0 && parsed.substr(0, 1) == ".") ||
-              (L > 1 && parsed.substr(0, 2) == "0.") ||
-              (L > 1 && parsed.substr(0, 2) == "-.")  ||
-              (L > 2 && parsed.substr(0, 3) == "-0.") );
+    return !( (L > 0 && parsed[0] == '.') ||
+              (L > 1 && parsed[0] == '0' && parsed[1] == '.') ||
+              (L > 1 && parsed[0] == '-' && parsed[1] == '.')  ||
+              (L > 2 && parsed[0] == '-' && parsed[1] == '0' && parsed[2] == '.') );
   }
 
   Number* Parser::lexed_number(const ParserState& pstate, const std::string& parsed)
@@ -1993,7 +2099,7 @@ namespace Sass {
     lex< identifier >();
     std::string name(lexed);
 
-    if (Util::normalize_underscores(name) == "content-exists" && stack.back() != Scope::Mixin)
+    if (Util::equalsNormalized("content-exists", name) && stack.back() != Scope::Mixin)
     { error("Cannot call content-exists() except within a mixin."); }
 
     ParserState call_pos = pstate;
@@ -2072,7 +2178,7 @@ namespace Sass {
       css_error("Invalid CSS", " after ", ": expected identifier, was ");
     }
     // return object
-    return token;
+    return lexed;
   }
   // helper to parse identifier
   Token Parser::lex_identifier()
@@ -2082,7 +2188,7 @@ namespace Sass {
       css_error("Invalid CSS", " after ", ": expected identifier, was ");
     }
     // return object
-    return token;
+    return lexed;
   }
 
   Each_Obj Parser::parse_each_directive()
@@ -2127,9 +2233,9 @@ namespace Sass {
   }
 
 
-  std::vector<CssMediaQuery_Obj> Parser::parseCssMediaQueries()
+  PoolVector<CssMediaQuery_Obj> Parser::parseCssMediaQueries()
   {
-    std::vector<CssMediaQuery_Obj> result;
+    PoolVector<CssMediaQuery_Obj> result;
     do {
       if (auto query = parseCssMediaQuery()) {
         result.push_back(query);
@@ -2624,6 +2730,9 @@ namespace Sass {
     Lookahead rv = Lookahead();
     // get start position
     const char* p = start ? start : position;
+    // reuse the result when we scanned here before
+    auto memo = memo_selector_lookahead.find(p);
+    if (memo != memo_selector_lookahead.end()) return memo->second;
     // match in one big "regex"
     rv.error = p;
     if (const char* q =
@@ -2665,6 +2774,9 @@ namespace Sass {
 
     rv.parsable = ! rv.has_interpolants;
 
+    // remember result for backtracking alternatives
+    memo_selector_lookahead[start ? start : position] = rv;
+
     // return result
     return rv;
 
@@ -2698,6 +2810,10 @@ namespace Sass {
     Lookahead rv = Lookahead();
     // get start position
     const char* p = start ? start : position;
+    // reuse the result when we scanned here before
+    const char* key = p;
+    auto memo = memo_value_lookahead.find(key);
+    if (memo != memo_value_lookahead.end()) return memo->second;
     // match in one big "regex"
     if (const char* q =
       peek <
@@ -2735,7 +2851,10 @@ namespace Sass {
         >
       >(p)
     ) {
-      if (p == q) return rv;
+      if (p == q) {
+        memo_value_lookahead[key] = rv;
+        return rv;
+      }
       while (p < q) {
         // did we have interpolations?
         if (*p == '#' && *(p+1) == '{') {
@@ -2754,6 +2873,9 @@ namespace Sass {
       else if (peek < exactly<'}'> >(q)) rv.found = q;
     }
 
+    // remember result for backtracking alternatives
+    memo_value_lookahead[key] = rv;
+
     // return result
     return rv;
   }
@@ -2828,9 +2950,37 @@ namespace Sass {
   }
 
 
+  // collapse literal numeric arithmetic while folding; mixin and
+  // function bodies are re-evaluated on every call, so reducing a
+  // constant subtree once here saves that work per expansion.
+  // returns null when the expression must be kept for the evaluator
+  Expression_Obj Parser::fold_constants(const ParserState& pstate, Operand op, Expression_Obj lhs, Expression_Obj rhs)
+  {
+    // division doubles as a literal separator and modulo can hit
+    // divide-by-zero; both stay with the evaluator, as does
+    // anything delayed or not a plain numeric literal
+    if (op.operand != Sass_OP::ADD &&
+        op.operand != Sass_OP::SUB &&
+        op.operand != Sass_OP::MUL) return {};
+    Number* l = Cast<Number>(lhs);
+    Number* r = Cast<Number>(rhs);
+    if (!l || !r) return {};
+    if (lhs->is_delayed() || rhs->is_delayed()) return {};
+    try {
+      return Operators::op_numbers(op.operand, *l, *r, ctx.c_options, pstate);
+    }
+    // incompatible units must error during evaluation with
+    // a proper backtrace; keep the node exactly as parsed
+    catch (...) { return {}; }
+  }
+
   Expression_Obj Parser::fold_operands(Expression_Obj base, std::vector<Expression_Obj>& operands, Operand op)
   {
     for (size_t i = 0, S = operands.size(); i < S; ++i) {
+      if (Expression_Obj folded = fold_constants(base->pstate(), op, base, operands[i])) {
+        base = folded;
+        continue;
+      }
       base = SASS_MEMORY_NEW(Binary_Expression, base->pstate(), op, base, operands[i]);
     }
     return base;
@@ -2872,9 +3022,13 @@ namespace Sass {
           }
           base = SASS_MEMORY_NEW(Binary_Expression, base->pstate(), ops[i], base, operands[i]);
           return base;
+        } else if (Expression_Obj folded = fold_constants(base->pstate(), ops[i], base, operands[i])) {
+          base = folded;
         } else {
           base = SASS_MEMORY_NEW(Binary_Expression, base->pstate(), ops[i], base, operands[i]);
         }
+      } else if (Expression_Obj folded = fold_constants(base->pstate(), ops[i], base, operands[i])) {
+        base = folded;
       } else {
         base = SASS_MEMORY_NEW(Binary_Expression, base->pstate(), ops[i], base, operands[i]);
       }
@@ -7,6 +7,7 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
 
 #include "ast.hpp"
 #include "position.hpp"
@@ -55,10 +56,15 @@ namespace Sass {
 
     Token lexed;
 
+    // shared nodes for plain property names (see intern_property);
+    // per parser, so positions never leave the file being parsed
+    std::unordered_map<std::string, String_Constant_Obj> prop_interns;
+
     Parser(Context& ctx, const ParserState& pstate, Backtraces traces, bool allow_parent = true)
     : ParserState(pstate), ctx(ctx), block_stack(), stack(0),
       source(0), position(0), end(0), before_token(pstate), after_token(pstate),
-      pstate(pstate), traces(traces), indentation(0), nestings(0), allow_parent(allow_parent)
+      pstate(pstate), traces(traces), indentation(0), nestings(0), allow_parent(allow_parent),
+      prop_interns()
     {
       stack.push_back(Scope::Root);
     }
@@ -117,6 +123,34 @@ namespace Sass {
 
     }
 
+    // counting twin of [sneak]: advances [offset] over whatever
+    // it skips, so [lex] gets the position bookkeeping for the
+    // gap from the same pass instead of rescanning those bytes
+    template <Prelexer::prelexer mx>
+    const char* sneak_counted(Offset& offset, const char* start = 0)
+    {
+      using namespace Prelexer;
+
+      // maybe use optional start position from arguments?
+      const char* it_position = start ? start : position;
+
+      // skip white-space?
+      if (mx == spaces ||
+          mx == no_spaces ||
+          mx == css_comments ||
+          mx == css_whitespace ||
+          mx == optional_spaces ||
+          mx == optional_css_comments ||
+          mx == optional_css_whitespace
+      ) {
+        return it_position;
+      }
+
+      // skip over spaces, tabs and sass line comments
+      return optional_css_whitespace_counted(it_position, offset);
+
+    }
+
     // match will not skip over space, tabs and line comment
     // return the position where the lexer match will occur
     template <Prelexer::prelexer mx>
@@ -161,9 +195,13 @@ namespace Sass {
       // lazy developers (but we need control)
       const char* it_before_token = position;
 
+      // line/column bookkeeping for the skipped gap, counted
+      // while sneaking and only applied once the lex succeeds
+      Offset skipped(0, 0);
+
       // sneak up to the actual token we want to lex
       // this should skip over white-space if desired
-      if (lazy) it_before_token = sneak < mx >(position);
+      if (lazy) it_before_token = sneak_counted < mx >(skipped, position);
 
       // now call matcher to get position after token
       const char* it_after_token = mx(it_before_token);
@@ -182,14 +220,16 @@ namespace Sass {
       // create new lexed token object (holds the parse results)
       lexed = Token(position, it_before_token, it_after_token);
 
-      // advance position (add whitespace before current token)
-      before_token = after_token.add(position, it_before_token);
+      // advance position (add whitespace before current token,
+      // already counted while sneaking up to the token itself)
+      after_token += skipped;
+      before_token = after_token;
 
       // update after_token position for current token
       after_token.add(it_before_token, it_after_token);
 
       // ToDo: could probably do this incremental on original object (API wants offset?)
-      pstate = ParserState(path, source, lexed, before_token, after_token - before_token);
+      pstate = ParserState(path, source, before_token, after_token - before_token);
 
       // advance internal char iterator
       return position = it_after_token;
@@ -275,6 +315,7 @@ namespace Sass {
     bool parse_block_node(bool is_root = false);
 
     Declaration_Obj parse_declaration();
+    String_Obj intern_property(const std::string& name);
     Expression_Obj parse_map();
     Expression_Obj parse_bracket_list();
     Expression_Obj parse_list(bool delayed = false);
@@ -305,7 +346,7 @@ namespace Sass {
     Each_Obj parse_each_directive();
     While_Obj parse_while_directive();
     MediaRule_Obj parseMediaRule();
-    std::vector<CssMediaQuery_Obj> parseCssMediaQueries();
+    PoolVector<CssMediaQuery_Obj> parseCssMediaQueries();
     std::string parseIdentifier();
     CssMediaQuery_Obj parseCssMediaQuery();
     Return_Obj parse_return_directive();
@@ -344,10 +385,22 @@ namespace Sass {
 
     void parse_block_comments(bool store = true);
 
+    // cheap pre-count of the statements a block will hold so its
+    // vector can be reserved once instead of growing geometrically
+    size_t estimate_block_statements(const char* p);
+
     Lookahead lookahead_for_value(const char* start = 0);
     Lookahead lookahead_for_selector(const char* start = 0);
     Lookahead lookahead_for_include(const char* start = 0);
 
+    // packrat-style memo tables for the two expensive speculative
+    // lookaheads: the scans are pure functions of the input
+    // position, so when alternatives backtrack over the same text
+    // the recorded result replaces the whole re-scan
+    std::unordered_map<const char*, Lookahead> memo_selector_lookahead;
+    std::unordered_map<const char*, Lookahead> memo_value_lookahead;
+
+    Expression_Obj fold_constants(const ParserState& pstate, Operand op, Expression_Obj lhs, Expression_Obj rhs);
     Expression_Obj fold_operands(Expression_Obj base, std::vector<Expression_Obj>& operands, Operand op);
     Expression_Obj fold_operands(Expression_Obj base, std::vector<Expression_Obj>& operands, std::vector<Operand>& ops, size_t i = 0);
 
@@ -17,9 +17,9 @@ namespace Sass {
   // ```
   // 
   // Note: called `paths` in dart-sass
-  template <class T>
-  std::vector<std::vector<T>> permutate(
-    const std::vector<std::vector<T>>& in)
+  template <class T, class A>
+  std::vector<std::vector<T, A>> permutate(
+    const std::vector<std::vector<T, A>>& in)
   {
 
     size_t L = in.size(), n = 0;
@@ -31,14 +31,14 @@ namespace Sass {
     }
 
     size_t* state = new size_t[L + 1];
-    std::vector<std::vector<T>> out;
+    std::vector<std::vector<T, A>> out;
 
     // First initialize all states for every permutation group
     for (size_t i = 0; i < L; i += 1) {
       state[i] = in[i].size() - 1;
     }
     while (true) {
-      std::vector<T> perm;
+      std::vector<T, A> perm;
       // Create one permutation for state
       for (size_t i = 0; i < L; i += 1) {
         perm.push_back(in.at(i).at(in[i].size() - state[i] - 1));
@@ -74,10 +74,56 @@ namespace Sass {
   }
   // EO permutate
 
+  // Streaming variant of [permutate]. Calls [yield] once per path, in the
+  // same order, instead of materializing the full cross-product; on deep
+  // @extend chains the product can reach tens of thousands of rows of
+  // which most get discarded again. The row buffer is reused between
+  // calls, so the callback must copy anything it wants to keep. Returning
+  // false from [yield] stops the enumeration early.
+  template <class T, class A, class F>
+  void permutateEach(
+    const std::vector<std::vector<T, A>>& in, F yield)
+  {
+
+    size_t L = in.size();
+
+    if (L == 0) return;
+    // Exit early if any entry is empty
+    for (size_t i = 0; i < L; i += 1) {
+      if (in[i].size() == 0) return;
+    }
+
+    std::vector<size_t> state(L, 0);
+
+    // Seed the row with the first choice of every group
+    std::vector<T, A> perm;
+    perm.reserve(L);
+    for (size_t i = 0; i < L; i += 1) {
+      perm.push_back(in[i][0]);
+    }
+
+    while (true) {
+      if (!yield(perm)) return;
+      // Advance the leftmost group; on overflow reset
+      // it and carry into the group to the right
+      size_t n = 0;
+      while (n < L && ++state[n] == in[n].size()) {
+        state[n] = 0;
+        perm[n] = in[n][0];
+        n += 1;
+      }
+      // All groups wrapped around
+      if (n == L) return;
+      perm[n] = in[n][state[n]];
+    }
+
+  }
+  // EO permutateEach
+
   // ToDo: this variant is used in resolve_parent_refs
-  template <class T>
-  std::vector<std::vector<T>>
-    permutateAlt(const std::vector<std::vector<T>>& in) {
+  template <class T, class A>
+  std::vector<std::vector<T, A>>
+    permutateAlt(const std::vector<std::vector<T, A>>& in) {
 
     size_t L = in.size();
     size_t n = in.size() - 1;
@@ -89,7 +135,7 @@ namespace Sass {
     }
 
     size_t* state = new size_t[L];
-    std::vector< std::vector<T>> out;
+    std::vector<std::vector<T, A>> out;
 
     // First initialize all states for every permutation group
     for (size_t i = 0; i < L; i += 1) {
@@ -103,7 +149,7 @@ namespace Sass {
       { // std::cerr << state[p] << " "; }
       // std::cerr << "\n";
       */
-      std::vector<T> perm;
+      std::vector<T, A> perm;
       // Create one permutation for state
       for (size_t i = 0; i < L; i += 1) {
         perm.push_back(in.at(i).at(in[i].size() - state[i] - 1));
@@ -3,6 +3,9 @@
 #include "sass.hpp"
 
 #include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <sys/stat.h>
 #include "output.hpp"
 #include "plugins.hpp"
 #include "util.hpp"
@@ -18,6 +21,26 @@
 
 namespace Sass {
 
+  // Plugin directory listings cached for the process lifetime:
+  // every Context constructs a fresh Plugins instance, so a
+  // per-request compile service re-scans the same directories
+  // thousands of times for an unchanging plugin set. The listing
+  // is revalidated by directory mtime, so dropping in a new
+  // plugin is still picked up without a restart. Library handles
+  // stay resident anyway (loaded plugins are never dlclosed), so
+  // replaying load_plugin over the cached paths costs a refcount
+  // bump plus the per-context entry point calls — those have to
+  // run per Context since each Plugins instance owns and deletes
+  // the function and importer entries it hands out.
+  namespace {
+    struct PluginDirCache {
+      time_t mtime;
+      std::vector<std::string> libs;
+    };
+    std::mutex plugin_cache_mutex;
+    std::unordered_map<std::string, PluginDirCache> plugin_dir_cache;
+  }
+
   Plugins::Plugins(void) { }
   Plugins::~Plugins(void)
   {
@@ -118,6 +141,33 @@ namespace Sass {
     // count plugins
     size_t loaded = 0;
 
+    struct stat dir_stat;
+    const bool can_cache = stat(path.c_str(), &dir_stat) == 0;
+
+    // replay a cached listing if the directory is unchanged
+    if (can_cache) {
+      std::vector<std::string> libs;
+      bool cached = false;
+      {
+        std::lock_guard<std::mutex> lock(plugin_cache_mutex);
+        auto it = plugin_dir_cache.find(path);
+        if (it != plugin_dir_cache.end() && it->second.mtime == dir_stat.st_mtime) {
+          libs = it->second.libs;
+          cached = true;
+        }
+      }
+      if (cached) {
+        // load outside the lock; plugin code may take its time
+        for (const std::string& lib : libs) {
+          if (load_plugin(lib)) ++ loaded;
+        }
+        return loaded;
+      }
+    }
+
+    // remember which libraries actually loaded
+    std::vector<std::string> libs;
+
     #ifdef _WIN32
 
       try
@@ -144,7 +194,7 @@ namespace Sass {
             // check if file ending matches exactly
             if (!ends_with(entry, ".dll")) continue;
             // load the plugin and increase counter
-            if (load_plugin(path + entry)) ++ loaded;
+            if (load_plugin(path + entry)) { ++ loaded; libs.push_back(path + entry); }
             // check if there should be more entries
             if (GetLastError() == ERROR_NO_MORE_FILES) break;
             // load next entry (check for return type)
@@ -176,11 +226,18 @@ namespace Sass {
         #else
           if (!ends_with(dirp->d_name, ".so")) continue;
         #endif
-        if (load_plugin(path + dirp->d_name)) ++ loaded;
+        if (load_plugin(path + dirp->d_name)) { ++ loaded; libs.push_back(path + dirp->d_name); }
       }
       closedir(dp);
 
     #endif
+
+    // cache the listing for the next context
+    if (can_cache) {
+      std::lock_guard<std::mutex> lock(plugin_cache_mutex);
+      plugin_dir_cache[path] = { dir_stat.st_mtime, std::move(libs) };
+    }
+
     return loaded;
 
   }
@@ -43,27 +43,35 @@ namespace Sass {
   Offset Offset::add(const char* begin, const char* end)
   {
     if (end == 0) return *this;
-    while (begin < end && *begin) {
-      if (*begin == '\n') {
-        ++ line;
-        // start new line
-        column = 0;
-      } else {
-        // do not count any utf8 continuation bytes
-        // https://stackoverflow.com/a/9356203/1550314
-        // https://en.wikipedia.org/wiki/UTF-8#Description
-        unsigned char chr = *begin;
-        // skip over 10xxxxxx
-        // is 1st bit not set
-        if ((chr & 128) == 0) {
-          // regular ascii char
-          column += 1;
-        }
-        // is 2nd bit not set
-        else if ((chr & 64) == 0) {
-          // first utf8 byte
-          column += 1;
-        }
+    // stop at embedded nul bytes (as the old
+    // char-by-char loop implicitly did)
+    if (const char* nul = static_cast<const char*>(
+        memchr(begin, 0, end - begin))) {
+      end = nul;
+    }
+    // skip whole lines in bulk; only the portion after the last
+    // line break contributes to the column, so there is no need
+    // to look at any byte before it individually
+    while (const char* nl = static_cast<const char*>(
+           memchr(begin, '\n', end - begin))) {
+      ++ line;
+      // start new line
+      column = 0;
+      begin = nl + 1;
+    }
+    // keep the historical per-byte column accounting: count every
+    // byte except utf8 lead bytes (11xxxxxx), so a three byte
+    // sequence contributes two columns. positions feed error
+    // output and source maps, which downstream tooling consumes,
+    // so the definition must not drift in a perf rewrite
+    // https://en.wikipedia.org/wiki/UTF-8#Description
+    while (begin < end) {
+      // skip over 11xxxxxx
+      unsigned char chr = *begin;
+      if ((chr & 0xC0) != 0xC0) {
+        // regular ascii char
+        // or continuation byte
+        column += 1;
       }
       ++ begin;
     }
@@ -118,13 +126,10 @@ namespace Sass {
 
 
   ParserState::ParserState(const char* path, const char* src, const size_t file)
-  : Position(file, 0, 0), path(path), src(src), offset(0, 0), token() { }
+  : Position(file, 0, 0), path(path), src(src), offset(0, 0) { }
 
   ParserState::ParserState(const char* path, const char* src, const Position& position, Offset offset)
-  : Position(position), path(path), src(src), offset(offset), token() { }
-
-  ParserState::ParserState(const char* path, const char* src, const Token& token, const Position& position, Offset offset)
-  : Position(position), path(path), src(src), offset(offset), token(token) { }
+  : Position(position), path(path), src(src), offset(offset) { }
 
   Position Position::add(const char* begin, const char* end)
   {
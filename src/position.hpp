@@ -3,6 +3,7 @@
 
 #include <string>
 #include <cstring>
+#include <cstdint>
 // #include <iostream>
 
 namespace Sass {
@@ -10,6 +11,12 @@ namespace Sass {
 
   class Offset {
 
+    public: // sentinel for unset lines/columns/files; the fields
+            // are 32 bits wide since every AST node embeds a full
+            // ParserState — halving them shaves a pointer-size
+            // word off each coordinate on multi-million node trees
+      static const uint32_t npos = 0xFFFFFFFFU;
+
     public: // c-tor
       Offset(const char chr);
       Offset(const char* string);
@@ -37,8 +44,8 @@ namespace Sass {
       Offset off() { return *this; }
 
     public:
-      size_t line;
-      size_t column;
+      uint32_t line;
+      uint32_t column;
 
   };
 
@@ -64,7 +71,7 @@ namespace Sass {
       // friend std::ostream& operator<<(std::ostream& strm, const Position& pos);
 
     public:
-      size_t file;
+      uint32_t file;
 
   };
 
@@ -104,18 +111,21 @@ namespace Sass {
     public: // c-tor
       ParserState(const char* path, const char* src = 0, const size_t file = std::string::npos);
       ParserState(const char* path, const char* src, const Position& position, Offset offset = Offset(0, 0));
-      ParserState(const char* path, const char* src, const Token& token, const Position& position, Offset offset = Offset(0, 0));
 
     public: // down casts
       Offset off() { return *this; }
       Position pos() { return *this; }
       ParserState pstate() { return *this; }
 
-    public:
+    public: // every AST node embeds a ParserState, so cold fields
+            // here multiply by the node count. The lexed token used
+            // to ride along as three more pointers per node, but
+            // nothing outside the parser ever read it back — the
+            // parser keeps its own `lexed` token — so node states
+            // carry only what diagnostics and source maps consume
       const char* path;
       const char* src;
       Offset offset;
-      Token token;
 
   };
 
@@ -288,6 +288,35 @@ namespace Sass {
                >
              >(src);
     }
+
+    // Find the next position that could start an interpolant, an
+    // escape or (optionally) a block comment. Everything between
+    // candidates is a plain character run, so memchr covers the
+    // distance instead of a per-char matcher cascade; base64
+    // payloads are full of lone slashes, so those are filtered
+    // here already (a comment needs the following star).
+    const char* find_first_interpolant_candidate(const char* beg, const char* end, bool comments)
+    {
+      if (beg >= end) return 0;
+      size_t len = end - beg;
+      const char* h = (const char*) memchr(beg, '#', len);
+      const char* e = (const char*) memchr(beg, '\\', len);
+      const char* z = (const char*) memchr(beg, '\0', len);
+      const char* next = h;
+      if (e && (!next || e < next)) next = e;
+      if (comments) {
+        const char* limit = next ? next : end;
+        const char* s = beg;
+        while (s < limit && (s = (const char*) memchr(s, '/', limit - s))) {
+          if (s[1] == '*') break;
+          ++s;
+        }
+        if (s && s < limit && (!next || s < next)) next = s;
+      }
+      // an embedded NUL terminates the scan like the generic loop
+      if (z && (!next || z < next)) return 0;
+      return next;
+    }
     /* not use anymore - remove?
     const char* block_comment_prefix(const char* src) {
       return exactly<slash_star>(src);
@@ -298,19 +327,78 @@ namespace Sass {
     }
     */
 
+    // Flat scanner behind the four css trivia matchers below.
+    // These run in front of nearly every lex/peek call, so the
+    // combinator tower (zero_plus over alternatives over spaces,
+    // line_comment and block_comment) is fused into one loop.
+    static const char* skip_css_trivia(const char* src, bool skip_block) {
+      while (true) {
+        if (Util::ascii_isspace(static_cast<unsigned char>(*src))) {
+          do { ++src; } while (Util::ascii_isspace(static_cast<unsigned char>(*src)));
+          continue;
+        }
+        if (src[0] == '/' && src[1] == '/') {
+          src += 2; // line comment ends before the linefeed
+          while (*src && *src != '\n' && *src != '\r' && *src != '\f') ++src;
+          continue;
+        }
+        if (skip_block && src[0] == '/' && src[1] == '*') {
+          const char* p = src + 2;
+          while (*p && !(p[0] == '*' && p[1] == '/')) ++p;
+          // an unterminated block comment is not consumed
+          if (*p == 0) return src;
+          src = p + 2;
+          continue;
+        }
+        return src;
+      }
+    }
+
     // Match zero plus white-space or line_comments
     const char* optional_css_whitespace(const char* src) {
-      return zero_plus< alternatives<spaces, line_comment> >(src);
+      return skip_css_trivia(src, false);
+    }
+    // Counting twin of the scanner above for the lazy lex path:
+    // the lexer needs line/column bookkeeping for everything it
+    // skips, and counting while scanning saves the second pass
+    // Offset::add would otherwise make over the same bytes.
+    const char* optional_css_whitespace_counted(const char* src, Offset& offset) {
+      uint32_t line = offset.line;
+      uint32_t column = offset.column;
+      while (true) {
+        if (Util::ascii_isspace(static_cast<unsigned char>(*src))) {
+          do {
+            if (*src == '\n') { ++line; column = 0; }
+            else ++column;
+            ++src;
+          } while (Util::ascii_isspace(static_cast<unsigned char>(*src)));
+          continue;
+        }
+        if (src[0] == '/' && src[1] == '/') {
+          src += 2; column += 2;
+          while (*src && *src != '\n' && *src != '\r' && *src != '\f') {
+            // do not count any utf8 continuation bytes
+            if ((static_cast<unsigned char>(*src) & 0xC0) != 0x80) ++column;
+            ++src;
+          }
+          continue;
+        }
+        offset.line = line;
+        offset.column = column;
+        return src;
+      }
     }
     const char* css_whitespace(const char* src) {
-      return one_plus< alternatives<spaces, line_comment> >(src);
+      const char* p = skip_css_trivia(src, false);
+      return p == src ? 0 : p;
     }
     // Match optional_css_whitepace plus block_comments
     const char* optional_css_comments(const char* src) {
-      return zero_plus< alternatives<spaces, line_comment, block_comment> >(src);
+      return skip_css_trivia(src, true);
     }
     const char* css_comments(const char* src) {
-      return one_plus< alternatives<spaces, line_comment, block_comment> >(src);
+      const char* p = skip_css_trivia(src, true);
+      return p == src ? 0 : p;
     }
 
     // Match one backslash escaped char /\\./
@@ -526,6 +614,8 @@ namespace Sass {
             unicode_seq,
             // skip interpolants
             interpolant,
+            // bulk-skip plain character runs
+            quoted_string_run < '\'' >,
             // skip non delimiters
             any_char_but < '\'' >
           >
@@ -550,6 +640,8 @@ namespace Sass {
             unicode_seq,
             // skip interpolants
             interpolant,
+            // bulk-skip plain character runs
+            quoted_string_run < '"' >,
             // skip non delimiters
             any_char_but < '"' >
           >
@@ -3,6 +3,8 @@
 
 #include <cstring>
 #include "lexer.hpp"
+#include "position.hpp"
+#include "constants.hpp"
 
 namespace Sass {
   // using namespace Lexer;
@@ -188,6 +190,8 @@ namespace Sass {
 
     // Match zero plus white-space or line_comments
     const char* optional_css_whitespace(const char* src);
+    // same matcher, but counts lines/columns into [offset]
+    const char* optional_css_whitespace_counted(const char* src, Offset& offset);
     const char* css_whitespace(const char* src);
     // Match optional_css_whitepace plus block_comments
     const char* optional_css_comments(const char* src);
@@ -417,6 +421,40 @@ namespace Sass {
       }
       return 0;
     }
+
+    // Bulk-scanning variants hunting for interpolant openers. Long
+    // plain tokens (embedded data: URIs run to hundreds of KB) have
+    // no special characters at all, so jump between candidate
+    // positions with memchr instead of testing every single char.
+    // Semantics match the generic loops above exactly, including
+    // stopping at an embedded NUL and the escape handling.
+    const char* find_first_interpolant_candidate(const char* beg, const char* end, bool comments);
+
+    template<>
+    inline const char* find_first_in_interval< exactly<Constants::hash_lbrace> >(const char* beg, const char* end) {
+      while ((beg = find_first_interpolant_candidate(beg, end, false))) {
+        if (*beg == '\\') { beg += 2; continue; }
+        if (beg[1] == '{') return beg;
+        ++beg;
+      }
+      return 0;
+    }
+
+    template<>
+    inline const char* find_first_in_interval< exactly<Constants::hash_lbrace>, block_comment >(const char* beg, const char* end) {
+      while ((beg = find_first_interpolant_candidate(beg, end, true))) {
+        if (*beg == '\\') { beg += 2; continue; }
+        if (*beg == '/') {
+          // the generic loop advances one past a skipped comment
+          if (const char* pos = block_comment(beg)) { beg = pos + 1; }
+          else ++beg;
+          continue;
+        }
+        if (beg[1] == '{') return beg;
+        ++beg;
+      }
+      return 0;
+    }
     template <prelexer mx>
     unsigned int count_interval(const char* beg, const char* end) {
       unsigned int counter = 0;
@@ -6,16 +6,68 @@
 #include <cstring>
 #include <vector>
 #include <sstream>
+#include <iostream>
 
 #include "sass.h"
 #include "file.hpp"
 #include "util.hpp"
+#include "tracing.hpp"
+#include "messages.hpp"
 #include "context.hpp"
 #include "sass_context.hpp"
 #include "sass_functions.hpp"
 
 namespace Sass {
 
+  namespace Tracing {
+    // registered via sass_set_trace_callback (see tracing.hpp)
+    void (*callback)(const char*, const char*, void*) = 0;
+    void* cookie = 0;
+  }
+
+  namespace Messages {
+
+    thread_local Sink* sink = 0;
+
+    void Sink::push(const std::string& msg)
+    {
+      if (dedup_) {
+        auto it = seen_.find(msg);
+        if (it != seen_.end()) {
+          entries_[it->second].second += 1;
+          return;
+        }
+        seen_[msg] = entries_.size();
+      }
+      entries_.push_back(std::make_pair(msg, 1));
+    }
+
+    void Sink::flush()
+    {
+      if (entries_.empty()) return;
+      std::string out;
+      for (auto& entry : entries_) {
+        out += entry.first;
+        if (entry.second > 1) {
+          out += "    (repeated ";
+          out += std::to_string(entry.second);
+          out += " times)\n";
+        }
+      }
+      entries_.clear();
+      seen_.clear();
+      if (handler_) handler_(out.c_str(), cookie_);
+      else std::cerr << out << std::flush;
+    }
+
+    void emit(const std::string& msg)
+    {
+      if (sink) sink->push(msg);
+      else std::cerr << msg << std::flush;
+    }
+
+  }
+
   // helper to convert string list to vector
   std::vector<std::string> list2vec(struct string_list* cur)
   {
@@ -49,6 +101,7 @@ extern "C" {
     size_t len = strlen(str) + 1;
     char* cpy = (char*) sass_alloc_memory(len);
     std::memcpy(cpy, str, len);
+    Sass::MemoryStats::instance().string_bytes += len;
     return cpy;
   }
 
@@ -58,6 +111,13 @@ extern "C" {
     if (ptr) free (ptr);
   }
 
+  // install (or clear) the process wide trace hook
+  void ADDCALL sass_set_trace_callback(Sass_Trace_Callback cb, void* cookie)
+  {
+    Sass::Tracing::cookie = cookie;
+    Sass::Tracing::callback = cb;
+  }
+
   // caller must free the returned memory
   char* ADDCALL sass_string_quote (const char *str, const char quote_mark)
   {
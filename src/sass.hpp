@@ -117,6 +117,10 @@ struct Sass_Output_Options : Sass_Inspect_Options {
   // the corresponding source line.
   bool source_comments;
 
+  // How fine grained the generated source mappings
+  // are (per token, per declaration or per rule)
+  enum Sass_Srcmap_Granularity source_map_granularity;
+
   // initialization list (constructor with defaults)
   Sass_Output_Options(struct Sass_Inspect_Options opt,
                       const char* indent = "  ",
@@ -124,7 +128,8 @@ struct Sass_Output_Options : Sass_Inspect_Options {
                       bool source_comments = false)
   : Sass_Inspect_Options(opt),
     indent(indent), linefeed(linefeed),
-    source_comments(source_comments)
+    source_comments(source_comments),
+    source_map_granularity(SASS_SRCMAP_TOKEN)
   { }
 
   // initialization list (constructor with defaults)
@@ -135,7 +140,8 @@ struct Sass_Output_Options : Sass_Inspect_Options {
                       bool source_comments = false)
   : Sass_Inspect_Options(style, precision),
     indent(indent), linefeed(linefeed),
-    source_comments(source_comments)
+    source_comments(source_comments),
+    source_map_granularity(SASS_SRCMAP_TOKEN)
   { }
 
 };
@@ -14,7 +14,6 @@
 #include <string>
 #include <cstring>
 #include <cstdlib>
-#include <sstream>
 #include <iostream>
 #include <stdio.h>
 
@@ -796,41 +795,6 @@ namespace Sass
 	}
 	// EO process
 
-	// read line with either CR, LF or CR LF format
-	// http://stackoverflow.com/a/6089413/1550314
-	static std::istream& safeGetline(std::istream& is, std::string& t)
-	{
-		t.clear();
-
-		// The characters in the stream are read one-by-one using a std::streambuf.
-		// That is faster than reading them one-by-one using the std::istream.
-		// Code that uses streambuf this way must be guarded by a sentry object.
-		// The sentry object performs various tasks,
-		// such as thread synchronization and updating the stream state.
-
-		std::istream::sentry se(is, true);
-		std::streambuf* sb = is.rdbuf();
-
-		for(;;) {
-			int c = sb->sbumpc();
-			switch (c) {
-				case '\n':
-					return is;
-				case '\r':
-					if(sb->sgetc() == '\n')
-						sb->sbumpc();
-					return is;
-				case EOF:
-					// Also handle the case when the last line has no line ending
-					if(t.empty())
-						is.setstate(std::ios::eofbit);
-					return is;
-				default:
-					t += (char)c;
-			}
-		}
-	}
-
 	// the main converter function for c++
 	char* sass2scss (const std::string& sass, const int options)
 	{
@@ -838,7 +802,6 @@ namespace Sass
 		// local variables
 		std::string line;
 		std::string scss = "";
-		std::stringstream stream(sass);
 
 		// create converter variable
 		converter converter;
@@ -853,9 +816,30 @@ namespace Sass
 		converter.indents.push("");
 		converter.options = options;
 
-		// read line by line and process them
-		while(safeGetline(stream, line) && !stream.eof())
-		{ scss += process(line, converter); }
+		// the conversion only inserts block braces and
+		// semicolons, so the output stays close to the
+		// input size; reserving up front avoids regrowth
+		// copies while the document accumulates
+		scss.reserve(sass.length() + sass.length() / 8 + 64);
+
+		// split lines directly off the input buffer instead
+		// of copying the whole document into a stringstream;
+		// handles CR, LF and CR LF line endings and a final
+		// line without any line ending
+		size_t pos = 0, len = sass.length();
+		while (pos < len)
+		{
+			size_t end = sass.find_first_of("\r\n", pos);
+			if (end == std::string::npos) end = len;
+			line.assign(sass, pos, end - pos);
+			// skip the line ending (CR LF counts as one)
+			if (end < len) {
+				end += (sass[end] == '\r' && end + 1 < len
+					&& sass[end + 1] == '\n') ? 2 : 1;
+			}
+			pos = end;
+			scss += process(line, converter);
+		}
 
 		// create mutable string
 		std::string closer = "";
@@ -4,8 +4,12 @@
 #include "ast.hpp"
 
 #include "sass_functions.hpp"
+#include "messages.hpp"
 #include "json.hpp"
 
+#include <atomic>
+#include <thread>
+
 #define LFEED "\n"
 
 // C++ helper
@@ -75,8 +79,8 @@ namespace Sass {
       }
 
       // now create the code trace (ToDo: maybe have util functions?)
-      if (e.pstate.line != std::string::npos &&
-          e.pstate.column != std::string::npos &&
+      if (e.pstate.line != Sass::Offset::npos &&
+          e.pstate.column != Sass::Offset::npos &&
           e.pstate.src != nullptr) {
         size_t lines = e.pstate.line;
         // scan through src until target line
@@ -132,6 +136,11 @@ namespace Sass {
       msg_stream << "Unable to allocate memory: " << ba.what();
       handle_string_error(c_ctx, msg_stream.str(), 2);
     }
+    catch (Exception::CompileCancelled& e) {
+      // cooperative budget/cancellation abort gets its own status
+      // so latency-bounded callers can tell it from real errors
+      handle_string_error(c_ctx, e.what(), 6);
+    }
     catch (std::exception& e) {
       handle_string_error(c_ctx, e.what(), 3);
     }
@@ -188,8 +197,15 @@ namespace Sass {
       size_t headers = cpp_ctx->head_imports;
 
       // copy the included files on to the context (dont forget to free later)
-      if (copy_strings(cpp_ctx->get_included_files(skip, headers), &c_ctx->included_files) == NULL)
+      std::vector<std::string> included(cpp_ctx->get_included_files(skip, headers));
+      if (copy_strings(included, &c_ctx->included_files) == NULL)
         throw(std::bad_alloc());
+      c_ctx->included_files_count = included.size();
+
+      // export the import dependency graph; complete once the
+      // parse resolved every import, so build systems can read
+      // it before deciding whether to execute at all
+      c_ctx->import_graph_json = cpp_ctx->render_import_graph_json();
 
       // return parsed block
       return root;
@@ -240,36 +256,44 @@ extern "C" {
     { type foo = ctx->option; ctx->option = 0; return foo; }
 
 
-  // generic compilation function (not exported, use file/data compile instead)
-  static Sass_Compiler* sass_prepare_context (Sass_Context* c_ctx, Context* cpp_ctx) throw()
+  // register the custom functions, headers and importers from
+  // the options with a (fresh) cpp context
+  static void sass_register_custom (Sass_Context* c_ctx, Context* cpp_ctx)
   {
-    try {
-      // register our custom functions
-      if (c_ctx->c_functions) {
-        auto this_func_data = c_ctx->c_functions;
-        while (this_func_data && *this_func_data) {
-          cpp_ctx->add_c_function(*this_func_data);
-          ++this_func_data;
-        }
+    // register our custom functions
+    if (c_ctx->c_functions) {
+      auto this_func_data = c_ctx->c_functions;
+      while (this_func_data && *this_func_data) {
+        cpp_ctx->add_c_function(*this_func_data);
+        ++this_func_data;
       }
+    }
 
-      // register our custom headers
-      if (c_ctx->c_headers) {
-        auto this_head_data = c_ctx->c_headers;
-        while (this_head_data && *this_head_data) {
-          cpp_ctx->add_c_header(*this_head_data);
-          ++this_head_data;
-        }
+    // register our custom headers
+    if (c_ctx->c_headers) {
+      auto this_head_data = c_ctx->c_headers;
+      while (this_head_data && *this_head_data) {
+        cpp_ctx->add_c_header(*this_head_data);
+        ++this_head_data;
       }
+    }
 
-      // register our custom importers
-      if (c_ctx->c_importers) {
-        auto this_imp_data = c_ctx->c_importers;
-        while (this_imp_data && *this_imp_data) {
-          cpp_ctx->add_c_importer(*this_imp_data);
-          ++this_imp_data;
-        }
+    // register our custom importers
+    if (c_ctx->c_importers) {
+      auto this_imp_data = c_ctx->c_importers;
+      while (this_imp_data && *this_imp_data) {
+        cpp_ctx->add_c_importer(*this_imp_data);
+        ++this_imp_data;
       }
+    }
+  }
+
+  // generic compilation function (not exported, use file/data compile instead)
+  static Sass_Compiler* sass_prepare_context (Sass_Context* c_ctx, Context* cpp_ctx) throw()
+  {
+    try {
+      // register functions, headers and importers
+      sass_register_custom(c_ctx, cpp_ctx);
 
       // reset error status
       c_ctx->error_json = 0;
@@ -306,6 +330,19 @@ extern "C" {
   }
 
   // generic compilation function (not exported, use file/data compile instead)
+  // fill and deliver the per-compile measurements; called at the
+  // end of every one-shot compile, cache hits and errors included
+  static void sass_emit_metrics (Sass_Context* c_ctx, Context* cpp_ctx, int cache_hit)
+  {
+    if (c_ctx->metrics_handler == 0) return;
+    struct Sass_Compile_Metrics metrics;
+    cpp_ctx->collect_metrics(metrics);
+    metrics.bytes_out = c_ctx->output_string ? strlen(c_ctx->output_string) : 0;
+    metrics.cache_hit = cache_hit;
+    metrics.error_status = c_ctx->error_status;
+    c_ctx->metrics_handler(&metrics, c_ctx->metrics_cookie);
+  }
+
   static int sass_compile_context (Sass_Context* c_ctx, Context* cpp_ctx)
   {
 
@@ -313,13 +350,42 @@ extern "C" {
     Sass_Compiler* compiler = sass_prepare_context(c_ctx, cpp_ctx);
 
     try {
+      // try to satisfy the whole compile from the caller's
+      // output cache before touching any parse machinery
+      if (compiler && c_ctx->cache_lookup
+          && c_ctx->type == SASS_CONTEXT_FILE
+          && c_ctx->error_status == 0) {
+        std::string key(cpp_ctx->output_cache_key_previous());
+        char* css = 0; char* map = 0;
+        if (!key.empty() && c_ctx->cache_lookup(key.c_str(), &css, &map, c_ctx->cache_cookie)) {
+          c_ctx->output_string = css;
+          c_ctx->source_map_string = map;
+          sass_emit_metrics(c_ctx, cpp_ctx, 1);
+          sass_delete_compiler(compiler);
+          return c_ctx->error_status;
+        }
+      }
       // call each compiler step
       sass_compiler_parse(compiler);
       sass_compiler_execute(compiler);
+      // publish the fresh result and remember the closure so
+      // the next rebuild can predict its key without compiling
+      if ((c_ctx->cache_lookup || c_ctx->cache_store)
+          && c_ctx->type == SASS_CONTEXT_FILE
+          && c_ctx->error_status == 0 && c_ctx->output_string) {
+        cpp_ctx->remember_output_closure();
+        if (c_ctx->cache_store) {
+          std::string key(cpp_ctx->output_cache_key_current());
+          c_ctx->cache_store(key.c_str(), c_ctx->output_string,
+            c_ctx->source_map_string, c_ctx->cache_cookie);
+        }
+      }
     }
     // pass errors to generic error handler
     catch (...) { handle_errors(c_ctx); }
 
+    sass_emit_metrics(c_ctx, cpp_ctx, 0);
+
     sass_delete_compiler(compiler);
 
     return c_ctx->error_status;
@@ -378,6 +444,29 @@ extern "C" {
     return ctx;
   }
 
+  Sass_Data_Context* ADDCALL sass_make_data_context_view(char* source_string, size_t source_len)
+  {
+    #ifdef DEBUG_SHARED_PTR
+    SharedObj::setTaint(true);
+    #endif
+    struct Sass_Data_Context* ctx = (struct Sass_Data_Context*) calloc(1, sizeof(struct Sass_Data_Context));
+    if (ctx == 0) { std::cerr << "Error allocating memory for data context" << std::endl; return 0; }
+    ctx->type = SASS_CONTEXT_DATA;
+    init_options(ctx);
+    try {
+      if (source_string == 0) { throw(std::runtime_error("Data context created without a source string")); }
+      if (source_len == 0 || *source_string == 0) { throw(std::runtime_error("Data context created with empty source string")); }
+      // the parser scans up to the terminator, so the view must
+      // provide one right after the advertised length
+      if (source_string[source_len] != 0) { throw(std::runtime_error("Borrowed source buffer must be NUL terminated")); }
+      ctx->source_string = source_string;
+      ctx->source_borrowed = true;
+    } catch (...) {
+      handle_errors(ctx);
+    }
+    return ctx;
+  }
+
   struct Sass_Compiler* ADDCALL sass_make_data_compiler (struct Sass_Data_Context* data_ctx)
   {
     if (data_ctx == 0) return 0;
@@ -392,6 +481,67 @@ extern "C" {
     return sass_prepare_context(file_ctx, cpp_ctx);
   }
 
+  // swap the input of a data context between compiles
+  // takes ownership of the new string (like make_data_context)
+  void ADDCALL sass_data_context_set_source (struct Sass_Data_Context* ctx, char* source_string)
+  {
+    if (ctx == 0) return;
+    // the old string may still be here if it was never parsed
+    // (borrowed buffers belong to the caller and stay untouched)
+    if (ctx->source_string && !ctx->source_borrowed) free(ctx->source_string);
+    ctx->source_string = source_string;
+    ctx->source_borrowed = false;
+  }
+
+  // rewind a compiler for another compile on the same context
+  // keeps all options, functions, headers and importers intact;
+  // only the per-document outputs and errors are released here;
+  // the fresh cpp context is created lazily on the next parse,
+  // so a data source set afterwards is still picked up
+  int ADDCALL sass_compiler_reset (struct Sass_Compiler* compiler)
+  {
+    if (compiler == 0) return 1;
+    if (compiler->c_ctx == NULL) return 1;
+    Sass_Context* c_ctx = compiler->c_ctx;
+
+    // drop the previous compilation (ast and context)
+    compiler->root = {};
+    if (compiler->cpp_ctx) delete(compiler->cpp_ctx);
+    compiler->cpp_ctx = NULL;
+
+    // release the outputs of the last compile, but leave the
+    // options alone (unlike sass_clear_context on final delete)
+    if (c_ctx->output_string)     free(c_ctx->output_string);
+    if (c_ctx->source_map_string) free(c_ctx->source_map_string);
+    if (c_ctx->profile_json)      free(c_ctx->profile_json);
+    if (c_ctx->stats_json)        free(c_ctx->stats_json);
+    if (c_ctx->import_graph_json) free(c_ctx->import_graph_json);
+    if (c_ctx->error_message)     free(c_ctx->error_message);
+    if (c_ctx->error_text)        free(c_ctx->error_text);
+    if (c_ctx->error_json)        free(c_ctx->error_json);
+    if (c_ctx->error_file)        free(c_ctx->error_file);
+    if (c_ctx->error_src)         free(c_ctx->error_src);
+    free_string_array(c_ctx->included_files);
+    c_ctx->output_string = 0;
+    c_ctx->source_map_string = 0;
+    c_ctx->profile_json = 0;
+    c_ctx->stats_json = 0;
+    c_ctx->import_graph_json = 0;
+    c_ctx->error_message = 0;
+    c_ctx->error_text = 0;
+    c_ctx->error_json = 0;
+    c_ctx->error_file = 0;
+    c_ctx->error_src = 0;
+    c_ctx->error_status = 0;
+    c_ctx->error_line = std::string::npos;
+    c_ctx->error_column = std::string::npos;
+    c_ctx->included_files = 0;
+
+    // ready for the next parse
+    compiler->state = SASS_COMPILER_CREATED;
+    return 0;
+  }
+
   int ADDCALL sass_compile_data_context(Sass_Data_Context* data_ctx)
   {
     if (data_ctx == 0) return 1;
@@ -421,15 +571,75 @@ extern "C" {
     return sass_compile_context(file_ctx, cpp_ctx);
   }
 
+  void ADDCALL sass_invalidate_file(const char* abs_path)
+  {
+    if (abs_path == 0) return;
+    Sass::invalidate_parse_cache(abs_path);
+  }
+
+  int ADDCALL sass_compiler_pool_compile(struct Sass_File_Context** file_ctxs, size_t n, size_t nthreads)
+  {
+    if (file_ctxs == 0 || n == 0) return 0;
+    if (nthreads == 0) nthreads = std::thread::hardware_concurrency();
+    if (nthreads == 0) nthreads = 1;
+    if (nthreads > n) nthreads = n;
+    // each worker claims the next unprocessed entry point;
+    // compilations are fully independent (one Context each)
+    std::atomic<size_t> next(0);
+    std::atomic<int> status(0);
+    std::vector<std::thread> workers;
+    workers.reserve(nthreads);
+    for (size_t t = 0; t < nthreads; ++t) {
+      workers.emplace_back([&]() {
+        while (true) {
+          size_t i = next.fetch_add(1);
+          if (i >= n) break;
+          int rv = sass_compile_file_context(file_ctxs[i]);
+          if (rv != 0) {
+            int expected = 0;
+            status.compare_exchange_strong(expected, rv);
+          }
+        }
+      });
+    }
+    for (auto& worker : workers) worker.join();
+    return status.load();
+  }
+
   int ADDCALL sass_compiler_parse(struct Sass_Compiler* compiler)
   {
     if (compiler == 0) return 1;
     if (compiler->state == SASS_COMPILER_PARSED) return 0;
     if (compiler->state != SASS_COMPILER_CREATED) return -1;
     if (compiler->c_ctx == NULL) return 1;
-    if (compiler->cpp_ctx == NULL) return 1;
+    // a reset compiler has no cpp context yet; build a fresh
+    // one of the original flavor, with customs re-registered
+    // (warm state like parsed sources and plugin listings lives
+    // in the process wide caches and carries over automatically)
+    if (compiler->cpp_ctx == NULL) {
+      Sass_Context* c_ctx = compiler->c_ctx;
+      try {
+        Context* cpp_ctx = 0;
+        if (c_ctx->type == SASS_CONTEXT_DATA) {
+          cpp_ctx = new Data_Context(*(struct Sass_Data_Context*)c_ctx);
+        }
+        else if (c_ctx->type == SASS_CONTEXT_FILE) {
+          cpp_ctx = new File_Context(*(struct Sass_File_Context*)c_ctx);
+        }
+        else {
+          throw(std::runtime_error("Compiler context has unknown type"));
+        }
+        sass_register_custom(c_ctx, cpp_ctx);
+        compiler->cpp_ctx = cpp_ctx;
+        cpp_ctx->c_compiler = compiler;
+      }
+      catch (...) { return handle_errors(c_ctx) | 1; }
+    }
     if (compiler->c_ctx->error_status)
       return compiler->c_ctx->error_status;
+    // batch warn/debug output for the whole phase
+    Messages::Scope messages(compiler->c_ctx->message_handler,
+      compiler->c_ctx->message_cookie, compiler->c_ctx->message_dedup);
     // parse the context we have set up (file or data)
     compiler->root = sass_parse_block(compiler);
     // success
@@ -449,16 +659,39 @@ extern "C" {
     compiler->state = SASS_COMPILER_EXECUTED;
     Context* cpp_ctx = compiler->cpp_ctx;
     Block_Obj root = compiler->root;
+    // batch warn/debug output for the whole phase
+    Messages::Scope messages(compiler->c_ctx->message_handler,
+      compiler->c_ctx->message_cookie, compiler->c_ctx->message_dedup);
     // compile the parsed root block
     try { compiler->c_ctx->output_string = cpp_ctx->render(root); }
     // pass catched errors to generic error handler
     catch (...) { return handle_errors(compiler->c_ctx) | 1; }
     // generate source map json and store on context
     compiler->c_ctx->source_map_string = cpp_ctx->render_srcmap();
+    // generate timing json when profiling was requested
+    compiler->c_ctx->profile_json = cpp_ctx->render_profile_json();
+    // generate allocation statistics json (always collected)
+    compiler->c_ctx->stats_json = cpp_ctx->render_stats_json();
     // success
     return 0;
   }
 
+  char* ADDCALL sass_compiler_render_output(struct Sass_Compiler* compiler, enum Sass_Output_Style output_style)
+  {
+    if (compiler == 0) return 0;
+    // the evaluated tree is available once parsing succeeded
+    if (compiler->state != SASS_COMPILER_PARSED &&
+        compiler->state != SASS_COMPILER_EXECUTED) return 0;
+    if (compiler->c_ctx == NULL) return 0;
+    if (compiler->cpp_ctx == NULL) return 0;
+    if (compiler->root.isNull()) return 0;
+    if (compiler->c_ctx->error_status) return 0;
+    // render the shared tree with a secondary emitter
+    try { return compiler->cpp_ctx->render_styled(compiler->root, output_style); }
+    // pass catched errors to generic error handler
+    catch (...) { handle_errors(compiler->c_ctx); return 0; }
+  }
+
   // helper function, not exported, only accessible locally
   static void sass_reset_options (struct Sass_Options* options)
   {
@@ -470,6 +703,7 @@ extern "C" {
     options->include_path = 0;
     options->source_map_file = 0;
     options->source_map_root = 0;
+    options->ast_cache_dir = 0;
     options->c_functions = 0;
     options->c_importers = 0;
     options->c_headers = 0;
@@ -516,6 +750,7 @@ extern "C" {
     free(options->include_path);
     free(options->source_map_file);
     free(options->source_map_root);
+    free(options->ast_cache_dir);
     // Reset our pointers
     options->input_path = 0;
     options->output_path = 0;
@@ -523,6 +758,7 @@ extern "C" {
     options->include_path = 0;
     options->source_map_file = 0;
     options->source_map_root = 0;
+    options->ast_cache_dir = 0;
     options->c_functions = 0;
     options->c_importers = 0;
     options->c_headers = 0;
@@ -538,6 +774,9 @@ extern "C" {
     // release the allocated memory (mostly via sass_copy_c_string)
     if (ctx->output_string)     free(ctx->output_string);
     if (ctx->source_map_string) free(ctx->source_map_string);
+    if (ctx->profile_json)      free(ctx->profile_json);
+    if (ctx->stats_json)        free(ctx->stats_json);
+    if (ctx->import_graph_json) free(ctx->import_graph_json);
     if (ctx->error_message)     free(ctx->error_message);
     if (ctx->error_text)        free(ctx->error_text);
     if (ctx->error_json)        free(ctx->error_json);
@@ -547,6 +786,9 @@ extern "C" {
     // play safe and reset properties
     ctx->output_string = 0;
     ctx->source_map_string = 0;
+    ctx->profile_json = 0;
+    ctx->stats_json = 0;
+    ctx->import_graph_json = 0;
     ctx->error_message = 0;
     ctx->error_text = 0;
     ctx->error_json = 0;
@@ -590,7 +832,8 @@ extern "C" {
   {
     // clean the source string if it was not passed
     // we reset this member once we start parsing
-    if (ctx->source_string) free(ctx->source_string);
+    // (borrowed buffers belong to the caller)
+    if (ctx->source_string && !ctx->source_borrowed) free(ctx->source_string);
     // clear the context and free it
     sass_clear_context(ctx); free(ctx);
   }
@@ -621,7 +864,7 @@ extern "C" {
 
   // Calculate the size of the stored null terminated array
   size_t ADDCALL sass_context_get_included_files_size (struct Sass_Context* ctx)
-  { size_t l = 0; auto i = ctx->included_files; while (i && *i) { ++i; ++l; } return l; }
+  { return ctx->included_files ? ctx->included_files_count : 0; }
 
   // Create getter and setters for options
   IMPLEMENT_SASS_OPTION_ACCESSOR(int, precision);
@@ -632,9 +875,37 @@ extern "C" {
   IMPLEMENT_SASS_OPTION_ACCESSOR(bool, source_map_file_urls);
   IMPLEMENT_SASS_OPTION_ACCESSOR(bool, omit_source_map_url);
   IMPLEMENT_SASS_OPTION_ACCESSOR(bool, is_indented_syntax_src);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(bool, mmap_sources);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(bool, share_sources);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(bool, import_once);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(enum Sass_Srcmap_Granularity, source_map_granularity);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(bool, profile);
   IMPLEMENT_SASS_OPTION_ACCESSOR(Sass_Function_List, c_functions);
   IMPLEMENT_SASS_OPTION_ACCESSOR(Sass_Importer_List, c_importers);
   IMPLEMENT_SASS_OPTION_ACCESSOR(Sass_Importer_List, c_headers);
+  // writer takes the cookie too, so no accessor macro here
+  Sass_Output_Writer_Fn ADDCALL sass_option_get_output_writer(struct Sass_Options* options)
+  { return options->output_writer; }
+  void ADDCALL sass_option_set_output_writer(struct Sass_Options* options, Sass_Output_Writer_Fn fn, void* cookie)
+  { options->output_writer = fn; options->output_writer_cookie = cookie; }
+  void ADDCALL sass_option_set_cache_handler(struct Sass_Options* options, Sass_Cache_Lookup_Fn lookup, Sass_Cache_Store_Fn store, void* cookie)
+  { options->cache_lookup = lookup; options->cache_store = store; options->cache_cookie = cookie; }
+  void ADDCALL sass_option_set_message_handler(struct Sass_Options* options, Sass_Message_Fn handler, void* cookie)
+  { options->message_handler = handler; options->message_cookie = cookie; }
+  void ADDCALL sass_option_set_message_dedup(struct Sass_Options* options, bool enable)
+  { options->message_dedup = enable; }
+  void ADDCALL sass_option_set_metrics_handler(struct Sass_Options* options, Sass_Metrics_Fn handler, void* cookie)
+  { options->metrics_handler = handler; options->metrics_cookie = cookie; }
+  IMPLEMENT_SASS_OPTION_ACCESSOR(size_t, render_threads);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(size_t, parse_threads);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(bool, speculative_imports);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(bool, tree_shaking);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(bool, dedup_declarations);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(bool, merge_media_rules);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(bool, trusted_input);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(size_t, extend_budget);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(size_t, compile_budget);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(int*, cancel_flag);
   IMPLEMENT_SASS_OPTION_ACCESSOR(const char*, indent);
   IMPLEMENT_SASS_OPTION_ACCESSOR(const char*, linefeed);
   IMPLEMENT_SASS_OPTION_STRING_SETTER(const char*, plugin_path, 0);
@@ -643,6 +914,7 @@ extern "C" {
   IMPLEMENT_SASS_OPTION_STRING_ACCESSOR(const char*, output_path, 0);
   IMPLEMENT_SASS_OPTION_STRING_ACCESSOR(const char*, source_map_file, 0);
   IMPLEMENT_SASS_OPTION_STRING_ACCESSOR(const char*, source_map_root, 0);
+  IMPLEMENT_SASS_OPTION_STRING_ACCESSOR(const char*, ast_cache_dir, 0);
 
   // Create getter and setters for context
   IMPLEMENT_SASS_CONTEXT_GETTER(int, error_status);
@@ -655,6 +927,9 @@ extern "C" {
   IMPLEMENT_SASS_CONTEXT_GETTER(size_t, error_column);
   IMPLEMENT_SASS_CONTEXT_GETTER(const char*, output_string);
   IMPLEMENT_SASS_CONTEXT_GETTER(const char*, source_map_string);
+  IMPLEMENT_SASS_CONTEXT_GETTER(const char*, profile_json);
+  IMPLEMENT_SASS_CONTEXT_GETTER(const char*, stats_json);
+  IMPLEMENT_SASS_CONTEXT_GETTER(const char*, import_graph_json);
   IMPLEMENT_SASS_CONTEXT_GETTER(char**, included_files);
 
   // Take ownership of memory (value on context is set to 0)
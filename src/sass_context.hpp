@@ -23,6 +23,25 @@ struct Sass_Options : Sass_Output_Options {
   // Treat source_string as sass (as opposed to scss)
   bool is_indented_syntax_src;
 
+  // Load imports via mmap instead of copying
+  // them into fresh heap buffers (posix only)
+  bool mmap_sources;
+
+  // Serve source files from a process wide refcounted registry
+  // so concurrent compiles sharing an import closure read and
+  // hold each file once between them (posix only, overrides
+  // mmap_sources for the shared reads)
+  bool share_sources;
+
+  // Expand every unique import target only once per
+  // compilation; repeated and diamond imports of the
+  // same file contribute neither work nor output again
+  bool import_once;
+
+  // Collect per-phase and per-file timings
+  // during compilation (see profile_json)
+  bool profile;
+
   // The input path is used for source map
   // generation. It can be used to define
   // something with string compilation or to
@@ -65,6 +84,101 @@ struct Sass_Options : Sass_Output_Options {
   // List of custom headers
   Sass_Importer_List c_headers;
 
+  // Stream output through this callback (with
+  // cookie) instead of storing an output_string
+  Sass_Output_Writer_Fn output_writer;
+  void* output_writer_cookie;
+
+  // Compile avoidance cache callbacks (with cookie);
+  // see sass_option_set_cache_handler
+  Sass_Cache_Lookup_Fn cache_lookup;
+  Sass_Cache_Store_Fn cache_store;
+  void* cache_cookie;
+
+  // Batched message sink configuration (with cookie);
+  // see sass_option_set_message_handler
+  Sass_Message_Fn message_handler;
+  void* message_cookie;
+  bool message_dedup;
+
+  // Per-compile measurement sink (with cookie);
+  // see sass_option_set_metrics_handler
+  Sass_Metrics_Fn metrics_handler;
+  void* metrics_cookie;
+
+  // Number of threads used to render independent top-level
+  // rules (0 and 1 render sequentially). Only honored when
+  // the library was built with thread-safe reference counts.
+  size_t render_threads;
+
+  // Number of threads used to warm the parse cache from the
+  // import closure remembered by the previous compile of the
+  // same entry (0 and 1 parse sequentially). Only honored when
+  // the library was built with thread-safe reference counts.
+  size_t parse_threads;
+
+  // Walk the probable import closure on a helper thread while the
+  // main thread parses: token scans of loaded sources yield the
+  // literal @import urls, the walker reads and scans those files
+  // for the next level and announces everything to the kernel's
+  // readahead. Deep import chains then stream in ahead of the
+  // parser instead of one level at a time. Mispredicted files cost
+  // one bounded read each. Off by default.
+  bool speculative_imports;
+
+  // Skip registering and evaluating mixins, functions and
+  // variables that no emitted code can ever reach. Off by
+  // default: dead code stops being evaluated at all, so its
+  // warnings, errors and other side effects disappear.
+  bool tree_shaking;
+
+  // Drop declarations that a later declaration of the same
+  // property in the same block overrides anyway. Fallback
+  // chains (vendor prefixed values, !important over plain,
+  // custom properties) are kept. Off by default.
+  bool dedup_declarations;
+
+  // Coalesce adjacent @media rules that share the exact same query
+  // list into one block, so bundles with hundreds of repeated
+  // `@media (min-width: ...)` sections render the query and braces
+  // once per run instead of once per rule. Off by default.
+  bool merge_media_rules;
+
+  // Treat the input as pre-validated and skip the nesting
+  // checks that only exist to produce author-error messages.
+  // Invalid input then misbehaves instead of erroring cleanly,
+  // so this is only for machine-generated sources that were
+  // validated when they were produced. Off by default.
+  bool trusted_input;
+
+  // Upper bound on the selector combinations @extend weaving may
+  // produce per compile. Pathological extend chains explode
+  // combinatorially; with a budget the weave stops there, keeps
+  // the combinations produced so far and reports a warning.
+  // Zero (the default) weaves exhaustively.
+  size_t extend_budget;
+
+  // Wall-clock budget in milliseconds for the whole compile
+  // (parse, expand, extend weaving and output). The phase loops
+  // poll it cooperatively and abort with error status 6 once it
+  // is spent, so a latency-bounded caller gets its thread back
+  // instead of killing the process and its warm caches. Zero
+  // (the default) means no budget.
+  size_t compile_budget;
+
+  // Caller-owned cancellation token polled at the same spots as
+  // the compile budget: set the pointed-to int non-zero (from
+  // any thread) to make a running compile abort with error
+  // status 6. The int must outlive the compile. NULL by default.
+  int* cancel_flag;
+
+  // Directory holding serialized parse results keyed by content
+  // hash (see ast_serialize.hpp). Parsed trees are loaded from and
+  // persisted to it, so the parse of stable sources is paid once
+  // per content revision instead of once per process. Source maps
+  // disable it for the compile. Unset by default.
+  char* ast_cache_dir;
+
 };
 
 
@@ -81,6 +195,15 @@ struct Sass_Context : Sass_Options
   // generated source map json
   char* source_map_string;
 
+  // phase/file timings (json, profile option)
+  char* profile_json;
+
+  // allocation/node statistics (json, always collected)
+  char* stats_json;
+
+  // import dependency graph with content hashes (json)
+  char* import_graph_json;
+
   // error status
   int error_status;
   char* error_json;
@@ -94,6 +217,9 @@ struct Sass_Context : Sass_Options
 
   // report imported files
   char** included_files;
+  // entry count of [included_files]; kept alongside so the size
+  // getter answers without walking the null terminated array
+  size_t included_files_count;
 
 };
 
@@ -111,6 +237,9 @@ struct Sass_Data_Context : Sass_Context {
   // provided source string
   char* source_string;
   char* srcmap_string;
+  // source_string stays owned by the caller (view mode);
+  // it is never freed and never handed to the parse cache
+  bool source_borrowed;
 
 };
 
@@ -64,6 +64,8 @@ extern "C" {
   }
 
   Sass_Importer_Fn ADDCALL sass_importer_get_function(Sass_Importer_Entry cb) { return cb->importer; }
+  void ADDCALL sass_importer_set_prefetch_function(Sass_Importer_Entry cb, Sass_Importer_Prefetch_Fn fn) { cb->prefetch = fn; }
+  Sass_Importer_Prefetch_Fn ADDCALL sass_importer_get_prefetch_function(Sass_Importer_Entry cb) { return cb->prefetch; }
   double ADDCALL sass_importer_get_priority (Sass_Importer_Entry cb) { return cb->priority; }
   void* ADDCALL sass_importer_get_cookie(Sass_Importer_Entry cb) { return cb->cookie; }
 
@@ -45,6 +45,8 @@ struct Sass_Importer {
   Sass_Importer_Fn importer;
   double           priority;
   void*            cookie;
+  // optional batch announcement hook (null when unused)
+  Sass_Importer_Prefetch_Fn prefetch;
 };
 
 #endif
\ No newline at end of file
@@ -13,6 +13,44 @@
 extern "C" {
   using namespace Sass;
 
+  // clones share list/map payloads until a setter writes;
+  // make sure this value is the only owner of its payload
+  // (the slot about to be overwritten is left empty, since
+  // its copy would be unreachable for the caller anyway)
+  static void sass_list_detach (union Sass_Value* v, size_t skip)
+  {
+    size_t* refs = v->list.refs;
+    if (refs == 0) return;
+    // the other holders are gone already
+    if (*refs == 1) { free(refs); v->list.refs = 0; return; }
+    union Sass_Value** values = (union Sass_Value**) calloc(v->list.length, sizeof(union Sass_Value*));
+    if (values == 0) return;
+    for (size_t i = 0; i < v->list.length; i++) {
+      if (i == skip) continue;
+      values[i] = sass_clone_value(v->list.values[i]);
+    }
+    -- *refs;
+    v->list.values = values;
+    v->list.refs = 0;
+  }
+
+  static void sass_map_detach (union Sass_Value* v, size_t skip, bool skip_key)
+  {
+    size_t* refs = v->map.refs;
+    if (refs == 0) return;
+    // the other holders are gone already
+    if (*refs == 1) { free(refs); v->map.refs = 0; return; }
+    struct Sass_MapPair* pairs = (struct Sass_MapPair*) calloc(v->map.length, sizeof(struct Sass_MapPair));
+    if (pairs == 0) return;
+    for (size_t i = 0; i < v->map.length; i++) {
+      if (i != skip || !skip_key) pairs[i].key = sass_clone_value(v->map.pairs[i].key);
+      if (i != skip || skip_key) pairs[i].value = sass_clone_value(v->map.pairs[i].value);
+    }
+    -- *refs;
+    v->map.pairs = pairs;
+    v->map.refs = 0;
+  }
+
   // Return the sass tag for a generic sass value
   enum Sass_Tag ADDCALL sass_value_get_tag(const union Sass_Value* v) { return v->unknown.tag; }
 
@@ -61,15 +99,34 @@ extern "C" {
   void ADDCALL sass_list_set_is_bracketed(union Sass_Value* v, bool is_bracketed) { v->list.is_bracketed = is_bracketed; }
   // Getters and setters for Sass_List values
   union Sass_Value* ADDCALL sass_list_get_value(const union Sass_Value* v, size_t i) { return v->list.values[i]; }
-  void ADDCALL sass_list_set_value(union Sass_Value* v, size_t i, union Sass_Value* value) { v->list.values[i] = value; }
+  void ADDCALL sass_list_set_value(union Sass_Value* v, size_t i, union Sass_Value* value) { sass_list_detach(v, i); v->list.values[i] = value; }
+  size_t ADDCALL sass_list_get_values(const union Sass_Value* v, size_t offset, size_t count, union Sass_Value** dest)
+  {
+    if (dest == 0 || offset >= v->list.length) return 0;
+    size_t avail = v->list.length - offset;
+    if (count > avail) count = avail;
+    memcpy(dest, v->list.values + offset, count * sizeof(union Sass_Value*));
+    return count;
+  }
 
   // Getters and setters for Sass_Map
   size_t ADDCALL sass_map_get_length(const union Sass_Value* v) { return v->map.length; }
   // Getters and setters for Sass_List keys and values
   union Sass_Value* ADDCALL sass_map_get_key(const union Sass_Value* v, size_t i) { return v->map.pairs[i].key; }
   union Sass_Value* ADDCALL sass_map_get_value(const union Sass_Value* v, size_t i) { return v->map.pairs[i].value; }
-  void ADDCALL sass_map_set_key(union Sass_Value* v, size_t i, union Sass_Value* key) { v->map.pairs[i].key = key; }
-  void ADDCALL sass_map_set_value(union Sass_Value* v, size_t i, union Sass_Value* val) { v->map.pairs[i].value = val; }
+  void ADDCALL sass_map_set_key(union Sass_Value* v, size_t i, union Sass_Value* key) { sass_map_detach(v, i, true); v->map.pairs[i].key = key; }
+  void ADDCALL sass_map_set_value(union Sass_Value* v, size_t i, union Sass_Value* val) { sass_map_detach(v, i, false); v->map.pairs[i].value = val; }
+  size_t ADDCALL sass_map_get_pairs(const union Sass_Value* v, size_t offset, size_t count, union Sass_Value** keys, union Sass_Value** values)
+  {
+    if ((keys == 0 && values == 0) || offset >= v->map.length) return 0;
+    size_t avail = v->map.length - offset;
+    if (count > avail) count = avail;
+    for (size_t i = 0; i < count; i++) {
+      if (keys) keys[i] = v->map.pairs[offset + i].key;
+      if (values) values[i] = v->map.pairs[offset + i].value;
+    }
+    return count;
+  }
 
   // Getters and setters for Sass_Error
   char* ADDCALL sass_error_get_message(const union Sass_Value* v) { return v->error.message; };
@@ -206,12 +263,22 @@ extern "C" {
                 free(val->string.value);
         }   break;
         case SASS_LIST: {
+                // payload may still be shared with other clones
+                if (val->list.refs) {
+                    if (-- *val->list.refs > 0) break;
+                    free(val->list.refs);
+                }
                 for (i=0; i<val->list.length; i++) {
                     sass_delete_value(val->list.values[i]);
                 }
                 free(val->list.values);
         }   break;
         case SASS_MAP: {
+                // payload may still be shared with other clones
+                if (val->map.refs) {
+                    if (-- *val->map.refs > 0) break;
+                    free(val->map.refs);
+                }
                 for (i=0; i<val->map.length; i++) {
                     sass_delete_value(val->map.pairs[i].key);
                     sass_delete_value(val->map.pairs[i].value);
@@ -235,7 +302,6 @@ extern "C" {
   union Sass_Value* ADDCALL sass_clone_value (const union Sass_Value* val)
   {
 
-    size_t i;
     if (val == 0) return 0;
     switch(val->unknown.tag) {
         case SASS_NULL: {
@@ -254,18 +320,39 @@ extern "C" {
                 return sass_string_is_quoted(val) ? sass_make_qstring(val->string.value) : sass_make_string(val->string.value);
         }
         case SASS_LIST: {
-                union Sass_Value* list = sass_make_list(val->list.length, val->list.separator, val->list.is_bracketed);
-                for (i = 0; i < list->list.length; i++) {
-                    list->list.values[i] = sass_clone_value(val->list.values[i]);
+                // O(1): share the payload and count the reference,
+                // the first write through a setter detaches a copy
+                union Sass_Value* list = (Sass_Value*) calloc(1, sizeof(Sass_Value));
+                if (list == 0) return 0;
+                list->list = val->list;
+                size_t* refs = val->list.refs;
+                if (refs == 0) {
+                    refs = (size_t*) malloc(sizeof(size_t));
+                    if (refs == 0) { free(list); return 0; }
+                    *refs = 1;
+                    // install on the source too (logically const)
+                    const_cast<union Sass_Value*>(val)->list.refs = refs;
                 }
+                ++ *refs;
+                list->list.refs = refs;
                 return list;
         }
         case SASS_MAP: {
-                union Sass_Value* map = sass_make_map(val->map.length);
-                for (i = 0; i < val->map.length; i++) {
-                    map->map.pairs[i].key = sass_clone_value(val->map.pairs[i].key);
-                    map->map.pairs[i].value = sass_clone_value(val->map.pairs[i].value);
+                // O(1): share the payload and count the reference,
+                // the first write through a setter detaches a copy
+                union Sass_Value* map = (Sass_Value*) calloc(1, sizeof(Sass_Value));
+                if (map == 0) return 0;
+                map->map = val->map;
+                size_t* refs = val->map.refs;
+                if (refs == 0) {
+                    refs = (size_t*) malloc(sizeof(size_t));
+                    if (refs == 0) { free(map); return 0; }
+                    *refs = 1;
+                    // install on the source too (logically const)
+                    const_cast<union Sass_Value*>(val)->map.refs = refs;
                 }
+                ++ *refs;
+                map->map.refs = refs;
                 return map;
         }
         case SASS_ERROR: {
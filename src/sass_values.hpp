@@ -39,12 +39,18 @@ struct Sass_List {
   size_t              length;
   // null terminated "array"
   union Sass_Value**  values;
+  // shared-payload counter for copy-on-write clones
+  // (null while the payload is uniquely owned)
+  size_t*             refs;
 };
 
 struct Sass_Map {
   enum Sass_Tag        tag;
   size_t               length;
   struct Sass_MapPair* pairs;
+  // shared-payload counter for copy-on-write clones
+  // (null while the payload is uniquely owned)
+  size_t*              refs;
 };
 
 struct Sass_Null {
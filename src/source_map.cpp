@@ -17,86 +17,110 @@ namespace Sass {
   SourceMap::SourceMap() : current_position(0, 0, 0), file("stdin") { }
   SourceMap::SourceMap(const std::string& file) : current_position(0, 0, 0), file(file) { }
 
+  // append a json encoded (quoted and escaped) string
+  static void append_json_string(std::string& out, const char* text)
+  {
+    char* encoded = json_encode_string(text);
+    out += encoded;
+    free(encoded);
+  }
+
   std::string SourceMap::render_srcmap(Context &ctx) {
 
     const bool include_sources = ctx.c_options.source_map_contents;
     const std::vector<std::string> links = ctx.srcmap_links;
     const std::vector<Resource>& sources(ctx.resources);
 
-    JsonNode* json_srcmap = json_mkobject();
+    std::string mappings = serialize_mappings();
 
-    json_append_member(json_srcmap, "version", json_mknumber(3));
+    // stream the document into a single buffer instead of building
+    // a json node tree (which copies every source again) and then
+    // stringifying that into yet another buffer; presize for the
+    // dominant parts so the string grows at most once
+    std::string out;
+    size_t estimate = mappings.size() + 256;
+    if (include_sources) {
+      for (size_t i = 0; i < source_index.size(); ++i) {
+        estimate += strlen(sources[source_index[i]].contents) + 16;
+      }
+    }
+    out.reserve(estimate);
 
-    const char *file_name = file.c_str();
-    JsonNode *json_file_name = json_mkstring(file_name);
-    json_append_member(json_srcmap, "file", json_file_name);
+    out += "{\n\t\"version\": 3,\n\t\"file\": ";
+    append_json_string(out, file.c_str());
 
     // pass-through sourceRoot option
     if (!ctx.source_map_root.empty()) {
-      JsonNode* root = json_mkstring(ctx.source_map_root.c_str());
-      json_append_member(json_srcmap, "sourceRoot", root);
+      out += ",\n\t\"sourceRoot\": ";
+      append_json_string(out, ctx.source_map_root.c_str());
     }
 
-    JsonNode *json_sources = json_mkarray();
-    for (size_t i = 0; i < source_index.size(); ++i) {
-      std::string source(links[source_index[i]]);
-      if (ctx.c_options.source_map_file_urls) {
-        source = File::rel2abs(source);
-        // check for windows abs path
-        if (source[0] == '/') {
-          // ends up with three slashes
-          source = "file://" + source;
-        } else {
-          // needs an additional slash
-          source = "file:///" + source;
+    out += ",\n\t\"sources\": ";
+    if (source_index.empty()) {
+      out += "[]";
+    }
+    else {
+      out += "[\n";
+      for (size_t i = 0; i < source_index.size(); ++i) {
+        std::string source(links[source_index[i]]);
+        if (ctx.c_options.source_map_file_urls) {
+          source = File::rel2abs(source);
+          // check for windows abs path
+          if (source[0] == '/') {
+            // ends up with three slashes
+            source = "file://" + source;
+          } else {
+            // needs an additional slash
+            source = "file:///" + source;
+          }
         }
+        out += "\t\t";
+        append_json_string(out, source.c_str());
+        out += i + 1 < source_index.size() ? ",\n" : "\n";
       }
-      const char* source_name = source.c_str();
-      JsonNode *json_source_name = json_mkstring(source_name);
-      json_append_element(json_sources, json_source_name);
+      out += "\t]";
     }
-    json_append_member(json_srcmap, "sources", json_sources);
 
     if (include_sources && source_index.size()) {
-      JsonNode *json_contents = json_mkarray();
+      out += ",\n\t\"sourcesContent\": [\n";
       for (size_t i = 0; i < source_index.size(); ++i) {
         const Resource& resource(sources[source_index[i]]);
-        JsonNode *json_content = json_mkstring(resource.contents);
-        json_append_element(json_contents, json_content);
+        out += "\t\t";
+        append_json_string(out, resource.contents);
+        out += i + 1 < source_index.size() ? ",\n" : "\n";
       }
-      json_append_member(json_srcmap, "sourcesContent", json_contents);
+      out += "\t]";
     }
 
-    JsonNode *json_names = json_mkarray();
     // so far we have no implementation for names
     // no problem as we do not alter any identifiers
-    json_append_member(json_srcmap, "names", json_names);
+    out += ",\n\t\"names\": [],\n\t\"mappings\": ";
 
-    std::string mappings = serialize_mappings();
-    JsonNode *json_mappings = json_mkstring(mappings.c_str());
-    json_append_member(json_srcmap, "mappings", json_mappings);
+    // vlq data is base64 and separators only, nothing to escape
+    out += '"';
+    out += mappings;
+    out += '"';
+    out += "\n}";
 
-    char *str = json_stringify(json_srcmap, "\t");
-    std::string result = std::string(str);
-    free(str);
-    json_delete(json_srcmap);
-    return result;
+    return out;
   }
 
   std::string SourceMap::serialize_mappings() {
     std::string result = "";
+    // four short VLQ values plus separator per mapping
+    result.reserve(size() * 8);
 
     size_t previous_generated_line = 0;
     size_t previous_generated_column = 0;
     size_t previous_original_line = 0;
     size_t previous_original_column = 0;
     size_t previous_original_file = 0;
-    for (size_t i = 0; i < mappings.size(); ++i) {
-      const size_t generated_line = mappings[i].generated_position.line;
-      const size_t generated_column = mappings[i].generated_position.column;
-      const size_t original_line = mappings[i].original_position.line;
-      const size_t original_column = mappings[i].original_position.column;
-      const size_t original_file = mappings[i].original_position.file;
+    for (size_t i = 0; i < size(); ++i) {
+      const size_t generated_line = gen_lines[i];
+      const size_t generated_column = gen_columns[i];
+      const size_t original_line = src_lines[i];
+      const size_t original_column = src_columns[i];
+      const size_t original_file = src_files[i];
 
       if (generated_line != previous_generated_line) {
         previous_generated_column = 0;
@@ -110,16 +134,16 @@ namespace Sass {
       }
 
       // generated column
-      result += base64vlq.encode(static_cast<int>(generated_column) - static_cast<int>(previous_generated_column));
+      base64vlq.encode(result, static_cast<int>(generated_column) - static_cast<int>(previous_generated_column));
       previous_generated_column = generated_column;
       // file
-      result += base64vlq.encode(static_cast<int>(original_file) - static_cast<int>(previous_original_file));
+      base64vlq.encode(result, static_cast<int>(original_file) - static_cast<int>(previous_original_file));
       previous_original_file = original_file;
       // source line
-      result += base64vlq.encode(static_cast<int>(original_line) - static_cast<int>(previous_original_line));
+      base64vlq.encode(result, static_cast<int>(original_line) - static_cast<int>(previous_original_line));
       previous_original_line = original_line;
       // source column
-      result += base64vlq.encode(static_cast<int>(original_column) - static_cast<int>(previous_original_column));
+      base64vlq.encode(result, static_cast<int>(original_column) - static_cast<int>(previous_original_column));
       previous_original_column = original_column;
     }
 
@@ -128,13 +152,13 @@ namespace Sass {
 
   void SourceMap::prepend(const OutputBuffer& out)
   {
-    Offset size(out.smap.current_position);
-    for (Mapping mapping : out.smap.mappings) {
-      if (mapping.generated_position.line > size.line) {
+    Offset end(out.smap.current_position);
+    for (size_t i = 0, L = out.smap.size(); i < L; ++i) {
+      if (out.smap.gen_lines[i] > end.line) {
         throw(std::runtime_error("prepend sourcemap has illegal line"));
       }
-      if (mapping.generated_position.line == size.line) {
-        if (mapping.generated_position.column > size.column) {
+      if (out.smap.gen_lines[i] == end.line) {
+        if (out.smap.gen_columns[i] > end.column) {
           throw(std::runtime_error("prepend sourcemap has illegal column"));
         }
       }
@@ -142,24 +166,44 @@ namespace Sass {
     // adjust the buffer offset
     prepend(Offset(out.buffer));
     // now add the new mappings
-    VECTOR_UNSHIFT(mappings, out.smap.mappings);
+    VECTOR_UNSHIFT(gen_lines, out.smap.gen_lines);
+    VECTOR_UNSHIFT(gen_columns, out.smap.gen_columns);
+    VECTOR_UNSHIFT(src_files, out.smap.src_files);
+    VECTOR_UNSHIFT(src_lines, out.smap.src_lines);
+    VECTOR_UNSHIFT(src_columns, out.smap.src_columns);
   }
 
   void SourceMap::append(const OutputBuffer& out)
   {
+    // merge the mappings rebased onto the current end of our
+    // buffer, then advance the position over the added text;
+    // only the generated side rebases, the source columns copy
+    // over untouched
+    Offset base(current_position);
+    reserve(size() + out.smap.size());
+    for (size_t i = 0, L = out.smap.size(); i < L; ++i) {
+      uint32_t line = out.smap.gen_lines[i];
+      uint32_t column = out.smap.gen_columns[i];
+      if (line == 0) column += (uint32_t) base.column;
+      gen_lines.push_back(line + (uint32_t) base.line);
+      gen_columns.push_back(column);
+    }
+    VECTOR_PUSH(src_files, out.smap.src_files);
+    VECTOR_PUSH(src_lines, out.smap.src_lines);
+    VECTOR_PUSH(src_columns, out.smap.src_columns);
     append(Offset(out.buffer));
   }
 
   void SourceMap::prepend(const Offset& offset)
   {
     if (offset.line != 0 || offset.column != 0) {
-      for (Mapping& mapping : mappings) {
+      for (size_t i = 0, L = size(); i < L; ++i) {
         // move stuff on the first old line
-        if (mapping.generated_position.line == 0) {
-          mapping.generated_position.column += offset.column;
+        if (gen_lines[i] == 0) {
+          gen_columns[i] += (uint32_t) offset.column;
         }
         // make place for the new lines
-        mapping.generated_position.line += offset.line;
+        gen_lines[i] += (uint32_t) offset.line;
       }
     }
     if (current_position.line == 0) {
@@ -175,21 +219,35 @@ namespace Sass {
 
   void SourceMap::add_open_mapping(const AST_Node* node)
   {
-    mappings.push_back(Mapping(node->pstate(), current_position));
+    const ParserState& pstate = node->pstate();
+    gen_lines.push_back((uint32_t) current_position.line);
+    gen_columns.push_back((uint32_t) current_position.column);
+    src_files.push_back(pstate.file);
+    src_lines.push_back((uint32_t) pstate.line);
+    src_columns.push_back((uint32_t) pstate.column);
   }
 
   void SourceMap::add_close_mapping(const AST_Node* node)
   {
-    mappings.push_back(Mapping(node->pstate() + node->pstate().offset, current_position));
+    Position original(node->pstate() + node->pstate().offset);
+    gen_lines.push_back((uint32_t) current_position.line);
+    gen_columns.push_back((uint32_t) current_position.column);
+    src_files.push_back(original.file);
+    src_lines.push_back((uint32_t) original.line);
+    src_columns.push_back((uint32_t) original.column);
   }
 
   ParserState SourceMap::remap(const ParserState& pstate) {
-    for (size_t i = 0; i < mappings.size(); ++i) {
+    // the generated side never carries a file, so only requests
+    // for file zero (what current_position always held) can match
+    for (size_t i = 0, L = size(); i < L; ++i) {
       if (
-        mappings[i].generated_position.file == pstate.file &&
-        mappings[i].generated_position.line == pstate.line &&
-        mappings[i].generated_position.column == pstate.column
-      ) return ParserState(pstate.path, pstate.src, mappings[i].original_position, pstate.offset);
+        0 == pstate.file &&
+        gen_lines[i] == pstate.line &&
+        gen_columns[i] == pstate.column
+      ) return ParserState(pstate.path, pstate.src,
+          Position(src_files[i], src_lines[i], src_columns[i]),
+          pstate.offset);
     }
     return ParserState(pstate.path, pstate.src, Position(-1, -1, -1), Offset(0, 0));
 
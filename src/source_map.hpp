@@ -7,7 +7,6 @@
 #include "ast_fwd_decl.hpp"
 #include "base64vlq.hpp"
 #include "position.hpp"
-#include "mapping.hpp"
 
 #define VECTOR_PUSH(vec, ins) vec.insert(vec.end(), ins.begin(), ins.end())
 #define VECTOR_UNSHIFT(vec, ins) vec.insert(vec.begin(), ins.begin(), ins.end())
@@ -24,6 +23,17 @@ namespace Sass {
     SourceMap();
     SourceMap(const std::string& file);
 
+    // presize the mapping store (renders know roughly how many
+    // mappings a tree will emit before emitting any)
+    void reserve(size_t size)
+    {
+      gen_lines.reserve(size);
+      gen_columns.reserve(size);
+      src_files.reserve(size);
+      src_lines.reserve(size);
+      src_columns.reserve(size);
+    }
+
     void append(const Offset& offset);
     void prepend(const Offset& offset);
     void append(const OutputBuffer& out);
@@ -38,7 +48,21 @@ namespace Sass {
 
     std::string serialize_mappings();
 
-    std::vector<Mapping> mappings;
+    // the mappings, stored columnar: entry i of every array
+    // together forms one mapping. Compared to an array of structs
+    // of two file/line/column positions this more than halves the
+    // footprint (the generated side needs no file and nothing
+    // needs 64 bits), rebasing on buffer merges walks just the two
+    // generated columns, and the VLQ serializer streams down four
+    // tightly packed arrays instead of striding over fat structs.
+    std::vector<uint32_t> gen_lines;
+    std::vector<uint32_t> gen_columns;
+    std::vector<uint32_t> src_files;
+    std::vector<uint32_t> src_lines;
+    std::vector<uint32_t> src_columns;
+
+    size_t size() const { return gen_lines.size(); }
+
     Position current_position;
 public:
     std::string file;
@@ -50,11 +74,15 @@ private:
     public:
       OutputBuffer(void)
       : buffer(""),
-        smap()
+        smap(),
+        has_non_ascii(false)
       { }
     public:
       std::string buffer;
       SourceMap smap;
+      // sticky flag maintained while appending, so the charset
+      // decision needs no scan over the finished buffer
+      bool has_non_ascii;
   };
 
 }
@@ -0,0 +1,67 @@
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+
+#include "tokenizer.hpp"
+#include "prelexer.hpp"
+
+namespace Sass {
+
+  namespace Tokenize {
+
+    // note any byte above 127 within a consumed span
+    static inline bool span_is_ascii(const char* beg, const char* end)
+    {
+      while (beg < end) {
+        if (static_cast<unsigned char>(*beg) > 127) return false;
+        ++ beg;
+      }
+      return true;
+    }
+
+    void scan(const char* src, TokenStream& out)
+    {
+      const char* p = src;
+      while (*p) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        // fold whitespace away
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+          ++ p; continue;
+        }
+        // fold comments away (but keep probing their bytes)
+        if (c == '/' && (p[1] == '*' || p[1] == '/')) {
+          const char* q = p[1] == '*'
+            ? Prelexer::block_comment(p)
+            : Prelexer::line_comment(p);
+          if (q) {
+            if (out.ascii) out.ascii = span_is_ascii(p, q);
+            p = q; continue;
+          }
+        }
+        uint8_t kind = TOK_PUNCT;
+        const char* q = 0;
+        if (c == '"' || c == '\'') {
+          if ((q = Prelexer::quoted_string(p))) kind = TOK_STRING;
+        }
+        else if (c == '#' && p[1] == '{') {
+          if ((q = Prelexer::interpolant(p))) kind = TOK_INTERPOLANT;
+        }
+        else if (c == '@') {
+          if ((q = Prelexer::identifier(p + 1))) kind = TOK_AT_KEYWORD;
+        }
+        else {
+          if ((q = Prelexer::identifier(p))) kind = TOK_IDENT;
+        }
+        // malformed or single byte input advances by one
+        if (q == 0 || q == p) { q = p + 1; kind = TOK_PUNCT; }
+        if (out.ascii) out.ascii = span_is_ascii(p, q);
+        out.tokens.push_back({ kind,
+          static_cast<uint32_t>(p - src),
+          static_cast<uint32_t>(q - p) });
+        p = q;
+      }
+    }
+
+  }
+
+}
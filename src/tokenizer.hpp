@@ -0,0 +1,50 @@
+#ifndef SASS_TOKENIZER_H
+#define SASS_TOKENIZER_H
+
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Sass {
+
+  // A compact token stream captured in one prelexer pass over a
+  // source buffer: (kind, offset, length) triples into the original
+  // text, plus facts that used to need separate scans (ascii-only
+  // probe). The stream is the lex half of a two-phase parse; the
+  // registration path consumes it for import prefetching today and
+  // it is cheap enough to persist next to a content hash.
+  namespace Tokenize {
+
+    enum TokenKind : uint8_t {
+      TOK_IDENT,       // css identifier
+      TOK_AT_KEYWORD,  // @ followed by an identifier
+      TOK_STRING,      // quoted string (quotes included)
+      TOK_INTERPOLANT, // #{...} span
+      TOK_PUNCT        // any other single byte
+    };
+
+    struct SourceToken {
+      uint8_t kind;
+      uint32_t offset;
+      uint32_t length;
+    };
+
+    struct TokenStream {
+      std::vector<SourceToken> tokens;
+      // no byte above 127 anywhere in the source
+      // (so the buffer is known to be valid utf8)
+      bool ascii = true;
+    };
+
+    // scan the whole null-terminated buffer; whitespace and
+    // comments are folded away, everything else becomes a token
+    void scan(const char* src, TokenStream& out);
+
+  }
+
+}
+
+#endif
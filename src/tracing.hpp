@@ -0,0 +1,29 @@
+#ifndef SASS_TRACING_H
+#define SASS_TRACING_H
+
+namespace Sass {
+
+  // Lightweight tracepoints for live profiling: a process wide
+  // callback registered via sass_set_trace_callback receives
+  // (event, detail) pairs from phase boundaries, imports, mixin
+  // expansions and extend registrations. The pointer is read
+  // without synchronization on hot paths, so callers register
+  // before compilations start and leave the hook in place.
+  namespace Tracing {
+
+    extern void (*callback)(const char*, const char*, void*);
+    extern void* cookie;
+
+    // check before building an expensive detail string
+    inline bool enabled() { return callback != 0; }
+
+    inline void emit(const char* event, const char* detail)
+    {
+      if (callback) callback(event, detail, cookie);
+    }
+
+  }
+
+}
+
+#endif
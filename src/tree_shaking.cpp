@@ -0,0 +1,339 @@
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+#include "ast.hpp"
+
+#include "context.hpp"
+#include "tree_shaking.hpp"
+#include "util.hpp"
+
+namespace Sass {
+
+  namespace {
+
+    // built-ins that resolve names at runtime: a single occurrence
+    // anywhere makes static reachability undecidable, so the scan
+    // gives up and shakes nothing
+    bool is_dynamic_builtin(const std::string& name)
+    {
+      return name == "call"
+          || name == "get-function"
+          || name == "mixin-exists"
+          || name == "function-exists"
+          || name == "variable-exists"
+          || name == "global-variable-exists";
+    }
+
+    // Walking state: every definition and assignment records which
+    // names its body mentions, attributed to its own key; code that
+    // is emitted unconditionally attributes to the root (the empty
+    // key). Reachability is then the closure of the root's
+    // mentions over those edges.
+    struct ShakeScan {
+      // owner key to the names its body mentions
+      std::unordered_map<std::string, std::unordered_set<std::string>> mentions;
+      // definition and assignment keys seen (the shake candidates)
+      std::unordered_set<std::string> candidates;
+      // stack of enclosing owners; empty means emitted code
+      std::vector<std::string> owners;
+      // cleared when reachability turns out undecidable
+      bool decidable = true;
+      void mention(const std::string& name) {
+        mentions[owners.empty() ? std::string() : owners.back()].insert(name);
+      }
+    };
+
+    void scan_block(Block* b, ShakeScan& scan);
+
+    void scan_expression(Expression* e, ShakeScan& scan)
+    {
+      if (e == 0 || !scan.decidable) return;
+      switch (e->concrete_type()) {
+        case Expression::NUMBER:
+        case Expression::BOOLEAN:
+        case Expression::COLOR:
+        case Expression::NULL_VAL:
+          return;
+        default:
+          break;
+      }
+      if (Variable* v = Cast<Variable>(e)) {
+        scan.mention(v->name());
+        return;
+      }
+      if (Function_Call* c = Cast<Function_Call>(e)) {
+        // interpolated names resolve to unknown callables
+        if (Cast<String_Schema>(c->sname())) {
+          scan.decidable = false;
+          return;
+        }
+        std::string name(Util::normalize_underscores(c->name()));
+        if (is_dynamic_builtin(name)) {
+          scan.decidable = false;
+          return;
+        }
+        scan.mention(name + "[f]");
+        if (c->arguments()) {
+          for (const Argument_Obj& arg : c->arguments()->elements()) {
+            scan_expression(arg->value(), scan);
+          }
+        }
+        return;
+      }
+      if (List* l = Cast<List>(e)) {
+        for (const Expression_Obj& item : l->elements()) {
+          scan_expression(item, scan);
+        }
+        return;
+      }
+      if (Map* m = Cast<Map>(e)) {
+        for (const Expression_Obj& key : m->keys()) {
+          scan_expression(key, scan);
+        }
+        for (const Expression_Obj& val : m->values()) {
+          scan_expression(val, scan);
+        }
+        return;
+      }
+      if (Binary_Expression* b = Cast<Binary_Expression>(e)) {
+        scan_expression(b->left(), scan);
+        scan_expression(b->right(), scan);
+        return;
+      }
+      if (Unary_Expression* u = Cast<Unary_Expression>(e)) {
+        scan_expression(u->operand(), scan);
+        return;
+      }
+      if (String_Schema* s = Cast<String_Schema>(e)) {
+        for (const PreValue_Obj& item : s->elements()) {
+          scan_expression(item, scan);
+        }
+        return;
+      }
+      // includes String_Quoted
+      if (Cast<String_Constant>(e)) return;
+      if (Media_Query* q = Cast<Media_Query>(e)) {
+        scan_expression(q->media_type(), scan);
+        for (const Media_Query_Expression_Obj& mqe : q->elements()) {
+          scan_expression(mqe, scan);
+        }
+        return;
+      }
+      if (Media_Query_Expression* mqe = Cast<Media_Query_Expression>(e)) {
+        scan_expression(mqe->feature(), scan);
+        scan_expression(mqe->value(), scan);
+        return;
+      }
+      if (At_Root_Query* q = Cast<At_Root_Query>(e)) {
+        scan_expression(q->feature(), scan);
+        scan_expression(q->value(), scan);
+        return;
+      }
+      if (Supports_Operator* op = Cast<Supports_Operator>(e)) {
+        scan_expression(op->left(), scan);
+        scan_expression(op->right(), scan);
+        return;
+      }
+      if (Supports_Negation* neg = Cast<Supports_Negation>(e)) {
+        scan_expression(neg->condition(), scan);
+        return;
+      }
+      if (Supports_Declaration* decl = Cast<Supports_Declaration>(e)) {
+        scan_expression(decl->feature(), scan);
+        scan_expression(decl->value(), scan);
+        return;
+      }
+      if (Supports_Interpolation* itpl = Cast<Supports_Interpolation>(e)) {
+        scan_expression(itpl->value(), scan);
+        return;
+      }
+      if (Arguments* args = Cast<Arguments>(e)) {
+        for (const Argument_Obj& arg : args->elements()) {
+          scan_expression(arg->value(), scan);
+        }
+        return;
+      }
+      // unknown expression kinds end the analysis
+      scan.decidable = false;
+    }
+
+    void scan_parameters(Parameters* params, ShakeScan& scan)
+    {
+      if (params == 0) return;
+      for (const Parameter_Obj& param : params->elements()) {
+        scan_expression(param->default_value(), scan);
+      }
+    }
+
+    void scan_statement(Statement* s, ShakeScan& scan)
+    {
+      if (s == 0 || !scan.decidable) return;
+      if (Definition* d = Cast<Definition>(s)) {
+        std::string key(d->name() +
+          (d->type() == Definition::MIXIN ? "[m]" : "[f]"));
+        scan.candidates.insert(key);
+        // the body's mentions only count once the name is reached
+        scan.owners.push_back(key);
+        scan_parameters(d->parameters(), scan);
+        scan_block(d->block(), scan);
+        scan.owners.pop_back();
+        return;
+      }
+      if (Assignment* a = Cast<Assignment>(s)) {
+        scan.candidates.insert(a->variable());
+        scan.owners.push_back(a->variable());
+        scan_expression(a->value(), scan);
+        scan.owners.pop_back();
+        return;
+      }
+      if (Mixin_Call* c = Cast<Mixin_Call>(s)) {
+        scan.mention(c->name() + "[m]");
+        if (c->arguments()) scan_expression(c->arguments(), scan);
+        scan_parameters(c->block_parameters(), scan);
+        scan_block(c->block(), scan);
+        return;
+      }
+      if (Declaration* d = Cast<Declaration>(s)) {
+        scan_expression(d->property(), scan);
+        scan_expression(d->value(), scan);
+        scan_block(d->block(), scan);
+        return;
+      }
+      if (Ruleset* r = Cast<Ruleset>(s)) {
+        if (r->schema()) scan_expression(r->schema()->contents(), scan);
+        scan_block(r->block(), scan);
+        return;
+      }
+      if (MediaRule* m = Cast<MediaRule>(s)) {
+        scan_expression(m->schema(), scan);
+        scan_block(m->block(), scan);
+        return;
+      }
+      if (Supports_Block* f = Cast<Supports_Block>(s)) {
+        scan_expression(f->condition(), scan);
+        scan_block(f->block(), scan);
+        return;
+      }
+      if (At_Root_Block* a = Cast<At_Root_Block>(s)) {
+        scan_expression(a->expression(), scan);
+        scan_block(a->block(), scan);
+        return;
+      }
+      if (Directive* a = Cast<Directive>(s)) {
+        scan_expression(a->value(), scan);
+        scan_block(a->block(), scan);
+        return;
+      }
+      if (Keyframe_Rule* k = Cast<Keyframe_Rule>(s)) {
+        scan_block(k->block(), scan);
+        return;
+      }
+      if (If* i = Cast<If>(s)) {
+        scan_expression(i->predicate(), scan);
+        scan_block(i->block(), scan);
+        scan_block(i->alternative(), scan);
+        return;
+      }
+      if (For* f = Cast<For>(s)) {
+        scan_expression(f->lower_bound(), scan);
+        scan_expression(f->upper_bound(), scan);
+        scan_block(f->block(), scan);
+        return;
+      }
+      if (Each* e = Cast<Each>(s)) {
+        scan_expression(e->list(), scan);
+        scan_block(e->block(), scan);
+        return;
+      }
+      if (While* w = Cast<While>(s)) {
+        scan_expression(w->predicate(), scan);
+        scan_block(w->block(), scan);
+        return;
+      }
+      if (Return* r = Cast<Return>(s)) {
+        scan_expression(r->value(), scan);
+        return;
+      }
+      if (ExtendRule* e = Cast<ExtendRule>(s)) {
+        if (e->schema()) scan_expression(e->schema()->contents(), scan);
+        return;
+      }
+      if (Content* c = Cast<Content>(s)) {
+        if (c->arguments()) scan_expression(c->arguments(), scan);
+        return;
+      }
+      if (Import* imp = Cast<Import>(s)) {
+        for (const Expression_Obj& url : imp->urls()) {
+          scan_expression(url, scan);
+        }
+        scan_expression(imp->import_queries(), scan);
+        return;
+      }
+      if (Warning* w = Cast<Warning>(s)) {
+        scan_expression(w->message(), scan);
+        return;
+      }
+      if (Error* e = Cast<Error>(s)) {
+        scan_expression(e->message(), scan);
+        return;
+      }
+      if (Debug* d = Cast<Debug>(s)) {
+        scan_expression(d->value(), scan);
+        return;
+      }
+      if (Comment* c = Cast<Comment>(s)) {
+        scan_expression(c->text(), scan);
+        return;
+      }
+      // imports of other sheets splice their roots in, which are
+      // all scanned on their own; the stub itself names nothing
+      if (Cast<Import_Stub>(s)) return;
+      // unknown statement kinds end the analysis
+      scan.decidable = false;
+    }
+
+    void scan_block(Block* b, ShakeScan& scan)
+    {
+      if (b == 0) return;
+      for (size_t i = 0, L = b->length(); i < L; ++i) {
+        scan_statement(b->at(i), scan);
+        if (!scan.decidable) return;
+      }
+    }
+
+  }
+
+  std::unordered_set<std::string> find_unreachable_definitions(Context& ctx)
+  {
+    ShakeScan scan;
+    // every parsed sheet is spliced into the output tree by its
+    // import stub, so all of them contribute emitted code
+    for (auto& sheet : ctx.sheets) {
+      scan_block(sheet.second.root, scan);
+      if (!scan.decidable) return {};
+    }
+    // close the root's mentions over the candidates they reach;
+    // names that several kinds of definition share merge their
+    // mentions, which can only keep more alive than necessary
+    std::unordered_set<std::string> live;
+    std::vector<std::string> queue(
+      scan.mentions[std::string()].begin(),
+      scan.mentions[std::string()].end());
+    while (!queue.empty()) {
+      std::string name(std::move(queue.back()));
+      queue.pop_back();
+      if (!live.insert(name).second) continue;
+      auto reached = scan.mentions.find(name);
+      if (reached == scan.mentions.end()) continue;
+      for (const std::string& next : reached->second) {
+        if (!live.count(next)) queue.push_back(next);
+      }
+    }
+    std::unordered_set<std::string> dead;
+    for (const std::string& name : scan.candidates) {
+      if (!live.count(name)) dead.insert(name);
+    }
+    return dead;
+  }
+
+}
@@ -0,0 +1,31 @@
+#ifndef SASS_TREE_SHAKING_H
+#define SASS_TREE_SHAKING_H
+
+// sass.hpp must go before all system headers to get the
+// __EXTENSIONS__ fix on Solaris.
+#include "sass.hpp"
+
+#include <string>
+#include <unordered_set>
+
+#include "ast_fwd_decl.hpp"
+
+namespace Sass {
+
+  class Context;
+
+  // Reachability pre-pass over the parsed import closure: collects
+  // the mixins, functions and variables that emitted code can ever
+  // name, directly or through other reachable definitions, so that
+  // Expand can skip registering and evaluating the rest (see the
+  // tree_shaking option and Context::compile). Names are keyed the
+  // way the environment keys them ("x[m]", "x[f]", "$x"). Returns
+  // an empty set — shake nothing — whenever anything makes
+  // reachability undecidable: dynamic dispatch through call() or
+  // get-function, existence introspection, interpolated call names
+  // or a node kind the scan does not know.
+  std::unordered_set<std::string> find_unreachable_definitions(Context& ctx);
+
+}
+
+#endif
@@ -93,30 +93,58 @@ namespace Sass {
 
   UnitType string_to_unit(const std::string& s)
   {
-    // size units
-    if      (s == "px")   return UnitType::PX;
-    else if (s == "pt")   return UnitType::PT;
-    else if (s == "pc")   return UnitType::PC;
-    else if (s == "mm")   return UnitType::MM;
-    else if (s == "cm")   return UnitType::CM;
-    else if (s == "in")   return UnitType::IN;
-    // angle units
-    else if (s == "deg")  return UnitType::DEG;
-    else if (s == "grad") return UnitType::GRAD;
-    else if (s == "rad")  return UnitType::RAD;
-    else if (s == "turn") return UnitType::TURN;
-    // time units
-    else if (s == "s")    return UnitType::SEC;
-    else if (s == "ms")   return UnitType::MSEC;
-    // frequency units
-    else if (s == "Hz")   return UnitType::HERTZ;
-    else if (s == "kHz")  return UnitType::KHERTZ;
-    // resolutions units
-    else if (s == "dpi")  return UnitType::DPI;
-    else if (s == "dpcm") return UnitType::DPCM;
-    else if (s == "dppx") return UnitType::DPPX;
+    // dispatch on length and lead char first, so unknown
+    // (custom) units bail out without string comparisons
+    switch (s.size()) {
+      case 1:
+        // time units
+        if (s[0] == 's') return UnitType::SEC;
+        break;
+      case 2:
+        switch (s[0]) {
+          // size units
+          case 'p':
+            if (s[1] == 'x') return UnitType::PX;
+            if (s[1] == 't') return UnitType::PT;
+            if (s[1] == 'c') return UnitType::PC;
+            break;
+          case 'm':
+            if (s[1] == 'm') return UnitType::MM;
+            // time units
+            if (s[1] == 's') return UnitType::MSEC;
+            break;
+          case 'c':
+            if (s[1] == 'm') return UnitType::CM;
+            break;
+          case 'i':
+            if (s[1] == 'n') return UnitType::IN;
+            break;
+          // frequency units
+          case 'H':
+            if (s[1] == 'z') return UnitType::HERTZ;
+            break;
+        }
+        break;
+      case 3:
+        // angle units
+        if (s == "deg")  return UnitType::DEG;
+        if (s == "rad")  return UnitType::RAD;
+        // frequency units
+        if (s == "kHz")  return UnitType::KHERTZ;
+        // resolutions units
+        if (s == "dpi")  return UnitType::DPI;
+        break;
+      case 4:
+        // angle units
+        if (s == "grad") return UnitType::GRAD;
+        if (s == "turn") return UnitType::TURN;
+        // resolutions units
+        if (s == "dpcm") return UnitType::DPCM;
+        if (s == "dppx") return UnitType::DPPX;
+        break;
+    }
     // for unknown units
-    else return UnitType::UNKNOWN;
+    return UnitType::UNKNOWN;
   }
 
   const char* unit_to_string(UnitType unit)
@@ -176,19 +204,63 @@ namespace Sass {
     return "CUSTOM:" + s;
   }
 
+  namespace {
+
+    // all known units in dense id order (class tables appended)
+    const UnitType dense_units[17] = {
+      UnitType::IN, UnitType::CM, UnitType::PC,
+      UnitType::MM, UnitType::PT, UnitType::PX,
+      UnitType::DEG, UnitType::GRAD, UnitType::RAD, UnitType::TURN,
+      UnitType::SEC, UnitType::MSEC,
+      UnitType::HERTZ, UnitType::KHERTZ,
+      UnitType::DPI, UnitType::DPCM, UnitType::DPPX
+    };
+
+    // map a unit to its dense id (-1 for unknown units); the
+    // enum encodes the class in the high byte and the position
+    // within the class table in the low byte
+    inline int dense_unit_index(UnitType unit)
+    {
+      if (unit == UnitType::UNKNOWN) return -1;
+      static const int class_offsets[5] = { 0, 6, 10, 12, 14 };
+      return class_offsets[unit >> 8] + (unit & 0xFF);
+    }
+
+    // one dense matrix over every known unit pair, filled once
+    // from the per-class tables; incommensurable pairs hold zero,
+    // the same "cannot convert" answer the class lookup gives
+    struct DenseConversionFactors {
+      double factors[17][17];
+      DenseConversionFactors() {
+        for (size_t i = 0; i < 17; i++) {
+          for (size_t n = 0; n < 17; n++) {
+            UnitType u1 = dense_units[i], u2 = dense_units[n];
+            factors[i][n] = conversion_factor(u1, u2,
+              get_unit_type(u1), get_unit_type(u2));
+          }
+        }
+      }
+    };
+
+  }
+
+  // never throws, returns zero for incommensurable pairs
+  double conversion_factor(UnitType u1, UnitType u2)
+  {
+    static DenseConversionFactors dense;
+    int i1 = dense_unit_index(u1);
+    int i2 = dense_unit_index(u2);
+    if (i1 < 0 || i2 < 0) return 0;
+    return dense.factors[i1][i2];
+  }
+
   // throws incompatibleUnits exceptions
   double conversion_factor(const std::string& s1, const std::string& s2)
   {
     // assert for same units
     if (s1 == s2) return 1;
-    // get unit enum from string
-    UnitType u1 = string_to_unit(s1);
-    UnitType u2 = string_to_unit(s2);
-    // query unit group types
-    UnitClass t1 = get_unit_type(u1);
-    UnitClass t2 = get_unit_type(u2);
     // return the conversion factor
-    return conversion_factor(u1, u2, t1, t2);
+    return conversion_factor(string_to_unit(s1), string_to_unit(s2));
   }
 
   // throws incompatibleUnits exceptions
@@ -233,15 +305,12 @@ namespace Sass {
     // skip units we cannot convert
     if (ulhs == UNKNOWN) return 0;
     if (urhs == UNKNOWN) return 0;
-    // query unit group types
-    UnitClass clhs = get_unit_type(ulhs);
-    UnitClass crhs = get_unit_type(urhs);
-    // skip units we cannot convert
-    if (clhs != crhs) return 0;
     // if right denominator is bigger than lhs, we want to keep it in rhs unit
     if (rhsexp < 0 && lhsexp > 0 && - rhsexp > lhsexp) {
       // get the conversion factor for units
-      f = conversion_factor(urhs, ulhs, clhs, crhs);
+      f = conversion_factor(urhs, ulhs);
+      // skip units we cannot convert
+      if (f == 0) return 0;
       // left hand side has been consumned
       f = std::pow(f, lhsexp);
       rhsexp += lhsexp;
@@ -249,7 +318,9 @@ namespace Sass {
     }
     else {
       // get the conversion factor for units
-      f = conversion_factor(ulhs, urhs, clhs, crhs);
+      f = conversion_factor(ulhs, urhs);
+      // skip units we cannot convert
+      if (f == 0) return 0;
       // right hand side has been consumned
       f = std::pow(f, rhsexp);
       lhsexp += rhsexp;
@@ -265,6 +336,11 @@ namespace Sass {
   }
   bool Units::operator== (const Units& rhs) const
   {
+    // a valid signature identifies the unit vectors completely, so
+    // it can accept and reject without touching any string; it can
+    // never collide with an unpackable right hand side either
+    uint64_t sig = unit_signature();
+    if (sig) return sig == rhs.unit_signature();
     return (numerators == rhs.numerators) &&
            (denominators == rhs.denominators);
   }
@@ -273,6 +349,26 @@ namespace Sass {
     return ! (*this == rhs);
   }
 
+  uint64_t Units::unit_signature() const
+  {
+    if (numerators.size() > 1) return 0;
+    if (denominators.size() > 1) return 0;
+    // bit 63 marks the signature as valid, so a
+    // plain unitless number still packs to non-zero
+    uint64_t sig = UINT64_C(1) << 63;
+    if (!numerators.empty()) {
+      UnitType u = string_to_unit(numerators[0]);
+      if (u == UnitType::UNKNOWN) return 0;
+      sig |= (uint64_t) u + 1;
+    }
+    if (!denominators.empty()) {
+      UnitType u = string_to_unit(denominators[0]);
+      if (u == UnitType::UNKNOWN) return 0;
+      sig |= ((uint64_t) u + 1) << 16;
+    }
+    return sig;
+  }
+
   double Units::normalize()
   {
 
@@ -369,9 +465,14 @@ namespace Sass {
 
   std::string Units::unit() const
   {
-    std::string u;
     size_t iL = numerators.size();
     size_t nL = denominators.size();
+    // fast paths for the overwhelmingly common cases
+    if (nL == 0) {
+      if (iL == 0) return std::string();
+      if (iL == 1) return numerators[0];
+    }
+    std::string u;
     for (size_t i = 0; i < iL; i += 1) {
       if (i) u += '*';
       u += numerators[i];
@@ -2,6 +2,7 @@
 #define SASS_UNITS_H
 
 #include <cmath>
+#include <cstdint>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -70,6 +71,13 @@ namespace Sass {
     { }
     // convert to string
     std::string unit() const;
+    // pack the units into one integer for fast identity checks.
+    // Only defined for at most one known css unit per side; bit 63
+    // flags a valid signature and zero means "not packable" (an
+    // unknown unit or more than one per side). Equal signatures
+    // imply identical unit vectors; a zero result says nothing and
+    // callers must fall back to the full vector compare.
+    uint64_t unit_signature() const;
     // get if units are empty
     bool is_unitless() const;
     // return if valid for css
@@ -88,6 +96,27 @@ namespace Sass {
     double convert_factor(const Units&) const;
   };
 
+  // Canonical form of a unit vector pair: the units after reduce()
+  // plus normalize(), with the conversion factors accumulated along
+  // the way. Numbers cache one of these (see Number::canonical) so
+  // repeated comparisons stop re-canonicalizing the same units; the
+  // key re-derives from the live unit vectors on every access, which
+  // keeps the cache valid across direct vector mutations.
+  struct CanonicalUnits {
+    // hash over the owning unit vectors (zero means "not computed")
+    size_t key = 0;
+    // how many units survive reduce(); comparisons treat a number
+    // as unitless once its units cancel out
+    size_t reduced_count = 0;
+    // multiply the raw value by this for the reduced-units value
+    double reduce_factor = 1.0;
+    // multiply the raw value by this for the normalized-units value
+    double total_factor = 1.0;
+    // the fully normalized (converted and sorted) unit vectors
+    std::vector<std::string> numerators;
+    std::vector<std::string> denominators;
+  };
+
   extern const double size_conversion_factors[6][6];
   extern const double angle_conversion_factors[4][4];
   extern const double time_conversion_factors[2][2];
@@ -102,6 +131,8 @@ namespace Sass {
   std::string unit_to_class(const std::string&);
   // throws incompatibleUnits exceptions
   double conversion_factor(const std::string&, const std::string&);
+  // dense variant: one table read over all known unit pairs
+  double conversion_factor(UnitType, UnitType);
   double conversion_factor(UnitType, UnitType, UnitClass, UnitClass);
   double convert_units(const std::string&, const std::string&, int&, int&);
 
@@ -10,6 +10,9 @@
 
 #include <cmath>
 #include <stdint.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <tmmintrin.h>
+#endif
 #if defined(_MSC_VER) && _MSC_VER >= 1800 && _MSC_VER < 1900 && defined(_M_X64)
 #include <mutex>
 #endif
@@ -35,10 +38,61 @@ namespace Sass {
     return ::round(val);
   }
 
+  // parse a plain decimal literal (sign, digits, dot, digits),
+  // which is nearly every number a stylesheet contains. up to 19
+  // digits fit a 64 bit mantissa and powers of ten up to 10^22
+  // are exact doubles, so when the mantissa stays below 2^53 one
+  // multiplication or division gives the correctly rounded value
+  // (Clinger's fast case; the fast path of Eisel-Lemire style
+  // parsers). returns false for exponents, overlong literals or
+  // trailing input, which all take the strtod road instead
+  static bool fast_strtod(const char* str, double& out)
+  {
+    static const double exact_pow10[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+      1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+      1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const char* p = str;
+    bool negative = false;
+    if (*p == '+' || *p == '-') {
+      negative = *p == '-';
+      ++p;
+    }
+    uint64_t mantissa = 0;
+    int digits = 0, fraction = 0;
+    while (*p >= '0' && *p <= '9') {
+      if (++digits > 19) return false;
+      mantissa = mantissa * 10 + (*p - '0');
+      ++p;
+    }
+    if (*p == '.') {
+      ++p;
+      while (*p >= '0' && *p <= '9') {
+        if (++digits > 19) return false;
+        mantissa = mantissa * 10 + (*p - '0');
+        ++fraction;
+        ++p;
+      }
+    }
+    // nothing numeric, an exponent or trailing input
+    if (digits == 0 || *p != 0) return false;
+    if (fraction > 22 || mantissa > (1ULL << 53)) return false;
+    double val = (double) mantissa;
+    if (fraction) val /= exact_pow10[fraction];
+    out = negative ? -val : val;
+    return true;
+  }
+
   /* Locale unspecific atof function. */
   double sass_strtod(const char *str)
   {
-    char separator = *(localeconv()->decimal_point);
+    double parsed;
+    if (fast_strtod(str, parsed)) return parsed;
+
+    // snapshot the locale's separator once; querying localeconv for
+    // every slow-path literal serializes compiles inside the C library
+    static const char separator = *(localeconv()->decimal_point);
     if(separator != '.'){
       // The current locale specifies another
       // separator. convert the separator to the
@@ -99,8 +153,11 @@ namespace Sass {
   // read css string (handle multiline DELIM)
   std::string read_css_string(const std::string& str, bool css)
   {
-    if (!css) return str;
+    // only backslash escapes need rewriting; the vast
+    // majority of strings pass through here untouched
+    if (!css || str.find('\\') == std::string::npos) return str;
     std::string out("");
+    out.reserve(str.size());
     bool esc = false;
     for (auto i : str) {
       if (i == '\\') {
@@ -123,10 +180,20 @@ namespace Sass {
     return out;
   }
 
+  // overload for temporaries; moves the buffer
+  // through when no rewriting has to be done
+  std::string read_css_string(std::string&& str, bool css)
+  {
+    if (!css || str.find('\\') == std::string::npos) return std::move(str);
+    return read_css_string(str, css);
+  }
+
   // double escape all escape sequences
   // keep unescaped quotes and backslashes
   std::string evacuate_escapes(const std::string& str)
   {
+    // nothing to evacuate without a backslash
+    if (str.find('\\') == std::string::npos) return str;
     std::string out("");
     bool esc = false;
     for (auto i : str) {
@@ -339,7 +406,7 @@ namespace Sass {
 
   }
 
-  std::string unquote(const std::string& s, char* qd, bool keep_utf8_sequences, bool strict)
+  std::string unquote(const std::string& s, char* qd, bool keep_utf8_sequences, bool strict, size_t* cp_count)
   {
 
     // not enough room for quotes
@@ -358,6 +425,11 @@ namespace Sass {
     std::string unq;
     unq.reserve(s.length()-2);
 
+    // count code points on the side while we
+    // decode anyway (utf8 continuation bytes
+    // do not start a new code point)
+    size_t cps = 0;
+
     for (size_t i = 1, L = s.length() - 1; i < L; ++i) {
 
       // implement the same strange ruby sass behavior
@@ -381,6 +453,7 @@ namespace Sass {
         // hex string?
         if (keep_utf8_sequences) {
           unq.push_back(s[i]);
+          ++ cps;
         } else if (len > 1) {
 
           // convert the extracted hex string to code point value
@@ -400,6 +473,7 @@ namespace Sass {
           // allocate memory for utf8 char and convert to utf8
           unsigned char u[5] = {0,0,0,0,0}; utf8::append(cp, u);
           for(size_t m = 0; m < 5 && u[m]; m++) unq.push_back(u[m]);
+          ++ cps;
 
           // skip some more chars?
           i += len - 1; skipped = false;
@@ -422,15 +496,103 @@ namespace Sass {
         }
         skipped = false;
         unq.push_back(s[i]);
+        cps += (static_cast<unsigned char>(s[i]) & 0xC0) != 0x80;
       }
 
     }
     if (skipped) { return s; }
     if (qd) *qd = q;
+    if (cp_count) *cp_count = cps;
     return unq;
 
   }
 
+  namespace {
+
+    const char base64_alphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    // plain three-bytes-in-four-digits-out loop; encodes the tail
+    // and everything on cpus without the shuffle kernel below
+    void encode_base64_scalar(const unsigned char* in, size_t size, char* out)
+    {
+      size_t i = 0;
+      for (; i + 3 <= size; i += 3) {
+        uint32_t triple = (uint32_t) in[i] << 16
+                        | (uint32_t) in[i + 1] << 8
+                        | in[i + 2];
+        *out++ = base64_alphabet[(triple >> 18) & 0x3F];
+        *out++ = base64_alphabet[(triple >> 12) & 0x3F];
+        *out++ = base64_alphabet[(triple >> 6) & 0x3F];
+        *out++ = base64_alphabet[triple & 0x3F];
+      }
+      if (i < size) {
+        uint32_t triple = (uint32_t) in[i] << 16;
+        if (i + 1 < size) triple |= (uint32_t) in[i + 1] << 8;
+        *out++ = base64_alphabet[(triple >> 18) & 0x3F];
+        *out++ = base64_alphabet[(triple >> 12) & 0x3F];
+        *out++ = i + 1 < size ? base64_alphabet[(triple >> 6) & 0x3F] : '=';
+        *out++ = '=';
+      }
+    }
+
+    #if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define SASS_BASE64_SSSE3
+    // Shuffle based kernel: each round loads sixteen input bytes,
+    // spreads the leading twelve over four 32 bit lanes, isolates
+    // the 6 bit digits with two multiplies, and maps the digits to
+    // ascii through a saturated offset lookup — twelve bytes in,
+    // sixteen digits out per round. Only reached after a runtime
+    // check, so the surrounding build needs no -mssse3.
+    __attribute__((target("ssse3")))
+    size_t encode_base64_ssse3(const unsigned char* in, size_t size, char* out)
+    {
+      size_t consumed = 0;
+      while (size - consumed >= 16) {
+        __m128i chunk = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(in + consumed));
+        chunk = _mm_shuffle_epi8(chunk, _mm_set_epi8(
+          10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        const __m128i t0 = _mm_and_si128(chunk, _mm_set1_epi32(0x0FC0FC00));
+        const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        const __m128i t2 = _mm_and_si128(chunk, _mm_set1_epi32(0x003F03F0));
+        const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        const __m128i digits = _mm_or_si128(t1, t3);
+        // digit ranges to ascii offsets: 'A', 'a' - 26, '0' - 52,
+        // '+' - 62 and '/' - 63 (see base64_alphabet)
+        const __m128i lut = _mm_setr_epi8(
+          65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+        __m128i indices = _mm_subs_epu8(digits, _mm_set1_epi8(51));
+        const __m128i over25 = _mm_cmpgt_epi8(digits, _mm_set1_epi8(25));
+        indices = _mm_sub_epi8(indices, over25);
+        const __m128i ascii = _mm_add_epi8(digits, _mm_shuffle_epi8(lut, indices));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), ascii);
+        consumed += 12;
+        out += 16;
+      }
+      return consumed;
+    }
+    #endif
+
+  }
+
+  std::string encode_base64(const char* data, size_t size)
+  {
+    std::string encoded(((size + 2) / 3) * 4, '\0');
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+    char* out = &encoded[0];
+    #ifdef SASS_BASE64_SSSE3
+    if (__builtin_cpu_supports("ssse3")) {
+      size_t consumed = encode_base64_ssse3(in, size, out);
+      in += consumed;
+      size -= consumed;
+      out += consumed / 3 * 4;
+    }
+    #endif
+    encode_base64_scalar(in, size, out);
+    return encoded;
+  }
+
   std::string quote(const std::string& s, char q)
   {
 
@@ -36,6 +36,7 @@ namespace Sass {
   void free_string_array(char **);
   char **copy_strings(const std::vector<std::string>&, char ***, int = 0);
   std::string read_css_string(const std::string& str, bool css = true);
+  std::string read_css_string(std::string&& str, bool css = true);
   std::string evacuate_escapes(const std::string& str);
   std::string string_to_output(const std::string& str);
   std::string comment_to_compact_string(const std::string& text);
@@ -43,8 +44,16 @@ namespace Sass {
   std::string escape_string(const std::string& str);
   void newline_to_space(std::string& str);
 
+  // bulk base64 (RFC 4648 alphabet, padded, no line breaks); used
+  // for embedded source maps, which can run to many megabytes, so
+  // the encoder vectorizes on capable cpus (see util.cpp)
+  std::string encode_base64(const char* data, size_t size);
+
   std::string quote(const std::string&, char q = 0);
-  std::string unquote(const std::string&, char* q = 0, bool keep_utf8_sequences = false, bool strict = true);
+  // [cp_count] optionally receives the utf8 code point count of the
+  // decoded value, gathered during the same scan (left untouched
+  // when the input could not be unquoted)
+  std::string unquote(const std::string&, char* q = 0, bool keep_utf8_sequences = false, bool strict = true, size_t* cp_count = 0);
   char detect_best_quotemark(const char* s, char qm = '"');
 
   bool is_hex_doublet(double n);
@@ -27,6 +27,15 @@ namespace Sass {
       return *lit == 0;
     }
 
+    bool equalsNormalized(const char* lit, const std::string& test) {
+      const char* src = test.c_str();
+      while (*lit && (*src == *lit || (*src == '_' && *lit == '-'))) {
+        ++src, ++lit;
+      }
+      // both must be consumed completely
+      return *lit == 0 && *src == 0;
+    }
+
     void ascii_str_tolower(std::string* s) {
       for (auto& ch : *s) {
         ch = ascii_tolower(static_cast<unsigned char>(ch));
@@ -16,6 +16,14 @@ namespace Sass {
     // ##########################################################################
     bool equalsLiteral(const char* lit, const std::string& test);
 
+    // ##########################################################################
+    // Whole-string comparison of [test] against a normalized
+    // [lit] (dashes, no underscores), treating underscores in
+    // [test] as dashes. The allocation-free equivalent of
+    // comparing normalize_underscores(test) to a literal.
+    // ##########################################################################
+    bool equalsNormalized(const char* lit, const std::string& test);
+
     // ###########################################################################
     // Returns [name] without a vendor prefix.
     // If [name] has no vendor prefix, it's returned as-is.
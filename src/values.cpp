@@ -42,7 +42,7 @@ namespace Sass {
     {
       const Map* m = Cast<Map>(val);
       union Sass_Value* map = sass_make_map(m->length());
-      size_t i = 0; for (Expression_Obj key : m->keys()) {
+      size_t i = 0; for (const Expression_Obj& key : m->keys()) {
         sass_map_set_key(map, i, ast_node_to_sass_value(key));
         sass_map_set_value(map, i, ast_node_to_sass_value(m->at(key)));
         ++ i;
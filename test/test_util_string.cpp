@@ -119,6 +119,18 @@ bool testEqualsLiteral() {
 
 }
 
+bool testEqualsNormalized() {
+  ASSERT_TRUE(Sass::Util::equalsNormalized("content-exists", "content-exists"));
+  ASSERT_TRUE(Sass::Util::equalsNormalized("content-exists", "content_exists"));
+  ASSERT_TRUE(Sass::Util::equalsNormalized("content-exists", "content_exists"));
+  ASSERT_TRUE(Sass::Util::equalsNormalized("a-b-c", "a_b-c"));
+  ASSERT_FALSE(Sass::Util::equalsNormalized("content-exists", "content-exist"));
+  ASSERT_FALSE(Sass::Util::equalsNormalized("content-exist", "content-exists"));
+  ASSERT_FALSE(Sass::Util::equalsNormalized("content-exists", "Content-Exists"));
+  ASSERT_FALSE(Sass::Util::equalsNormalized("a-b", "a-b_"));
+  return true;
+}
+
 bool TestUnvendor() {
   // Generated by using dart sass
   ASSERT_STR_EQ("moz", Sass::Util::unvendor("moz"));
@@ -204,6 +216,7 @@ int main(int argc, char **argv) {
   TEST(TestNormalizeDecimalsLeadingZero);
   TEST(TestNormalizeDecimalsNoLeadingZero);
   TEST(testEqualsLiteral);
+  TEST(testEqualsNormalized);
   TEST(TestUnvendor);
   TEST(Test_ascii_str_to_lower);
   TEST(Test_ascii_str_to_upper);